@@ -18,6 +18,11 @@
 @property (nonatomic, readonly) PHImageContentMode contentMode;
 @property (nonatomic, readonly) BOOL cache;
 - (NSDictionary<NSString *, id> * _Nonnull)from:(NSInteger)offset to:(NSInteger)length;
+- (NSArray<PHAsset *> * _Nonnull)assetsFrom:(NSInteger)offset to:(NSInteger)length;
+- (NSDictionary<NSString *, id> * _Nonnull)responseWithLength:(NSInteger)length offset:(NSInteger)offset;
+- (NSString * _Nullable)timestampForAsset:(PHAsset * _Nonnull)asset;
++ (NSString * _Nullable)filenameForAsset:(PHAsset * _Nonnull)asset;
++ (NSString * _Nullable)mimeTypeForFilename:(NSString * _Nullable)filename;
 - (void)stop;
 @end
 
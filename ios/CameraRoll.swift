@@ -160,43 +160,37 @@ import Photos
   @objc(size) let size: CGSize
   @objc(contentMode) let contentMode: PHImageContentMode
 
-  private func response(data: [PHAsset], error: Error? = nil, offset: Int) -> Dictionary<String, Any> {
-    let length = data.count
-    let dateFormatter = self.dateFormatter
-    let remaining = count - offset + length
+  @objc(timestampForAsset:) func timestamp(asset: PHAsset) -> String? {
+    guard let timestamp = asset.modificationDate ?? asset.creationDate else {
+      return nil
+    }
 
-    var values: [Dictionary<String, Any>] = []
-    for asset in data {
-      var timestamp: Date? = nil
+    return dateFormatter.string(from: timestamp)
+  }
 
-      if asset.modificationDate != nil {
-        timestamp = asset.modificationDate
-      }
+  @objc(filenameForAsset:) static func filename(asset: PHAsset) -> String? {
+    return asset.value(forKey: "filename") as? String
+  }
 
-      if timestamp == nil {
-        timestamp = asset.creationDate
-      }
+  @objc(mimeTypeForFilename:) static func mimeType(filename: String?) -> String? {
+    guard let _filename = filename else {
+      return nil
+    }
 
-      var mimeType: MimeType? = nil
+    guard let pathExtension = URL(string: "file://blah/\(_filename)")?.pathExtension else {
+      return nil
+    }
 
-      let filename = asset.value(forKey: "filename") as? String
+    return MimeType.fileExtension(pathExtension)?.rawValue
+  }
 
-      if let _filename = asset.value(forKey: "filename")  {
-        if let pathExtension = URL(string: "file://blah/\(_filename)")?.pathExtension {
-          mimeType = MimeType.fileExtension(pathExtension)
-        }
-      }
+  // Everything in a page except the assets themselves, so MediaPlayerJSIModule can hand the assets to JS as columns.
+  @objc(responseWithLength:offset:) func response(length: Int, offset: Int) -> Dictionary<String, Any> {
+    return response(length: length, error: nil, offset: offset)
+  }
 
-      values.append([
-        "uri": "ph://\(asset.localIdentifier)",
-        "width": asset.pixelWidth,
-        "height": asset.pixelHeight,
-        "filename": filename,
-        "mimeType": mimeType?.rawValue,
-        "timestamp": timestamp != nil ? dateFormatter.string(from: timestamp!) : nil,
-        "duration": asset.duration
-      ])
-    }
+  private func response(length: Int, error: Error? = nil, offset: Int) -> Dictionary<String, Any> {
+    let remaining = count - offset + length
 
     return [
       "sessionId": cacheKey,
@@ -208,25 +202,49 @@ import Photos
         "remaining": remaining,
         "has_next_page": remaining > 0,
       ],
-      "data": values,
       "error": error?.localizedDescription
     ]
   }
 
+  private func response(data: [PHAsset], error: Error? = nil, offset: Int) -> Dictionary<String, Any> {
+    var values: [Dictionary<String, Any>] = []
+    for asset in data {
+      let filename = CameraRoll.filename(asset: asset)
+
+      values.append([
+        "uri": "ph://\(asset.localIdentifier)",
+        "width": asset.pixelWidth,
+        "height": asset.pixelHeight,
+        "filename": filename,
+        "mimeType": CameraRoll.mimeType(filename: filename),
+        "timestamp": timestamp(asset: asset),
+        "duration": asset.duration
+      ])
+    }
+
+    var result = response(length: data.count, error: error, offset: offset)
+    result["data"] = values
+    return result
+  }
+
   @objc(cache) let cache: Bool
 
   @objc(from:to:) func page(offset: NSInteger, length: NSInteger) -> Dictionary<String, Any> {
+    return response(data: assets(offset: offset, length: length), error: nil, offset: offset)
+  }
+
+  @objc(assetsFrom:to:) func assets(offset: NSInteger, length: NSInteger) -> [PHAsset] {
     if assetCollection != nil {
-      return page(offset: offset, length: length, reversed: false)
+      return assets(offset: offset, length: length, reversed: false)
     } else {
-      return page(offset: offset, length: length, reversed: true)
+      return assets(offset: offset, length: length, reversed: true)
     }
   }
 
-  func page(offset: NSInteger, length: NSInteger, reversed: Bool) -> Dictionary<String, Any> {
+  func assets(offset: NSInteger, length: NSInteger, reversed: Bool) -> [PHAsset] {
     var results: [PHAsset] = []
     guard let result = self.result else {
-      return response(data: [], error: nil, offset: offset)
+      return []
     }
 
     let fetchResultCache = YeetImageView.fetchRequestCache
@@ -237,11 +255,11 @@ import Photos
       let endOffset = max(min(_offset + length, count - 1), 1)
 
       guard endOffset > _offset else {
-       return response(data: [], error: nil, offset: offset)
+       return []
       }
 
       guard endOffset < count else {
-       return response(data: [], error: nil, offset: offset)
+       return []
       }
 
       result.enumerateObjects(at: IndexSet(integersIn: _offset...endOffset), options: .reverse) { asset, index, stopper in
@@ -255,11 +273,11 @@ import Photos
     } else {
       let endOffset = max(min(offset + length, count - 1), min(1, count))
       guard endOffset > offset else {
-       return response(data: [], error: nil, offset: offset)
+       return []
       }
 
       guard endOffset < count else {
-       return response(data: [], error: nil, offset: offset)
+       return []
       }
 
       result.enumerateObjects(at: IndexSet(integersIn: offset...endOffset), options: .init(rawValue: 0)) { asset, index, stopper in
@@ -276,7 +294,7 @@ import Photos
      YeetImageView.phImageManager.startCachingImages(for: results, targetSize: size, contentMode: contentMode, options: nil)
     }
 
-    return response(data: results, error: nil, offset: offset)
+    return results
   }
 
   @objc(stop) func stop() {
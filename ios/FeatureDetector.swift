@@ -17,8 +17,10 @@ class FeatureDetector {
 //  let textDetector = CIDetector(ofType: CIDetectorTypeText, context: nil, options: nil)!
 //  let rectangleDetector = CIDetector(ofType: CIDetectorTypeRectangle, context: nil, options: nil)!
 
-  func detectText() -> Array<CGRect> {
-     return []
+  func detectText(image: UIImage) -> Array<CGRect> {
+    return FindContours.findTextLines(in: image).map { line in
+      return (line["rect"] as! NSValue).cgRectValue
+    }
   }
 
 //  let image = UIImage(named: "xfqbg89beo441.png")
@@ -26,8 +28,14 @@ class FeatureDetector {
 //  let image = UIImage(named: "vrynlmwfrn441.jpg")
 //  let image = UIImage(named: "lq3lc5cquo441.jpg")
 
-  func detectRectangles(image: UIImage) -> Array<CGRect> {
-    return FindContours.findContours(in: image) as! Array<CGRect>
+  func detectRectangles(image: UIImage, pyramidScale: CGFloat = 1.0) -> Array<CGRect> {
+    return FindContours.findContours(in: image, pyramidScale: pyramidScale) as! Array<CGRect>
+  }
+
+  func detectRankedRectangles(image: UIImage, pyramidScale: CGFloat = 1.0) -> Array<(rect: CGRect, confidence: Double)> {
+    return FindContours.findRectangles(in: image, pyramidScale: pyramidScale).map { rectangle in
+      return (rect: (rectangle["rect"] as! NSValue).cgRectValue, confidence: (rectangle["confidence"] as! NSNumber).doubleValue)
+    }
   }
   
 }
@@ -8,11 +8,26 @@
 
 #import <Foundation/Foundation.h>
 #import <UIKit/UIKit.h>
+#import <CoreVideo/CoreVideo.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
+// Follows rectangles across consecutive video frames: full detection on keyframes, optical flow
+// in between. Each result is @{@"id", @"rect", @"corners", @"confidence", @"detected"}.
+// Not thread-safe; feed it frames in order from one serial queue.
+@interface RectangleTracker : NSObject
+- (NSArray<NSDictionary*>*)trackPixelBuffer:(CVPixelBufferRef)pixelBuffer;
+- (void)reset;
+@end
+
 @interface FindContours : NSObject
 + (NSArray*)findContoursInImage:(UIImage*)image;
+// pyramidScale < 1 finds candidates on a downscaled copy and only refines those regions at full size.
++ (NSArray*)findContoursInImage:(UIImage*)image pyramidScale:(CGFloat)pyramidScale;
+// Deduplicated rectangles, most confident first: @{@"rect": NSValue(CGRect), @"confidence": 0...1, @"support": count}
++ (NSArray<NSDictionary*>*)findRectanglesInImage:(UIImage*)image pyramidScale:(CGFloat)pyramidScale;
+// Lines of text, top to bottom: @{@"rect": NSValue(CGRect), @"characters": count}
++ (NSArray<NSDictionary*>*)findTextLinesInImage:(UIImage*)image;
 @end
 
 NS_ASSUME_NONNULL_END
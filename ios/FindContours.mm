@@ -14,6 +14,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #import <opencv2/imgcodecs/ios.h>
+#include "YeetSquareDetector.h"
+#include "YeetQuadGeometry.h"
+#include "YeetQuadSuppression.h"
+#include "YeetRectangleTracker.h"
+#include "YeetPixelBuffer.h"
+#include "YeetTextDetector.h"
 
 using namespace cv;
 using namespace std;
@@ -32,217 +38,82 @@ using namespace std;
 
 + (NSArray*)findContoursInImage:(UIImage*)image
 {
-  cv::Mat original = [UIImage toCvMat:image];
-    CGRect _cropRect = CGRectMake(0, 0, image.size.width, image.size.height);
-  CGSize targetSize = image.size;
-
-
-
-    std::vector<std::vector<cv::Point>>squares;
-    std::vector<cv::Point> largest_square;
-
-    find_squares(original, squares);
-    find_largest_square(squares, largest_square);
-
-
-
-     original.release();
-
-
+  return [self findContoursInImage:image pyramidScale:1.0];
+}
 
-  NSMutableArray *rects = [[NSMutableArray alloc] init];
-  for (int i = 0; i < squares.size(); i++) {
-    [rects addObject:[NSValue valueWithCGRect:[self rectFromSquare:squares[i]]]];
++ (NSArray*)findContoursInImage:(UIImage*)image pyramidScale:(CGFloat)pyramidScale
+{
+  NSArray<NSDictionary*> *rectangles = [self findRectanglesInImage:image pyramidScale:pyramidScale];
+  NSMutableArray *rects = [[NSMutableArray alloc] initWithCapacity:rectangles.count];
+  for (NSDictionary *rectangle in rectangles) {
+    [rects addObject:rectangle[@"rect"]];
   }
 
   return rects;
 }
 
-+ (CGRect)rectFromSquare:(std::vector<cv::Point>)largest_square {
-  CGPoint origin = CGPointZero;
-   CGSize size = CGSizeZero;
-
-     if (largest_square.size() == 4)
-      {
-
-          // Manually sorting points, needs major improvement. Sorry.
-
-          NSMutableArray *points = [NSMutableArray array];
-          NSMutableDictionary *sortedPoints = [NSMutableDictionary dictionary];
-
-          for (int i = 0; i < 4; i++)
-          {
-              NSDictionary *dict = [NSDictionary dictionaryWithObjectsAndKeys:[NSValue valueWithCGPoint:CGPointMake(largest_square[i].x, largest_square[i].y)], @"point" , [NSNumber numberWithInt:(largest_square[i].x + largest_square[i].y)], @"value", nil];
-              [points addObject:dict];
-          }
-
-          int min = [[points valueForKeyPath:@"@min.value"] intValue];
-          int max = [[points valueForKeyPath:@"@max.value"] intValue];
-
-          int minIndex;
-          int maxIndex;
-
-          int missingIndexOne;
-          int missingIndexTwo;
-
-          for (int i = 0; i < 4; i++)
-          {
-              NSDictionary *dict = [points objectAtIndex:i];
-
-              if ([[dict objectForKey:@"value"] intValue] == min)
-              {
-                  [sortedPoints setObject:[dict objectForKey:@"point"] forKey:@"0"];
-                  minIndex = i;
-                  continue;
-              }
-
-              if ([[dict objectForKey:@"value"] intValue] == max)
-              {
-                  [sortedPoints setObject:[dict objectForKey:@"point"] forKey:@"2"];
-                  maxIndex = i;
-                  continue;
-              }
-
-              NSLog(@"MSSSING %i", i);
-
-              missingIndexOne = i;
-          }
-
-          for (int i = 0; i < 4; i++)
-          {
-              if (missingIndexOne != i && minIndex != i && maxIndex != i)
-              {
-                  missingIndexTwo = i;
-              }
-          }
-
-
-          if (largest_square[missingIndexOne].x < largest_square[missingIndexTwo].x)
-          {
-              //2nd Point Found
-              [sortedPoints setObject:[[points objectAtIndex:missingIndexOne] objectForKey:@"point"] forKey:@"3"];
-              [sortedPoints setObject:[[points objectAtIndex:missingIndexTwo] objectForKey:@"point"] forKey:@"1"];
-          }
-          else
-          {
-              //4rd Point Found
-              [sortedPoints setObject:[[points objectAtIndex:missingIndexOne] objectForKey:@"point"] forKey:@"1"];
-              [sortedPoints setObject:[[points objectAtIndex:missingIndexTwo] objectForKey:@"point"] forKey:@"3"];
-          }
-
-
-          origin = [[sortedPoints objectForKey:@"0"] CGPointValue];
-
-        CGPoint topRight = [[sortedPoints objectForKey:@"1"] CGPointValue];
-        CGPoint bottomRight = [[sortedPoints objectForKey:@"2"] CGPointValue];
-        CGPoint bottomLeft = [[sortedPoints objectForKey:@"3"] CGPointValue];
-        size.width = bottomRight.x - bottomLeft.x;
-        size.height = bottomRight.y - topRight.y;
-      }
-
-  return CGRectMake(origin.x, origin.y, size.width, size.height);
-}
-
-// http://stackoverflow.com/questions/8667818/opencv-c-obj-c-detecting-a-sheet-of-paper-square-detection
-void find_squares(cv::Mat& image, vector<vector<cv::Point>>&squares) {
-
-    // blur will enhance edge detection
-    cv::Mat blurred(image);
-    medianBlur(image, blurred, 5);
-
-    cv::Mat gray0(blurred.size(), CV_8U), gray;
-    vector<vector<cv::Point> > contours;
-
-    // find squares in every color plane of the image
-    for (int c = 0; c < 3; c++)
-    {
-        int ch[] = {c, 0};
-        mixChannels(&blurred, 1, &gray0, 1, ch, 1);
-
-        // try several threshold levels
-        const int threshold_level = 10;
-        for (int l = 0; l < threshold_level; l++)
-        {
-
-                gray = gray0 >= (l+1) * 255 / threshold_level;
-
-
-            // Find contours and store them in a list
-          findContours(gray, contours, RETR_LIST, CHAIN_APPROX_SIMPLE);
-
-            // Test contours
-            vector<cv::Point> approx;
-            for (size_t i = 0; i < contours.size(); i++)
-            {
-                // approximate contour with accuracy proportional
-                // to the contour perimeter
-                approxPolyDP(cv::Mat(contours[i]), approx, arcLength(cv::Mat(contours[i]), true)*0.02, true);
-
-                // Note: absolute value of an area is used because
-                // area may be positive or negative - in accordance with the
-                // contour orientation
-                if (approx.size() == 4 &&
-                    fabs(contourArea(cv::Mat(approx))) > 1000 &&
-                    isContourConvex(cv::Mat(approx)))
-                {
-
-                    double maxCosine = 0;
-
-                    for (int j = 2; j < 5; j++)
-                    {
-                        double cosine = fabs(angle(approx[j%4], approx[j-2], approx[j-1]));
-                        maxCosine = MAX(maxCosine, cosine);
-                    }
-
-                  if (maxCosine < 0.3) {
-                    squares.push_back(approx);
-                  }
-
-                }
-            }
-        }
-    }
-}
-
-
-void find_largest_square(const vector<vector<cv::Point> >& squares, vector<cv::Point>& biggest_square)
++ (NSArray<NSDictionary*>*)findRectanglesInImage:(UIImage*)image pyramidScale:(CGFloat)pyramidScale
 {
-    if (!squares.size())
-    {
-        // no squares detected
-        return;
-    }
-
-    int max_width = 0;
-    int max_height = 0;
-    int max_square_idx = 0;
-
-    for (size_t i = 0; i < squares.size(); i++)
-    {
-        // Convert a set of 4 unordered Points into a meaningful cv::Rect structure.
-        cv::Rect rectangle = boundingRect(cv::Mat(squares[i]));
-
-        //        cout << "find_largest_square: #" << i << " rectangle x:" << rectangle.x << " y:" << rectangle.y << " " << rectangle.width << "x" << rectangle.height << endl;
-
-        // Store the index position of the biggest square found
-        if ((rectangle.width >= max_width) && (rectangle.height >= max_height))
-        {
-            max_width = rectangle.width;
-            max_height = rectangle.height;
-            max_square_idx = i;
-        }
-    }
+  // Skip redrawing the image when its pixels can be copied out as they are.
+  YeetPixelBuffer pixels;
+  cv::Mat swizzled;
+  cv::Mat original = [UIImage copyPixelBuffer:pixels fromImage:image]
+    ? yeetPixelBufferRGBA(pixels, swizzled)
+    : [UIImage toCvMat:image];
+
+  std::vector<std::vector<cv::Point>> squares;
+  YeetSquareDetectorOptions options;
+  options.pyramidScale = pyramidScale;
+  YeetSquareDetector detector(options);
+  detector.detect(original, squares);
+
+  // Every pass that sees the same rectangle reports it again, so collapse those before paying
+  // for cornerSubPix.
+  std::vector<YeetQuad> quads;
+  yeetQuadsFromSquares(squares, cv::Mat(), quads);
+  std::vector<YeetRankedQuad> ranked;
+  yeetSuppressQuads(quads, ranked);
+
+  // Corners are refined against the same pixels they were detected in.
+  cv::Mat gray;
+  cv::cvtColor(original, gray, cv::COLOR_RGBA2GRAY);
+  original.release();
+  yeetRefineRankedQuads(gray, ranked);
+
+  NSMutableArray *rects = [[NSMutableArray alloc] initWithCapacity:ranked.size()];
+  for (const auto &result : ranked) {
+    const cv::Rect2f &bounds = result.quad.bounds;
+    [rects addObject:@{
+      @"rect": [NSValue valueWithCGRect:CGRectMake(bounds.x, bounds.y, bounds.width, bounds.height)],
+      @"confidence": @(result.confidence),
+      @"support": @(result.support),
+    }];
+  }
 
-    biggest_square = squares[max_square_idx];
+  return rects;
 }
 
++ (NSArray<NSDictionary*>*)findTextLinesInImage:(UIImage*)image
+{
+  YeetPixelBuffer pixels;
+  cv::Mat swizzled;
+  cv::Mat original = [UIImage copyPixelBuffer:pixels fromImage:image]
+    ? yeetPixelBufferRGBA(pixels, swizzled)
+    : [UIImage toCvMat:image];
+
+  std::vector<YeetTextLine> lines;
+  YeetTextDetector detector;
+  detector.detect(original, lines);
+
+  NSMutableArray *results = [[NSMutableArray alloc] initWithCapacity:lines.size()];
+  for (const auto &line : lines) {
+    [results addObject:@{
+      @"rect": [NSValue valueWithCGRect:CGRectMake(line.bounds.x, line.bounds.y, line.bounds.width, line.bounds.height)],
+      @"characters": @(line.characterCount),
+    }];
+  }
 
-double angle( cv::Point pt1, cv::Point pt2, cv::Point pt0 ) {
-    double dx1 = pt1.x - pt0.x;
-    double dy1 = pt1.y - pt0.y;
-    double dx2 = pt2.x - pt0.x;
-    double dy2 = pt2.y - pt0.y;
-    return (dx1*dx2 + dy1*dy2)/sqrt((dx1*dx1 + dy1*dy1)*(dx2*dx2 + dy2*dy2) + 1e-10);
+  return results;
 }
 
 cv::Mat debugSquares( std::vector<std::vector<cv::Point> > squares, cv::Mat image ){
@@ -274,3 +145,56 @@ cv::Mat debugSquares( std::vector<std::vector<cv::Point> > squares, cv::Mat imag
 
 @end
 
+static NSDictionary *pointDictionary(const cv::Point2f &point) {
+  return @{@"x": @(point.x), @"y": @(point.y)};
+}
+
+@implementation RectangleTracker {
+  YeetRectangleTracker _tracker;
+  cv::Mat _swizzled;
+}
+
+- (NSArray<NSDictionary*>*)trackPixelBuffer:(CVPixelBufferRef)pixelBuffer
+{
+  OSType pixelFormat = CVPixelBufferGetPixelFormatType(pixelBuffer);
+  if (pixelFormat != kCVPixelFormatType_32BGRA && pixelFormat != kCVPixelFormatType_32RGBA) {
+    return @[];
+  }
+
+  CVPixelBufferLockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+
+  // Only valid while the base address is locked, so nothing needs to own it.
+  YeetPixelBuffer pixels = YeetPixelBuffer::borrow(
+    (uint8_t *)CVPixelBufferGetBaseAddress(pixelBuffer),
+    (int)CVPixelBufferGetWidth(pixelBuffer),
+    (int)CVPixelBufferGetHeight(pixelBuffer),
+    CVPixelBufferGetBytesPerRow(pixelBuffer),
+    pixelFormat == kCVPixelFormatType_32BGRA ? YeetPixelFormat::BGRA : YeetPixelFormat::RGBA,
+    nullptr
+  );
+
+  const std::vector<YeetTrackedQuad> &tracks = _tracker.process(yeetPixelBufferRGBA(pixels, _swizzled));
+
+  CVPixelBufferUnlockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+
+  NSMutableArray *results = [[NSMutableArray alloc] initWithCapacity:tracks.size()];
+  for (const auto &track : tracks) {
+    const YeetQuad &quad = track.quad;
+    [results addObject:@{
+      @"id": @(track.id),
+      @"rect": [NSValue valueWithCGRect:CGRectMake(quad.bounds.x, quad.bounds.y, quad.bounds.width, quad.bounds.height)],
+      @"corners": @[pointDictionary(quad.topLeft), pointDictionary(quad.topRight), pointDictionary(quad.bottomRight), pointDictionary(quad.bottomLeft)],
+      @"confidence": @(track.confidence),
+      @"detected": @(track.detected),
+    }];
+  }
+
+  return results;
+}
+
+- (void)reset
+{
+  _tracker.reset();
+}
+
+@end
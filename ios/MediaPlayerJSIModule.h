@@ -8,14 +8,17 @@
 
 #import <jsi/jsi.h>
 #include <ReactCommon/BridgeJSCallInvoker.h>
+#import "YeetJSIStruct.h"
+#import "YeetJSIMethodTable.h"
+#import "YeetJSIModuleRegistry.h"
 
 using namespace facebook;
 
 @class MediaPlayerViewManager;
 
-class JSI_EXPORT MediaPlayerJSIModule : public jsi::HostObject {
+class JSI_EXPORT MediaPlayerJSIModule : public YeetJSIHostObject {
 public:
-    MediaPlayerJSIModule(MediaPlayerViewManager* mediaPlayer);
+    MediaPlayerJSIModule(MediaPlayerViewManager* mediaPlayer, std::shared_ptr<facebook::react::JSCallInvoker> jsInvoker, std::shared_ptr<YeetJSIPropNameCache> propNames);
 
     static void install(MediaPlayerViewManager *mediaPlayerManager);
 
@@ -23,12 +26,19 @@ public:
      * `jsi::HostObject` specific overloads.
      */
     jsi::Value get(jsi::Runtime &runtime, const jsi::PropNameID &name) override;
+    std::vector<jsi::PropNameID> getPropertyNames(jsi::Runtime &runtime) override;
 
     jsi::Value getOther(jsi::Runtime &runtime, const jsi::PropNameID &name);
 
+    void invalidate() override;
+
 private:
+    jsi::Value createMethod(jsi::Runtime &runtime, const jsi::PropNameID &name, const std::string &methodName);
+
     MediaPlayerViewManager* mediaPlayer_;
     std::shared_ptr<facebook::react::JSCallInvoker> _jsInvoker;
+    YeetJSIMethodTable methods_;
+    std::shared_ptr<YeetJSIPropNameCache> propNames_;
 };
 
 
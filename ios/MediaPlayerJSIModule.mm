@@ -18,6 +18,293 @@
 #import <React/RCTScrollView.h>
 #import "RCTConvert+PHotos.h"
 #import <MMKV/MMKV.h>
+#import "YeetJSIStruct.h"
+#import "YeetPhotoPage.h"
+#import "YeetNativePromise.h"
+#include "YeetTaskScheduler.h"
+#include "YeetPerceptualHash.h"
+#include "YeetHashIndex.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#import "YeetWebPExporter.h"
+#import "UIImage+OpenCVConversion.h"
+
+struct MediaBounds {
+  double x = 0;
+  double y = 0;
+  double width = 0;
+  double height = 0;
+};
+
+template <>
+struct YeetJSIStructFields<MediaBounds> {
+  static auto fields() {
+    return std::make_tuple(
+      jsiField("x", &MediaBounds::x),
+      jsiField("y", &MediaBounds::y),
+      jsiField("width", &MediaBounds::width),
+      jsiField("height", &MediaBounds::height)
+    );
+  }
+};
+
+struct MediaSize {
+  double width = 0;
+  double height = 0;
+};
+
+template <>
+struct YeetJSIStructFields<MediaSize> {
+  static auto fields() {
+    return std::make_tuple(
+      jsiField("width", &MediaSize::width),
+      jsiField("height", &MediaSize::height)
+    );
+  }
+};
+
+// getSize resolves with {} when the tag isn't a MediaPlayer, same as -[MediaPlayerViewManager mediaSize:].
+struct MediaSizeResult {
+  bool found = false;
+  MediaSize size;
+};
+
+static jsi::Value convertMediaSizeResult(jsi::Runtime &runtime, MediaSizeResult &result) {
+  jsi::Object object(runtime);
+  if (result.found) {
+    object.setProperty(runtime, "width", result.size.width);
+    object.setProperty(runtime, "height", result.size.height);
+  }
+  return object;
+}
+
+struct ImageHashResult {
+  uint64_t hash = 0;
+  uint64_t differenceHash = 0;
+};
+
+static jsi::Value convertImageHashResult(jsi::Runtime &runtime, ImageHashResult &result) {
+  jsi::Object object(runtime);
+  object.setProperty(runtime, "hash", jsi::String::createFromUtf8(runtime, yeetHashToHex(result.hash)));
+  object.setProperty(runtime, "dHash", jsi::String::createFromUtf8(runtime, yeetHashToHex(result.differenceHash)));
+  return object;
+}
+
+static NSURL *fileURLFromPath(NSString *path) {
+  return [path hasPrefix:@"file://"] ? [NSURL URLWithString:path] : [NSURL fileURLWithPath:path];
+}
+
+// Every hashed image, by path, persisted in Application Support so duplicates are found across launches.
+static YeetHashIndex &mediaHashIndex() {
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    NSString *directory = NSSearchPathForDirectoriesInDomains(NSApplicationSupportDirectory, NSUserDomainMask, YES).firstObject;
+    [[NSFileManager defaultManager] createDirectoryAtPath:directory withIntermediateDirectories:YES attributes:nil error:nil];
+    YeetHashIndex::shared().open([directory stringByAppendingPathComponent:@"perceptual-hashes.idx"].UTF8String);
+  });
+
+  return YeetHashIndex::shared();
+}
+
+// Exports in flight, by destination path. cancelEncodeWebP sets the flag, and the encoder stops
+// the next time it reports progress.
+static std::mutex webPExportsMutex;
+static std::unordered_map<std::string, std::shared_ptr<std::atomic<bool>>> webPExports;
+
+static std::shared_ptr<std::atomic<bool>> beginWebPExport(const std::string &destination) {
+  auto cancelled = std::make_shared<std::atomic<bool>>(false);
+  std::lock_guard<std::mutex> lock(webPExportsMutex);
+  webPExports[destination] = cancelled;
+  return cancelled;
+}
+
+static void endWebPExport(const std::string &destination, const std::shared_ptr<std::atomic<bool>> &cancelled) {
+  std::lock_guard<std::mutex> lock(webPExportsMutex);
+  auto entry = webPExports.find(destination);
+  // A newer export to the same path replaces this one's entry; leave it alone.
+  if (entry != webPExports.end() && entry->second == cancelled) {
+    webPExports.erase(entry);
+  }
+}
+
+static bool cancelWebPExport(const std::string &destination) {
+  std::lock_guard<std::mutex> lock(webPExportsMutex);
+  auto entry = webPExports.find(destination);
+  if (entry == webPExports.end()) {
+    return false;
+  }
+  entry->second->store(true);
+  return true;
+}
+
+template <>
+struct YeetJSIEnum<YeetWebPPreset> {
+  static bool fromString(const std::string &value, YeetWebPPreset &out) {
+    if (value == "default") {
+      out = YeetWebPPreset::automatic;
+    } else if (value == "picture") {
+      out = YeetWebPPreset::picture;
+    } else if (value == "photo") {
+      out = YeetWebPPreset::photo;
+    } else if (value == "drawing") {
+      out = YeetWebPPreset::drawing;
+    } else if (value == "icon") {
+      out = YeetWebPPreset::icon;
+    } else if (value == "text") {
+      out = YeetWebPPreset::text;
+    } else {
+      return false;
+    }
+
+    return true;
+  }
+};
+
+// Defaults match YeetWebPEncodeOptions.
+struct WebPExportParams {
+  double quality = 80;
+  bool lossless = false;
+  long method = 4;
+  YeetWebPPreset preset = YeetWebPPreset::automatic;
+  bool multithreaded = true;
+  long loopCount = 0;
+  bool minimizeSize = false;
+  long kmin = 0;
+  long kmax = 0;
+  bool allowMixed = false;
+  bool frameDiff = false;
+  double maxSize = 0;
+  double fps = 15;
+
+  YeetWebPEncodeOptions encodeOptions() const {
+    YeetWebPEncodeOptions options;
+    options.quality = quality;
+    options.lossless = lossless;
+    options.method = (int)method;
+    options.preset = preset;
+    options.multithreaded = multithreaded;
+    options.loopCount = (int)loopCount;
+    options.minimizeSize = minimizeSize;
+    options.minKeyframeInterval = (int)kmin;
+    options.maxKeyframeInterval = (int)kmax;
+    options.allowMixed = allowMixed;
+    options.frameDiff = frameDiff;
+    return options;
+  }
+};
+
+template <>
+struct YeetJSIStructFields<WebPExportParams> {
+  static auto fields() {
+    return std::make_tuple(
+      jsiField("quality", &WebPExportParams::quality),
+      jsiField("lossless", &WebPExportParams::lossless),
+      jsiField("method", &WebPExportParams::method),
+      jsiField("preset", &WebPExportParams::preset),
+      jsiField("multithreaded", &WebPExportParams::multithreaded),
+      jsiField("loopCount", &WebPExportParams::loopCount),
+      jsiField("minimizeSize", &WebPExportParams::minimizeSize),
+      jsiField("kmin", &WebPExportParams::kmin),
+      jsiField("kmax", &WebPExportParams::kmax),
+      jsiField("allowMixed", &WebPExportParams::allowMixed),
+      jsiField("frameDiff", &WebPExportParams::frameDiff),
+      jsiField("maxSize", &WebPExportParams::maxSize),
+      jsiField("fps", &WebPExportParams::fps)
+    );
+  }
+};
+
+struct WebPExportResult {
+  std::string path;
+  YeetWebPExportResult file;
+};
+
+static jsi::Value convertWebPExportResult(jsi::Runtime &runtime, WebPExportResult &result) {
+  jsi::Object object(runtime);
+  object.setProperty(runtime, "path", jsi::String::createFromUtf8(runtime, result.path));
+  object.setProperty(runtime, "width", result.file.width);
+  object.setProperty(runtime, "height", result.file.height);
+  object.setProperty(runtime, "frameCount", (double)result.file.frameCount);
+  object.setProperty(runtime, "size", (double)result.file.byteCount);
+  return object;
+}
+
+template <>
+struct YeetJSIEnum<UIViewContentMode> {
+  static bool fromString(const std::string &value, UIViewContentMode &out) {
+    if (value == "aspectFill") {
+      out = UIViewContentModeScaleAspectFill;
+      return true;
+    } else if (value == "aspectFit") {
+      out = UIViewContentModeScaleAspectFit;
+      return true;
+    }
+
+    return false;
+  }
+};
+
+template <>
+struct YeetJSIEnum<PHImageContentMode> {
+  static bool fromString(const std::string &value, PHImageContentMode &out) {
+    if (value == "aspectFill") {
+      out = PHImageContentModeAspectFill;
+      return true;
+    } else if (value == "aspectFit") {
+      out = PHImageContentModeAspectFit;
+      return true;
+    }
+
+    return false;
+  }
+};
+
+struct PhotosParams {
+  YeetJSINullable<std::string> albumId;
+  YeetJSINullable<std::string> mediaType;
+  MediaSize size;
+  PHImageContentMode contentMode = PHImageContentModeAspectFill;
+  bool cache = false;
+  long offset = 0;
+  long length = 0;
+};
+
+template <>
+struct YeetJSIStructFields<PhotosParams> {
+  static auto fields() {
+    return std::make_tuple(
+      jsiField("albumId", &PhotosParams::albumId),
+      jsiField("mediaType", &PhotosParams::mediaType),
+      jsiField("size", &PhotosParams::size),
+      jsiField("contentMode", &PhotosParams::contentMode),
+      jsiField("cache", &PhotosParams::cache),
+      jsiField("offset", &PhotosParams::offset),
+      jsiField("length", &PhotosParams::length)
+    );
+  }
+};
+
+static YeetPhotoMediaType photoMediaType(PHAssetMediaType mediaType) {
+  switch (mediaType) {
+    case PHAssetMediaTypeImage:
+      return YeetPhotoMediaType::image;
+    case PHAssetMediaTypeVideo:
+      return YeetPhotoMediaType::video;
+    case PHAssetMediaTypeAudio:
+      return YeetPhotoMediaType::audio;
+    default:
+      return YeetPhotoMediaType::unknown;
+  }
+}
+
+static NSString *nullableStringToNSString(const YeetJSINullable<std::string> &value) {
+  if (value.isNull) {
+    return nil;
+  }
+
+  return [[NSString alloc] initWithBytes:value.value.data() length:value.value.size() encoding:NSUTF8StringEncoding];
+}
 
 
 
@@ -63,37 +350,73 @@
 - (std::weak_ptr<facebook::react::Instance>)reactInstance;
 @end
 
-MediaPlayerJSIModule::MediaPlayerJSIModule(MediaPlayerViewManager* mediaPlayer)
-: mediaPlayer_(mediaPlayer) {
-  std::shared_ptr<facebook::react::JSCallInvoker> _jsInvoker = std::make_shared<react::BridgeJSCallInvoker>(mediaPlayer.bridge.reactInstance);
+static const char *const MediaPlayerJSIModulePropertyNames[] = {
+  "isCached",
+  "startCaching",
+  "stopCaching",
+  "batchPlay",
+  "batchPause",
+  "play",
+  "pause",
+  "getSize",
+  "getPhotos",
+  "getAlbums",
+  "stopAlbumSession",
+  "getStatus",
+  "hashImage",
+  "findSimilar",
+  "encodeWebP",
+  "cancelEncodeWebP",
+};
+
+MediaPlayerJSIModule::MediaPlayerJSIModule(MediaPlayerViewManager* mediaPlayer, std::shared_ptr<facebook::react::JSCallInvoker> jsInvoker, std::shared_ptr<YeetJSIPropNameCache> propNames)
+: mediaPlayer_(mediaPlayer), _jsInvoker(jsInvoker), methods_(MediaPlayerJSIModulePropertyNames), propNames_(propNames) {
 }
 
 
 void MediaPlayerJSIModule::install(MediaPlayerViewManager *mediaPlayerManager) {
-  MediaPlayerViewManager *_mediaPlayerManager = mediaPlayerManager;
-  RCTCxxBridge *cxxBridge = (RCTCxxBridge *)mediaPlayerManager.bridge;
-
-  if (cxxBridge.runtime == nullptr) {
+  auto registry = YeetJSIModuleRegistry::forBridge(mediaPlayerManager.bridge);
+  if (registry == nullptr) {
     return;
   }
 
- jsi::Runtime &runtime = *(jsi::Runtime *)cxxBridge.runtime;
+  registry->install("MediaPlayerViewManager", std::make_shared<MediaPlayerJSIModule>(mediaPlayerManager, registry->jsInvoker(), registry->propNames()));
+}
 
- auto reaModuleName = "MediaPlayerViewManager";
- auto reaJsiModule = std::make_shared<MediaPlayerJSIModule>(std::move(_mediaPlayerManager));
- auto object = jsi::Object::createFromHostObject(runtime, reaJsiModule);
- runtime.global().setProperty(runtime, reaModuleName, std::move(object));
+void MediaPlayerJSIModule::invalidate() {
+  methods_.clear();
+  mediaPlayer_ = nil;
+  _jsInvoker = nullptr;
+  propNames_ = nullptr;
 }
 
 
 jsi::Value MediaPlayerJSIModule::get(jsi::Runtime &runtime, const jsi::PropNameID &name) {
-  auto methodName = name.utf8(runtime);
-  if (_jsInvoker == nullptr) {
-      RCTCxxBridge* bridge = mediaPlayer_.bridge;
-    _jsInvoker = std::make_shared<react::BridgeJSCallInvoker>(bridge.reactInstance);
+  if (_jsInvoker == nullptr || propNames_ == nullptr) {
+    return jsi::Value::undefined();
+  }
+
+  int index = methods_.indexOf(runtime, *propNames_, name);
+  if (index < 0) {
+    return jsi::Value::undefined();
+  }
+
+  // The HostObject is installed once per runtime, so the functions are cached for its lifetime.
+  return methods_.get(runtime, index, [&]() {
+    return createMethod(runtime, name, methods_.name(index));
+  });
+}
+
+std::vector<jsi::PropNameID> MediaPlayerJSIModule::getPropertyNames(jsi::Runtime &runtime) {
+  if (propNames_ == nullptr) {
+    return {};
   }
 
- std::shared_ptr<facebook::react::JSCallInvoker> jsInvoker = _jsInvoker;
+  return methods_.propertyNames(runtime, *propNames_);
+}
+
+jsi::Value MediaPlayerJSIModule::createMethod(jsi::Runtime &runtime, const jsi::PropNameID &name, const std::string &methodName) {
+  std::shared_ptr<facebook::react::JSCallInvoker> jsInvoker = _jsInvoker;
 
   
   if (methodName == "isCached") {
@@ -116,29 +439,28 @@ jsi::Value MediaPlayerJSIModule::get(jsi::Runtime &runtime, const jsi::PropNameI
    });
   } else if (methodName == "startCaching") {
     MediaPlayerViewManager* mediaPlayerViewManager = mediaPlayer_;
-     return jsi::Function::createFromHostFunction(runtime, name, 3, [mediaPlayerViewManager, jsInvoker](
+    std::shared_ptr<YeetJSIPropNameCache> propNames = propNames_;
+     return jsi::Function::createFromHostFunction(runtime, name, 3, [mediaPlayerViewManager, jsInvoker, propNames](
            jsi::Runtime &runtime,
            const jsi::Value &thisValue,
            const jsi::Value *arguments,
            size_t count) -> jsi::Value {
 
       auto sources = &arguments[0];
-      auto bounds = &arguments[1];
-      auto contentMode = &arguments[2];
 
        __block id _sources = convertJSIValueToObjCObject(runtime, sources->asObject(runtime), jsInvoker);
-       __block CGRect _bounds = [RCTConvert CGRect:convertJSIObjectToNSDictionary(runtime, bounds->asObject(runtime), jsInvoker)];
-
-       __block NSString *__contentMode = convertJSIStringToNSString(runtime, contentMode->asString(runtime));
-       UIViewContentMode _contentMode;
-       if ([__contentMode isEqualToString:@"aspectFill"]) {
-         _contentMode = UIViewContentModeScaleAspectFill;
-       } else if ([__contentMode isEqualToString:@"aspectFit"]) {
-         _contentMode = UIViewContentModeScaleAspectFit;
-       }
 
-       dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-        [mediaPlayerViewManager startCachingMediaSources:_sources bounds:_bounds contentMode:_contentMode];
+       MediaBounds bounds;
+       decodeJSIStruct(runtime, *propNames, arguments[1], bounds);
+       CGRect _bounds = CGRectMake(bounds.x, bounds.y, bounds.width, bounds.height);
+
+       UIViewContentMode _contentMode = UIViewContentModeScaleAspectFill;
+       decodeJSIValue(runtime, *propNames, arguments[2], _contentMode);
+
+       YeetTaskScheduler::shared().schedule(YeetTaskPriority::prefetch, [mediaPlayerViewManager, _sources, _bounds, _contentMode]() {
+         @autoreleasepool {
+           [mediaPlayerViewManager startCachingMediaSources:_sources bounds:_bounds contentMode:_contentMode];
+         }
        });
 
 
@@ -221,57 +543,71 @@ jsi::Value MediaPlayerJSIModule::get(jsi::Runtime &runtime, const jsi::PropNameI
            size_t count) -> jsi::Value {
 
 
-       __block NSNumber *viewTag = @(arguments[0].asNumber());
-       return createPromise(runtime, jsInvoker, ^(jsi::Runtime &rt, std::shared_ptr<PromiseWrapper> wrapper) {
-           __block NSMutableArray *retained = [[NSMutableArray alloc] initWithCapacity:2];
-           RCTPromiseResolveBlock resolver = wrapper->resolveBlock();
-           RCTPromiseRejectBlock rejecter = wrapper->rejectBlock();
-           [retained addObject:resolver];
-           [retained addObject:rejecter];
-
-           RCTExecuteOnMainQueue(^{
-             __block NSDictionary *size = [mediaPlayerViewManager mediaSize:viewTag];
-
-             if (!mediaPlayerViewManager.bridge.isValid) {
-               [retained removeAllObjects];
-               retained = nil;
-               return;
-             }
-
-             [mediaPlayerViewManager.bridge dispatchBlock:^{
-               resolver(size);
-               [retained removeAllObjects];
-               retained = nil;
-             } queue:RCTJSThread];
-           });
+       NSNumber *viewTag = @(arguments[0].asNumber());
+       return createNativePromise<MediaSizeResult>(runtime, jsInvoker, convertMediaSizeResult, [mediaPlayerViewManager, viewTag](std::shared_ptr<NativePromise<MediaSizeResult>> promise) {
+         RCTExecuteOnMainQueue(^{
+           if (!mediaPlayerViewManager.bridge.isValid) {
+             promise->reject("The bridge was invalidated");
+             return;
+           }
+
+           MediaSizeResult result;
+           UIView *view = [mediaPlayerViewManager.bridge.uiManager unsafeViewForReactTag:viewTag];
+           if ([view isKindOfClass:[MediaPlayer class]]) {
+             CGSize size = ((MediaPlayer *)view).mediaSize;
+             result.found = true;
+             result.size.width = size.width;
+             result.size.height = size.height;
+           }
+
+           promise->resolve(std::move(result));
          });
-
+       });
     });
   } else if (methodName == "getPhotos") {
-     return jsi::Function::createFromHostFunction(runtime, name, 1, [jsInvoker](
+    std::shared_ptr<YeetJSIPropNameCache> propNames = propNames_;
+     return jsi::Function::createFromHostFunction(runtime, name, 1, [propNames](
            jsi::Runtime &runtime,
            const jsi::Value &thisValue,
            const jsi::Value *arguments,
            size_t count) -> jsi::Value {
 
-       NSDictionary *params = convertJSIObjectToNSDictionary(runtime, arguments[0].asObject(runtime), jsInvoker);
+       PhotosParams params;
+       decodeJSIStruct(runtime, *propNames, arguments[0], params);
 
-       PHImageContentMode contentMode = PHImageContentModeAspectFill;
-       if ([params[@"contentMode"] isEqualToString:@"aspectFit"]) {
-         contentMode = PHImageContentModeAspectFit;
-       }
+       CameraRoll *cameraRoll = [CameraRoll withAlbumID:nullableStringToNSString(params.albumId) mediaType:nullableStringToNSString(params.mediaType) size:CGSizeMake(params.size.width, params.size.height) contentMode:params.contentMode cache:params.cache];
 
-       CameraRoll *cameraRoll = [CameraRoll withAlbumID:[params objectForKey:@"albumId"] mediaType: params[@"mediaType"] size:[RCTConvert CGSize:params[@"size"]] contentMode:contentMode cache:[RCTConvert BOOL:params[@"cache"]]];
+       NSArray<PHAsset *> *assets = [cameraRoll assetsFrom:params.offset to:params.length];
+
+       // `data` is array-like but only builds a row object when JS reads it.
+       auto page = std::make_shared<YeetPhotoPage>();
+       page->reserve(assets.count);
+       for (PHAsset *asset in assets) {
+         page->push_back(
+           std::string(asset.localIdentifier.UTF8String ?: ""),
+           asset.pixelWidth,
+           asset.pixelHeight,
+           asset.duration,
+           photoMediaType(asset.mediaType)
+         );
+       }
 
-       NSInteger offset = [params[@"offset"] integerValue];
-       NSInteger length = [params[@"length"] integerValue];
+       // The filename goes through KVC, so only look it up for rows JS actually reads.
+       page->loadDetails = [assets, cameraRoll](size_t index) {
+         PHAsset *asset = assets[index];
+         NSString *filename = [CameraRoll filenameForAsset:asset];
 
-       NSDictionary *results = [cameraRoll from:offset to:length];
+         YeetPhotoDetails details;
+         details.filename = std::string(filename.UTF8String ?: "");
+         details.mimeType = std::string([CameraRoll mimeTypeForFilename:filename].UTF8String ?: "");
+         details.timestamp = std::string([cameraRoll timestampForAsset:asset].UTF8String ?: "");
+         return details;
+       };
 
-        params = nil;
-       cameraRoll = nil;
+       jsi::Object results = convertNSDictionaryToJSIObject(runtime, [cameraRoll responseWithLength:assets.count offset:params.offset]);
+       results.setProperty(runtime, "data", jsi::Object::createFromHostObject(runtime, std::make_shared<YeetPhotoPageHostObject>(page)));
 
-       return convertNSDictionaryToJSIObject(runtime, results);
+       return results;
     });
   } else if (methodName == "getAlbums") {
      return jsi::Function::createFromHostFunction(runtime, name, 0, [](
@@ -316,6 +652,145 @@ jsi::Value MediaPlayerJSIModule::get(jsi::Runtime &runtime, const jsi::PropNameI
        }
 
     });
+  } else if (methodName == "hashImage") {
+     return jsi::Function::createFromHostFunction(runtime, name, 1, [jsInvoker](
+           jsi::Runtime &runtime,
+           const jsi::Value &thisValue,
+           const jsi::Value *arguments,
+           size_t count) -> jsi::Value {
+
+       NSString *path = convertJSIStringToNSString(runtime, arguments[0].asString(runtime));
+       return createNativePromise<ImageHashResult>(runtime, jsInvoker, convertImageHashResult, [path](std::shared_ptr<NativePromise<ImageHashResult>> promise) {
+         YeetTaskScheduler::shared().schedule(YeetTaskPriority::interactive, [path, promise]() {
+           @autoreleasepool {
+             UIImage *image = [UIImage imageWithContentsOfFile:fileURLFromPath(path).path];
+             if (!image) {
+               promise->reject(std::string("Could not load image at ") + (path.UTF8String ?: ""));
+               return;
+             }
+
+             // Both hashes only look at a tiny grayscale thumbnail, so skip the color conversion.
+             cv::Mat gray = [UIImage toCvMatGray:image];
+             if (gray.empty()) {
+               promise->reject(std::string("Could not read pixels of ") + (path.UTF8String ?: ""));
+               return;
+             }
+
+             ImageHashResult result;
+             result.hash = yeetPerceptualHash(gray);
+             result.differenceHash = yeetDifferenceHash(gray);
+             mediaHashIndex().insert(result.hash, path.UTF8String ?: "");
+
+             promise->resolve(std::move(result));
+           }
+         });
+       });
+    });
+  } else if (methodName == "findSimilar") {
+     return jsi::Function::createFromHostFunction(runtime, name, 2, [](
+           jsi::Runtime &runtime,
+           const jsi::Value &thisValue,
+           const jsi::Value *arguments,
+           size_t count) -> jsi::Value {
+
+       uint64_t hash;
+       if (!arguments[0].isString() || !yeetHashFromHex(arguments[0].asString(runtime).utf8(runtime), hash)) {
+         return jsi::Array(runtime, 0);
+       }
+
+       const int maxDistance = count > 1 && arguments[1].isNumber() ? (int)arguments[1].asNumber() : 0;
+
+       std::vector<YeetHashMatch> matches;
+       mediaHashIndex().query(hash, maxDistance, matches);
+
+       jsi::Array results(runtime, matches.size());
+       for (size_t i = 0; i < matches.size(); i++) {
+         jsi::Object match(runtime);
+         match.setProperty(runtime, "path", jsi::String::createFromUtf8(runtime, matches[i].id));
+         match.setProperty(runtime, "hash", jsi::String::createFromUtf8(runtime, yeetHashToHex(matches[i].hash)));
+         match.setProperty(runtime, "distance", matches[i].distance);
+         results.setValueAtIndex(runtime, i, std::move(match));
+       }
+
+       return results;
+    });
+  } else if (methodName == "encodeWebP") {
+    std::shared_ptr<YeetJSIPropNameCache> propNames = propNames_;
+     return jsi::Function::createFromHostFunction(runtime, name, 4, [jsInvoker, propNames](
+           jsi::Runtime &runtime,
+           const jsi::Value &thisValue,
+           const jsi::Value *arguments,
+           size_t count) -> jsi::Value {
+
+       NSString *source = convertJSIStringToNSString(runtime, arguments[0].asString(runtime));
+       NSString *destination = convertJSIStringToNSString(runtime, arguments[1].asString(runtime));
+
+       WebPExportParams params;
+       if (count > 2) {
+         decodeJSIStruct(runtime, *propNames, arguments[2], params);
+       }
+
+       std::shared_ptr<react::CallbackWrapper> onProgress;
+       if (count > 3 && arguments[3].isObject() && arguments[3].getObject(runtime).isFunction(runtime)) {
+         onProgress = std::make_shared<react::CallbackWrapper>(arguments[3].getObject(runtime).getFunction(runtime), runtime, jsInvoker);
+       }
+
+       return createNativePromise<WebPExportResult>(runtime, jsInvoker, convertWebPExportResult, [source, destination, params, onProgress, jsInvoker](std::shared_ptr<NativePromise<WebPExportResult>> promise) {
+         NSURL *destinationURL = fileURLFromPath(destination);
+         const std::string destinationPath = destinationURL.path.UTF8String ?: "";
+         std::shared_ptr<std::atomic<bool>> cancelled = beginWebPExport(destinationPath);
+
+         YeetTaskScheduler::shared().schedule(YeetTaskPriority::background, [source, destinationURL, destinationPath, cancelled, params, onProgress, jsInvoker, promise]() mutable {
+           @autoreleasepool {
+             // libwebp reports progress many times per percent. Only cross over to JS once it moves by 1%.
+             float reportedProgress = -1;
+             YeetWebPEncodeProgress progress = [onProgress, jsInvoker, cancelled, &reportedProgress](float value) {
+               if (onProgress && (value >= 1 || value - reportedProgress >= 0.01f)) {
+                 reportedProgress = value;
+                 jsInvoker->invokeAsync([onProgress, value]() {
+                   jsi::Runtime &rt = onProgress->runtime();
+                   onProgress->callback().call(rt, (double)value);
+                 });
+               }
+               return !cancelled->load();
+             };
+
+             WebPExportResult result;
+             std::string error;
+             const bool success = [YeetWebPExporter exportURL:fileURLFromPath(source) toURL:destinationURL options:params.encodeOptions() maxPixelSize:params.maxSize framesPerSecond:params.fps progress:progress result:result.file error:error];
+             endWebPExport(destinationPath, cancelled);
+
+             // onProgress holds a jsi::Function, which can only be released on the JS thread. Hand the
+             // last reference over instead of dropping it here when this task is destroyed.
+             progress = nullptr;
+             if (onProgress) {
+               jsInvoker->invokeAsync([onProgress = std::move(onProgress)]() {});
+             }
+
+             if (cancelled->load()) {
+               [[NSFileManager defaultManager] removeItemAtURL:destinationURL error:nil];
+               promise->reject("Cancelled");
+             } else if (!success) {
+               promise->reject(error);
+             } else {
+               result.path = destinationPath;
+               promise->resolve(std::move(result));
+             }
+           }
+         });
+       });
+    });
+  } else if (methodName == "cancelEncodeWebP") {
+     return jsi::Function::createFromHostFunction(runtime, name, 1, [](
+           jsi::Runtime &runtime,
+           const jsi::Value &thisValue,
+           const jsi::Value *arguments,
+           size_t count) -> jsi::Value {
+
+       // Returns false if nothing is being exported to that path.
+       NSURL *destinationURL = fileURLFromPath(convertJSIStringToNSString(runtime, arguments[0].asString(runtime)));
+       return cancelWebPExport(destinationURL.path.UTF8String ?: "");
+    });
   }
 
 
@@ -12,9 +12,13 @@ NS_ASSUME_NONNULL_BEGIN
 @class MediaPlayerViewManager;
 @class YeetClipboardJSI;
 @class YeetClipboard;
+@class RCTBridge;
 
 @interface MediaPlayerJSIModuleInstaller : NSObject
 
+// Each of these installs through the runtime's YeetJSIModuleRegistry, so they share one
+// JSCallInvoker and are torn down together when the bridge reloads.
++(void)installYeetJSI:(RCTBridge *)bridge;
 +(void)install:(id)player;
 +(void)installClipboard:(id)clipboard;
 
@@ -9,9 +9,14 @@
 #import "MediaPlayerJSIModuleInstaller.h"
 #import "MediaPlayerJSIModule.h"
 #import "YeetClipboardJSI.h"
+#import "YeetJSIModule.h"
 
 @implementation MediaPlayerJSIModuleInstaller
 
++(void)installYeetJSI:(RCTBridge *)bridge {
+  YeetJSIModule::install((RCTCxxBridge *)bridge);
+}
+
 +(void)install:(id)player {
   MediaPlayerJSIModule::install(player);
 }
@@ -70,6 +70,7 @@
 - (void)play:(nonnull NSNumber*)tag;
 - (void)editVideo:(nonnull NSNumber*)tag cb:(RCTResponseSenderBlock)callback;
 - (void)detectRectangles:(nonnull NSNumber*)tag cb:(RCTResponseSenderBlock)callback;
+- (void)suggestCrop:(nonnull NSNumber*)tag aspectRatio:(CGFloat)aspectRatio cb:(RCTResponseSenderBlock)callback;
 - (void)reset:(nonnull NSNumber*)tag;
 - (void)save:(nonnull NSNumber*)tag cb:(RCTResponseSenderBlock)callback;
 @end
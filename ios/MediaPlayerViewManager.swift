@@ -326,6 +326,35 @@ class MediaPlayerViewManager: RCTViewManager, RCTInvalidating {
     }
   }
 
+  @objc(suggestCrop: aspectRatio: cb:)
+  func suggestCrop(_ tag: NSNumber, aspectRatio: CGFloat, _ cb: @escaping RCTResponseSenderBlock) {
+    withView(tag: tag) { view in
+      guard self.bridge?.isValid == true else {
+        return
+      }
+
+      guard let image = view.imageView?.image, let mediaSource = view.currentItem else {
+        cb([nil, ["crop": nil]])
+        return
+      }
+
+      let imageSize = view.imageView!.bounds.size
+      let scaleX = imageSize.width / (image.size.width * image.scale)
+      let scaleY = imageSize.height / (image.size.height * image.scale)
+
+      // The saliency map is cached per media source, so later aspect ratios come back almost immediately.
+      YeetTaskQueue.schedule(.interactive) {
+        let crop = SmartCrop.cropRect(in: image, assetId: mediaSource.id, aspectRatio: aspectRatio, zoom: 1.0)
+        guard !crop.isNull else {
+          cb([nil, ["crop": nil]])
+          return
+        }
+
+        cb([nil, ["crop": crop.applying(.init(scaleX: scaleX, y: scaleY)).dictionaryValue()]])
+      }
+    }
+  }
+
   @objc(detectRectangles: cb:)
   func detectRectangles(_ tag: NSNumber, _ cb: @escaping RCTResponseSenderBlock) {
     withView(tag: tag) { view in
@@ -343,11 +372,15 @@ class MediaPlayerViewManager: RCTViewManager, RCTInvalidating {
       let scaleY = imageSize.height / (image.size.height * image.scale)
       
 
-      var rects: Array<[String: Any]> = []
-      for rect in FeatureDetector().detectRectangles(image: image) {
-        rects.append(rect.applying(.init(scaleX: scaleX, y: scaleY)).dictionaryValue())
+      YeetTaskQueue.schedule(.interactive) {
+        var rects: Array<[String: Any]> = []
+        for rectangle in FeatureDetector().detectRankedRectangles(image: image) {
+          var rect = rectangle.rect.applying(.init(scaleX: scaleX, y: scaleY)).dictionaryValue()
+          rect["confidence"] = rectangle.confidence
+          rects.append(rect)
+        }
+        cb([nil, ["rectangles": rects]])
       }
-      cb([nil, ["rectangles": rects]])
 
 //      let request = VNDetectRectanglesRequest(completionHandler: { request, error in
 //        guard let observations = request.results as? [VNRectangleObservation]
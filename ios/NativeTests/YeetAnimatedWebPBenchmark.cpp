@@ -0,0 +1,138 @@
+//
+//  YeetAnimatedWebPBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include "YeetAnimatedWebP.h"
+#include "YeetResidentMemory.h"
+#include "YeetWebPAnimationFixtures.h"
+
+// Plays a sticker-sized animated WebP (200 lossy 512x512 frames by default) two ways and reports
+// time per frame and how far the process's peak RSS rose above where it started:
+//
+//   lazy:     YeetAnimatedWebP with its ring of 3, one frame at a time, twice through like a looping
+//             image view;
+//   up front: WebPAnimDecoder, keeping every canvas, which is what decoding into
+//             SDAnimatedImage.images amounts to.
+//
+// Exits non-zero if any lazy frame differs from WebPAnimDecoder's by more than blending rounding.
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void printTimes(const char *name, std::vector<double> times, long rssGrowth) {
+  double total = 0;
+  for (double time : times) {
+    total += time;
+  }
+  std::sort(times.begin(), times.end());
+  printf("%-9s %7.3f ms/frame mean %7.3f ms p95 %7.3f ms max   peak RSS +%6.1f MB\n", name,
+    total / times.size(), times[std::min(times.size() - 1, times.size() * 95 / 100)], times.back(), rssGrowth / 1024.0);
+}
+
+int main(int argc, char **argv) {
+  const int frameCount = std::max(2, argc > 1 ? atoi(argv[1]) : 200);
+  const int size = std::max(64, argc > 2 ? atoi(argv[2]) : 512) & ~1;
+
+  // A full-canvas keyframe every 50 frames, and in between a quarter-canvas sprite moving over the
+  // previous frames, blended and sometimes disposed: the usual shape of a sticker.
+  std::vector<YeetTestWebPFrame> frames;
+  for (int i = 0; i < frameCount; i++) {
+    if (i % 50 == 0) {
+      frames.push_back(yeetTestWebPFrame(i, 0, 0, size, size, false, false));
+    } else {
+      const int side = size / 2;
+      const int x = ((i * 6) % (size - side)) & ~1;
+      const int y = ((i * 4) % (size - side)) & ~1;
+      frames.push_back(yeetTestWebPFrame(i, x, y, side, side, true, i % 4 == 0));
+    }
+  }
+  const std::vector<uint8_t> file = yeetEncodeTestAnimation(size, size, frames, 75);
+  frames.clear();
+  if (file.empty()) {
+    fprintf(stderr, "couldn't encode the animation\n");
+    return 1;
+  }
+  printf("%d frames, %dx%d, %zu KB\n", frameCount, size, size, file.size() / 1024);
+
+  std::vector<double> lazyTimes;
+  long before = yeetResetPeakResident();
+  {
+    auto owner = std::make_shared<std::vector<uint8_t>>(file);
+    auto image = YeetAnimatedWebP::create(owner->data(), owner->size(), owner);
+    if (!image) {
+      fprintf(stderr, "YeetAnimatedWebP couldn't open the animation\n");
+      return 1;
+    }
+
+    std::shared_ptr<const YeetAnimatedWebPFrame> onScreen;
+    for (int loop = 0; loop < 2; loop++) {
+      for (int i = 0; i < image->frameCount(); i++) {
+        auto start = std::chrono::steady_clock::now();
+        onScreen = image->frame(i);
+        lazyTimes.push_back(millisecondsSince(start));
+        if (!onScreen) {
+          fprintf(stderr, "frame %d failed to decode\n", i);
+          return 1;
+        }
+      }
+    }
+  }
+  printTimes("lazy", lazyTimes, yeetPeakResidentGrowth(before));
+
+  std::vector<double> upFrontTimes;
+  std::vector<std::vector<uint8_t>> canvases;
+  before = yeetResetPeakResident();
+  {
+    WebPData data;
+    data.bytes = file.data();
+    data.size = file.size();
+    WebPAnimDecoderOptions options;
+    WebPAnimDecoderOptionsInit(&options);
+    options.color_mode = MODE_rgbA;
+    WebPAnimDecoder *decoder = WebPAnimDecoderNew(&data, &options);
+    if (!decoder) {
+      fprintf(stderr, "WebPAnimDecoder couldn't open the animation\n");
+      return 1;
+    }
+
+    const size_t canvasSize = (size_t)size * size * 4;
+    while (WebPAnimDecoderHasMoreFrames(decoder)) {
+      auto start = std::chrono::steady_clock::now();
+      uint8_t *canvas = nullptr;
+      int timestamp = 0;
+      if (!WebPAnimDecoderGetNext(decoder, &canvas, &timestamp)) {
+        fprintf(stderr, "WebPAnimDecoder failed at frame %zu\n", canvases.size());
+        return 1;
+      }
+      canvases.emplace_back(canvas, canvas + canvasSize);
+      upFrontTimes.push_back(millisecondsSince(start));
+    }
+    WebPAnimDecoderDelete(decoder);
+  }
+  printTimes("up front", upFrontTimes, yeetPeakResidentGrowth(before));
+
+  auto owner = std::make_shared<std::vector<uint8_t>>(file);
+  auto image = YeetAnimatedWebP::create(owner->data(), owner->size(), owner);
+  bool mismatch = false;
+  for (int i = 0; i < image->frameCount(); i++) {
+    auto frame = image->frame(i);
+    const int difference = frame ? yeetMaxChannelDifference(frame->pixels, canvases[i]) : 256;
+    if (difference > 1) {
+      fprintf(stderr, "frame %d differs from WebPAnimDecoder's by %d\n", i, difference);
+      mismatch = true;
+    }
+  }
+
+  return mismatch ? 1 : 0;
+}
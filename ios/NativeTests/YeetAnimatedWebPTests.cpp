@@ -0,0 +1,184 @@
+//
+//  YeetAnimatedWebPTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetAnimatedWebP.h"
+#include "YeetWebPAnimationFixtures.h"
+#include <set>
+
+static const int YeetCanvasWidth = 64;
+static const int YeetCanvasHeight = 48;
+
+// A full-canvas first frame, then partial frames that overlap each other and the canvas edges,
+// all with the same blend and dispose methods.
+static std::vector<YeetTestWebPFrame> partialFrames(bool blend, bool disposeToBackground) {
+  return {
+    yeetTestWebPFrame(0, 0, 0, YeetCanvasWidth, YeetCanvasHeight, blend, disposeToBackground),
+    yeetTestWebPFrame(1, 8, 6, 30, 20, blend, disposeToBackground),
+    yeetTestWebPFrame(2, 20, 14, 30, 20, blend, disposeToBackground),
+    yeetTestWebPFrame(3, 34, 28, 30, 20, blend, disposeToBackground),
+    yeetTestWebPFrame(4, 0, 0, 16, 48, blend, disposeToBackground),
+    yeetTestWebPFrame(5, 2, 2, 60, 44, blend, disposeToBackground),
+  };
+}
+
+static std::unique_ptr<YeetAnimatedWebP> open(const std::vector<uint8_t> &file, size_t ringSize = 3) {
+  auto owner = std::make_shared<std::vector<uint8_t>>(file);
+  return YeetAnimatedWebP::create(owner->data(), owner->size(), owner, ringSize);
+}
+
+// Libwebp blends with its own fixed-point rounding, so blended pixels can be off by one.
+static int tolerance(const std::vector<YeetTestWebPFrame> &frames) {
+  for (const auto &frame : frames) {
+    if (frame.blend) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void expectMatchesAnimDecoder(const std::vector<YeetTestWebPFrame> &frames) {
+  const std::vector<uint8_t> file = yeetEncodeTestAnimation(YeetCanvasWidth, YeetCanvasHeight, frames);
+  ASSERT_FALSE(file.empty());
+  const auto expected = yeetDecodeWithAnimDecoder(file);
+  ASSERT_EQ(expected.size(), frames.size());
+
+  auto image = open(file);
+  ASSERT_NE(image, nullptr);
+  ASSERT_EQ(image->frameCount(), (int)frames.size());
+  EXPECT_EQ(image->width(), YeetCanvasWidth);
+  EXPECT_EQ(image->height(), YeetCanvasHeight);
+
+  for (int i = 0; i < image->frameCount(); i++) {
+    auto frame = image->frame(i);
+    ASSERT_NE(frame, nullptr) << i;
+    EXPECT_EQ(frame->index, i);
+    EXPECT_LE(yeetMaxChannelDifference(frame->pixels, expected[i]), tolerance(frames)) << "frame " << i;
+  }
+}
+
+TEST(YeetAnimatedWebP, MatchesAnimDecoderNoBlendDisposeNone) {
+  expectMatchesAnimDecoder(partialFrames(false, false));
+}
+
+TEST(YeetAnimatedWebP, MatchesAnimDecoderNoBlendDisposeBackground) {
+  expectMatchesAnimDecoder(partialFrames(false, true));
+}
+
+TEST(YeetAnimatedWebP, MatchesAnimDecoderBlendDisposeNone) {
+  expectMatchesAnimDecoder(partialFrames(true, false));
+}
+
+TEST(YeetAnimatedWebP, MatchesAnimDecoderBlendDisposeBackground) {
+  expectMatchesAnimDecoder(partialFrames(true, true));
+}
+
+TEST(YeetAnimatedWebP, MatchesAnimDecoderWithMixedModes) {
+  std::vector<YeetTestWebPFrame> frames;
+  for (int i = 0; i < 12; i++) {
+    // Every combination follows every other, and a full-canvas frame every so often becomes a keyframe.
+    const bool full = i % 5 == 0;
+    frames.push_back(yeetTestWebPFrame(i, full ? 0 : (i * 6) % 34, full ? 0 : (i * 4) % 28, full ? YeetCanvasWidth : 30, full ? YeetCanvasHeight : 20, i % 2, (i / 2) % 2));
+  }
+  expectMatchesAnimDecoder(frames);
+}
+
+TEST(YeetAnimatedWebP, SeekingBackMatchesPlayingForward) {
+  std::vector<YeetTestWebPFrame> frames = partialFrames(true, false);
+  const auto more = partialFrames(false, true);
+  frames.insert(frames.end(), more.begin(), more.end());
+  const std::vector<uint8_t> file = yeetEncodeTestAnimation(YeetCanvasWidth, YeetCanvasHeight, frames);
+  const auto expected = yeetDecodeWithAnimDecoder(file);
+  ASSERT_EQ(expected.size(), frames.size());
+
+  // A ring of one, so nothing is served from the ring and every request composites.
+  auto image = open(file, 1);
+  ASSERT_NE(image, nullptr);
+  for (int index : {4, 1, 9, 10, 3, 11, 0, 7, 7, 2}) {
+    auto frame = image->frame(index);
+    ASSERT_NE(frame, nullptr) << index;
+    EXPECT_LE(yeetMaxChannelDifference(frame->pixels, expected[index]), 1) << "frame " << index;
+  }
+}
+
+TEST(YeetAnimatedWebP, RingMemoryStaysBounded) {
+  std::vector<YeetTestWebPFrame> frames;
+  for (int i = 0; i < 200; i++) {
+    frames.push_back(yeetTestWebPFrame(i, (i * 2) % 34, (i * 2) % 28, 30, 20, true, i % 3 == 0));
+  }
+  frames[0] = yeetTestWebPFrame(0, 0, 0, YeetCanvasWidth, YeetCanvasHeight, false, false);
+  const std::vector<uint8_t> file = yeetEncodeTestAnimation(YeetCanvasWidth, YeetCanvasHeight, frames);
+  auto image = open(file, 3);
+  ASSERT_NE(image, nullptr);
+
+  // Plays twice, holding on to the frame on screen like an image view does, and counts canvases
+  // still alive anywhere after each step.
+  std::vector<std::weak_ptr<const YeetAnimatedWebPFrame>> handedOut;
+  std::shared_ptr<const YeetAnimatedWebPFrame> onScreen;
+  size_t mostAlive = 0;
+  for (int loop = 0; loop < 2; loop++) {
+    for (int i = 0; i < image->frameCount(); i++) {
+      onScreen = image->frame(i);
+      ASSERT_NE(onScreen, nullptr) << i;
+      handedOut.push_back(onScreen);
+
+      // A reused slot hands out the same canvas again, so count distinct ones.
+      std::set<const YeetAnimatedWebPFrame *> alive;
+      for (const auto &frame : handedOut) {
+        if (auto canvas = frame.lock()) {
+          alive.insert(canvas.get());
+        }
+      }
+      mostAlive = std::max(mostAlive, alive.size());
+    }
+  }
+
+  // The ring's three slots, plus the one on screen when its slot comes around again.
+  EXPECT_LE(mostAlive, 4u);
+  EXPECT_EQ(handedOut.size(), 400u);
+}
+
+TEST(YeetAnimatedWebP, HeldFramesAreNeverOverwritten) {
+  const std::vector<YeetTestWebPFrame> frames = partialFrames(true, true);
+  const std::vector<uint8_t> file = yeetEncodeTestAnimation(YeetCanvasWidth, YeetCanvasHeight, frames);
+  const auto expected = yeetDecodeWithAnimDecoder(file);
+  auto image = open(file, 2);
+  ASSERT_NE(image, nullptr);
+
+  auto held = image->frame(1);
+  ASSERT_NE(held, nullptr);
+  for (int i = 2; i < image->frameCount(); i++) {
+    ASSERT_NE(image->frame(i), nullptr);
+  }
+
+  EXPECT_EQ(held->index, 1);
+  EXPECT_LE(yeetMaxChannelDifference(held->pixels, expected[1]), 1);
+}
+
+TEST(YeetAnimatedWebP, ReadsTimingAndRejectsBadInput) {
+  std::vector<YeetTestWebPFrame> frames = partialFrames(false, false);
+  frames[1].duration = 40;
+  // Browsers play 10ms and shorter as 100ms.
+  frames[2].duration = 10;
+  frames[3].duration = 0;
+  auto image = open(yeetEncodeTestAnimation(YeetCanvasWidth, YeetCanvasHeight, frames));
+  ASSERT_NE(image, nullptr);
+
+  EXPECT_EQ(image->loopCount(), 0);
+  EXPECT_EQ(image->duration(0), 100);
+  EXPECT_EQ(image->duration(1), 40);
+  EXPECT_EQ(image->duration(2), 100);
+  EXPECT_EQ(image->duration(3), 100);
+  EXPECT_EQ(image->duration(-1), 0);
+  EXPECT_EQ(image->duration(image->frameCount()), 0);
+  EXPECT_EQ(image->frame(-1), nullptr);
+  EXPECT_EQ(image->frame(image->frameCount()), nullptr);
+
+  const std::vector<uint8_t> garbage(256, 7);
+  EXPECT_EQ(open(garbage), nullptr);
+}
@@ -0,0 +1,145 @@
+//
+//  YeetFrameDiffTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/21/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetFrameDiff.h"
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+// An RGBA frame with optional padding at the end of each row, like a CVPixelBuffer.
+struct Frame {
+  int width;
+  int height;
+  size_t bytesPerRow;
+  std::vector<uint8_t> bytes;
+
+  Frame(int width, int height, size_t padding) : width(width), height(height), bytesPerRow(width * 4 + padding), bytes(bytesPerRow * height) {}
+
+  uint8_t *pixel(int x, int y) { return &bytes[y * bytesPerRow + x * 4]; }
+  const uint8_t *pixel(int x, int y) const { return &bytes[y * bytesPerRow + x * 4]; }
+};
+
+}
+
+static Frame randomFrame(std::mt19937 &random, int width, int height, size_t padding) {
+  Frame frame(width, height, padding);
+  for (auto &byte : frame.bytes) {
+    byte = (uint8_t)random();
+  }
+  return frame;
+}
+
+// Same pixels, different padding bytes, so a diff that reads past the row shows up.
+static Frame copyFrame(std::mt19937 &random, const Frame &source, size_t padding) {
+  Frame frame = randomFrame(random, source.width, source.height, padding);
+  for (int y = 0; y < source.height; y++) {
+    memcpy(frame.pixel(0, y), source.pixel(0, y), source.width * 4);
+  }
+  return frame;
+}
+
+static YeetFrameRect bruteForceChangedRect(const Frame &previous, const Frame &current) {
+  int left = previous.width, top = previous.height, right = 0, bottom = 0;
+  for (int y = 0; y < previous.height; y++) {
+    for (int x = 0; x < previous.width; x++) {
+      if (memcmp(previous.pixel(x, y), current.pixel(x, y), 4) != 0) {
+        left = std::min(left, x);
+        right = std::max(right, x + 1);
+        top = std::min(top, y);
+        bottom = std::max(bottom, y + 1);
+      }
+    }
+  }
+
+  YeetFrameRect rect;
+  if (right > left) {
+    rect.x = left;
+    rect.y = top;
+    rect.width = right - left;
+    rect.height = bottom - top;
+  }
+  return rect;
+}
+
+static YeetFrameRect changedRect(const Frame &previous, const Frame &current) {
+  return yeetChangedRect(previous.bytes.data(), previous.bytesPerRow, current.bytes.data(), current.bytesPerRow, previous.width, previous.height);
+}
+
+static void expectRect(const YeetFrameRect &actual, const YeetFrameRect &expected) {
+  EXPECT_EQ(actual.x, expected.x);
+  EXPECT_EQ(actual.y, expected.y);
+  EXPECT_EQ(actual.width, expected.width);
+  EXPECT_EQ(actual.height, expected.height);
+}
+
+TEST(YeetFrameDiff, IdenticalFramesAreEmpty) {
+  std::mt19937 random(1);
+  const Frame previous = randomFrame(random, 37, 20, 12);
+  const Frame current = copyFrame(random, previous, 0);
+
+  const YeetFrameRect rect = changedRect(previous, current);
+  EXPECT_TRUE(rect.empty());
+  expectRect(rect, YeetFrameRect());
+}
+
+TEST(YeetFrameDiff, FindsSinglePixels) {
+  std::mt19937 random(2);
+  const Frame previous = randomFrame(random, 33, 9, 0);
+
+  // Every position, including the scalar tail past the last whole vector.
+  for (int y = 0; y < previous.height; y++) {
+    for (int x = 0; x < previous.width; x++) {
+      Frame current = copyFrame(random, previous, 0);
+      current.pixel(x, y)[random() % 4] ^= 1;
+
+      const YeetFrameRect rect = changedRect(previous, current);
+      EXPECT_EQ(rect.x, x);
+      EXPECT_EQ(rect.y, y);
+      EXPECT_EQ(rect.width, 1);
+      EXPECT_EQ(rect.height, 1);
+    }
+  }
+}
+
+TEST(YeetFrameDiff, MatchesBruteForce) {
+  std::mt19937 random(3);
+  std::uniform_int_distribution<int> dimension(1, 70);
+  for (int trial = 0; trial < 2000; trial++) {
+    const int width = dimension(random);
+    const int height = dimension(random);
+    const Frame previous = randomFrame(random, width, height, (random() % 3) * 4);
+    Frame current = copyFrame(random, previous, (random() % 3) * 4);
+
+    // A few changed regions, sometimes single pixels, sometimes scattered across the frame.
+    for (int regions = random() % 4; regions > 0; regions--) {
+      const int x = random() % width;
+      const int y = random() % height;
+      const int regionWidth = 1 + random() % (width - x);
+      const int regionHeight = 1 + random() % (height - y);
+      const bool sparse = random() % 2;
+      for (int j = y; j < y + regionHeight; j++) {
+        for (int i = x; i < x + regionWidth; i++) {
+          if (!sparse || random() % 8 == 0) {
+            current.pixel(i, j)[random() % 4] += 1 + random() % 255;
+          }
+        }
+      }
+    }
+
+    const YeetFrameRect expected = bruteForceChangedRect(previous, current);
+    const YeetFrameRect actual = changedRect(previous, current);
+    SCOPED_TRACE(testing::Message() << "trial " << trial << ", " << width << "x" << height);
+    expectRect(actual, expected);
+    if (HasFailure()) {
+      return;
+    }
+  }
+}
@@ -0,0 +1,148 @@
+//
+//  YeetHashIndexBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "YeetHashIndex.h"
+#include "YeetPerceptualHash.h"
+
+// Indexes 100k hashes (by default), then times queries at a range of distances against a linear
+// popcount scan over the same hashes. Exits non-zero if any query's matches differ.
+//
+// Most hashes are random; one in ten is a near-duplicate of an earlier one, a few bits away, like
+// a re-upload. Half the queries are near-duplicates of indexed hashes and half are random.
+
+static const int YeetQueryCount = 1000;
+static const int YeetDistances[] = {0, 4, 8, 12, 16, 20};
+
+static uint64_t flipBits(uint64_t hash, int bits, std::mt19937_64 &random) {
+  for (int i = 0; i < bits; i++) {
+    hash ^= 1ull << (random() % 64);
+  }
+  return hash;
+}
+
+static double microsecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double percentile(std::vector<double> values, double fraction) {
+  std::sort(values.begin(), values.end());
+  return values[std::min(values.size() - 1, (size_t)(values.size() * fraction))];
+}
+
+int main(int argc, char **argv) {
+  const int count = std::max(1, argc > 1 ? atoi(argv[1]) : 100000);
+
+  std::mt19937_64 random(1);
+  std::vector<uint64_t> hashes;
+  std::vector<std::string> ids;
+  hashes.reserve(count);
+  ids.reserve(count);
+  for (int i = 0; i < count; i++) {
+    const bool duplicate = i > 0 && random() % 10 == 0;
+    hashes.push_back(duplicate ? flipBits(hashes[random() % i], 1 + random() % 6, random) : random());
+    ids.push_back("asset-" + std::to_string(i));
+  }
+
+  char path[] = "/tmp/yeet-hash-index-benchmark-XXXXXX";
+  const int descriptor = mkstemp(path);
+  if (descriptor < 0) {
+    perror("mkstemp");
+    return 1;
+  }
+  close(descriptor);
+  unlink(path);
+
+  double insertMicroseconds;
+  {
+    YeetHashIndex index;
+    if (!index.open(path)) {
+      fprintf(stderr, "couldn't open %s\n", path);
+      return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+      index.insert(hashes[i], ids[i]);
+    }
+    insertMicroseconds = microsecondsSince(start);
+  }
+
+  YeetHashIndex index;
+  auto start = std::chrono::steady_clock::now();
+  if (!index.open(path)) {
+    fprintf(stderr, "couldn't reopen %s\n", path);
+    return 1;
+  }
+  const double openMicroseconds = microsecondsSince(start);
+  unlink(path);
+
+  printf("%zu hashes\n", index.size());
+  printf("insert (appending to the log): %8.3f us/hash\n", insertMicroseconds / count);
+  printf("open (replaying the log):      %8.2f ms\n", openMicroseconds / 1000);
+
+  std::vector<uint64_t> queries;
+  for (int i = 0; i < YeetQueryCount; i++) {
+    queries.push_back(i % 2 ? random() : flipBits(hashes[random() % count], random() % 8, random));
+  }
+
+  bool mismatch = false;
+  std::vector<YeetHashMatch> matches;
+  for (int distance : YeetDistances) {
+    std::vector<double> times;
+    size_t found = 0;
+    for (uint64_t query : queries) {
+      start = std::chrono::steady_clock::now();
+      index.query(query, distance, matches);
+      times.push_back(microsecondsSince(start));
+      found += matches.size();
+    }
+
+    // The reference: every hash, one popcount each.
+    std::vector<std::vector<std::string>> expected(queries.size());
+    start = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < queries.size(); q++) {
+      for (int i = 0; i < count; i++) {
+        if (yeetHammingDistance(queries[q], hashes[i]) <= distance) {
+          expected[q].push_back(ids[i]);
+        }
+      }
+    }
+    const double scanMicroseconds = microsecondsSince(start) / queries.size();
+
+    for (size_t q = 0; q < queries.size(); q++) {
+      index.query(queries[q], distance, matches);
+      std::vector<std::string> actual;
+      for (const auto &match : matches) {
+        actual.push_back(match.id);
+      }
+      std::sort(actual.begin(), actual.end());
+      std::sort(expected[q].begin(), expected[q].end());
+      if (actual != expected[q]) {
+        fprintf(stderr, "distance %d query %zu: %zu matches, linear scan found %zu\n", distance, q, actual.size(), expected[q].size());
+        mismatch = true;
+      }
+    }
+
+    double total = 0;
+    for (double time : times) {
+      total += time;
+    }
+    printf("distance %2d: %8.2f us mean %8.2f us p99   linear scan %8.2f us   %6.2f matches/query\n",
+      distance, total / times.size(), percentile(times, 0.99), scanMicroseconds, (double)found / queries.size());
+  }
+
+  return mismatch ? 1 : 0;
+}
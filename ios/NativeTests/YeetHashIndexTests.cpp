@@ -0,0 +1,250 @@
+//
+//  YeetHashIndexTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/21/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetHashIndex.h"
+#include "YeetPerceptualHash.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <unistd.h>
+
+static std::string temporaryIndexPath(const char *name) {
+  const std::string path = testing::TempDir() + "yeet-hash-index-" + name + ".idx";
+  remove(path.c_str());
+  remove((path + ".compact").c_str());
+  return path;
+}
+
+static long fileSize(const std::string &path) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return -1;
+  }
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fclose(file);
+  return size;
+}
+
+static std::vector<std::string> queryIds(const YeetHashIndex &index, uint64_t hash, int maxDistance) {
+  std::vector<YeetHashMatch> matches;
+  index.query(hash, maxDistance, matches);
+  std::vector<std::string> ids;
+  for (const auto &match : matches) {
+    ids.push_back(match.id);
+  }
+  return ids;
+}
+
+TEST(YeetHashIndex, FindsHashesWithinDistanceClosestFirst) {
+  YeetHashIndex index;
+  EXPECT_TRUE(index.insert(0x0, "zero"));
+  EXPECT_TRUE(index.insert(0x7, "three bits"));
+  EXPECT_TRUE(index.insert(0x1, "one bit"));
+  EXPECT_TRUE(index.insert(0xFFFF000000000000ull, "far"));
+
+  EXPECT_EQ(queryIds(index, 0x0, 0), std::vector<std::string>({"zero"}));
+  EXPECT_EQ(queryIds(index, 0x0, 3), std::vector<std::string>({"zero", "one bit", "three bits"}));
+
+  std::vector<YeetHashMatch> matches;
+  // 0x1 and 0x7 are a bit away; 0x0 is two.
+  index.query(0x3, 1, matches);
+  ASSERT_EQ(matches.size(), 2u);
+  for (const auto &match : matches) {
+    EXPECT_EQ(match.distance, 1);
+    EXPECT_EQ(match.distance, yeetHammingDistance(match.hash, 0x3));
+  }
+}
+
+// Covers both the multi-index probe (small distances) and the linear scan it falls back to.
+TEST(YeetHashIndex, MatchesBruteForceAtEveryDistance) {
+  std::mt19937_64 random(7);
+  std::vector<uint64_t> hashes;
+  YeetHashIndex index;
+  for (int i = 0; i < 2000; i++) {
+    uint64_t hash = random();
+    // Cluster some hashes near earlier ones, like near-duplicate photos.
+    if (i > 0 && i % 3 == 0) {
+      hash = hashes[random() % hashes.size()];
+      for (int flips = random() % 12; flips > 0; flips--) {
+        hash ^= 1ull << (random() % 64);
+      }
+    }
+    hashes.push_back(hash);
+    index.insert(hash, std::to_string(i));
+  }
+
+  for (int maxDistance : {0, 1, 3, 4, 7, 8, 11, 15, 16, 20, 32}) {
+    for (int q = 0; q < 40; q++) {
+      const uint64_t query = q % 2 == 0 ? hashes[random() % hashes.size()] : random();
+
+      std::vector<std::pair<int, std::string>> expected;
+      for (size_t i = 0; i < hashes.size(); i++) {
+        const int distance = yeetHammingDistance(hashes[i], query);
+        if (distance <= maxDistance) {
+          expected.emplace_back(distance, std::to_string(i));
+        }
+      }
+      std::sort(expected.begin(), expected.end());
+
+      std::vector<YeetHashMatch> matches;
+      index.query(query, maxDistance, matches);
+      std::vector<std::pair<int, std::string>> actual;
+      for (size_t i = 0; i < matches.size(); i++) {
+        actual.emplace_back(matches[i].distance, matches[i].id);
+        if (i > 0) {
+          EXPECT_LE(matches[i - 1].distance, matches[i].distance);
+        }
+      }
+      std::sort(actual.begin(), actual.end());
+
+      ASSERT_EQ(actual, expected) << "distance " << maxDistance << ", query " << q;
+    }
+  }
+}
+
+TEST(YeetHashIndex, RehashingAnIdReplacesItsOldHash) {
+  YeetHashIndex index;
+  EXPECT_TRUE(index.insert(0xAAAA, "photo"));
+  EXPECT_FALSE(index.insert(0xAAAA, "photo"));
+  EXPECT_TRUE(index.insert(0x5555, "photo"));
+
+  EXPECT_EQ(index.size(), 1u);
+  EXPECT_TRUE(queryIds(index, 0xAAAA, 0).empty());
+  EXPECT_EQ(queryIds(index, 0x5555, 0), std::vector<std::string>({"photo"}));
+  // The dead entry isn't reported by the linear scan either.
+  EXPECT_EQ(queryIds(index, 0xAAAA, 64), std::vector<std::string>({"photo"}));
+
+  // Going back to the first hash works too.
+  EXPECT_TRUE(index.insert(0xAAAA, "photo"));
+  EXPECT_EQ(queryIds(index, 0xAAAA, 0), std::vector<std::string>({"photo"}));
+  EXPECT_TRUE(queryIds(index, 0x5555, 0).empty());
+}
+
+TEST(YeetHashIndex, PersistsAndCompactsReplacedRecords) {
+  const std::string path = temporaryIndexPath("persist");
+  {
+    YeetHashIndex index;
+    ASSERT_TRUE(index.open(path));
+    index.insert(0x1, "a");
+    index.insert(0x2, "b");
+    index.insert(0x3, "a");
+  }
+  const long logSize = fileSize(path);
+
+  {
+    YeetHashIndex index;
+    ASSERT_TRUE(index.open(path));
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_TRUE(queryIds(index, 0x1, 0).empty());
+    EXPECT_EQ(queryIds(index, 0x3, 0), std::vector<std::string>({"a"}));
+    EXPECT_EQ(queryIds(index, 0x2, 0), std::vector<std::string>({"b"}));
+
+    // The record a replaced is gone from the file: 8 byte hash, 4 byte length, 1 byte id.
+    EXPECT_EQ(fileSize(path), logSize - 13);
+    EXPECT_EQ(access((path + ".compact").c_str(), F_OK), -1);
+
+    index.insert(0x4, "c");
+  }
+
+  YeetHashIndex index;
+  ASSERT_TRUE(index.open(path));
+  EXPECT_EQ(index.size(), 3u);
+  EXPECT_EQ(queryIds(index, 0x4, 0), std::vector<std::string>({"c"}));
+  remove(path.c_str());
+}
+
+TEST(YeetHashIndex, DropsATornLastRecord) {
+  const std::string path = temporaryIndexPath("torn");
+  {
+    YeetHashIndex index;
+    ASSERT_TRUE(index.open(path));
+    index.insert(0x1, "first");
+    index.insert(0x2, "second");
+  }
+
+  // Cut the last record off halfway through its id.
+  const long size = fileSize(path);
+  ASSERT_EQ(truncate(path.c_str(), size - 3), 0);
+
+  {
+    YeetHashIndex index;
+    ASSERT_TRUE(index.open(path));
+    EXPECT_EQ(index.size(), 1u);
+    EXPECT_EQ(queryIds(index, 0x1, 0), std::vector<std::string>({"first"}));
+    // Appends start on a record boundary again.
+    index.insert(0x3, "third");
+  }
+
+  YeetHashIndex index;
+  ASSERT_TRUE(index.open(path));
+  EXPECT_EQ(index.size(), 2u);
+  EXPECT_EQ(queryIds(index, 0x3, 0), std::vector<std::string>({"third"}));
+  remove(path.c_str());
+}
+
+TEST(YeetHashIndex, RejectsFilesThatArentIndexes) {
+  const std::string path = temporaryIndexPath("garbage");
+  FILE *file = fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  fputs("definitely not an index", file);
+  fclose(file);
+
+  YeetHashIndex index;
+  EXPECT_FALSE(index.open(path));
+  // Still usable in memory.
+  EXPECT_TRUE(index.insert(0x1, "a"));
+  EXPECT_EQ(index.size(), 1u);
+  remove(path.c_str());
+}
+
+TEST(YeetHashIndex, EmptiesLogsFromAnOlderHashVersion) {
+  const std::string path = temporaryIndexPath("old-version");
+  FILE *file = fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  const uint32_t version = 1;
+  const uint64_t hash = 0x1;
+  const uint32_t length = 1;
+  fwrite("YHIX", 1, 4, file);
+  fwrite(&version, sizeof(version), 1, file);
+  fwrite(&hash, sizeof(hash), 1, file);
+  fwrite(&length, sizeof(length), 1, file);
+  fwrite("a", 1, 1, file);
+  fclose(file);
+
+  {
+    YeetHashIndex index;
+    ASSERT_TRUE(index.open(path));
+    // Version 1 pHashes included DC and can't be compared with new ones.
+    EXPECT_EQ(index.size(), 0u);
+    EXPECT_EQ(fileSize(path), 8);
+    EXPECT_TRUE(index.insert(0x2, "b"));
+  }
+
+  YeetHashIndex reopened;
+  ASSERT_TRUE(reopened.open(path));
+  EXPECT_EQ(queryIds(reopened, 0x2, 0), std::vector<std::string>({"b"}));
+  remove(path.c_str());
+}
+
+TEST(YeetHashIndex, RejectsLogsFromANewerVersion) {
+  const std::string path = temporaryIndexPath("new-version");
+  FILE *file = fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  const uint32_t version = 1000;
+  fwrite("YHIX", 1, 4, file);
+  fwrite(&version, sizeof(version), 1, file);
+  fclose(file);
+
+  YeetHashIndex index;
+  EXPECT_FALSE(index.open(path));
+  // Left alone for the app version that wrote it.
+  EXPECT_EQ(fileSize(path), 8);
+  remove(path.c_str());
+}
@@ -0,0 +1,110 @@
+//
+//  YeetJSIMethodTableBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "YeetJSIMethodTable.h"
+#include "YeetTestRuntime.h"
+
+// YeetJSIModule's property names, in the same order.
+static const char *const YeetBenchmarkMethodNames[] = {
+  "photosAuthorizationStatus",
+  "scrollViewMetrics",
+  "triggerScrollEvent",
+  "removeItem",
+  "getItem",
+  "setItem",
+  "multiGet",
+  "multiSet",
+  "hideSplashScreen",
+  "hapticFeedback",
+  "focusedTextInputTag",
+  "focus",
+  "blur",
+  "transitionPanView",
+  "measureRelativeTo",
+  "measureRelativeToSync",
+  "stopMeasuringRelativeTo",
+};
+
+static const size_t YeetBenchmarkMethodCount = sizeof(YeetBenchmarkMethodNames) / sizeof(YeetBenchmarkMethodNames[0]);
+
+static jsi::Value createMethod(jsi::Runtime &runtime, const jsi::PropNameID &name) {
+  return jsi::Function::createFromHostFunction(runtime, name, 0, [](jsi::Runtime &runtime, const jsi::Value &thisValue, const jsi::Value *args, size_t count) -> jsi::Value {
+    return jsi::Value::undefined();
+  });
+}
+
+// What YeetJSIModule::get did before the table: convert the name, walk a compare chain and build a
+// new host function on every read.
+static jsi::Value getByString(jsi::Runtime &runtime, const jsi::PropNameID &name) {
+  std::string methodName = name.utf8(runtime);
+  for (auto candidate : YeetBenchmarkMethodNames) {
+    if (methodName == candidate) {
+      return createMethod(runtime, name);
+    }
+  }
+
+  return jsi::Value::undefined();
+}
+
+template <typename Get>
+static double nanosecondsPerGet(YeetTestRuntime &runtime, const std::vector<jsi::PropNameID> &names, size_t iterations, Get &&get) {
+  auto start = std::chrono::steady_clock::now();
+  size_t found = 0;
+  for (size_t i = 0; i < iterations; i++) {
+    found += get(names[i % names.size()]).isObject();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  if (found != iterations) {
+    fprintf(stderr, "expected every lookup to find a method, found %zu of %zu\n", found, iterations);
+    exit(1);
+  }
+
+  return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+int main(int argc, char **argv) {
+  const size_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+
+  YeetTestRuntime runtime;
+  YeetJSIPropNameCache propNames;
+  YeetJSIMethodTable methods(YeetBenchmarkMethodNames);
+
+  // Names as JS would pass them: new PropNameIDs, not the interned ones.
+  std::vector<jsi::PropNameID> names;
+  for (auto name : YeetBenchmarkMethodNames) {
+    names.push_back(jsi::PropNameID::forAscii(runtime, name));
+  }
+
+  auto before = runtime.counters;
+  double byString = nanosecondsPerGet(runtime, names, iterations, [&](const jsi::PropNameID &name) {
+    return getByString(runtime, name);
+  });
+  auto stringCounters = runtime.counters;
+
+  double byTable = nanosecondsPerGet(runtime, names, iterations, [&](const jsi::PropNameID &name) {
+    int index = methods.indexOf(runtime, propNames, name);
+    return methods.get(runtime, index, [&]() { return createMethod(runtime, name); });
+  });
+  auto tableCounters = runtime.counters;
+
+  printf("%zu methods, %zu gets each\n", YeetBenchmarkMethodCount, iterations);
+  printf("utf8 + compare chain: %8.1f ns/get, %zu utf8 conversions, %zu functions created\n", byString,
+         stringCounters.propNameUtf8 - before.propNameUtf8, stringCounters.createFunction - before.createFunction);
+  printf("YeetJSIMethodTable:   %8.1f ns/get, %zu utf8 conversions, %zu functions created\n", byTable,
+         tableCounters.propNameUtf8 - stringCounters.propNameUtf8, tableCounters.createFunction - stringCounters.createFunction);
+  printf("YeetTestRuntime's utf8() is a plain string copy, so the times undercount what a conversion\n"
+         "costs in JSC; the call counts carry over as-is.\n");
+
+  methods.clear();
+  propNames.clear();
+  return 0;
+}
@@ -0,0 +1,131 @@
+//
+//  YeetJSIMethodTableTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetJSIMethodTable.h"
+#include "YeetTestRuntime.h"
+
+static const char *const YeetTestMethodNames[] = {
+  "getItem",
+  "setItem",
+  "focusedTextInputTag",
+};
+
+namespace {
+
+// Answers get() the way YeetJSIModule does, and counts how often it had to build a method.
+class TestModule : public jsi::HostObject {
+public:
+  TestModule(std::shared_ptr<YeetJSIPropNameCache> propNames) : methods(YeetTestMethodNames), propNames_(propNames) {}
+
+  jsi::Value get(jsi::Runtime &runtime, const jsi::PropNameID &name) override {
+    int index = methods.indexOf(runtime, *propNames_, name);
+    if (index < 0) {
+      return jsi::Value::undefined();
+    }
+
+    return methods.get(runtime, index, [&]() -> jsi::Value {
+      created++;
+      if (std::string(methods.name(index)) == "focusedTextInputTag") {
+        return jsi::Value(created);
+      }
+
+      std::string methodName = methods.name(index);
+      return jsi::Function::createFromHostFunction(runtime, name, 0, [methodName](jsi::Runtime &runtime, const jsi::Value &thisValue, const jsi::Value *args, size_t count) -> jsi::Value {
+        return jsi::String::createFromUtf8(runtime, methodName);
+      });
+    });
+  }
+
+  std::vector<jsi::PropNameID> getPropertyNames(jsi::Runtime &runtime) override {
+    return methods.propertyNames(runtime, *propNames_);
+  }
+
+  YeetJSIMethodTable methods;
+  int created = 0;
+
+private:
+  std::shared_ptr<YeetJSIPropNameCache> propNames_;
+};
+
+}
+
+class YeetJSIMethodTableTest : public testing::Test {
+protected:
+  YeetTestRuntime runtime;
+  std::shared_ptr<YeetJSIPropNameCache> propNames = std::make_shared<YeetJSIPropNameCache>();
+  std::shared_ptr<TestModule> module = std::make_shared<TestModule>(propNames);
+  jsi::Object object = jsi::Object::createFromHostObject(runtime, module);
+
+  void TearDown() override {
+    module->methods.clear();
+    propNames->clear();
+  }
+};
+
+TEST_F(YeetJSIMethodTableTest, FindsEveryNameAndNothingElse) {
+  for (size_t index = 0; index < module->methods.size(); index++) {
+    EXPECT_EQ(module->methods.indexOf(runtime, *propNames, jsi::PropNameID::forAscii(runtime, YeetTestMethodNames[index])), (int)index);
+  }
+
+  EXPECT_EQ(module->methods.indexOf(runtime, *propNames, jsi::PropNameID::forAscii(runtime, "getItems")), -1);
+  EXPECT_EQ(module->methods.indexOf(runtime, *propNames, jsi::PropNameID::forAscii(runtime, "")), -1);
+  EXPECT_TRUE(object.getProperty(runtime, "removeItem").isUndefined());
+}
+
+TEST_F(YeetJSIMethodTableTest, CreatesEachFunctionOnce) {
+  jsi::Value first = object.getProperty(runtime, "getItem");
+  ASSERT_TRUE(first.isObject());
+  ASSERT_TRUE(first.getObject(runtime).isFunction(runtime));
+
+  for (int i = 0; i < 100; i++) {
+    jsi::Value again = object.getProperty(runtime, "getItem");
+    EXPECT_TRUE(jsi::Value::strictEquals(runtime, first, again));
+  }
+  EXPECT_EQ(module->created, 1);
+
+  jsi::Value result = first.getObject(runtime).getFunction(runtime).call(runtime);
+  EXPECT_EQ(result.getString(runtime).utf8(runtime), "getItem");
+
+  object.getProperty(runtime, "setItem");
+  EXPECT_EQ(module->created, 2);
+}
+
+TEST_F(YeetJSIMethodTableTest, GettersRunOnEveryRead) {
+  EXPECT_EQ(object.getProperty(runtime, "focusedTextInputTag").getNumber(), 1);
+  EXPECT_EQ(object.getProperty(runtime, "focusedTextInputTag").getNumber(), 2);
+}
+
+TEST_F(YeetJSIMethodTableTest, LookupsDontConvertNamesOrInternAgain) {
+  jsi::PropNameID name = jsi::PropNameID::forAscii(runtime, "setItem");
+  module->get(runtime, name);
+
+  const auto before = runtime.counters;
+  for (int i = 0; i < 100; i++) {
+    module->get(runtime, name);
+  }
+
+  EXPECT_EQ(runtime.counters.propNameUtf8, before.propNameUtf8);
+  EXPECT_EQ(runtime.counters.createPropNameID, before.createPropNameID);
+  EXPECT_EQ(runtime.counters.createFunction, before.createFunction);
+}
+
+TEST_F(YeetJSIMethodTableTest, ListsItsPropertyNames) {
+  jsi::Array names = object.getPropertyNames(runtime);
+  ASSERT_EQ(names.size(runtime), 3u);
+  for (size_t index = 0; index < 3; index++) {
+    EXPECT_EQ(names.getValueAtIndex(runtime, index).getString(runtime).utf8(runtime), YeetTestMethodNames[index]);
+  }
+}
+
+TEST_F(YeetJSIMethodTableTest, ClearDropsTheCachedFunctions) {
+  object.getProperty(runtime, "getItem");
+  module->methods.clear();
+  object.getProperty(runtime, "getItem");
+  EXPECT_EQ(module->created, 2);
+}
@@ -0,0 +1,168 @@
+//
+//  YeetJSIStructBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+#include "YeetJSIStruct.h"
+#include "YeetTestRuntime.h"
+
+// The shape of MediaPlayerJSIModule's WebPExportParams.
+struct ExportParams {
+  double quality = 75;
+  bool lossless = false;
+  long method = 4;
+  std::string preset = "default";
+  bool multithreaded = true;
+  long loopCount = 0;
+  bool minimizeSize = false;
+  long kmin = 0;
+  long kmax = 0;
+  bool allowMixed = false;
+  bool frameDiff = true;
+  double maxSize = 0;
+  double fps = 0;
+};
+
+template <>
+struct YeetJSIStructFields<ExportParams> {
+  static auto fields() {
+    return std::make_tuple(
+      jsiField("quality", &ExportParams::quality),
+      jsiField("lossless", &ExportParams::lossless),
+      jsiField("method", &ExportParams::method),
+      jsiField("preset", &ExportParams::preset),
+      jsiField("multithreaded", &ExportParams::multithreaded),
+      jsiField("loopCount", &ExportParams::loopCount),
+      jsiField("minimizeSize", &ExportParams::minimizeSize),
+      jsiField("kmin", &ExportParams::kmin),
+      jsiField("kmax", &ExportParams::kmax),
+      jsiField("allowMixed", &ExportParams::allowMixed),
+      jsiField("frameDiff", &ExportParams::frameDiff),
+      jsiField("maxSize", &ExportParams::maxSize),
+      jsiField("fps", &ExportParams::fps)
+    );
+  }
+};
+
+// Stands in for convertJSIObjectToNSDictionary + RCTConvert: every key is listed and converted,
+// every value is boxed into a map, and the struct is filled by looking the keys up again.
+struct Boxed {
+  bool isString = false;
+  double number = 0;
+  std::string string;
+};
+
+static ExportParams decodeByWalking(jsi::Runtime &runtime, const jsi::Object &object) {
+  std::unordered_map<std::string, Boxed> dictionary;
+  jsi::Array keys = object.getPropertyNames(runtime);
+  size_t count = keys.size(runtime);
+  for (size_t i = 0; i < count; i++) {
+    jsi::String key = keys.getValueAtIndex(runtime, i).getString(runtime);
+    jsi::Value value = object.getProperty(runtime, key);
+    Boxed &boxed = dictionary[key.utf8(runtime)];
+    if (value.isString()) {
+      boxed.isString = true;
+      boxed.string = value.getString(runtime).utf8(runtime);
+    } else if (value.isNumber()) {
+      boxed.number = value.getNumber();
+    } else if (value.isBool()) {
+      boxed.number = value.getBool();
+    }
+  }
+
+  ExportParams params;
+  auto number = [&](const char *key, double fallback) {
+    auto found = dictionary.find(key);
+    return found == dictionary.end() || found->second.isString ? fallback : found->second.number;
+  };
+
+  params.quality = number("quality", params.quality);
+  params.lossless = number("lossless", params.lossless);
+  params.method = number("method", params.method);
+  auto preset = dictionary.find("preset");
+  if (preset != dictionary.end() && preset->second.isString) {
+    params.preset = preset->second.string;
+  }
+  params.multithreaded = number("multithreaded", params.multithreaded);
+  params.loopCount = number("loopCount", params.loopCount);
+  params.minimizeSize = number("minimizeSize", params.minimizeSize);
+  params.kmin = number("kmin", params.kmin);
+  params.kmax = number("kmax", params.kmax);
+  params.allowMixed = number("allowMixed", params.allowMixed);
+  params.frameDiff = number("frameDiff", params.frameDiff);
+  params.maxSize = number("maxSize", params.maxSize);
+  params.fps = number("fps", params.fps);
+  return params;
+}
+
+static bool sameParams(const ExportParams &a, const ExportParams &b) {
+  return a.quality == b.quality && a.lossless == b.lossless && a.method == b.method && a.preset == b.preset &&
+         a.multithreaded == b.multithreaded && a.loopCount == b.loopCount && a.minimizeSize == b.minimizeSize &&
+         a.kmin == b.kmin && a.kmax == b.kmax && a.allowMixed == b.allowMixed && a.frameDiff == b.frameDiff &&
+         a.maxSize == b.maxSize && a.fps == b.fps;
+}
+
+template <typename Decode>
+static double nanosecondsPerDecode(size_t iterations, Decode &&decode) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    decode();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+int main(int argc, char **argv) {
+  const size_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+
+  YeetTestRuntime runtime;
+  YeetJSIPropNameCache names;
+
+  jsi::Object object(runtime);
+  object.setProperty(runtime, "quality", 90);
+  object.setProperty(runtime, "lossless", false);
+  object.setProperty(runtime, "method", 6);
+  object.setProperty(runtime, "preset", "picture");
+  object.setProperty(runtime, "loopCount", 3);
+  object.setProperty(runtime, "kmin", 3);
+  object.setProperty(runtime, "kmax", 5);
+  object.setProperty(runtime, "allowMixed", true);
+  object.setProperty(runtime, "maxSize", 1280);
+  object.setProperty(runtime, "fps", 24);
+  jsi::Value value(runtime, object);
+
+  ExportParams walked = decodeByWalking(runtime, object);
+  ExportParams decoded;
+  decodeJSIStruct(runtime, names, value, decoded);
+  if (!sameParams(walked, decoded)) {
+    fprintf(stderr, "decodeJSIStruct and the walker disagree\n");
+    return 1;
+  }
+
+  auto before = runtime.counters;
+  double byWalking = nanosecondsPerDecode(iterations, [&]() { return decodeByWalking(runtime, object); });
+  auto walkingCounters = runtime.counters;
+
+  double byStruct = nanosecondsPerDecode(iterations, [&]() {
+    ExportParams params;
+    decodeJSIStruct(runtime, names, value, params);
+    return params;
+  });
+  auto structCounters = runtime.counters;
+
+  printf("%zu decodes of a 13-field struct from a 10-key object\n", iterations);
+  printf("walk + box + look up: %8.1f ns/decode, %5.1f getProperty/decode\n", byWalking,
+         (double)(walkingCounters.getProperty - before.getProperty) / iterations);
+  printf("decodeJSIStruct:      %8.1f ns/decode, %5.1f getProperty/decode\n", byStruct,
+         (double)(structCounters.getProperty - walkingCounters.getProperty) / iterations);
+
+  names.clear();
+  return 0;
+}
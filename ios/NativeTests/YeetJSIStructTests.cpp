@@ -0,0 +1,202 @@
+//
+//  YeetJSIStructTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetJSIStruct.h"
+#include "YeetTestRuntime.h"
+
+namespace {
+
+enum class Fit {
+  cover,
+  contain,
+};
+
+struct Size {
+  double width = 0;
+  double height = 0;
+};
+
+struct Params {
+  double quality = 0.75;
+  long offset = 0;
+  bool cache = false;
+  std::string albumId = "all";
+  Fit fit = Fit::cover;
+  YeetJSINullable<std::string> mediaType;
+  Size size;
+};
+
+}
+
+template <>
+struct YeetJSIEnum<Fit> {
+  static bool fromString(const std::string &value, Fit &out) {
+    if (value == "cover") {
+      out = Fit::cover;
+    } else if (value == "contain") {
+      out = Fit::contain;
+    } else {
+      return false;
+    }
+
+    return true;
+  }
+};
+
+template <>
+struct YeetJSIStructFields<Size> {
+  static auto fields() {
+    return std::make_tuple(
+      jsiField("width", &Size::width),
+      jsiField("height", &Size::height)
+    );
+  }
+};
+
+template <>
+struct YeetJSIStructFields<Params> {
+  static auto fields() {
+    return std::make_tuple(
+      jsiField("quality", &Params::quality),
+      jsiField("offset", &Params::offset),
+      jsiField("cache", &Params::cache),
+      jsiField("albumId", &Params::albumId),
+      jsiField("fit", &Params::fit),
+      jsiField("mediaType", &Params::mediaType),
+      jsiField("size", &Params::size)
+    );
+  }
+};
+
+class YeetJSIStructTest : public testing::Test {
+protected:
+  YeetTestRuntime runtime;
+  YeetJSIPropNameCache names;
+
+  jsi::Object size(double width, double height) {
+    jsi::Object object(runtime);
+    object.setProperty(runtime, "width", width);
+    object.setProperty(runtime, "height", height);
+    return object;
+  }
+
+  void TearDown() override {
+    names.clear();
+  }
+};
+
+TEST_F(YeetJSIStructTest, DecodesEveryField) {
+  jsi::Object object(runtime);
+  object.setProperty(runtime, "quality", 0.5);
+  object.setProperty(runtime, "offset", 40.9);
+  object.setProperty(runtime, "cache", true);
+  object.setProperty(runtime, "albumId", "recents");
+  object.setProperty(runtime, "fit", "contain");
+  object.setProperty(runtime, "mediaType", "video");
+  object.setProperty(runtime, "size", size(320, 240));
+
+  Params params;
+  ASSERT_TRUE(decodeJSIStruct(runtime, names, jsi::Value(runtime, object), params));
+
+  EXPECT_EQ(params.quality, 0.5);
+  EXPECT_EQ(params.offset, 40);
+  EXPECT_TRUE(params.cache);
+  EXPECT_EQ(params.albumId, "recents");
+  EXPECT_EQ(params.fit, Fit::contain);
+  EXPECT_FALSE(params.mediaType.isNull);
+  EXPECT_EQ(params.mediaType.value, "video");
+  EXPECT_EQ(params.size.width, 320);
+  EXPECT_EQ(params.size.height, 240);
+}
+
+TEST_F(YeetJSIStructTest, MissingAndMistypedFieldsKeepTheirDefaults) {
+  jsi::Object object(runtime);
+  object.setProperty(runtime, "quality", "high");
+  object.setProperty(runtime, "cache", "yes");
+  object.setProperty(runtime, "albumId", 12);
+  object.setProperty(runtime, "fit", "stretch");
+  object.setProperty(runtime, "size", 5);
+
+  Params params;
+  ASSERT_TRUE(decodeJSIStruct(runtime, names, jsi::Value(runtime, object), params));
+
+  EXPECT_EQ(params.quality, 0.75);
+  EXPECT_EQ(params.offset, 0);
+  EXPECT_FALSE(params.cache);
+  EXPECT_EQ(params.albumId, "all");
+  EXPECT_EQ(params.fit, Fit::cover);
+  EXPECT_TRUE(params.mediaType.isNull);
+  EXPECT_EQ(params.size.width, 0);
+}
+
+TEST_F(YeetJSIStructTest, NumbersDecodeAsBools) {
+  jsi::Object object(runtime);
+  object.setProperty(runtime, "cache", 1);
+
+  Params params;
+  decodeJSIStruct(runtime, names, jsi::Value(runtime, object), params);
+  EXPECT_TRUE(params.cache);
+
+  object.setProperty(runtime, "cache", 0);
+  decodeJSIStruct(runtime, names, jsi::Value(runtime, object), params);
+  EXPECT_FALSE(params.cache);
+}
+
+TEST_F(YeetJSIStructTest, NullableTellsNullApartFromAValue) {
+  Params params;
+  params.mediaType.isNull = false;
+  params.mediaType.value = "photo";
+
+  jsi::Object object(runtime);
+  object.setProperty(runtime, "mediaType", jsi::Value::null());
+  decodeJSIStruct(runtime, names, jsi::Value(runtime, object), params);
+  EXPECT_TRUE(params.mediaType.isNull);
+
+  object.setProperty(runtime, "mediaType", "photo");
+  decodeJSIStruct(runtime, names, jsi::Value(runtime, object), params);
+  EXPECT_FALSE(params.mediaType.isNull);
+  EXPECT_EQ(params.mediaType.value, "photo");
+
+  // Missing is null too.
+  decodeJSIStruct(runtime, names, jsi::Value(runtime, jsi::Object(runtime)), params);
+  EXPECT_TRUE(params.mediaType.isNull);
+}
+
+TEST_F(YeetJSIStructTest, NonObjectsLeaveTheStructAlone) {
+  Params params;
+  params.quality = 0.1;
+
+  EXPECT_FALSE(decodeJSIStruct(runtime, names, jsi::Value::undefined(), params));
+  EXPECT_FALSE(decodeJSIStruct(runtime, names, jsi::Value::null(), params));
+  EXPECT_FALSE(decodeJSIStruct(runtime, names, jsi::Value(4), params));
+  EXPECT_FALSE(decodeJSIStruct(runtime, names, jsi::String::createFromAscii(runtime, "quality"), params));
+  EXPECT_EQ(params.quality, 0.1);
+}
+
+TEST_F(YeetJSIStructTest, ReadsEachDeclaredFieldOnceAndInternsNamesOnce) {
+  jsi::Object object(runtime);
+  object.setProperty(runtime, "size", size(1, 2));
+  object.setProperty(runtime, "unrelated", 1);
+  jsi::Value value(runtime, object);
+
+  Params params;
+  const auto start = runtime.counters;
+  decodeJSIStruct(runtime, names, value, params);
+  const auto first = runtime.counters;
+
+  // Seven fields on Params and two on the nested Size.
+  EXPECT_EQ(first.getProperty - start.getProperty, 9u);
+  EXPECT_EQ(first.createPropNameID - start.createPropNameID, 9u);
+  EXPECT_EQ(first.propNameUtf8, start.propNameUtf8);
+
+  decodeJSIStruct(runtime, names, value, params);
+  const auto second = runtime.counters;
+  EXPECT_EQ(second.getProperty - first.getProperty, 9u);
+  EXPECT_EQ(second.createPropNameID, first.createPropNameID);
+}
@@ -0,0 +1,118 @@
+//
+//  YeetLayoutMeasurementTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetLayoutMeasurement.h"
+#include <cmath>
+
+static YGNodeRef absoluteNode(YGNodeRef parent, float left, float top, float width, float height) {
+  YGNodeRef node = YGNodeNew();
+  YGNodeStyleSetPositionType(node, YGPositionTypeAbsolute);
+  YGNodeStyleSetPosition(node, YGEdgeLeft, left);
+  YGNodeStyleSetPosition(node, YGEdgeTop, top);
+  YGNodeStyleSetWidth(node, width);
+  YGNodeStyleSetHeight(node, height);
+  YGNodeInsertChild(parent, node, YGNodeGetChildCount(parent));
+  return node;
+}
+
+static void expectFrame(const double *frame, double x, double y, double width, double height) {
+  EXPECT_EQ(frame[0], x);
+  EXPECT_EQ(frame[1], y);
+  EXPECT_EQ(frame[2], width);
+  EXPECT_EQ(frame[3], height);
+}
+
+static void expectCleared(const double *frame) {
+  for (size_t i = 0; i < YeetLayoutFrameStride; i++) {
+    EXPECT_TRUE(std::isnan(frame[i])) << i;
+  }
+}
+
+class YeetLayoutMeasurementTest : public testing::Test {
+protected:
+  void SetUp() override {
+    root = YGNodeNew();
+    YGNodeStyleSetWidth(root, 400);
+    YGNodeStyleSetHeight(root, 800);
+
+    container = absoluteNode(root, 10, 20, 300, 300);
+    block = absoluteNode(container, 5, 7, 50, 60);
+    inner = absoluteNode(block, 1, 2, 10, 12);
+    sibling = absoluteNode(root, 0, 400, 100, 100);
+
+    YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+  }
+
+  void TearDown() override {
+    YGNodeFreeRecursive(root);
+  }
+
+  YGNodeRef root;
+  YGNodeRef container;
+  YGNodeRef block;
+  YGNodeRef inner;
+  YGNodeRef sibling;
+};
+
+TEST_F(YeetLayoutMeasurementTest, AddsOffsetsUpToTheAncestor) {
+  double frame[YeetLayoutFrameStride];
+
+  ASSERT_TRUE(measureYogaNodeRelativeTo(inner, root, frame));
+  expectFrame(frame, 16, 29, 10, 12);
+
+  ASSERT_TRUE(measureYogaNodeRelativeTo(inner, container, frame));
+  expectFrame(frame, 6, 9, 10, 12);
+
+  ASSERT_TRUE(measureYogaNodeRelativeTo(block, container, frame));
+  expectFrame(frame, 5, 7, 50, 60);
+}
+
+TEST_F(YeetLayoutMeasurementTest, ANodeIsAtTheOriginOfItself) {
+  double frame[YeetLayoutFrameStride];
+  ASSERT_TRUE(measureYogaNodeRelativeTo(block, block, frame));
+  expectFrame(frame, 0, 0, 50, 60);
+}
+
+TEST_F(YeetLayoutMeasurementTest, NodesOutsideTheAncestorAreCleared) {
+  double frame[YeetLayoutFrameStride] = {1, 2, 3, 4};
+  EXPECT_FALSE(measureYogaNodeRelativeTo(inner, sibling, frame));
+  expectCleared(frame);
+
+  // The ancestor has to be above the node, not below it.
+  double reversed[YeetLayoutFrameStride] = {1, 2, 3, 4};
+  EXPECT_FALSE(measureYogaNodeRelativeTo(container, inner, reversed));
+  expectCleared(reversed);
+}
+
+TEST_F(YeetLayoutMeasurementTest, NullNodesAreCleared) {
+  double frame[YeetLayoutFrameStride] = {1, 2, 3, 4};
+  EXPECT_FALSE(measureYogaNodeRelativeTo(nullptr, root, frame));
+  expectCleared(frame);
+
+  double orphan[YeetLayoutFrameStride] = {1, 2, 3, 4};
+  EXPECT_FALSE(measureYogaNodeRelativeTo(inner, nullptr, orphan));
+  expectCleared(orphan);
+}
+
+// measureRelativeTo fills one packed buffer for every block it was asked about, so a block that
+// can't be measured must leave its neighbours' slots alone.
+TEST_F(YeetLayoutMeasurementTest, PackedFramesStayParallelToTheirNodes) {
+  YGNodeRef nodes[] = {block, sibling, inner};
+  double frames[3 * YeetLayoutFrameStride];
+
+  double *frame = frames;
+  for (YGNodeRef node : nodes) {
+    measureYogaNodeRelativeTo(node, container, frame);
+    frame += YeetLayoutFrameStride;
+  }
+
+  expectFrame(frames, 5, 7, 50, 60);
+  expectCleared(frames + YeetLayoutFrameStride);
+  expectFrame(frames + 2 * YeetLayoutFrameStride, 6, 9, 10, 12);
+}
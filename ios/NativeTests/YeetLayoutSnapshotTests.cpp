@@ -0,0 +1,128 @@
+//
+//  YeetLayoutSnapshotTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/21/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetLayoutSnapshot.h"
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+static YeetLayoutSnapshot::Frame frameWithValue(double value) {
+  YeetLayoutSnapshot::Frame frame;
+  frame.fill(value);
+  return frame;
+}
+
+TEST(YeetLayoutSnapshot, ReadsThePublishedFrames) {
+  YeetLayoutSnapshot snapshot;
+  auto &containers = snapshot.beginWrite();
+  containers[1][10] = {1, 2, 3, 4};
+  containers[1][11] = {5, 6, 7, 8};
+  snapshot.publish();
+
+  double frames[3 * YeetLayoutFrameStride];
+  ASSERT_TRUE(snapshot.read(1, {11, 10, 12}, frames));
+
+  EXPECT_EQ(frames[0], 5);
+  EXPECT_EQ(frames[3], 8);
+  EXPECT_EQ(frames[4], 1);
+  EXPECT_EQ(frames[7], 4);
+  // 12 isn't in the container.
+  for (size_t i = 8; i < 12; i++) {
+    EXPECT_TRUE(std::isnan(frames[i]));
+  }
+}
+
+TEST(YeetLayoutSnapshot, MissingContainerReturnsFalse) {
+  YeetLayoutSnapshot snapshot;
+  double frame[YeetLayoutFrameStride];
+  EXPECT_FALSE(snapshot.read(1, {10}, frame));
+
+  snapshot.beginWrite()[1][10] = {1, 2, 3, 4};
+  snapshot.publish();
+  EXPECT_FALSE(snapshot.read(2, {10}, frame));
+}
+
+TEST(YeetLayoutSnapshot, OnlyTheLatestPublishIsVisible) {
+  YeetLayoutSnapshot snapshot;
+  snapshot.beginWrite()[1][10] = frameWithValue(1);
+  snapshot.publish();
+  snapshot.beginWrite()[2][20] = frameWithValue(2);
+
+  // Not published yet.
+  double frame[YeetLayoutFrameStride];
+  ASSERT_TRUE(snapshot.read(1, {10}, frame));
+  EXPECT_EQ(frame[0], 1);
+
+  snapshot.publish();
+  EXPECT_FALSE(snapshot.read(1, {10}, frame));
+  ASSERT_TRUE(snapshot.read(2, {20}, frame));
+  EXPECT_EQ(frame[0], 2);
+}
+
+// Every published generation writes the same value into all of a frame's slots and all of its
+// tags, so a reader that ever sees a mix was reading a buffer the writer was refilling.
+TEST(YeetLayoutSnapshot, ReadersNeverSeeATornWrite) {
+  static const int tagCount = 64;
+  static const int generations = 20000;
+
+  YeetLayoutSnapshot snapshot;
+  std::vector<int> tags;
+  for (int tag = 0; tag < tagCount; tag++) {
+    tags.push_back(tag);
+  }
+
+  std::atomic<bool> done{false};
+  std::atomic<int> tornReads{0};
+  std::atomic<int> backwardReads{0};
+  std::atomic<long> reads{0};
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 3; r++) {
+    readers.emplace_back([&]() {
+      std::vector<double> frames(tagCount * YeetLayoutFrameStride);
+      double lastGeneration = -1;
+      while (!done.load()) {
+        if (!snapshot.read(0, tags, frames.data())) {
+          continue;
+        }
+
+        reads++;
+        const double generation = frames[0];
+        for (double value : frames) {
+          if (value != generation) {
+            tornReads++;
+            break;
+          }
+        }
+        if (generation < lastGeneration) {
+          backwardReads++;
+        }
+        lastGeneration = generation;
+      }
+    });
+  }
+
+  for (int generation = 0; generation < generations; generation++) {
+    auto &frames = snapshot.beginWrite()[0];
+    for (int tag : tags) {
+      frames[tag] = frameWithValue(generation);
+    }
+    snapshot.publish();
+  }
+
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_GT(reads.load(), 0);
+  EXPECT_EQ(tornReads.load(), 0);
+  EXPECT_EQ(backwardReads.load(), 0);
+}
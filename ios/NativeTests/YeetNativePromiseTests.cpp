@@ -0,0 +1,173 @@
+//
+//  YeetNativePromiseTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetNativePromise.h"
+#include "YeetTestRuntime.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Size {
+  double width;
+  double height;
+};
+
+}
+
+class YeetNativePromiseTest : public testing::Test {
+protected:
+  YeetTestRuntime runtime;
+  std::shared_ptr<YeetTestJSCallInvoker> jsInvoker = std::make_shared<YeetTestJSCallInvoker>();
+  std::atomic<int> conversions { 0 };
+
+  // Creates a promise the way MediaPlayerJSIModule does and hands back its native side.
+  jsi::Value createPromise(std::shared_ptr<NativePromise<Size>> &nativePromise) {
+    return createNativePromise<Size>(runtime, jsInvoker, [this](jsi::Runtime &runtime, Size &size) {
+      conversions++;
+      jsi::Object result(runtime);
+      result.setProperty(runtime, "width", size.width);
+      result.setProperty(runtime, "height", size.height);
+      return jsi::Value(runtime, result);
+    }, [&nativePromise](std::shared_ptr<NativePromise<Size>> promise) {
+      nativePromise = promise;
+    });
+  }
+
+  std::string rejection(const jsi::Value &promise) {
+    return runtime.promiseResult(promise).getObject(runtime).getProperty(runtime, "message").getString(runtime).utf8(runtime);
+  }
+
+  void TearDown() override {
+    jsInvoker->flush();
+    // What YeetJSIModuleRegistry does on the JS thread before the runtime goes away.
+    react::LongLivedObjectCollection::get().clear();
+  }
+};
+
+TEST_F(YeetNativePromiseTest, ResolvesOnTheJSThreadWithTheConvertedValue) {
+  std::shared_ptr<NativePromise<Size>> nativePromise;
+  jsi::Value promise = createPromise(nativePromise);
+  ASSERT_NE(nativePromise, nullptr);
+  EXPECT_EQ(runtime.promiseState(promise), YeetTestRuntime::PromiseState::pending);
+
+  nativePromise->resolve({ 320, 240 });
+
+  // Nothing touches JS until the JS thread runs the queued work.
+  EXPECT_EQ(conversions, 0);
+  EXPECT_EQ(runtime.promiseState(promise), YeetTestRuntime::PromiseState::pending);
+
+  EXPECT_EQ(jsInvoker->flush(), 1u);
+  EXPECT_EQ(conversions, 1);
+  ASSERT_EQ(runtime.promiseState(promise), YeetTestRuntime::PromiseState::fulfilled);
+
+  jsi::Object result = runtime.promiseResult(promise).getObject(runtime);
+  EXPECT_EQ(result.getProperty(runtime, "width").getNumber(), 320);
+  EXPECT_EQ(result.getProperty(runtime, "height").getNumber(), 240);
+}
+
+TEST_F(YeetNativePromiseTest, RejectsWithAnError) {
+  std::shared_ptr<NativePromise<Size>> nativePromise;
+  jsi::Value promise = createPromise(nativePromise);
+
+  nativePromise->reject("No video track");
+  jsInvoker->flush();
+
+  ASSERT_EQ(runtime.promiseState(promise), YeetTestRuntime::PromiseState::rejected);
+  EXPECT_EQ(rejection(promise), "No video track");
+  EXPECT_EQ(conversions, 0);
+}
+
+TEST_F(YeetNativePromiseTest, OnlyTheFirstSettleCounts) {
+  std::shared_ptr<NativePromise<Size>> nativePromise;
+  jsi::Value promise = createPromise(nativePromise);
+
+  nativePromise->resolve({ 1, 1 });
+  nativePromise->resolve({ 2, 2 });
+  nativePromise->reject("too late");
+  EXPECT_EQ(jsInvoker->pending(), 1u);
+
+  jsInvoker->flush();
+  EXPECT_EQ(conversions, 1);
+  ASSERT_EQ(runtime.promiseState(promise), YeetTestRuntime::PromiseState::fulfilled);
+  EXPECT_EQ(runtime.promiseResult(promise).getObject(runtime).getProperty(runtime, "width").getNumber(), 1);
+
+  // Once it's settled, releasing it doesn't reject it.
+  nativePromise = nullptr;
+  EXPECT_EQ(jsInvoker->pending(), 0u);
+}
+
+TEST_F(YeetNativePromiseTest, RejectFirstWins) {
+  std::shared_ptr<NativePromise<Size>> nativePromise;
+  jsi::Value promise = createPromise(nativePromise);
+
+  nativePromise->reject("cancelled");
+  nativePromise->resolve({ 1, 1 });
+  EXPECT_EQ(jsInvoker->pending(), 1u);
+
+  jsInvoker->flush();
+  EXPECT_EQ(conversions, 0);
+  ASSERT_EQ(runtime.promiseState(promise), YeetTestRuntime::PromiseState::rejected);
+  EXPECT_EQ(rejection(promise), "cancelled");
+}
+
+TEST_F(YeetNativePromiseTest, ReleasingAnUnsettledPromiseRejectsIt) {
+  std::shared_ptr<NativePromise<Size>> nativePromise;
+  jsi::Value promise = createPromise(nativePromise);
+
+  nativePromise = nullptr;
+  jsInvoker->flush();
+
+  ASSERT_EQ(runtime.promiseState(promise), YeetTestRuntime::PromiseState::rejected);
+  EXPECT_EQ(rejection(promise), "The native promise was released without being settled");
+}
+
+TEST_F(YeetNativePromiseTest, RacingThreadsSettleItOnce) {
+  for (int round = 0; round < 50; round++) {
+    std::shared_ptr<NativePromise<Size>> nativePromise;
+    jsi::Value promise = createPromise(nativePromise);
+
+    std::atomic<bool> go { false };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; i++) {
+      threads.emplace_back([&, i]() {
+        while (!go) {
+          std::this_thread::yield();
+        }
+        if (i % 2 == 0) {
+          nativePromise->resolve({ (double)i, (double)i });
+        } else {
+          nativePromise->reject("thread " + std::to_string(i));
+        }
+      });
+    }
+
+    go = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    EXPECT_EQ(jsInvoker->pending(), 1u);
+    jsInvoker->flush();
+    EXPECT_NE(runtime.promiseState(promise), YeetTestRuntime::PromiseState::pending);
+  }
+}
+
+TEST_F(YeetNativePromiseTest, SettlingAfterTheRuntimeIsTornDownDoesNothing) {
+  std::shared_ptr<NativePromise<Size>> nativePromise;
+  jsi::Value promise = createPromise(nativePromise);
+
+  react::LongLivedObjectCollection::get().clear();
+  nativePromise->resolve({ 1, 1 });
+  EXPECT_EQ(jsInvoker->flush(), 1u);
+
+  EXPECT_EQ(conversions, 0);
+  EXPECT_EQ(runtime.promiseState(promise), YeetTestRuntime::PromiseState::pending);
+}
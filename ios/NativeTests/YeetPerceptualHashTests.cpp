@@ -0,0 +1,140 @@
+//
+//  YeetPerceptualHashTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetPerceptualHash.h"
+#include <opencv2/imgproc/imgproc.hpp>
+#include <algorithm>
+#include <random>
+
+// A gradient with a few filled ellipses, different for every seed.
+static cv::Mat scene(unsigned seed, int width = 320, int height = 240) {
+  std::mt19937 random(seed);
+  auto uniform = [&random](int low, int high) {
+    return std::uniform_int_distribution<int>(low, high)(random);
+  };
+
+  cv::Mat image(height, width, CV_8UC4);
+  for (int y = 0; y < height; y++) {
+    image.row(y).setTo(cv::Scalar(40 + y * 100 / height, 70, 150 - y * 80 / height, 255));
+  }
+  for (int s = 0; s < 6; s++) {
+    const cv::Scalar color(uniform(30, 200), uniform(30, 200), uniform(30, 200), 255);
+    const cv::Point center(uniform(0, width), uniform(0, height));
+    const cv::Size axes(uniform(width / 16, width / 4), uniform(height / 16, height / 4));
+    cv::ellipse(image, center, axes, uniform(0, 180), 0, 360, color, cv::FILLED);
+  }
+  return image;
+}
+
+// pHash spelled out with cv::dct on the whole thumbnail.
+static uint64_t referencePerceptualHash(const cv::Mat &image) {
+  cv::Mat gray, thumbnail, pixels, spectrum;
+  cv::cvtColor(image, gray, cv::COLOR_RGBA2GRAY);
+  cv::resize(gray, thumbnail, cv::Size(32, 32), 0, 0, cv::INTER_AREA);
+  thumbnail.convertTo(pixels, CV_32F);
+  cv::dct(pixels, spectrum);
+
+  std::vector<float> coefficients;
+  for (int u = 0; u < 8; u++) {
+    for (int v = 0; v < 8; v++) {
+      coefficients.push_back(spectrum.at<float>(u, v));
+    }
+  }
+
+  std::vector<float> sorted(coefficients.begin() + 1, coefficients.end());
+  std::sort(sorted.begin(), sorted.end());
+  const float median = sorted[sorted.size() / 2];
+
+  uint64_t hash = 0;
+  for (size_t i = 1; i < coefficients.size(); i++) {
+    hash = (hash << 1) | (coefficients[i] > median ? 1 : 0);
+  }
+  return hash;
+}
+
+TEST(YeetPerceptualHash, MatchesAFullDCT) {
+  for (unsigned seed = 1; seed <= 8; seed++) {
+    const cv::Mat image = scene(seed);
+    // Only the 8x8 corner is computed, in a different order, so a coefficient sitting right on the
+    // median could round to the other side.
+    EXPECT_LE(yeetHammingDistance(yeetPerceptualHash(image), referencePerceptualHash(image)), 1) << seed;
+  }
+}
+
+TEST(YeetPerceptualHash, LeavesOutTheDCCoefficient) {
+  for (unsigned seed = 1; seed <= 8; seed++) {
+    const uint64_t hash = yeetPerceptualHash(scene(seed));
+    EXPECT_EQ(hash >> 63, 0u) << seed;
+    // 63 bits split at their median.
+    EXPECT_EQ(__builtin_popcountll(hash), 31) << seed;
+  }
+}
+
+TEST(YeetPerceptualHash, IgnoresUniformBrightnessChanges) {
+  for (unsigned seed = 1; seed <= 8; seed++) {
+    const cv::Mat image = scene(seed);
+    cv::Mat brighter, darker;
+    cv::add(image, cv::Scalar(40, 40, 40, 0), brighter);
+    cv::subtract(image, cv::Scalar(30, 30, 30, 0), darker);
+
+    const uint64_t hash = yeetPerceptualHash(image);
+    EXPECT_LE(yeetHammingDistance(hash, yeetPerceptualHash(brighter)), 2) << seed;
+    EXPECT_LE(yeetHammingDistance(hash, yeetPerceptualHash(darker)), 2) << seed;
+  }
+}
+
+TEST(YeetPerceptualHash, NearDuplicatesAreCloseAndOtherImagesAreNot) {
+  for (unsigned seed = 1; seed <= 5; seed++) {
+    const cv::Mat image = scene(seed);
+    cv::Mat smaller, blurred;
+    cv::resize(image, smaller, cv::Size(160, 120), 0, 0, cv::INTER_AREA);
+    cv::GaussianBlur(image, blurred, cv::Size(5, 5), 0);
+
+    const uint64_t hash = yeetPerceptualHash(image);
+    EXPECT_LE(yeetHammingDistance(hash, yeetPerceptualHash(smaller)), 4) << seed;
+    EXPECT_LE(yeetHammingDistance(hash, yeetPerceptualHash(blurred)), 4) << seed;
+    EXPECT_LE(yeetHammingDistance(yeetDifferenceHash(image), yeetDifferenceHash(smaller)), 6) << seed;
+
+    for (unsigned other = 10; other < 30; other++) {
+      EXPECT_GT(yeetHammingDistance(hash, yeetPerceptualHash(scene(other))), 12) << seed << " vs " << other;
+    }
+  }
+}
+
+TEST(YeetPerceptualHash, AcceptsGrayAndColor) {
+  const cv::Mat image = scene(3);
+  cv::Mat gray, rgb;
+  cv::cvtColor(image, gray, cv::COLOR_RGBA2GRAY);
+  cv::cvtColor(image, rgb, cv::COLOR_RGBA2RGB);
+
+  EXPECT_EQ(yeetPerceptualHash(gray), yeetPerceptualHash(image));
+  EXPECT_EQ(yeetPerceptualHash(rgb), yeetPerceptualHash(image));
+  EXPECT_EQ(yeetDifferenceHash(gray), yeetDifferenceHash(image));
+
+  EXPECT_EQ(yeetPerceptualHash(cv::Mat()), 0u);
+  EXPECT_EQ(yeetDifferenceHash(cv::Mat()), 0u);
+}
+
+TEST(YeetPerceptualHash, HexRoundTrips) {
+  for (uint64_t hash : {0ull, 1ull, 0x0123456789abcdefull, 0xffffffffffffffffull}) {
+    const std::string hex = yeetHashToHex(hash);
+    EXPECT_EQ(hex.size(), 16u);
+
+    uint64_t parsed = 0;
+    ASSERT_TRUE(yeetHashFromHex(hex, parsed)) << hex;
+    EXPECT_EQ(parsed, hash);
+  }
+
+  uint64_t parsed = 0;
+  EXPECT_TRUE(yeetHashFromHex("ABC", parsed));
+  EXPECT_EQ(parsed, 0xabcu);
+  EXPECT_FALSE(yeetHashFromHex("", parsed));
+  EXPECT_FALSE(yeetHashFromHex("0123456789abcdef0", parsed));
+  EXPECT_FALSE(yeetHashFromHex("12g4", parsed));
+}
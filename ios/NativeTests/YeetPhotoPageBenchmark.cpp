@@ -0,0 +1,87 @@
+//
+//  YeetPhotoPageBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "YeetPhotoPage.h"
+#include "YeetTestRuntime.h"
+
+// Compares handing JS a page of rows built up front, the way getPhotos did before, with the
+// YeetPhotoPageHostObject that builds a row when it's indexed. A grid only reads the rows that
+// are on screen, so the benchmark reads the first `visible` of them.
+
+static std::shared_ptr<YeetPhotoPage> makePage(size_t count, size_t &detailsLoaded) {
+  auto page = std::make_shared<YeetPhotoPage>();
+  page->reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    page->push_back("5A1B2C3D-4E5F-6789-ABCD-EF01234567" + std::to_string(i % 100) + "/L0/001", 3024, 4032, i % 7 ? 0 : 14.2,
+                    i % 7 ? YeetPhotoMediaType::image : YeetPhotoMediaType::video);
+  }
+
+  page->loadDetails = [&detailsLoaded](size_t index) {
+    detailsLoaded++;
+    return YeetPhotoDetails { "IMG_" + std::to_string(index) + ".HEIC", "image/heic", "1584835200" };
+  };
+  return page;
+}
+
+template <typename Run>
+static double microsecondsPerPage(size_t iterations, Run &&run) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    run();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+}
+
+int main(int argc, char **argv) {
+  const size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000;
+  const size_t visible = argc > 2 ? strtoul(argv[2], nullptr, 10) : 24;
+  const size_t iterations = 200;
+
+  YeetTestRuntime runtime;
+  size_t eagerDetails = 0;
+  size_t lazyDetails = 0;
+  auto eagerPage = makePage(count, eagerDetails);
+  auto lazyPage = makePage(count, lazyDetails);
+
+  jsi::Object firstEager = eagerPage->row(runtime, visible - 1);
+  jsi::Object firstLazy = jsi::Object::createFromHostObject(runtime, std::make_shared<YeetPhotoPageHostObject>(lazyPage))
+                            .getProperty(runtime, std::to_string(visible - 1).c_str()).getObject(runtime);
+  if (firstEager.getProperty(runtime, "filename").getString(runtime).utf8(runtime) !=
+      firstLazy.getProperty(runtime, "filename").getString(runtime).utf8(runtime)) {
+    fprintf(stderr, "the host object and the eager rows disagree\n");
+    return 1;
+  }
+  eagerDetails = 0;
+  lazyDetails = 0;
+
+  double eager = microsecondsPerPage(iterations, [&]() {
+    jsi::Array rows(runtime, count);
+    for (size_t i = 0; i < count; i++) {
+      rows.setValueAtIndex(runtime, i, eagerPage->row(runtime, i));
+    }
+    for (size_t i = 0; i < visible; i++) {
+      rows.getValueAtIndex(runtime, i);
+    }
+  });
+
+  double lazy = microsecondsPerPage(iterations, [&]() {
+    jsi::Object rows = jsi::Object::createFromHostObject(runtime, std::make_shared<YeetPhotoPageHostObject>(lazyPage));
+    for (size_t i = 0; i < visible; i++) {
+      rows.getProperty(runtime, std::to_string(i).c_str());
+    }
+  });
+
+  printf("%zu assets per page, %zu read\n", count, visible);
+  printf("rows built up front:  %9.1f us/page, %6zu details loaded/page\n", eager, eagerDetails / iterations);
+  printf("YeetPhotoPage rows:   %9.1f us/page, %6zu details loaded/page\n", lazy, lazyDetails / iterations);
+  return 0;
+}
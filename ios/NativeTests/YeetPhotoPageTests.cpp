@@ -0,0 +1,104 @@
+//
+//  YeetPhotoPageTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetPhotoPage.h"
+#include "YeetTestRuntime.h"
+
+class YeetPhotoPageTest : public testing::Test {
+protected:
+  YeetTestRuntime runtime;
+  std::shared_ptr<YeetPhotoPage> page = std::make_shared<YeetPhotoPage>();
+  std::vector<size_t> detailsLoaded;
+
+  void SetUp() override {
+    page->reserve(3);
+    page->push_back("A1", 1080, 1920, 0, YeetPhotoMediaType::image);
+    page->push_back("B2", 720, 1280, 12.5, YeetPhotoMediaType::video);
+    page->push_back("C3", 0, 0, 3, YeetPhotoMediaType::audio);
+
+    page->loadDetails = [this](size_t index) {
+      detailsLoaded.push_back(index);
+
+      YeetPhotoDetails details;
+      if (index == 1) {
+        details.filename = "IMG_0002.MOV";
+        details.mimeType = "video/quicktime";
+        details.timestamp = "1584835200";
+      }
+      return details;
+    };
+  }
+
+  std::string string(const jsi::Object &object, const char *name) {
+    return object.getProperty(runtime, name).getString(runtime).utf8(runtime);
+  }
+};
+
+TEST_F(YeetPhotoPageTest, BuildsTheCameraRollRow) {
+  jsi::Object row = page->row(runtime, 1);
+
+  EXPECT_EQ(string(row, "uri"), "ph://B2");
+  EXPECT_EQ(row.getProperty(runtime, "width").getNumber(), 720);
+  EXPECT_EQ(row.getProperty(runtime, "height").getNumber(), 1280);
+  EXPECT_EQ(row.getProperty(runtime, "duration").getNumber(), 12.5);
+  EXPECT_EQ(string(row, "filename"), "IMG_0002.MOV");
+  EXPECT_EQ(string(row, "mimeType"), "video/quicktime");
+  EXPECT_EQ(string(row, "timestamp"), "1584835200");
+  EXPECT_EQ(string(row, "mediaType"), "video");
+}
+
+TEST_F(YeetPhotoPageTest, MissingDetailsAreNull) {
+  jsi::Object row = page->row(runtime, 0);
+  EXPECT_TRUE(row.getProperty(runtime, "filename").isNull());
+  EXPECT_TRUE(row.getProperty(runtime, "mimeType").isNull());
+  EXPECT_TRUE(row.getProperty(runtime, "timestamp").isNull());
+  EXPECT_EQ(string(row, "mediaType"), "image");
+
+  page->loadDetails = nullptr;
+  jsi::Object withoutDetails = page->row(runtime, 2);
+  EXPECT_TRUE(withoutDetails.getProperty(runtime, "filename").isNull());
+  EXPECT_EQ(string(withoutDetails, "mediaType"), "audio");
+}
+
+TEST_F(YeetPhotoPageTest, OnlyRowsThatAreReadLoadTheirDetails) {
+  jsi::Object object = jsi::Object::createFromHostObject(runtime, std::make_shared<YeetPhotoPageHostObject>(page));
+
+  EXPECT_EQ(object.getProperty(runtime, "length").getNumber(), 3);
+  EXPECT_TRUE(detailsLoaded.empty());
+
+  jsi::Value row = object.getProperty(runtime, "2");
+  ASSERT_TRUE(row.isObject());
+  EXPECT_EQ(string(row.getObject(runtime), "uri"), "ph://C3");
+  EXPECT_EQ(detailsLoaded, std::vector<size_t>({2}));
+}
+
+TEST_F(YeetPhotoPageTest, AnswersLikeAnArray) {
+  jsi::Object object = jsi::Object::createFromHostObject(runtime, std::make_shared<YeetPhotoPageHostObject>(page));
+
+  for (const char *name : {"3", "100", "-1", "1.5", "1a", "", "map", "uri"}) {
+    EXPECT_TRUE(object.getProperty(runtime, name).isUndefined()) << name;
+  }
+  EXPECT_TRUE(detailsLoaded.empty());
+
+  jsi::Array names = object.getPropertyNames(runtime);
+  ASSERT_EQ(names.size(runtime), 4u);
+  EXPECT_EQ(names.getValueAtIndex(runtime, 0).getString(runtime).utf8(runtime), "length");
+  for (size_t i = 0; i < 3; i++) {
+    EXPECT_EQ(names.getValueAtIndex(runtime, i + 1).getString(runtime).utf8(runtime), std::to_string(i));
+  }
+}
+
+TEST_F(YeetPhotoPageTest, EmptyPage) {
+  auto empty = std::make_shared<YeetPhotoPage>();
+  jsi::Object object = jsi::Object::createFromHostObject(runtime, std::make_shared<YeetPhotoPageHostObject>(empty));
+
+  EXPECT_EQ(object.getProperty(runtime, "length").getNumber(), 0);
+  EXPECT_TRUE(object.getProperty(runtime, "0").isUndefined());
+  EXPECT_EQ(object.getPropertyNames(runtime).size(runtime), 1u);
+}
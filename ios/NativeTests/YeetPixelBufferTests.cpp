@@ -0,0 +1,171 @@
+//
+//  YeetPixelBufferTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetPixelBuffer.h"
+#include <vector>
+
+static const int YeetTestWidth = 5;
+static const int YeetTestHeight = 3;
+// Padded past width * 4, the way CoreGraphics rounds bytesPerRow up.
+static const size_t YeetTestBytesPerRow = 32;
+
+// Pixel (x, y) is {x, y, 10 + x + y, 200} in memory order. Padding bytes are 0xEE.
+static std::vector<uint8_t> paddedPixels() {
+  std::vector<uint8_t> pixels(YeetTestBytesPerRow * YeetTestHeight, 0xEE);
+  for (int y = 0; y < YeetTestHeight; y++) {
+    for (int x = 0; x < YeetTestWidth; x++) {
+      uint8_t *pixel = &pixels[y * YeetTestBytesPerRow + x * 4];
+      pixel[0] = (uint8_t)x;
+      pixel[1] = (uint8_t)y;
+      pixel[2] = (uint8_t)(10 + x + y);
+      pixel[3] = 200;
+    }
+  }
+  return pixels;
+}
+
+TEST(YeetPixelBuffer, ViewsPaddedRowsWithoutCopying) {
+  std::vector<uint8_t> pixels = paddedPixels();
+  YeetPixelBuffer buffer = YeetPixelBuffer::borrow(pixels.data(), YeetTestWidth, YeetTestHeight, YeetTestBytesPerRow, YeetPixelFormat::RGBA, nullptr);
+  ASSERT_FALSE(buffer.empty());
+  EXPECT_EQ(buffer.length(), YeetTestBytesPerRow * YeetTestHeight);
+
+  cv::Mat view = buffer.view();
+  EXPECT_EQ(view.data, pixels.data());
+  EXPECT_EQ(view.cols, YeetTestWidth);
+  EXPECT_EQ(view.rows, YeetTestHeight);
+  EXPECT_EQ(view.step[0], YeetTestBytesPerRow);
+  EXPECT_EQ(view.type(), CV_8UC4);
+  EXPECT_FALSE(view.isContinuous());
+
+  for (int y = 0; y < YeetTestHeight; y++) {
+    for (int x = 0; x < YeetTestWidth; x++) {
+      const cv::Vec4b &pixel = view.at<cv::Vec4b>(y, x);
+      EXPECT_EQ(pixel[0], x);
+      EXPECT_EQ(pixel[1], y);
+      EXPECT_EQ(pixel[2], 10 + x + y);
+      EXPECT_EQ(pixel[3], 200);
+    }
+  }
+}
+
+TEST(YeetPixelBuffer, RGBABuffersAreReturnedAsIs) {
+  std::vector<uint8_t> pixels = paddedPixels();
+  YeetPixelBuffer buffer = YeetPixelBuffer::borrow(pixels.data(), YeetTestWidth, YeetTestHeight, YeetTestBytesPerRow, YeetPixelFormat::RGBA, nullptr);
+
+  cv::Mat scratch;
+  cv::Mat rgba = yeetPixelBufferRGBA(buffer, scratch);
+  EXPECT_EQ(rgba.data, pixels.data());
+  EXPECT_TRUE(scratch.empty());
+}
+
+TEST(YeetPixelBuffer, BGRAIsSwizzledIntoScratch) {
+  std::vector<uint8_t> pixels = paddedPixels();
+  const std::vector<uint8_t> original = pixels;
+  YeetPixelBuffer buffer = YeetPixelBuffer::borrow(pixels.data(), YeetTestWidth, YeetTestHeight, YeetTestBytesPerRow, YeetPixelFormat::BGRA, nullptr);
+
+  cv::Mat scratch;
+  cv::Mat rgba = yeetPixelBufferRGBA(buffer, scratch);
+  ASSERT_FALSE(scratch.empty());
+  EXPECT_EQ(rgba.data, scratch.data);
+  EXPECT_EQ(rgba.cols, YeetTestWidth);
+  EXPECT_EQ(rgba.rows, YeetTestHeight);
+
+  for (int y = 0; y < YeetTestHeight; y++) {
+    for (int x = 0; x < YeetTestWidth; x++) {
+      const cv::Vec4b &pixel = rgba.at<cv::Vec4b>(y, x);
+      EXPECT_EQ(pixel[0], 10 + x + y);
+      EXPECT_EQ(pixel[1], y);
+      EXPECT_EQ(pixel[2], x);
+      EXPECT_EQ(pixel[3], 200);
+    }
+  }
+
+  // The source isn't touched, padding included.
+  EXPECT_EQ(pixels, original);
+
+  // Same size again reuses scratch.
+  const uchar *scratchData = scratch.data;
+  yeetPixelBufferRGBA(buffer, scratch);
+  EXPECT_EQ(scratch.data, scratchData);
+}
+
+TEST(YeetPixelBuffer, BorrowRejectsRowsShorterThanTheWidth) {
+  std::vector<uint8_t> pixels(YeetTestBytesPerRow * YeetTestHeight);
+
+  EXPECT_TRUE(YeetPixelBuffer::borrow(pixels.data(), YeetTestWidth, YeetTestHeight, YeetTestWidth * 4 - 1, YeetPixelFormat::RGBA, nullptr).empty());
+  EXPECT_TRUE(YeetPixelBuffer::borrow(pixels.data(), 8, YeetTestHeight, 31, YeetPixelFormat::RGBA, nullptr).empty());
+  EXPECT_TRUE(YeetPixelBuffer::borrow(nullptr, YeetTestWidth, YeetTestHeight, YeetTestBytesPerRow, YeetPixelFormat::RGBA, nullptr).empty());
+
+  YeetPixelBuffer tight = YeetPixelBuffer::borrow(pixels.data(), YeetTestWidth, YeetTestHeight, YeetTestWidth * 4, YeetPixelFormat::RGBA, nullptr);
+  EXPECT_FALSE(tight.empty());
+  EXPECT_TRUE(tight.view().isContinuous());
+
+  EXPECT_TRUE(YeetPixelBuffer().view().empty());
+}
+
+TEST(YeetPixelBuffer, OwnerLivesAsLongAsAnyCopy) {
+  bool released = false;
+  auto pixels = new std::vector<uint8_t>(paddedPixels());
+  std::shared_ptr<void> owner(pixels, [&released](void *pixels) {
+    released = true;
+    delete static_cast<std::vector<uint8_t> *>(pixels);
+  });
+
+  YeetPixelBuffer copy;
+  {
+    YeetPixelBuffer buffer = YeetPixelBuffer::borrow(pixels->data(), YeetTestWidth, YeetTestHeight, YeetTestBytesPerRow, YeetPixelFormat::RGBA, std::move(owner));
+    copy = buffer;
+  }
+
+  EXPECT_FALSE(released);
+  EXPECT_EQ(copy.view().at<cv::Vec4b>(2, 4)[2], 16);
+
+  copy = YeetPixelBuffer();
+  EXPECT_TRUE(released);
+}
+
+TEST(YeetPixelBuffer, AdoptKeepsPixelsAliveAfterTheMatIsReleased) {
+  cv::Mat mat(YeetTestHeight, YeetTestWidth, CV_8UC4, cv::Scalar(1, 2, 3, 4));
+  mat.at<cv::Vec4b>(1, 2) = cv::Vec4b(9, 8, 7, 6);
+  const uchar *data = mat.data;
+
+  YeetPixelBuffer buffer = YeetPixelBuffer::adopt(mat, YeetPixelFormat::BGRA);
+  mat.release();
+  // Reallocating the same variable mustn't land on the adopted pixels either.
+  mat = cv::Mat(YeetTestHeight, YeetTestWidth, CV_8UC4, cv::Scalar(0, 0, 0, 0));
+
+  ASSERT_FALSE(buffer.empty());
+  EXPECT_EQ(buffer.data, data);
+  EXPECT_EQ(buffer.format, YeetPixelFormat::BGRA);
+  EXPECT_EQ(buffer.view().at<cv::Vec4b>(1, 2), cv::Vec4b(9, 8, 7, 6));
+  EXPECT_EQ(buffer.view().at<cv::Vec4b>(0, 0), cv::Vec4b(1, 2, 3, 4));
+}
+
+TEST(YeetPixelBuffer, AdoptKeepsTheStrideOfAnROI) {
+  cv::Mat mat(10, 10, CV_8UC4, cv::Scalar(0, 0, 0, 255));
+  cv::Mat roi = mat(cv::Rect(2, 3, 4, 5));
+  roi.setTo(cv::Scalar(50, 60, 70, 255));
+
+  YeetPixelBuffer buffer = YeetPixelBuffer::adopt(roi, YeetPixelFormat::RGBA);
+  mat.release();
+  roi.release();
+
+  ASSERT_FALSE(buffer.empty());
+  EXPECT_EQ(buffer.width, 4);
+  EXPECT_EQ(buffer.height, 5);
+  EXPECT_EQ(buffer.bytesPerRow, 40u);
+  EXPECT_EQ(buffer.view().at<cv::Vec4b>(4, 3), cv::Vec4b(50, 60, 70, 255));
+}
+
+TEST(YeetPixelBuffer, AdoptOnlyTakesFourChannelBytes) {
+  EXPECT_TRUE(YeetPixelBuffer::adopt(cv::Mat(), YeetPixelFormat::RGBA).empty());
+  EXPECT_TRUE(YeetPixelBuffer::adopt(cv::Mat(4, 4, CV_8UC3, cv::Scalar(0)), YeetPixelFormat::RGBA).empty());
+  EXPECT_TRUE(YeetPixelBuffer::adopt(cv::Mat(4, 4, CV_32FC1, cv::Scalar(0)), YeetPixelFormat::RGBA).empty());
+}
@@ -0,0 +1,84 @@
+//
+//  YeetQuadGeometryBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <opencv2/imgproc/imgproc.hpp>
+#include "YeetQuadGeometry.h"
+
+// Times ordering a frame's worth of squares, and refining them with one cornerSubPix call against
+// one call per quad.
+
+template <typename Run>
+static double microsecondsPerFrame(int iterations, Run &&run) {
+  run();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    run();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+}
+
+int main(int argc, char **argv) {
+  const int count = argc > 1 ? atoi(argv[1]) : 64;
+  const int iterations = argc > 2 ? atoi(argv[2]) : 1000;
+
+  // Bright rectangles on a dark background, each detected a couple of pixels off, in a random
+  // winding and starting corner like findContours would produce.
+  std::mt19937 random(1);
+  cv::Mat gray(1440, 1080, CV_8UC1, cv::Scalar(30));
+  std::vector<YeetSquare> squares;
+  for (int i = 0; i < count; i++) {
+    const int x = 20 + (int)(random() % 900);
+    const int y = 20 + (int)(random() % 1250);
+    const int width = 40 + (int)(random() % 120);
+    const int height = 40 + (int)(random() % 120);
+    gray(cv::Rect(x, y, width, height)).setTo(cv::Scalar(120 + i % 100));
+
+    YeetSquare square = {cv::Point(x, y), cv::Point(x + width, y), cv::Point(x + width, y + height), cv::Point(x, y + height)};
+    for (auto &point : square) {
+      point.x += (int)(random() % 5) - 2;
+      point.y += (int)(random() % 5) - 2;
+    }
+    std::rotate(square.begin(), square.begin() + random() % 4, square.end());
+    if (random() % 2) {
+      std::reverse(square.begin(), square.end());
+    }
+    squares.push_back(square);
+  }
+  cv::GaussianBlur(gray, gray, cv::Size(3, 3), 0);
+
+  std::vector<YeetQuad> quads;
+  double order = microsecondsPerFrame(iterations, [&]() {
+    yeetQuadsFromSquares(squares, cv::Mat(), quads);
+  });
+
+  std::vector<YeetQuad> ordered = quads;
+  double batch = microsecondsPerFrame(iterations, [&]() {
+    quads = ordered;
+    yeetRefineQuadCorners(gray, quads);
+  });
+
+  std::vector<YeetQuad> single(1);
+  double perQuad = microsecondsPerFrame(iterations, [&]() {
+    for (const auto &quad : ordered) {
+      single[0] = quad;
+      yeetRefineQuadCorners(gray, single);
+    }
+  });
+
+  printf("%d squares per frame, %d iterations\n", count, iterations);
+  printf("order:                 %9.3f us/frame  %7.1f ns/square\n", order, order * 1000 / count);
+  printf("refine, one batch:     %9.3f us/frame\n", batch);
+  printf("refine, call per quad: %9.3f us/frame\n", perQuad);
+  return 0;
+}
@@ -0,0 +1,156 @@
+//
+//  YeetQuadGeometryTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include <opencv2/imgproc/imgproc.hpp>
+#include "YeetQuadGeometry.h"
+#include <algorithm>
+
+static void expectPoint(const cv::Point2f &actual, float x, float y, float tolerance = 0) {
+  EXPECT_NEAR(actual.x, x, tolerance);
+  EXPECT_NEAR(actual.y, y, tolerance);
+}
+
+// Orders every permutation of square and checks they all agree with the first.
+static YeetQuad orderEveryPermutation(YeetSquare square) {
+  std::sort(square.begin(), square.end(), [](const cv::Point &a, const cv::Point &b) {
+    return a.y != b.y ? a.y < b.y : a.x < b.x;
+  });
+
+  YeetQuad expected;
+  EXPECT_TRUE(yeetOrderQuadCorners(square, expected));
+
+  do {
+    YeetQuad quad;
+    EXPECT_TRUE(yeetOrderQuadCorners(square, quad));
+    expectPoint(quad.topLeft, expected.topLeft.x, expected.topLeft.y);
+    expectPoint(quad.topRight, expected.topRight.x, expected.topRight.y);
+    expectPoint(quad.bottomRight, expected.bottomRight.x, expected.bottomRight.y);
+    expectPoint(quad.bottomLeft, expected.bottomLeft.x, expected.bottomLeft.y);
+  } while (std::next_permutation(square.begin(), square.end(), [](const cv::Point &a, const cv::Point &b) {
+    return a.y != b.y ? a.y < b.y : a.x < b.x;
+  }));
+
+  return expected;
+}
+
+TEST(YeetQuadGeometry, OrdersClockwiseFromTheTopLeft) {
+  YeetQuad quad = orderEveryPermutation({cv::Point(10, 20), cv::Point(110, 25), cv::Point(105, 90), cv::Point(12, 85)});
+
+  expectPoint(quad.topLeft, 10, 20);
+  expectPoint(quad.topRight, 110, 25);
+  expectPoint(quad.bottomRight, 105, 90);
+  expectPoint(quad.bottomLeft, 12, 85);
+
+  EXPECT_EQ(quad.bounds.x, 10);
+  EXPECT_EQ(quad.bounds.y, 20);
+  EXPECT_EQ(quad.bounds.width, 100);
+  EXPECT_EQ(quad.bounds.height, 70);
+}
+
+// A diamond has two corners with the smallest x + y. The one with the smaller y goes first.
+TEST(YeetQuadGeometry, BreaksTiesOnTheSmallerY) {
+  YeetQuad quad = orderEveryPermutation({cv::Point(50, 0), cv::Point(100, 50), cv::Point(50, 100), cv::Point(0, 50)});
+
+  expectPoint(quad.topLeft, 50, 0);
+  expectPoint(quad.topRight, 100, 50);
+  expectPoint(quad.bottomRight, 50, 100);
+  expectPoint(quad.bottomLeft, 0, 50);
+}
+
+// Nothing the detector should produce, but the old code read uninitialized indices on inputs like
+// these, so they have to come out the same for every input order.
+TEST(YeetQuadGeometry, DegenerateSquaresAreStillDeterministic) {
+  YeetQuad collinear = orderEveryPermutation({cv::Point(0, 0), cv::Point(10, 0), cv::Point(20, 0), cv::Point(30, 0)});
+  EXPECT_EQ(collinear.bounds.width, 30);
+  EXPECT_EQ(collinear.bounds.height, 0);
+
+  orderEveryPermutation({cv::Point(5, 5), cv::Point(5, 5), cv::Point(40, 5), cv::Point(40, 30)});
+  orderEveryPermutation({cv::Point(0, 0), cv::Point(10, 10), cv::Point(20, 20), cv::Point(10, 0)});
+
+  YeetQuad point = orderEveryPermutation({cv::Point(7, 7), cv::Point(7, 7), cv::Point(7, 7), cv::Point(7, 7)});
+  expectPoint(point.topLeft, 7, 7);
+  expectPoint(point.bottomRight, 7, 7);
+  EXPECT_EQ(point.bounds.width, 0);
+}
+
+TEST(YeetQuadGeometry, RejectsAnythingButFourPoints) {
+  YeetQuad quad;
+  quad.topLeft = cv::Point2f(-1, -1);
+
+  EXPECT_FALSE(yeetOrderQuadCorners({}, quad));
+  EXPECT_FALSE(yeetOrderQuadCorners({cv::Point(0, 0), cv::Point(1, 0), cv::Point(1, 1)}, quad));
+  EXPECT_FALSE(yeetOrderQuadCorners({cv::Point(0, 0), cv::Point(1, 0), cv::Point(1, 1), cv::Point(0, 1), cv::Point(0, 0)}, quad));
+  expectPoint(quad.topLeft, -1, -1);
+
+  std::vector<YeetQuad> quads(1);
+  yeetQuadsFromSquares({{cv::Point(0, 0), cv::Point(1, 0)}, {cv::Point(0, 0), cv::Point(9, 0), cv::Point(9, 9), cv::Point(0, 9)}}, cv::Mat(), quads);
+  ASSERT_EQ(quads.size(), 1u);
+  expectPoint(quads[0].bottomRight, 9, 9);
+}
+
+// A bright rectangle covering pixels [40, 140) x [30, 110). Its edges sit halfway between pixel
+// centers, so the corners are at (39.5, 29.5) and (139.5, 109.5).
+static cv::Mat rectangleImage() {
+  cv::Mat gray(160, 200, CV_8UC1, cv::Scalar(30));
+  gray(cv::Rect(40, 30, 100, 80)).setTo(cv::Scalar(220));
+  cv::GaussianBlur(gray, gray, cv::Size(3, 3), 0);
+  return gray;
+}
+
+TEST(YeetQuadGeometry, RefinesCornersToSubPixelAccuracy) {
+  cv::Mat gray = rectangleImage();
+
+  // What approxPolyDP hands back is usually a couple of pixels off.
+  std::vector<YeetQuad> quads;
+  yeetQuadsFromSquares({{cv::Point(42, 32), cv::Point(137, 28), cv::Point(141, 112), cv::Point(37, 107)}}, gray, quads);
+  ASSERT_EQ(quads.size(), 1u);
+
+  const YeetQuad &quad = quads[0];
+  expectPoint(quad.topLeft, 39.5f, 29.5f, 0.25f);
+  expectPoint(quad.topRight, 139.5f, 29.5f, 0.25f);
+  expectPoint(quad.bottomRight, 139.5f, 109.5f, 0.25f);
+  expectPoint(quad.bottomLeft, 39.5f, 109.5f, 0.25f);
+
+  EXPECT_NEAR(quad.bounds.x, 39.5f, 0.25f);
+  EXPECT_NEAR(quad.bounds.y, 29.5f, 0.25f);
+  EXPECT_NEAR(quad.bounds.width, 100, 0.5f);
+  EXPECT_NEAR(quad.bounds.height, 80, 0.5f);
+}
+
+// Refining a batch in one call gives the same corners as refining each quad on its own.
+TEST(YeetQuadGeometry, RefinesABatchLikeSeparateCalls) {
+  cv::Mat gray = rectangleImage();
+  const std::vector<YeetSquare> squares = {
+    {cv::Point(42, 32), cv::Point(137, 28), cv::Point(141, 112), cv::Point(37, 107)},
+    {cv::Point(38, 31), cv::Point(141, 30), cv::Point(138, 108), cv::Point(41, 111)},
+  };
+
+  std::vector<YeetQuad> batch;
+  yeetQuadsFromSquares(squares, gray, batch);
+  ASSERT_EQ(batch.size(), squares.size());
+
+  for (size_t i = 0; i < squares.size(); i++) {
+    std::vector<YeetQuad> single;
+    yeetQuadsFromSquares({squares[i]}, gray, single);
+    ASSERT_EQ(single.size(), 1u);
+
+    expectPoint(batch[i].topLeft, single[0].topLeft.x, single[0].topLeft.y);
+    expectPoint(batch[i].topRight, single[0].topRight.x, single[0].topRight.y);
+    expectPoint(batch[i].bottomRight, single[0].bottomRight.x, single[0].bottomRight.y);
+    expectPoint(batch[i].bottomLeft, single[0].bottomLeft.x, single[0].bottomLeft.y);
+  }
+}
+
+TEST(YeetQuadGeometry, SkipsRefinementWithoutAnImage) {
+  std::vector<YeetQuad> quads;
+  yeetQuadsFromSquares({{cv::Point(42, 32), cv::Point(137, 28), cv::Point(141, 112), cv::Point(37, 107)}}, cv::Mat(), quads);
+  ASSERT_EQ(quads.size(), 1u);
+  expectPoint(quads[0].topLeft, 42, 32);
+  expectPoint(quads[0].bottomLeft, 37, 107);
+}
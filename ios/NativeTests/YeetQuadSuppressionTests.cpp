@@ -0,0 +1,172 @@
+//
+//  YeetQuadSuppressionTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/21/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetQuadSuppression.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+static YeetQuad makeQuad(cv::Point2f topLeft, cv::Point2f topRight, cv::Point2f bottomRight, cv::Point2f bottomLeft) {
+  YeetQuad quad;
+  quad.topLeft = topLeft;
+  quad.topRight = topRight;
+  quad.bottomRight = bottomRight;
+  quad.bottomLeft = bottomLeft;
+  yeetUpdateQuadBounds(quad);
+  return quad;
+}
+
+static YeetQuad makeRect(float x, float y, float width, float height) {
+  return makeQuad({x, y}, {x + width, y}, {x + width, y + height}, {x, y + height});
+}
+
+static bool sameBounds(const cv::Rect2f &a, const cv::Rect2f &b) {
+  return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+// The O(n²) version of yeetSuppressQuads: every candidate is compared against every kept quad.
+static std::vector<YeetRankedQuad> bruteForceSuppress(const std::vector<YeetQuad> &candidates, YeetQuadSuppressionOptions options) {
+  const int count = (int)candidates.size();
+  std::vector<float> rectangularity(count);
+  for (int i = 0; i < count; i++) {
+    rectangularity[i] = yeetQuadRectangularity(candidates[i]);
+  }
+
+  std::vector<int> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    if (rectangularity[a] != rectangularity[b]) {
+      return rectangularity[a] > rectangularity[b];
+    }
+    return candidates[a].bounds.area() > candidates[b].bounds.area();
+  });
+
+  std::vector<int> kept;
+  std::vector<int> support(count, 0);
+  for (int candidate : order) {
+    int bestMatch = -1;
+    float bestIoU = options.iouThreshold;
+    for (int keptIndex : kept) {
+      const float iou = yeetBoundsIoU(candidates[candidate].bounds, candidates[keptIndex].bounds);
+      if (iou > bestIoU) {
+        bestIoU = iou;
+        bestMatch = keptIndex;
+      }
+    }
+
+    if (bestMatch >= 0) {
+      support[bestMatch]++;
+    } else {
+      support[candidate] = 1;
+      kept.push_back(candidate);
+    }
+  }
+
+  std::vector<YeetRankedQuad> ranked;
+  for (int index : kept) {
+    YeetRankedQuad result;
+    result.quad = candidates[index];
+    result.support = support[index];
+    result.confidence = (rectangularity[index] + std::min(1.0f, (float)support[index] / options.supportSaturation)) / 2;
+    ranked.push_back(result);
+  }
+  std::stable_sort(ranked.begin(), ranked.end(), [](const YeetRankedQuad &a, const YeetRankedQuad &b) {
+    return a.confidence > b.confidence;
+  });
+  return ranked;
+}
+
+TEST(YeetQuadSuppression, BoundsIoU) {
+  EXPECT_FLOAT_EQ(yeetBoundsIoU(cv::Rect2f(0, 0, 10, 10), cv::Rect2f(0, 0, 10, 10)), 1);
+  EXPECT_FLOAT_EQ(yeetBoundsIoU(cv::Rect2f(0, 0, 10, 10), cv::Rect2f(5, 0, 10, 10)), 50.0f / 150.0f);
+  EXPECT_EQ(yeetBoundsIoU(cv::Rect2f(0, 0, 10, 10), cv::Rect2f(10, 0, 10, 10)), 0);
+  EXPECT_EQ(yeetBoundsIoU(cv::Rect2f(0, 0, 10, 10), cv::Rect2f(20, 20, 5, 5)), 0);
+}
+
+TEST(YeetQuadSuppression, Rectangularity) {
+  EXPECT_NEAR(yeetQuadRectangularity(makeRect(10, 10, 100, 50)), 1, 1e-5);
+
+  // A parallelogram with 45° corners.
+  const float skewed = yeetQuadRectangularity(makeQuad({0, 0}, {100, 0}, {150, 50}, {50, 50}));
+  EXPECT_NEAR(skewed, 1 - std::sqrt(0.5f), 1e-4);
+}
+
+TEST(YeetQuadSuppression, MergesDuplicatesIntoTheMostRectangularOne) {
+  std::vector<YeetQuad> candidates = {
+    makeQuad({101, 100}, {200, 102}, {201, 200}, {100, 199}),
+    makeRect(100, 100, 100, 100),
+    makeQuad({99, 101}, {202, 100}, {200, 201}, {101, 198}),
+    makeRect(400, 400, 50, 50),
+  };
+
+  std::vector<YeetRankedQuad> ranked;
+  yeetSuppressQuads(candidates, ranked);
+
+  ASSERT_EQ(ranked.size(), 2u);
+  // Same rectangularity, so support decides the order.
+  EXPECT_TRUE(sameBounds(ranked[0].quad.bounds, candidates[1].bounds));
+  EXPECT_EQ(ranked[0].support, 3);
+  EXPECT_TRUE(sameBounds(ranked[1].quad.bounds, candidates[3].bounds));
+  EXPECT_EQ(ranked[1].support, 1);
+  EXPECT_FLOAT_EQ(ranked[1].confidence, (1 + 1.0f / 6) / 2);
+}
+
+TEST(YeetQuadSuppression, EmptyInput) {
+  std::vector<YeetRankedQuad> ranked(3);
+  yeetSuppressQuads({}, ranked);
+  EXPECT_TRUE(ranked.empty());
+}
+
+TEST(YeetQuadSuppression, MatchesBruteForce) {
+  std::mt19937 random(1);
+  std::uniform_real_distribution<float> position(0, 1000);
+  std::uniform_real_distribution<float> size(5, 300);
+  std::uniform_real_distribution<float> jitter(-8, 8);
+  std::uniform_real_distribution<float> threshold(0.1f, 0.9f);
+
+  for (int trial = 0; trial < 50; trial++) {
+    std::vector<YeetQuad> candidates;
+    const int count = 1 + trial * 8;
+    for (int i = 0; i < count; i++) {
+      // Half the candidates are jittered copies of an earlier one, like the detector's repeats.
+      if (i > 0 && random() % 2 == 0) {
+        const YeetQuad &source = candidates[random() % candidates.size()];
+        candidates.push_back(makeQuad(
+          source.topLeft + cv::Point2f(jitter(random), jitter(random)),
+          source.topRight + cv::Point2f(jitter(random), jitter(random)),
+          source.bottomRight + cv::Point2f(jitter(random), jitter(random)),
+          source.bottomLeft + cv::Point2f(jitter(random), jitter(random))));
+      } else {
+        const float x = position(random);
+        const float y = position(random);
+        const float width = size(random);
+        const float height = size(random);
+        candidates.push_back(makeQuad(
+          {x + jitter(random), y + jitter(random)},
+          {x + width + jitter(random), y + jitter(random)},
+          {x + width + jitter(random), y + height + jitter(random)},
+          {x + jitter(random), y + height + jitter(random)}));
+      }
+    }
+
+    YeetQuadSuppressionOptions options;
+    options.iouThreshold = threshold(random);
+
+    std::vector<YeetRankedQuad> ranked;
+    yeetSuppressQuads(candidates, ranked, options);
+    const std::vector<YeetRankedQuad> expected = bruteForceSuppress(candidates, options);
+
+    ASSERT_EQ(ranked.size(), expected.size()) << "trial " << trial;
+    for (size_t i = 0; i < ranked.size(); i++) {
+      EXPECT_TRUE(sameBounds(ranked[i].quad.bounds, expected[i].quad.bounds)) << "trial " << trial << ", quad " << i;
+      EXPECT_EQ(ranked[i].support, expected[i].support) << "trial " << trial << ", quad " << i;
+      EXPECT_FLOAT_EQ(ranked[i].confidence, expected[i].confidence) << "trial " << trial << ", quad " << i;
+    }
+  }
+}
@@ -0,0 +1,136 @@
+//
+//  YeetRectangleTrackerBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <vector>
+#include "YeetRectangleTracker.h"
+#include "YeetRectangleTrackerFixtures.h"
+
+// Plays a synthetic clip of two pages drifting across a noisy frame through YeetRectangleTracker
+// and reports:
+//
+// - FPS, split into keyframes (full detection) and flow frames, next to running the detector on
+//   every frame the way the camera path would without the tracker;
+// - how stable the output is: IDs per page (1 is perfect), frames where a page had no track, and
+//   how far the smoothed corners sit from the truth.
+
+static std::vector<YeetSyntheticPage> pagesAt(int frame, int width, int height) {
+  YeetSyntheticPage first;
+  first.center = cv::Point2f(width * 0.2f + 3.0f * frame, height * 0.3f + 30 * std::sin(frame / 8.0f));
+  first.size = cv::Size2f(width * 0.23f, height * 0.42f);
+  first.degrees = 5 + 0.1f * frame;
+
+  YeetSyntheticPage second;
+  second.center = cv::Point2f(width * 0.8f - 3.0f * frame, height * 0.78f);
+  second.size = cv::Size2f(width * 0.19f, height * 0.33f);
+  second.degrees = -6;
+  second.color = cv::Scalar(120, 200, 240, 255);
+
+  return {first, second};
+}
+
+static cv::Mat frameAt(int frame, int width, int height, std::vector<YeetSyntheticPage> &pages) {
+  pages = pagesAt(frame, width, height);
+  cv::Mat image = yeetTrackerBackground(width, height);
+  for (const auto &page : pages) {
+    yeetDrawSyntheticPage(image, page);
+  }
+
+  // Sensor noise, so optical flow and cornerSubPix don't get a perfectly clean image.
+  cv::Mat noise(height, width, CV_16SC4);
+  cv::randn(noise, cv::Scalar(0, 0, 0, 0), cv::Scalar(4, 4, 4, 0));
+  cv::Mat noisy;
+  image.convertTo(noisy, CV_16SC4);
+  noisy += noise;
+  noisy.convertTo(image, CV_8UC4);
+  return image;
+}
+
+int main(int argc, char **argv) {
+  const int width = argc > 1 ? atoi(argv[1]) : 960;
+  const int height = argc > 2 ? atoi(argv[2]) : 720;
+  const int frames = argc > 3 ? atoi(argv[3]) : 120;
+
+  cv::theRNG().state = 1;
+  std::vector<cv::Mat> clip(frames);
+  std::vector<std::vector<YeetSyntheticPage>> truth(frames);
+  for (int frame = 0; frame < frames; frame++) {
+    clip[frame] = frameAt(frame, width, height, truth[frame]);
+  }
+
+  YeetRectangleTracker tracker;
+  std::vector<std::set<int>> ids(2);
+  int missing = 0;
+  int keyframes = 0;
+  double keyframeTime = 0;
+  double flowTime = 0;
+  double errorSum = 0;
+  float maxError = 0;
+  int measurements = 0;
+
+  for (int frame = 0; frame < frames; frame++) {
+    auto start = std::chrono::steady_clock::now();
+    const std::vector<YeetTrackedQuad> &tracks = tracker.process(clip[frame]);
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    const bool keyframe = !tracks.empty() && tracks[0].detected;
+    if (keyframe || tracks.empty()) {
+      keyframes++;
+      keyframeTime += elapsed;
+    } else {
+      flowTime += elapsed;
+    }
+
+    std::vector<bool> seen(truth[frame].size(), false);
+    for (const auto &track : tracks) {
+      size_t closest = 0;
+      float closestError = INFINITY;
+      for (size_t page = 0; page < truth[frame].size(); page++) {
+        const float error = yeetQuadCornerError(track.quad, truth[frame][page].corners());
+        if (error < closestError) {
+          closest = page;
+          closestError = error;
+        }
+      }
+
+      ids[closest].insert(track.id);
+      seen[closest] = true;
+      errorSum += closestError;
+      maxError = std::max(maxError, closestError);
+      measurements++;
+    }
+
+    for (bool page : seen) {
+      missing += !page;
+    }
+  }
+
+  YeetSquareDetector detector;
+  std::vector<YeetSquare> squares;
+  auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++) {
+    detector.detect(clip[frame], squares);
+  }
+  const double detectorTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  const int flowFrames = frames - keyframes;
+  printf("%dx%d, %d frames, keyframe every %d\n", width, height, frames, YeetRectangleTrackerOptions().keyframeInterval);
+  printf("tracker:              %7.1f fps\n", frames * 1000 / (keyframeTime + flowTime));
+  printf("  keyframes:          %7.3f ms/frame (%d)\n", keyframes ? keyframeTime / keyframes : 0, keyframes);
+  printf("  flow frames:        %7.3f ms/frame (%d)\n", flowFrames ? flowTime / flowFrames : 0, flowFrames);
+  printf("detector every frame: %7.1f fps\n", frames * 1000 / detectorTime);
+  printf("IDs per page:         %zu, %zu\n", ids[0].size(), ids[1].size());
+  printf("frames missing a page: %d\n", missing);
+  printf("corner error:         %.2f px mean, %.2f px max\n", measurements ? errorSum / measurements : 0, maxError);
+  return 0;
+}
@@ -0,0 +1,76 @@
+//
+//  YeetRectangleTrackerFixtures.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include "YeetQuadGeometry.h"
+
+// A page in a synthetic video frame: a rectangle of the given size centered on center, rotated by
+// degrees. Keep |degrees| well under 45 so the corners below come out in YeetQuad's order.
+struct YeetSyntheticPage {
+  cv::Point2f center;
+  cv::Size2f size;
+  float degrees = 0;
+  cv::Scalar color = cv::Scalar(230, 220, 200, 255);
+
+  YeetQuad corners() const {
+    const float radians = degrees * (float)CV_PI / 180;
+    const float cosine = std::cos(radians);
+    const float sine = std::sin(radians);
+    auto corner = [&](float x, float y) {
+      x *= size.width / 2;
+      y *= size.height / 2;
+      return cv::Point2f(center.x + x * cosine - y * sine, center.y + x * sine + y * cosine);
+    };
+
+    YeetQuad quad;
+    quad.topLeft = corner(-1, -1);
+    quad.topRight = corner(1, -1);
+    quad.bottomRight = corner(1, 1);
+    quad.bottomLeft = corner(-1, 1);
+    yeetUpdateQuadBounds(quad);
+    return quad;
+  }
+};
+
+// An RGBA frame, dark enough that the background is below every detector threshold.
+inline cv::Mat yeetTrackerBackground(int width, int height) {
+  return cv::Mat(height, width, CV_8UC4, cv::Scalar(20, 20, 20, 255));
+}
+
+// Draws page with 1/16px precision, so corners move smoothly between frames.
+inline void yeetDrawSyntheticPage(cv::Mat &frame, const YeetSyntheticPage &page) {
+  const YeetQuad quad = page.corners();
+  const cv::Point2f corners[4] = {quad.topLeft, quad.topRight, quad.bottomRight, quad.bottomLeft};
+
+  cv::Point points[4];
+  for (int i = 0; i < 4; i++) {
+    points[i] = cv::Point(cvRound(corners[i].x * 16), cvRound(corners[i].y * 16));
+  }
+  cv::fillConvexPoly(frame, points, 4, page.color, cv::LINE_8, 4);
+}
+
+// The largest distance between matching corners, on either axis.
+inline float yeetQuadCornerError(const YeetQuad &a, const YeetQuad &b) {
+  auto error = [](const cv::Point2f &p, const cv::Point2f &q) {
+    return std::max(std::fabs(p.x - q.x), std::fabs(p.y - q.y));
+  };
+
+  return std::max(
+    std::max(error(a.topLeft, b.topLeft), error(a.topRight, b.topRight)),
+    std::max(error(a.bottomRight, b.bottomRight), error(a.bottomLeft, b.bottomLeft))
+  );
+}
+
+#endif
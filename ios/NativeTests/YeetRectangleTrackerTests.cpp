@@ -0,0 +1,145 @@
+//
+//  YeetRectangleTrackerTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetRectangleTracker.h"
+#include "YeetRectangleTrackerFixtures.h"
+
+static const int YeetTestFrameWidth = 640;
+static const int YeetTestFrameHeight = 480;
+
+// Drifting right and a little down while it turns, 3-4px a frame, like a hand-held phone.
+static YeetSyntheticPage movingPage(int frame) {
+  YeetSyntheticPage page;
+  page.center = cv::Point2f(160 + 4.0f * frame, 200 + 1.5f * frame);
+  page.size = cv::Size2f(180, 240);
+  page.degrees = 8 + 0.3f * frame;
+  return page;
+}
+
+TEST(YeetRectangleTracker, MovingPageKeepsItsID) {
+  YeetRectangleTrackerOptions options;
+  YeetRectangleTracker tracker(options);
+
+  int id = 0;
+  for (int frame = 0; frame < 60; frame++) {
+    SCOPED_TRACE(frame);
+    const YeetSyntheticPage page = movingPage(frame);
+    cv::Mat image = yeetTrackerBackground(YeetTestFrameWidth, YeetTestFrameHeight);
+    yeetDrawSyntheticPage(image, page);
+
+    const std::vector<YeetTrackedQuad> &tracks = tracker.process(image);
+    ASSERT_EQ(tracks.size(), 1u);
+
+    if (frame == 0) {
+      id = tracks[0].id;
+    }
+    EXPECT_EQ(tracks[0].id, id);
+    EXPECT_EQ(tracks[0].age, frame);
+    EXPECT_EQ(tracks[0].detected, frame % options.keyframeInterval == 0);
+
+    // Rasterizing at 1/16px and the 5px cornerSubPix window both cost a little accuracy.
+    EXPECT_LE(yeetQuadCornerError(tracks[0].measured, page.corners()), 2.5f);
+  }
+}
+
+TEST(YeetRectangleTracker, PagesKeepTheirOwnIDs) {
+  YeetRectangleTracker tracker;
+
+  int firstID = 0;
+  int secondID = 0;
+  for (int frame = 0; frame < 60; frame++) {
+    SCOPED_TRACE(frame);
+    YeetSyntheticPage first;
+    first.center = cv::Point2f(130 + 2.0f * frame, 150 + 1.0f * frame);
+    first.size = cv::Size2f(140, 180);
+    first.degrees = 5;
+
+    YeetSyntheticPage second;
+    second.center = cv::Point2f(480 - 2.0f * frame, 330 - 1.0f * frame);
+    second.size = cv::Size2f(120, 160);
+    second.degrees = -6;
+    second.color = cv::Scalar(120, 200, 240, 255);
+
+    cv::Mat image = yeetTrackerBackground(YeetTestFrameWidth, YeetTestFrameHeight);
+    yeetDrawSyntheticPage(image, first);
+    yeetDrawSyntheticPage(image, second);
+
+    const std::vector<YeetTrackedQuad> &tracks = tracker.process(image);
+    ASSERT_EQ(tracks.size(), 2u);
+
+    for (const auto &track : tracks) {
+      const bool isFirst = yeetQuadCornerError(track.measured, first.corners()) < yeetQuadCornerError(track.measured, second.corners());
+      int &id = isFirst ? firstID : secondID;
+      if (frame == 0) {
+        id = track.id;
+      }
+      EXPECT_EQ(track.id, id) << (isFirst ? "first" : "second") << " page";
+    }
+  }
+
+  EXPECT_NE(firstID, secondID);
+}
+
+// Once every track is lost the next frame is a keyframe, and whatever it finds is a new rectangle.
+TEST(YeetRectangleTracker, PageThatComesBackGetsANewID) {
+  YeetRectangleTracker tracker;
+  YeetSyntheticPage page;
+  page.size = cv::Size2f(180, 240);
+  page.degrees = 8;
+
+  int firstID = 0;
+  for (int frame = 0; frame < 25; frame++) {
+    SCOPED_TRACE(frame);
+    page.center = cv::Point2f(200 + 3.0f * frame, 220);
+    cv::Mat image = yeetTrackerBackground(YeetTestFrameWidth, YeetTestFrameHeight);
+    const bool visible = frame < 10 || frame >= 15;
+    if (visible) {
+      yeetDrawSyntheticPage(image, page);
+    }
+
+    const std::vector<YeetTrackedQuad> &tracks = tracker.process(image);
+    if (!visible) {
+      EXPECT_TRUE(tracks.empty());
+      continue;
+    }
+
+    ASSERT_EQ(tracks.size(), 1u);
+    if (frame == 0) {
+      firstID = tracks[0].id;
+    } else if (frame == 15) {
+      EXPECT_NE(tracks[0].id, firstID);
+      EXPECT_TRUE(tracks[0].detected);
+      EXPECT_EQ(tracks[0].age, 0);
+    }
+  }
+}
+
+TEST(YeetRectangleTracker, ResetStartsOverWithAKeyframe) {
+  YeetRectangleTracker tracker;
+  for (int frame = 0; frame < 3; frame++) {
+    cv::Mat image = yeetTrackerBackground(YeetTestFrameWidth, YeetTestFrameHeight);
+    yeetDrawSyntheticPage(image, movingPage(frame));
+    tracker.process(image);
+  }
+  ASSERT_EQ(tracker.tracks().size(), 1u);
+  EXPECT_FALSE(tracker.tracks()[0].detected);
+
+  tracker.reset();
+  EXPECT_TRUE(tracker.tracks().empty());
+
+  cv::Mat image = yeetTrackerBackground(YeetTestFrameWidth, YeetTestFrameHeight);
+  yeetDrawSyntheticPage(image, movingPage(3));
+  const std::vector<YeetTrackedQuad> &tracks = tracker.process(image);
+  ASSERT_EQ(tracks.size(), 1u);
+  EXPECT_TRUE(tracks[0].detected);
+  EXPECT_EQ(tracks[0].age, 0);
+
+  // Empty frames are skipped without touching the tracks.
+  EXPECT_EQ(tracker.process(cv::Mat()).size(), 1u);
+}
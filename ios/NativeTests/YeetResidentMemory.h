@@ -0,0 +1,59 @@
+//
+//  YeetResidentMemory.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+
+// Peak resident memory for the benchmarks, from /proc (Linux only).
+//
+// Benchmarks usually allocate more building their fixtures than the code under test does, so the
+// peak is reset right before the part being measured (Linux 4.0+), and compared with the resident
+// size at that moment.
+
+// A "VmHWM" (peak) or "VmRSS" (current) line of /proc/self/status, in kilobytes. 0 if unreadable.
+inline long yeetResidentKilobytes(const char *field) {
+  long kilobytes = 0;
+  FILE *file = fopen("/proc/self/status", "r");
+  if (file) {
+    const size_t length = strlen(field);
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+      if (strncmp(line, field, length) == 0 && line[length] == ':') {
+        kilobytes = atol(line + length + 1);
+        break;
+      }
+    }
+    fclose(file);
+  }
+  return kilobytes;
+}
+
+// Hands freed heap back to the system, so the next allocation shows up, then resets VmHWM to the
+// current resident size and returns that size.
+inline long yeetResetPeakResident() {
+  malloc_trim(0);
+  FILE *file = fopen("/proc/self/clear_refs", "w");
+  if (file) {
+    fputs("5", file);
+    fclose(file);
+  }
+  return yeetResidentKilobytes("VmRSS");
+}
+
+// How far the peak rose above a yeetResetPeakResident() baseline.
+inline long yeetPeakResidentGrowth(long baseline) {
+  return yeetResidentKilobytes("VmHWM") - baseline;
+}
+
+#endif
@@ -0,0 +1,120 @@
+//
+//  YeetSaliencyMapBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <opencv2/imgproc/imgproc.hpp>
+#include "YeetSaliencyMap.h"
+#include "YeetSaliencyMapFixtures.h"
+
+// Computes saliency maps for photo-sized images the way SmartCrop does (on a downscaled copy, with
+// crops reported at full size), then times the crop queries layout runs against that map: the
+// summed-area table against summing every window cell by cell. Exits non-zero if the two disagree.
+
+static const double YeetAspectRatios[] = {1.0, 4.0 / 5, 9.0 / 16, 16.0 / 9, 1.91, 2.0 / 3};
+static const double YeetZooms[] = {1.0, 0.75, 0.5};
+
+static cv::Mat makePhoto(cv::Size size, std::mt19937 &random) {
+  auto uniform = [&random](int low, int high) {
+    return std::uniform_int_distribution<int>(low, high)(random);
+  };
+
+  cv::Mat image(size, CV_8UC4);
+  for (int y = 0; y < size.height; y++) {
+    image.row(y).setTo(cv::Scalar(70 + y * 100 / size.height, 110, 150 - y * 80 / size.height, 255));
+  }
+
+  for (int s = 0; s < 4; s++) {
+    const cv::Scalar color(uniform(0, 255), uniform(0, 255), uniform(0, 255), 255);
+    const cv::Point center(uniform(0, size.width), uniform(0, size.height));
+    const cv::Size axes(uniform(size.width / 30, size.width / 8), uniform(size.height / 30, size.height / 8));
+    cv::ellipse(image, center, axes, uniform(0, 180), 0, 360, color, cv::FILLED);
+  }
+
+  const int side = std::min(size.width, size.height) / 5;
+  const cv::Rect subject(uniform(0, size.width - side), uniform(0, size.height - side), side, side);
+  yeetDrawChecker(image, subject, std::max(2, side / 6));
+  return image;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+  const int count = std::max(1, argc > 1 ? atoi(argv[1]) : 8);
+  const cv::Size sizes[] = {cv::Size(1080, 1080), cv::Size(1080, 1920), cv::Size(1920, 1080), cv::Size(4032, 3024)};
+
+  std::mt19937 random(1);
+  bool mismatch = false;
+
+  for (const cv::Size &size : sizes) {
+    std::vector<cv::Mat> photos;
+    for (int i = 0; i < count; i++) {
+      photos.push_back(makePhoto(size, random));
+    }
+
+    // SmartCrop's working size: the detectors and the map both run on a copy 512 on its longest side.
+    const double downscale = std::min(1.0, 512.0 / std::max(size.width, size.height));
+    std::vector<cv::Mat> small(count);
+    for (int i = 0; i < count; i++) {
+      cv::resize(photos[i], small[i], cv::Size(), downscale, downscale, cv::INTER_AREA);
+    }
+
+    std::vector<YeetSaliencyMap> maps(count);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+      maps[i].compute(small[i], {}, size);
+    }
+    const double computeSeconds = secondsSince(start) / count;
+
+    // Repeated so the timer sees more than a few hundred microseconds; the last pass is kept to check.
+    const int repeats = 50;
+    std::vector<cv::Rect> crops;
+    start = std::chrono::steady_clock::now();
+    for (int repeat = 0; repeat < repeats; repeat++) {
+      crops.clear();
+      for (const auto &map : maps) {
+        for (double aspectRatio : YeetAspectRatios) {
+          for (double zoom : YeetZooms) {
+            crops.push_back(map.bestCrop(aspectRatio, zoom));
+          }
+        }
+      }
+    }
+    const double querySeconds = secondsSince(start) / (repeats * crops.size());
+
+    std::vector<cv::Rect> expected;
+    start = std::chrono::steady_clock::now();
+    for (const auto &map : maps) {
+      for (double aspectRatio : YeetAspectRatios) {
+        for (double zoom : YeetZooms) {
+          expected.push_back(yeetBruteForceCrop(map, aspectRatio, zoom));
+        }
+      }
+    }
+    const double bruteSeconds = secondsSince(start) / expected.size();
+
+    for (size_t i = 0; i < crops.size(); i++) {
+      if (crops[i] != expected[i]) {
+        fprintf(stderr, "%dx%d query %zu: summed-area crop doesn't match brute force\n", size.width, size.height, i);
+        mismatch = true;
+      }
+    }
+
+    printf("%4dx%-4d map %3dx%-3d  compute %7.2f ms  crop %7.2f us  brute force %9.2f us  (%zu queries)\n",
+      size.width, size.height, maps[0].map().cols, maps[0].map().rows,
+      computeSeconds * 1e3, querySeconds * 1e6, bruteSeconds * 1e6, repeats * crops.size());
+  }
+
+  return mismatch ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+//
+//  YeetSaliencyMapFixtures.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <opencv2/core/core.hpp>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include "YeetSaliencyMap.h"
+
+// Black and white cells over rect: about as salient as a patch of image gets, for both the
+// spectral residual and the edge term.
+inline void yeetDrawChecker(cv::Mat &image, const cv::Rect &rect, int cell) {
+  for (int y = 0; y < rect.height; y += cell) {
+    for (int x = 0; x < rect.width; x += cell) {
+      const cv::Rect square = cv::Rect(rect.x + x, rect.y + y, cell, cell) & rect;
+      const bool white = ((x / cell) + (y / cell)) % 2;
+      image(square).setTo(white ? cv::Scalar(255, 255, 255, 255) : cv::Scalar(0, 0, 0, 255));
+    }
+  }
+}
+
+// YeetSaliencyMap::bestCrop without the summed-area table: every window is summed cell by cell
+// straight from map(). Same sizing, tie-breaking and rounding, so the two must agree exactly.
+inline cv::Rect yeetBruteForceCrop(const YeetSaliencyMap &saliency, double aspectRatio, double zoom = 1) {
+  const cv::Size source = saliency.sourceSize();
+  const cv::Mat &map = saliency.map();
+  const double scaleX = (double)map.cols / source.width;
+  const double scaleY = (double)map.rows / source.height;
+
+  zoom = std::max(0.01, std::min(1.0, zoom));
+  double width = source.width;
+  double height = width / aspectRatio;
+  if (height > source.height) {
+    height = source.height;
+    width = height * aspectRatio;
+  }
+
+  const int cropWidth = std::max(1, std::min(source.width, cvRound(width * zoom)));
+  const int cropHeight = std::max(1, std::min(source.height, cvRound(height * zoom)));
+  const int windowWidth = std::max(1, std::min(map.cols, cvRound(cropWidth * scaleX)));
+  const int windowHeight = std::max(1, std::min(map.rows, cvRound(cropHeight * scaleY)));
+  const int lastX = map.cols - windowWidth;
+  const int lastY = map.rows - windowHeight;
+  const double tolerance = 1e-6 * std::max(1.0, cv::sum(map)[0]);
+
+  int bestX = 0;
+  int bestY = 0;
+  double bestSum = -1;
+  int bestDistance = INT_MAX;
+  for (int y = 0; y <= lastY; y++) {
+    for (int x = 0; x <= lastX; x++) {
+      double windowSum = 0;
+      for (int row = y; row < y + windowHeight; row++) {
+        const float *cells = map.ptr<float>(row);
+        for (int column = x; column < x + windowWidth; column++) {
+          windowSum += cells[column];
+        }
+      }
+
+      const int distance = std::abs(2 * y - lastY) + std::abs(2 * x - lastX);
+      if (windowSum > bestSum + tolerance || (windowSum >= bestSum - tolerance && distance < bestDistance)) {
+        bestSum = std::max(bestSum, windowSum);
+        bestDistance = distance;
+        bestX = x;
+        bestY = y;
+      }
+    }
+  }
+
+  const int x = std::max(0, std::min(source.width - cropWidth, cvRound(bestX / scaleX)));
+  const int y = std::max(0, std::min(source.height - cropHeight, cvRound(bestY / scaleY)));
+  return cv::Rect(x, y, cropWidth, cropHeight);
+}
+
+#endif
@@ -0,0 +1,213 @@
+//
+//  YeetSaliencyMapTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetSaliencyMap.h"
+#include "YeetSaliencyMapFixtures.h"
+#include <opencv2/imgproc/imgproc.hpp>
+
+static cv::Mat grayImage(int width, int height) {
+  return cv::Mat(height, width, CV_8UC4, cv::Scalar(128, 128, 128, 255));
+}
+
+static bool contains(const cv::Rect &outer, const cv::Rect &inner) {
+  return (outer & inner) == inner;
+}
+
+// Only the detected regions count, so the crop can't be pulled around by the image itself.
+static YeetSaliencyOptions regionsOnly() {
+  YeetSaliencyOptions options;
+  options.spectralWeight = 0;
+  options.edgeWeight = 0;
+  options.regionWeight = 1;
+  return options;
+}
+
+TEST(YeetSaliencyMap, CoverageMatchesSummingTheMap) {
+  // Smaller than mapSize, so map cells and source pixels line up one to one.
+  cv::Mat image = grayImage(120, 90);
+  yeetDrawChecker(image, cv::Rect(70, 20, 40, 40), 4);
+
+  YeetSaliencyMap saliency;
+  saliency.compute(image, {});
+  ASSERT_EQ(saliency.map().size(), image.size());
+
+  const double total = cv::sum(saliency.map())[0];
+  ASSERT_GT(total, 0);
+
+  const cv::Rect rects[] = {cv::Rect(0, 0, 120, 90), cv::Rect(70, 20, 40, 40), cv::Rect(3, 7, 1, 1), cv::Rect(0, 45, 120, 45), cv::Rect(101, 0, 19, 90)};
+  for (const auto &rect : rects) {
+    EXPECT_NEAR(saliency.coverage(rect), cv::sum(saliency.map()(rect))[0] / total, 1e-9) << rect;
+  }
+
+  // Partly outside is clipped to the image, fully outside covers nothing.
+  EXPECT_NEAR(saliency.coverage(cv::Rect(-50, -50, 100, 100)), saliency.coverage(cv::Rect(0, 0, 50, 50)), 1e-9);
+  EXPECT_EQ(saliency.coverage(cv::Rect(200, 200, 10, 10)), 0);
+}
+
+TEST(YeetSaliencyMap, CropMatchesBruteForce) {
+  cv::Mat image = grayImage(640, 480);
+  yeetDrawChecker(image, cv::Rect(420, 60, 140, 90), 10);
+  yeetDrawChecker(image, cv::Rect(60, 330, 80, 80), 6);
+
+  YeetSaliencyMap saliency;
+  saliency.compute(image, {{cv::Rect(200, 200, 120, 40), 1}}, cv::Size(1920, 1440));
+
+  for (double aspectRatio : {1.0, 0.8, 9.0 / 16, 16.0 / 9, 1.91, 3.0}) {
+    for (double zoom : {1.0, 0.75, 0.5, 0.2}) {
+      EXPECT_EQ(saliency.bestCrop(aspectRatio, zoom), yeetBruteForceCrop(saliency, aspectRatio, zoom)) << aspectRatio << " @ " << zoom;
+    }
+  }
+}
+
+TEST(YeetSaliencyMap, CropKeepsTheAspectRatioInsideTheSource) {
+  // Odd sizes on both sides, so every conversion between map cells and source pixels rounds.
+  cv::Mat image = grayImage(333, 211);
+  yeetDrawChecker(image, cv::Rect(250, 150, 60, 50), 5);
+
+  YeetSaliencyMap saliency;
+  saliency.compute(image, {}, cv::Size(1000, 633));
+  const cv::Rect source(0, 0, 1000, 633);
+
+  for (double aspectRatio : {1.0, 0.8, 9.0 / 16, 16.0 / 9, 3.0, 0.2}) {
+    for (double zoom : {1.0, 0.5, 0.1}) {
+      const cv::Rect crop = saliency.bestCrop(aspectRatio, zoom);
+      EXPECT_TRUE(contains(source, crop)) << crop;
+      // Width and height are each rounded on their own.
+      EXPECT_NEAR(crop.width, crop.height * aspectRatio, 0.5 + 0.5 * aspectRatio) << aspectRatio << " @ " << zoom;
+
+      if (zoom == 1) {
+        EXPECT_TRUE(crop.width == source.width || crop.height == source.height) << crop;
+      }
+    }
+  }
+}
+
+// A patch on a flat background is the case spectral residual gets wrong without its amplitude floor:
+// the near-empty spectrum turns into stripes across the whole map and the crop ignores the patch.
+TEST(YeetSaliencyMap, CropFollowsTheSalientPatch) {
+  const cv::Rect right(480, 180, 120, 120);
+  const cv::Rect left(20, 300, 100, 100);
+
+  for (const cv::Rect &patch : {right, left}) {
+    cv::Mat image = grayImage(640, 480);
+    yeetDrawChecker(image, patch, 20);
+
+    YeetSaliencyMap saliency;
+    saliency.compute(image, {});
+
+    EXPECT_TRUE(contains(saliency.bestCrop(1), patch)) << saliency.bestCrop(1);
+    EXPECT_TRUE(contains(saliency.bestCrop(9.0 / 16), patch)) << saliency.bestCrop(9.0 / 16);
+    EXPECT_TRUE(contains(saliency.bestCrop(1, 0.5), patch)) << saliency.bestCrop(1, 0.5);
+    // The flat background still gets some saliency, so compare against the patch's share of the area.
+    EXPECT_GT(saliency.coverage(patch), 2.0 * patch.area() / (640 * 480));
+  }
+}
+
+TEST(YeetSaliencyMap, CropsAreInSourceCoordinates) {
+  // A half-size copy of a 640x480 image, with the patch at (480, 180, 120, 120) in the original.
+  cv::Mat image = grayImage(320, 240);
+  yeetDrawChecker(image, cv::Rect(240, 90, 60, 60), 10);
+
+  YeetSaliencyMap saliency;
+  saliency.compute(image, {}, cv::Size(640, 480));
+  EXPECT_EQ(saliency.sourceSize(), cv::Size(640, 480));
+
+  const cv::Rect patch(480, 180, 120, 120);
+  const cv::Rect crop = saliency.bestCrop(1, 0.5);
+  EXPECT_EQ(crop.size(), cv::Size(240, 240));
+  EXPECT_TRUE(contains(crop, patch)) << crop;
+  EXPECT_GT(saliency.coverage(patch), 2.0 * patch.area() / (640 * 480));
+}
+
+TEST(YeetSaliencyMap, RegionsPullTheCropByWeight) {
+  YeetSaliencyMap saliency;
+  const cv::Rect region(500, 40, 100, 100);
+  saliency.compute(grayImage(640, 480), {{region, 1}}, cv::Size(), regionsOnly());
+  EXPECT_TRUE(contains(saliency.bestCrop(1, 0.4), region)) << saliency.bestCrop(1, 0.4);
+  EXPECT_NEAR(saliency.coverage(region), 1, 1e-6);
+
+  // Too small a crop for both, so it goes to the heavier one.
+  const cv::Rect light(20, 40, 100, 100);
+  const cv::Rect heavy(500, 300, 100, 100);
+  saliency.compute(grayImage(640, 480), {{light, 1}, {heavy, 2}}, cv::Size(), regionsOnly());
+  const cv::Rect crop = saliency.bestCrop(1, 0.3);
+  EXPECT_GT((crop & heavy).area(), heavy.area() * 9 / 10) << crop;
+  EXPECT_TRUE((crop & light).empty()) << crop;
+}
+
+TEST(YeetSaliencyMap, GrayAndColorImagesGiveTheSameMap) {
+  cv::Mat image = grayImage(200, 150);
+  yeetDrawChecker(image, cv::Rect(30, 40, 50, 50), 5);
+
+  cv::Mat gray, rgb;
+  cv::cvtColor(image, gray, cv::COLOR_RGBA2GRAY);
+  cv::cvtColor(image, rgb, cv::COLOR_RGBA2RGB);
+
+  YeetSaliencyMap fromRGBA, fromGray, fromRGB;
+  fromRGBA.compute(image, {});
+  fromGray.compute(gray, {});
+  fromRGB.compute(rgb, {});
+
+  EXPECT_EQ(cv::norm(fromRGBA.map(), fromGray.map(), cv::NORM_INF), 0);
+  EXPECT_EQ(cv::norm(fromRGBA.map(), fromRGB.map(), cv::NORM_INF), 0);
+}
+
+TEST(YeetSaliencyMap, EmptyImageCropsToTheWholeSource) {
+  YeetSaliencyMap saliency;
+  saliency.compute(cv::Mat(), {}, cv::Size(640, 480));
+
+  EXPECT_TRUE(saliency.empty());
+  EXPECT_EQ(saliency.bestCrop(1), cv::Rect(0, 0, 640, 480));
+  EXPECT_EQ(saliency.coverage(cv::Rect(0, 0, 640, 480)), 0);
+
+  // And computing again on a real image replaces it.
+  saliency.compute(grayImage(64, 48), {});
+  EXPECT_FALSE(saliency.empty());
+  EXPECT_EQ(saliency.sourceSize(), cv::Size(64, 48));
+  EXPECT_EQ(saliency.bestCrop(0), cv::Rect(0, 0, 64, 48));
+}
+
+TEST(YeetSaliencyCache, EvictsLeastRecentlyUsed) {
+  YeetSaliencyCache cache(2);
+  auto a = std::make_shared<YeetSaliencyMap>();
+  auto b = std::make_shared<YeetSaliencyMap>();
+  auto c = std::make_shared<YeetSaliencyMap>();
+
+  cache.set("a", a);
+  cache.set("b", b);
+  // Reading a makes b the oldest.
+  EXPECT_EQ(cache.get("a"), a);
+  cache.set("c", c);
+
+  EXPECT_EQ(cache.get("a"), a);
+  EXPECT_EQ(cache.get("b"), nullptr);
+  EXPECT_EQ(cache.get("c"), c);
+}
+
+TEST(YeetSaliencyCache, SetReplacesAndRemoveForgets) {
+  YeetSaliencyCache cache(2);
+  auto first = std::make_shared<YeetSaliencyMap>();
+  auto second = std::make_shared<YeetSaliencyMap>();
+
+  cache.set("asset", first);
+  cache.set("asset", second);
+  EXPECT_EQ(cache.get("asset"), second);
+  // Replacing didn't take a second slot.
+  cache.set("other", first);
+  EXPECT_EQ(cache.get("asset"), second);
+
+  cache.remove("asset");
+  EXPECT_EQ(cache.get("asset"), nullptr);
+  EXPECT_EQ(cache.get("other"), first);
+
+  cache.clear();
+  EXPECT_EQ(cache.get("other"), nullptr);
+  // The cache let go of its references.
+  EXPECT_EQ(first.use_count(), 1);
+}
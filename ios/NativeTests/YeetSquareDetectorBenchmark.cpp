@@ -0,0 +1,102 @@
+//
+//  YeetSquareDetectorBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <opencv2/core/utility.hpp>
+#include "YeetSquareDetector.h"
+#include "YeetSquareDetectorFixtures.h"
+
+// Times the serial find_squares against YeetSquareDetector, on one thread and on all of them, and
+// in pyramid mode. Exits non-zero if the full-resolution detector's output differs from the serial one.
+
+template <typename Detect>
+static double millisecondsPerFrame(const std::vector<cv::Mat> &frames, int iterations, Detect &&detect) {
+  std::vector<YeetSquare> squares;
+  detect(frames[0], squares);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    detect(frames[i % frames.size()], squares);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+}
+
+static bool sameSquares(const std::vector<YeetSquare> &a, const std::vector<YeetSquare> &b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].size() != b[i].size()) {
+      return false;
+    }
+    for (size_t p = 0; p < a[i].size(); p++) {
+      if (a[i][p].x != b[i][p].x || a[i][p].y != b[i][p].y) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char **argv) {
+  const int width = argc > 1 ? atoi(argv[1]) : 1080;
+  const int height = argc > 2 ? atoi(argv[2]) : 1440;
+  const int iterations = argc > 3 ? atoi(argv[3]) : 20;
+
+  std::vector<cv::Mat> frames;
+  for (unsigned seed = 0; seed < 4; seed++) {
+    frames.push_back(yeetSyntheticSquaresImage(width, height, seed, 5));
+  }
+
+  YeetSquareDetector detector;
+  YeetSquareDetectorOptions pyramidOptions;
+  pyramidOptions.pyramidScale = 0.5;
+  YeetSquareDetector pyramid(pyramidOptions);
+
+  std::vector<YeetSquare> serialSquares;
+  std::vector<YeetSquare> detectorSquares;
+  for (const auto &frame : frames) {
+    yeetFindSquaresSerial(frame, serialSquares);
+    detector.detect(frame, detectorSquares);
+    if (!sameSquares(serialSquares, detectorSquares)) {
+      fprintf(stderr, "YeetSquareDetector found %zu squares, find_squares found %zu\n", detectorSquares.size(), serialSquares.size());
+      return 1;
+    }
+  }
+
+  const int threads = cv::getNumThreads();
+  double serial = millisecondsPerFrame(frames, iterations, [](const cv::Mat &frame, std::vector<YeetSquare> &squares) {
+    yeetFindSquaresSerial(frame, squares);
+  });
+
+  cv::setNumThreads(1);
+  double oneThread = millisecondsPerFrame(frames, iterations, [&](const cv::Mat &frame, std::vector<YeetSquare> &squares) {
+    detector.detect(frame, squares);
+  });
+
+  cv::setNumThreads(threads);
+  double allThreads = millisecondsPerFrame(frames, iterations, [&](const cv::Mat &frame, std::vector<YeetSquare> &squares) {
+    detector.detect(frame, squares);
+  });
+
+  double pyramidThreads = millisecondsPerFrame(frames, iterations, [&](const cv::Mat &frame, std::vector<YeetSquare> &squares) {
+    pyramid.detect(frame, squares);
+  });
+
+  printf("%dx%d RGBA, %d frames\n", width, height, iterations);
+  printf("find_squares (serial):          %7.2f ms/frame\n", serial);
+  printf("YeetSquareDetector, 1 thread:   %7.2f ms/frame\n", oneThread);
+  printf("YeetSquareDetector, %2d threads: %7.2f ms/frame\n", threads, allThreads);
+  printf("  pyramidScale 0.5:             %7.2f ms/frame\n", pyramidThreads);
+  return 0;
+}
@@ -0,0 +1,136 @@
+//
+//  YeetSquareDetectorFixtures.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "YeetSquareDetector.h"
+
+// find_squares as FindContours.mm had it before YeetSquareDetector: every (channel, level) job runs
+// one after another on a freshly thresholded Mat. YeetSquareDetector has to return exactly this.
+inline void yeetFindSquaresSerial(const cv::Mat &image, std::vector<YeetSquare> &squares) {
+  squares.clear();
+
+  // blur will enhance edge detection
+  cv::Mat blurred;
+  cv::medianBlur(image, blurred, 5);
+
+  cv::Mat gray0(blurred.size(), CV_8U), gray;
+  std::vector<std::vector<cv::Point>> contours;
+
+  // find squares in every color plane of the image
+  for (int c = 0; c < 3; c++) {
+    int ch[] = {c, 0};
+    cv::mixChannels(&blurred, 1, &gray0, 1, ch, 1);
+
+    // try several threshold levels
+    const int threshold_level = 10;
+    for (int l = 0; l < threshold_level; l++) {
+      gray = gray0 >= (l + 1) * 255 / threshold_level;
+
+      // Find contours and store them in a list
+      cv::findContours(gray, contours, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+
+      // Test contours
+      std::vector<cv::Point> approx;
+      for (size_t i = 0; i < contours.size(); i++) {
+        // approximate contour with accuracy proportional
+        // to the contour perimeter
+        cv::approxPolyDP(contours[i], approx, cv::arcLength(contours[i], true) * 0.02, true);
+
+        // Note: absolute value of an area is used because
+        // area may be positive or negative - in accordance with the
+        // contour orientation
+        if (approx.size() == 4 &&
+            fabs(cv::contourArea(approx)) > 1000 &&
+            cv::isContourConvex(approx)) {
+          double maxCosine = 0;
+
+          for (int j = 2; j < 5; j++) {
+            double cosine = fabs(yeetSquareCornerCosine(approx[j % 4], approx[j - 2], approx[j - 1]));
+            maxCosine = MAX(maxCosine, cosine);
+          }
+
+          if (maxCosine < 0.3) {
+            squares.push_back(approx);
+          }
+        }
+      }
+    }
+  }
+}
+
+// An RGBA frame with a gradient background, a few filled and slightly rotated rectangles in
+// random colors, and per-pixel noise, so every threshold level has contours to look at.
+inline cv::Mat yeetSyntheticSquaresImage(int width, int height, unsigned seed, int rectangles = 4) {
+  std::mt19937 random(seed);
+  cv::Mat image(height, width, CV_8UC4);
+
+  for (int y = 0; y < height; y++) {
+    uchar *row = image.ptr<uchar>(y);
+    for (int x = 0; x < width; x++) {
+      row[x * 4 + 0] = (uchar)(40 + 60 * x / width);
+      row[x * 4 + 1] = (uchar)(40 + 60 * x / width + 30 * y / height);
+      row[x * 4 + 2] = (uchar)(40 + 60 * x / width + 60 * y / height);
+      row[x * 4 + 3] = 255;
+    }
+  }
+
+  for (int i = 0; i < rectangles; i++) {
+    const double rectWidth = std::uniform_int_distribution<int>(width / 8, width / 3)(random);
+    const double rectHeight = std::uniform_int_distribution<int>(height / 8, height / 3)(random);
+    const double centerX = std::uniform_int_distribution<int>((int)rectWidth / 2 + 10, width - (int)rectWidth / 2 - 10)(random);
+    const double centerY = std::uniform_int_distribution<int>((int)rectHeight / 2 + 10, height - (int)rectHeight / 2 - 10)(random);
+    const double angle = std::uniform_real_distribution<double>(-0.2, 0.2)(random);
+
+    cv::Point corners[4];
+    const double halfWidths[] = {-0.5, 0.5, 0.5, -0.5};
+    const double halfHeights[] = {-0.5, -0.5, 0.5, 0.5};
+    for (int c = 0; c < 4; c++) {
+      const double dx = halfWidths[c] * rectWidth;
+      const double dy = halfHeights[c] * rectHeight;
+      corners[c] = cv::Point(cvRound(centerX + dx * cos(angle) - dy * sin(angle)), cvRound(centerY + dx * sin(angle) + dy * cos(angle)));
+    }
+
+    std::uniform_int_distribution<int> channel(150, 255);
+    cv::fillConvexPoly(image, corners, 4, cv::Scalar(channel(random), channel(random), channel(random), 255));
+  }
+
+  std::uniform_int_distribution<int> noise(-6, 6);
+  for (int y = 0; y < height; y++) {
+    uchar *row = image.ptr<uchar>(y);
+    for (int x = 0; x < width * 4; x++) {
+      if (x % 4 != 3) {
+        row[x] = cv::saturate_cast<uchar>(row[x] + noise(random));
+      }
+    }
+  }
+
+  return image;
+}
+
+// A page on a dark background, with a thin, faint frame drawn gap pixels outside it. At full
+// resolution the frame is a square of its own, but downscaling by 4 blurs it below one pixel and
+// the median blur removes it, so pyramid mode only finds it if the page's region is padded enough.
+inline cv::Mat yeetFramedPageImage(int width, int height, int gap) {
+  cv::Mat image(height, width, CV_8UC4, cv::Scalar(10, 10, 10, 255));
+  const cv::Rect page(width / 4, height / 4, width / 2, height / 2);
+  const int line = 3;
+
+  cv::rectangle(image, cv::Point(page.x - gap - line, page.y - gap - line), cv::Point(page.x + page.width + gap + line, page.y + page.height + gap + line), cv::Scalar(40, 40, 40, 255), line);
+  cv::rectangle(image, cv::Point(page.x, page.y), cv::Point(page.x + page.width, page.y + page.height), cv::Scalar(90, 140, 230, 255), -1);
+  return image;
+}
+
+#endif
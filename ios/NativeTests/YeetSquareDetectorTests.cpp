@@ -0,0 +1,155 @@
+//
+//  YeetSquareDetectorTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include <opencv2/core/utility.hpp>
+#include "YeetSquareDetector.h"
+#include "YeetSquareDetectorFixtures.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+static void expectSameSquares(const std::vector<YeetSquare> &expected, const std::vector<YeetSquare> &actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_EQ(expected[i].size(), actual[i].size()) << "square " << i;
+    for (size_t p = 0; p < expected[i].size(); p++) {
+      EXPECT_EQ(expected[i][p].x, actual[i][p].x) << "square " << i << " point " << p;
+      EXPECT_EQ(expected[i][p].y, actual[i][p].y) << "square " << i << " point " << p;
+    }
+  }
+}
+
+TEST(YeetSquareDetector, MatchesTheSerialFindSquares) {
+  YeetSquareDetector detector;
+  std::vector<YeetSquare> expected;
+  std::vector<YeetSquare> actual;
+
+  for (unsigned seed = 0; seed < 8; seed++) {
+    cv::Mat image = yeetSyntheticSquaresImage(640, 480, seed);
+    yeetFindSquaresSerial(image, expected);
+    detector.detect(image, actual);
+
+    ASSERT_FALSE(expected.empty()) << "seed " << seed;
+    expectSameSquares(expected, actual);
+  }
+}
+
+// The stripes split the levels differently depending on the thread count, but the results are
+// gathered in (channel, level) order, so the output can't depend on it.
+TEST(YeetSquareDetector, OutputDoesntDependOnTheThreadCount) {
+  const int threads = cv::getNumThreads();
+  cv::Mat image = yeetSyntheticSquaresImage(800, 600, 42, 6);
+
+  std::vector<YeetSquare> expected;
+  yeetFindSquaresSerial(image, expected);
+
+  YeetSquareDetector detector;
+  std::vector<YeetSquare> actual;
+  for (int count : {1, 2, 3, 8}) {
+    cv::setNumThreads(count);
+    detector.detect(image, actual);
+    expectSameSquares(expected, actual);
+  }
+
+  cv::setNumThreads(threads);
+}
+
+// Scratch buffers are kept between calls. A smaller image after a bigger one must not see stale data.
+TEST(YeetSquareDetector, ReusesBuffersAcrossSizes) {
+  YeetSquareDetector detector;
+  std::vector<YeetSquare> expected;
+  std::vector<YeetSquare> actual;
+
+  for (auto size : {cv::Size(800, 600), cv::Size(320, 480), cv::Size(800, 600)}) {
+    cv::Mat image = yeetSyntheticSquaresImage(size.width, size.height, size.width);
+    yeetFindSquaresSerial(image, expected);
+    detector.detect(image, actual);
+    expectSameSquares(expected, actual);
+  }
+}
+
+TEST(YeetSquareDetector, RejectsImagesWithoutColor) {
+  YeetSquareDetector detector;
+  std::vector<YeetSquare> squares(1);
+
+  detector.detect(cv::Mat(), squares);
+  EXPECT_TRUE(squares.empty());
+
+  squares.resize(1);
+  detector.detect(cv::Mat(100, 100, CV_8UC1, cv::Scalar(0)), squares);
+  EXPECT_TRUE(squares.empty());
+}
+
+// The largest distance between matching corners of a and b, over every starting corner and both
+// windings, since the two passes can trace the same quad from different points.
+static int cornerDistance(const YeetSquare &a, const YeetSquare &b) {
+  int best = INT_MAX;
+  for (int start = 0; start < 4; start++) {
+    for (int direction : {1, -1}) {
+      int worst = 0;
+      for (int i = 0; i < 4; i++) {
+        const cv::Point &p = b[(start + direction * i + 4) % 4];
+        worst = std::max(worst, std::max(std::abs(a[i].x - p.x), std::abs(a[i].y - p.y)));
+      }
+      best = std::min(best, worst);
+    }
+  }
+  return best;
+}
+
+// Pyramid mode only searches around what it found at low resolution, so it can find extra squares
+// where a region's edge cuts through something, but it shouldn't lose any.
+static void expectPyramidFindsEverySquare(const cv::Mat &image, double scale) {
+  YeetSquareDetector full;
+  std::vector<YeetSquare> expected;
+  full.detect(image, expected);
+
+  YeetSquareDetectorOptions options;
+  options.pyramidScale = scale;
+  YeetSquareDetector pyramid(options);
+  std::vector<YeetSquare> actual;
+  pyramid.detect(image, actual);
+
+  ASSERT_FALSE(expected.empty());
+  for (const auto &square : expected) {
+    int closest = INT_MAX;
+    for (const auto &candidate : actual) {
+      closest = std::min(closest, cornerDistance(square, candidate));
+    }
+
+    EXPECT_LE(closest, 2) << "pyramidScale " << scale << " missed the square at " << square[0].x << ", " << square[0].y;
+  }
+}
+
+TEST(YeetSquareDetector, PyramidFindsWhatTheFullPassFinds) {
+  for (double scale : {0.5, 0.25}) {
+    for (unsigned seed = 0; seed < 8; seed++) {
+      SCOPED_TRACE(seed);
+      expectPyramidFindsEverySquare(yeetSyntheticSquaresImage(800, 600, seed, 3), scale);
+    }
+  }
+}
+
+// The frame is 27px outside the page. At pyramidScale 0.25 the page's region has to be padded by
+// 10% of its 400px side, not 10% of the 100px it measures in the downscaled image.
+TEST(YeetSquareDetector, PyramidPaddingIsInFullResolutionPixels) {
+  cv::Mat image = yeetFramedPageImage(800, 600, 24);
+
+  YeetSquareDetector full;
+  std::vector<YeetSquare> squares;
+  full.detect(image, squares);
+
+  bool foundFrame = false;
+  for (const auto &square : squares) {
+    foundFrame |= cv::boundingRect(square).width > 430;
+  }
+  ASSERT_TRUE(foundFrame);
+
+  expectPyramidFindsEverySquare(image, 0.25);
+}
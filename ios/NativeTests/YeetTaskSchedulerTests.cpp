@@ -0,0 +1,210 @@
+//
+//  YeetTaskSchedulerTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/21/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetTaskScheduler.h"
+#include <chrono>
+#include <string>
+
+namespace {
+
+// Blocks waiters until open() is called.
+class Gate {
+public:
+  void open() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      open_ = true;
+    }
+    condition_.notify_all();
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this]() { return open_; });
+  }
+
+  bool waitFor(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return condition_.wait_for(lock, timeout, [this]() { return open_; });
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool open_ = false;
+};
+
+}
+
+TEST(YeetTaskScheduler, RunsEveryTaskBeforeDestruction) {
+  std::atomic<int> ran{0};
+  {
+    YeetTaskScheduler scheduler(4);
+    for (int i = 0; i < 1000; i++) {
+      scheduler.schedule(static_cast<YeetTaskPriority>(i % 3), [&ran]() { ran++; });
+    }
+  }
+  EXPECT_EQ(ran.load(), 1000);
+}
+
+TEST(YeetTaskScheduler, RunsTasksScheduledFromWorkers) {
+  std::atomic<int> ran{0};
+  {
+    YeetTaskScheduler scheduler(4);
+    for (int i = 0; i < 50; i++) {
+      scheduler.schedule(YeetTaskPriority::background, [&scheduler, &ran]() {
+        // Fan out onto this worker's own deque, where the other workers have to steal it from.
+        for (int j = 0; j < 50; j++) {
+          scheduler.schedule(static_cast<YeetTaskPriority>(j % 3), [&ran]() { ran++; });
+        }
+        ran++;
+      });
+    }
+  }
+  EXPECT_EQ(ran.load(), 50 * 51);
+}
+
+TEST(YeetTaskScheduler, DrainsLanesInPriorityOrder) {
+  std::vector<std::string> order;
+  Gate gate;
+  {
+    YeetTaskScheduler scheduler(1);
+    // Holds the only worker so everything below is queued before anything runs.
+    scheduler.schedule(YeetTaskPriority::background, [&gate]() { gate.wait(); });
+
+    scheduler.schedule(YeetTaskPriority::background, [&order]() { order.push_back("background 1"); });
+    scheduler.schedule(YeetTaskPriority::prefetch, [&order]() { order.push_back("prefetch 1"); });
+    scheduler.schedule(YeetTaskPriority::interactive, [&order]() { order.push_back("interactive 1"); });
+    scheduler.schedule(YeetTaskPriority::background, [&order]() { order.push_back("background 2"); });
+    scheduler.schedule(YeetTaskPriority::interactive, [&order]() { order.push_back("interactive 2"); });
+    scheduler.schedule(YeetTaskPriority::prefetch, [&order]() { order.push_back("prefetch 2"); });
+    gate.open();
+  }
+
+  // Tasks from outside the pool are FIFO within a lane.
+  const std::vector<std::string> expected = {
+    "interactive 1", "interactive 2", "prefetch 1", "prefetch 2", "background 1", "background 2",
+  };
+  EXPECT_EQ(order, expected);
+}
+
+TEST(YeetTaskScheduler, DropsTasksCancelledBeforeTheyStart) {
+  std::atomic<bool> ran{false};
+  Gate gate;
+  {
+    YeetTaskScheduler scheduler(1);
+    scheduler.schedule(YeetTaskPriority::interactive, [&gate]() { gate.wait(); });
+
+    YeetCancellationToken token;
+    scheduler.schedule(YeetTaskPriority::interactive, [&ran]() { ran = true; }, token);
+    token.cancel();
+    gate.open();
+  }
+  EXPECT_FALSE(ran.load());
+
+  // Already cancelled when scheduled.
+  {
+    YeetTaskScheduler scheduler(1);
+    YeetCancellationToken token;
+    token.cancel();
+    scheduler.schedule(YeetTaskPriority::interactive, [&ran]() { ran = true; }, token);
+  }
+  EXPECT_FALSE(ran.load());
+}
+
+TEST(YeetTaskScheduler, InteractiveWorkRunsWhileBackgroundWorkFillsThePool) {
+  const size_t threadCount = 3;
+  Gate backgroundGate;
+  std::atomic<int> backgroundStarted{0};
+  Gate interactiveRan;
+  {
+    YeetTaskScheduler scheduler(threadCount);
+    // More long background tasks than there are threads.
+    for (size_t i = 0; i < threadCount * 2; i++) {
+      scheduler.schedule(YeetTaskPriority::background, [&backgroundGate, &backgroundStarted]() {
+        backgroundStarted++;
+        backgroundGate.wait();
+      });
+    }
+
+    // Let every worker that's going to pick up background work do so.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (backgroundStarted.load() < (int)threadCount - 1 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // Worker 0 never takes background work, so it's still free for this.
+    EXPECT_EQ(backgroundStarted.load(), (int)threadCount - 1);
+    scheduler.schedule(YeetTaskPriority::interactive, [&interactiveRan]() { interactiveRan.open(); });
+    EXPECT_TRUE(interactiveRan.waitFor(std::chrono::seconds(5)));
+    backgroundGate.open();
+  }
+  EXPECT_EQ(backgroundStarted.load(), (int)threadCount * 2);
+}
+
+TEST(YeetTaskScheduler, SingleThreadRunsEveryLane) {
+  // With one thread there's nothing to reserve, so worker 0 has to run background work too.
+  std::atomic<int> ran{0};
+  Gate done;
+  YeetTaskScheduler scheduler(1);
+  auto task = [&ran, &done]() {
+    if (++ran == 2) {
+      done.open();
+    }
+  };
+  scheduler.schedule(YeetTaskPriority::background, task);
+  scheduler.schedule(YeetTaskPriority::prefetch, task);
+  EXPECT_TRUE(done.waitFor(std::chrono::seconds(5)));
+}
+
+// schedule() counts a job before pushing it, so a worker that takes it straight away can't
+// decrement first. If it could, the counts would wrap around to huge values until schedule()
+// caught up. Producers keep the queue nearly empty, so jobs are taken the moment they're pushed
+// and every count is close to 0 when a task checks it.
+TEST(YeetTaskScheduler, PendingCountsNeverUnderflow) {
+  const size_t producers = 4;
+  const size_t tasksPerProducer = 25000;
+  const size_t total = producers * tasksPerProducer;
+
+  std::atomic<size_t> ran{0};
+  std::atomic<size_t> underflows{0};
+  {
+    YeetTaskScheduler scheduler(4);
+    auto check = [&scheduler, &underflows]() {
+      if (scheduler.pendingCount() > total || scheduler.pendingInteractiveCount() > total) {
+        underflows++;
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t producer = 0; producer < producers; producer++) {
+      threads.emplace_back([&, producer]() {
+        for (size_t i = 0; i < tasksPerProducer; i++) {
+          while (scheduler.pendingCount() > 2 && scheduler.pendingCount() <= total) {
+            std::this_thread::yield();
+          }
+
+          scheduler.schedule(static_cast<YeetTaskPriority>((producer + i) % 3), [&]() {
+            check();
+            ran++;
+          });
+          check();
+        }
+      });
+    }
+
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  EXPECT_EQ(ran.load(), total);
+  EXPECT_EQ(underflows.load(), 0u);
+}
@@ -0,0 +1,424 @@
+//
+//  YeetTestRuntime.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetTestRuntime.h"
+#include <stdexcept>
+#include <utility>
+
+// Strings, symbols, property names and objects are all cells. jsi values hold a CellPointer, and
+// every clone is a new CellPointer to the same cell.
+struct YeetTestRuntime::Cell {
+  std::string string;
+
+  std::vector<std::pair<std::string, jsi::Value>> properties;
+  bool isArray = false;
+  std::vector<jsi::Value> elements;
+  std::shared_ptr<jsi::HostObject> hostObject;
+  std::unique_ptr<jsi::HostFunctionType> hostFunction;
+
+  PromiseState promiseState = PromiseState::notAPromise;
+  jsi::Value promiseResult;
+};
+
+struct YeetTestRuntime::CellPointer : public jsi::Runtime::PointerValue {
+  explicit CellPointer(std::shared_ptr<Cell> cell) : cell(std::move(cell)) {}
+
+  void invalidate() override { delete this; }
+
+  std::shared_ptr<Cell> cell;
+};
+
+YeetTestRuntime::Cell &YeetTestRuntime::cell(const jsi::Pointer &pointer) {
+  return *static_cast<const CellPointer *>(getPointerValue(pointer))->cell;
+}
+
+const YeetTestRuntime::Cell &YeetTestRuntime::cell(const jsi::Value &value) {
+  return *static_cast<const CellPointer *>(getPointerValue(value))->cell;
+}
+
+template <typename T>
+T YeetTestRuntime::wrap(std::shared_ptr<Cell> cell) {
+  return make<T>(new CellPointer(std::move(cell)));
+}
+
+std::shared_ptr<YeetTestRuntime::Cell> YeetTestRuntime::makeString(std::string string) {
+  auto cell = std::make_shared<Cell>();
+  cell->string = std::move(string);
+  return cell;
+}
+
+YeetTestRuntime::YeetTestRuntime() : global_(std::make_shared<Cell>()) {
+  installGlobals();
+}
+
+YeetTestRuntime::~YeetTestRuntime() {
+  // Objects can refer to each other, so break the links instead of leaking every cell.
+  global_->properties.clear();
+}
+
+void YeetTestRuntime::installGlobals() {
+  jsi::Object global = this->global();
+
+  global.setProperty(*this, "Error", jsi::Function::createFromHostFunction(*this, jsi::PropNameID::forAscii(*this, "Error"), 1, [](jsi::Runtime &runtime, const jsi::Value &thisValue, const jsi::Value *args, size_t count) -> jsi::Value {
+    jsi::Object error(runtime);
+    if (count > 0) {
+      error.setProperty(runtime, "message", args[0]);
+    }
+    return error;
+  }));
+
+  // new Promise(executor) runs the executor right away. Settling is synchronous, so a test can
+  // check a promise as soon as the native side calls resolve or reject.
+  global.setProperty(*this, "Promise", jsi::Function::createFromHostFunction(*this, jsi::PropNameID::forAscii(*this, "Promise"), 1, [](jsi::Runtime &runtime, const jsi::Value &thisValue, const jsi::Value *args, size_t count) -> jsi::Value {
+    jsi::Object promise(runtime);
+    auto promiseCell = static_cast<const CellPointer *>(getPointerValue(promise))->cell;
+    promiseCell->promiseState = PromiseState::pending;
+
+    auto settle = [promiseCell](PromiseState state) {
+      return [promiseCell, state](jsi::Runtime &runtime, const jsi::Value &thisValue, const jsi::Value *args, size_t count) -> jsi::Value {
+        if (promiseCell->promiseState == PromiseState::pending) {
+          promiseCell->promiseState = state;
+          promiseCell->promiseResult = count > 0 ? jsi::Value(runtime, args[0]) : jsi::Value::undefined();
+        }
+        return jsi::Value::undefined();
+      };
+    };
+
+    jsi::Function resolve = jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forAscii(runtime, "resolve"), 1, settle(PromiseState::fulfilled));
+    jsi::Function reject = jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forAscii(runtime, "reject"), 1, settle(PromiseState::rejected));
+    args[0].getObject(runtime).getFunction(runtime).call(runtime, resolve, reject);
+    return promise;
+  }));
+}
+
+YeetTestRuntime::PromiseState YeetTestRuntime::promiseState(const jsi::Value &promise) {
+  if (!promise.isObject()) {
+    return PromiseState::notAPromise;
+  }
+  return cell(promise).promiseState;
+}
+
+jsi::Value YeetTestRuntime::promiseResult(const jsi::Value &promise) {
+  if (!promise.isObject()) {
+    return jsi::Value::undefined();
+  }
+  return jsi::Value(*this, cell(promise).promiseResult);
+}
+
+jsi::Value YeetTestRuntime::evaluateJavaScript(const std::shared_ptr<const jsi::Buffer> &buffer, const std::string &sourceURL) {
+  throw jsi::JSINativeException("YeetTestRuntime can't evaluate JavaScript");
+}
+
+std::shared_ptr<const jsi::PreparedJavaScript> YeetTestRuntime::prepareJavaScript(const std::shared_ptr<const jsi::Buffer> &buffer, std::string sourceURL) {
+  throw jsi::JSINativeException("YeetTestRuntime can't evaluate JavaScript");
+}
+
+jsi::Value YeetTestRuntime::evaluatePreparedJavaScript(const std::shared_ptr<const jsi::PreparedJavaScript> &js) {
+  throw jsi::JSINativeException("YeetTestRuntime can't evaluate JavaScript");
+}
+
+jsi::Object YeetTestRuntime::global() {
+  return wrap<jsi::Object>(global_);
+}
+
+std::string YeetTestRuntime::description() {
+  return "YeetTestRuntime";
+}
+
+bool YeetTestRuntime::isInspectable() {
+  return false;
+}
+
+jsi::Runtime::PointerValue *YeetTestRuntime::cloneSymbol(const PointerValue *pv) {
+  return new CellPointer(static_cast<const CellPointer *>(pv)->cell);
+}
+
+jsi::Runtime::PointerValue *YeetTestRuntime::cloneString(const PointerValue *pv) {
+  return new CellPointer(static_cast<const CellPointer *>(pv)->cell);
+}
+
+jsi::Runtime::PointerValue *YeetTestRuntime::cloneObject(const PointerValue *pv) {
+  return new CellPointer(static_cast<const CellPointer *>(pv)->cell);
+}
+
+jsi::Runtime::PointerValue *YeetTestRuntime::clonePropNameID(const PointerValue *pv) {
+  return new CellPointer(static_cast<const CellPointer *>(pv)->cell);
+}
+
+jsi::PropNameID YeetTestRuntime::createPropNameIDFromAscii(const char *str, size_t length) {
+  counters.createPropNameID++;
+  return wrap<jsi::PropNameID>(makeString(std::string(str, length)));
+}
+
+jsi::PropNameID YeetTestRuntime::createPropNameIDFromUtf8(const uint8_t *utf8, size_t length) {
+  counters.createPropNameID++;
+  return wrap<jsi::PropNameID>(makeString(std::string(reinterpret_cast<const char *>(utf8), length)));
+}
+
+jsi::PropNameID YeetTestRuntime::createPropNameIDFromString(const jsi::String &str) {
+  counters.createPropNameID++;
+  return wrap<jsi::PropNameID>(makeString(cell(str).string));
+}
+
+std::string YeetTestRuntime::utf8(const jsi::PropNameID &name) {
+  counters.propNameUtf8++;
+  return cell(name).string;
+}
+
+bool YeetTestRuntime::compare(const jsi::PropNameID &a, const jsi::PropNameID &b) {
+  return cell(a).string == cell(b).string;
+}
+
+std::string YeetTestRuntime::symbolToString(const jsi::Symbol &symbol) {
+  return "Symbol(" + cell(symbol).string + ")";
+}
+
+jsi::String YeetTestRuntime::createStringFromAscii(const char *str, size_t length) {
+  return wrap<jsi::String>(makeString(std::string(str, length)));
+}
+
+jsi::String YeetTestRuntime::createStringFromUtf8(const uint8_t *utf8, size_t length) {
+  return wrap<jsi::String>(makeString(std::string(reinterpret_cast<const char *>(utf8), length)));
+}
+
+std::string YeetTestRuntime::utf8(const jsi::String &string) {
+  return cell(string).string;
+}
+
+jsi::Object YeetTestRuntime::createObject() {
+  return wrap<jsi::Object>(std::make_shared<Cell>());
+}
+
+jsi::Object YeetTestRuntime::createObject(std::shared_ptr<jsi::HostObject> hostObject) {
+  auto object = std::make_shared<Cell>();
+  object->hostObject = std::move(hostObject);
+  return wrap<jsi::Object>(object);
+}
+
+std::shared_ptr<jsi::HostObject> YeetTestRuntime::getHostObject(const jsi::Object &object) {
+  return cell(object).hostObject;
+}
+
+jsi::HostFunctionType &YeetTestRuntime::getHostFunction(const jsi::Function &function) {
+  return *cell(function).hostFunction;
+}
+
+jsi::Value YeetTestRuntime::getNamedProperty(const jsi::Object &object, const std::string &name) {
+  counters.getProperty++;
+  Cell &target = cell(object);
+  if (target.isArray && name == "length") {
+    return jsi::Value((double)target.elements.size());
+  }
+
+  for (auto &property : target.properties) {
+    if (property.first == name) {
+      return jsi::Value(*this, property.second);
+    }
+  }
+  return jsi::Value::undefined();
+}
+
+void YeetTestRuntime::setNamedProperty(jsi::Object &object, const std::string &name, const jsi::Value &value) {
+  Cell &target = cell(object);
+  for (auto &property : target.properties) {
+    if (property.first == name) {
+      property.second = jsi::Value(*this, value);
+      return;
+    }
+  }
+  target.properties.emplace_back(name, jsi::Value(*this, value));
+}
+
+jsi::Value YeetTestRuntime::getProperty(const jsi::Object &object, const jsi::PropNameID &name) {
+  Cell &target = cell(object);
+  if (target.hostObject) {
+    counters.getProperty++;
+    return target.hostObject->get(*this, name);
+  }
+  return getNamedProperty(object, cell(name).string);
+}
+
+jsi::Value YeetTestRuntime::getProperty(const jsi::Object &object, const jsi::String &name) {
+  Cell &target = cell(object);
+  if (target.hostObject) {
+    counters.getProperty++;
+    return target.hostObject->get(*this, wrap<jsi::PropNameID>(makeString(cell(name).string)));
+  }
+  return getNamedProperty(object, cell(name).string);
+}
+
+bool YeetTestRuntime::hasProperty(const jsi::Object &object, const jsi::PropNameID &name) {
+  return !getProperty(object, name).isUndefined();
+}
+
+bool YeetTestRuntime::hasProperty(const jsi::Object &object, const jsi::String &name) {
+  return !getProperty(object, name).isUndefined();
+}
+
+void YeetTestRuntime::setPropertyValue(jsi::Object &object, const jsi::PropNameID &name, const jsi::Value &value) {
+  Cell &target = cell(object);
+  if (target.hostObject) {
+    target.hostObject->set(*this, name, value);
+    return;
+  }
+  setNamedProperty(object, cell(name).string, value);
+}
+
+void YeetTestRuntime::setPropertyValue(jsi::Object &object, const jsi::String &name, const jsi::Value &value) {
+  Cell &target = cell(object);
+  if (target.hostObject) {
+    target.hostObject->set(*this, wrap<jsi::PropNameID>(makeString(cell(name).string)), value);
+    return;
+  }
+  setNamedProperty(object, cell(name).string, value);
+}
+
+bool YeetTestRuntime::isArray(const jsi::Object &object) const {
+  return cell(object).isArray;
+}
+
+bool YeetTestRuntime::isArrayBuffer(const jsi::Object &object) const {
+  return false;
+}
+
+bool YeetTestRuntime::isFunction(const jsi::Object &object) const {
+  return cell(object).hostFunction != nullptr;
+}
+
+bool YeetTestRuntime::isHostObject(const jsi::Object &object) const {
+  return cell(object).hostObject != nullptr;
+}
+
+bool YeetTestRuntime::isHostFunction(const jsi::Function &function) const {
+  return cell(function).hostFunction != nullptr;
+}
+
+jsi::Array YeetTestRuntime::getPropertyNames(const jsi::Object &object) {
+  Cell &target = cell(object);
+  std::vector<std::string> names;
+  if (target.hostObject) {
+    for (auto &name : target.hostObject->getPropertyNames(*this)) {
+      names.push_back(cell(name).string);
+    }
+  } else {
+    for (auto &property : target.properties) {
+      names.push_back(property.first);
+    }
+  }
+
+  jsi::Array result = createArray(names.size());
+  for (size_t i = 0; i < names.size(); i++) {
+    result.setValueAtIndex(*this, i, wrap<jsi::String>(makeString(names[i])));
+  }
+  return result;
+}
+
+jsi::WeakObject YeetTestRuntime::createWeakObject(const jsi::Object &object) {
+  return wrap<jsi::WeakObject>(static_cast<const CellPointer *>(getPointerValue(object))->cell);
+}
+
+jsi::Value YeetTestRuntime::lockWeakObject(const jsi::WeakObject &object) {
+  return wrap<jsi::Object>(static_cast<const CellPointer *>(getPointerValue(object))->cell);
+}
+
+jsi::Array YeetTestRuntime::createArray(size_t length) {
+  auto array = std::make_shared<Cell>();
+  array->isArray = true;
+  array->elements.resize(length);
+  return wrap<jsi::Array>(array);
+}
+
+size_t YeetTestRuntime::size(const jsi::Array &array) {
+  return cell(array).elements.size();
+}
+
+size_t YeetTestRuntime::size(const jsi::ArrayBuffer &buffer) {
+  throw jsi::JSINativeException("YeetTestRuntime doesn't have ArrayBuffers");
+}
+
+uint8_t *YeetTestRuntime::data(const jsi::ArrayBuffer &buffer) {
+  throw jsi::JSINativeException("YeetTestRuntime doesn't have ArrayBuffers");
+}
+
+jsi::Value YeetTestRuntime::getValueAtIndex(const jsi::Array &array, size_t index) {
+  Cell &target = cell(array);
+  if (index >= target.elements.size()) {
+    return jsi::Value::undefined();
+  }
+  return jsi::Value(*this, target.elements[index]);
+}
+
+void YeetTestRuntime::setValueAtIndexImpl(jsi::Array &array, size_t index, const jsi::Value &value) {
+  Cell &target = cell(array);
+  if (index >= target.elements.size()) {
+    target.elements.resize(index + 1);
+  }
+  target.elements[index] = jsi::Value(*this, value);
+}
+
+jsi::Function YeetTestRuntime::createFunctionFromHostFunction(const jsi::PropNameID &name, unsigned int paramCount, jsi::HostFunctionType func) {
+  counters.createFunction++;
+  auto function = std::make_shared<Cell>();
+  function->string = cell(name).string;
+  function->hostFunction.reset(new jsi::HostFunctionType(std::move(func)));
+  return wrap<jsi::Function>(function);
+}
+
+jsi::Value YeetTestRuntime::call(const jsi::Function &function, const jsi::Value &jsThis, const jsi::Value *args, size_t count) {
+  return (*cell(function).hostFunction)(*this, jsThis, args, count);
+}
+
+jsi::Value YeetTestRuntime::callAsConstructor(const jsi::Function &function, const jsi::Value *args, size_t count) {
+  jsi::Value object = jsi::Value(createObject());
+  jsi::Value result = call(function, object, args, count);
+  return result.isObject() ? std::move(result) : std::move(object);
+}
+
+bool YeetTestRuntime::strictEquals(const jsi::Symbol &a, const jsi::Symbol &b) const {
+  return &cell(a) == &cell(b);
+}
+
+bool YeetTestRuntime::strictEquals(const jsi::String &a, const jsi::String &b) const {
+  return cell(a).string == cell(b).string;
+}
+
+bool YeetTestRuntime::strictEquals(const jsi::Object &a, const jsi::Object &b) const {
+  return &cell(a) == &cell(b);
+}
+
+bool YeetTestRuntime::instanceOf(const jsi::Object &object, const jsi::Function &constructor) {
+  return false;
+}
+
+void YeetTestJSCallInvoker::invokeAsync(std::function<void()> &&func) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  queue_.push_back(std::move(func));
+}
+
+size_t YeetTestJSCallInvoker::flush() {
+  size_t ran = 0;
+  while (true) {
+    std::vector<std::function<void()>> queue;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue.swap(queue_);
+    }
+    if (queue.empty()) {
+      return ran;
+    }
+    for (auto &func : queue) {
+      func();
+      ran++;
+    }
+  }
+}
+
+size_t YeetTestJSCallInvoker::pending() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_.size();
+}
@@ -0,0 +1,149 @@
+//
+//  YeetTestRuntime.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <jsi/jsi.h>
+#include <ReactCommon/JSCallInvoker.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace facebook;
+
+// A small in-memory jsi::Runtime for testing native modules without a JS engine. It can't evaluate
+// JavaScript, but it has plain objects, arrays, strings, host objects and host functions, plus
+// global.Error and a global.Promise that settles synchronously.
+//
+// Counts the calls the native side makes, so tests can check how much work a lookup does.
+class YeetTestRuntime : public jsi::Runtime {
+public:
+  struct Counters {
+    size_t getProperty = 0;
+    size_t propNameUtf8 = 0;
+    size_t createPropNameID = 0;
+    size_t createFunction = 0;
+  };
+
+  enum class PromiseState {
+    notAPromise,
+    pending,
+    fulfilled,
+    rejected,
+  };
+
+  YeetTestRuntime();
+  ~YeetTestRuntime();
+
+  Counters counters;
+
+  // The state of a promise created by global.Promise, and the value it settled with.
+  PromiseState promiseState(const jsi::Value &promise);
+  jsi::Value promiseResult(const jsi::Value &promise);
+
+  jsi::Value evaluateJavaScript(const std::shared_ptr<const jsi::Buffer> &buffer, const std::string &sourceURL) override;
+  std::shared_ptr<const jsi::PreparedJavaScript> prepareJavaScript(const std::shared_ptr<const jsi::Buffer> &buffer, std::string sourceURL) override;
+  jsi::Value evaluatePreparedJavaScript(const std::shared_ptr<const jsi::PreparedJavaScript> &js) override;
+  jsi::Object global() override;
+  std::string description() override;
+  bool isInspectable() override;
+
+  struct Cell;
+
+protected:
+  PointerValue *cloneSymbol(const PointerValue *pv) override;
+  PointerValue *cloneString(const PointerValue *pv) override;
+  PointerValue *cloneObject(const PointerValue *pv) override;
+  PointerValue *clonePropNameID(const PointerValue *pv) override;
+
+  jsi::PropNameID createPropNameIDFromAscii(const char *str, size_t length) override;
+  jsi::PropNameID createPropNameIDFromUtf8(const uint8_t *utf8, size_t length) override;
+  jsi::PropNameID createPropNameIDFromString(const jsi::String &str) override;
+  std::string utf8(const jsi::PropNameID &name) override;
+  bool compare(const jsi::PropNameID &a, const jsi::PropNameID &b) override;
+
+  std::string symbolToString(const jsi::Symbol &symbol) override;
+
+  jsi::String createStringFromAscii(const char *str, size_t length) override;
+  jsi::String createStringFromUtf8(const uint8_t *utf8, size_t length) override;
+  std::string utf8(const jsi::String &string) override;
+
+  jsi::Object createObject() override;
+  jsi::Object createObject(std::shared_ptr<jsi::HostObject> hostObject) override;
+  std::shared_ptr<jsi::HostObject> getHostObject(const jsi::Object &object) override;
+  jsi::HostFunctionType &getHostFunction(const jsi::Function &function) override;
+
+  jsi::Value getProperty(const jsi::Object &object, const jsi::PropNameID &name) override;
+  jsi::Value getProperty(const jsi::Object &object, const jsi::String &name) override;
+  bool hasProperty(const jsi::Object &object, const jsi::PropNameID &name) override;
+  bool hasProperty(const jsi::Object &object, const jsi::String &name) override;
+  void setPropertyValue(jsi::Object &object, const jsi::PropNameID &name, const jsi::Value &value) override;
+  void setPropertyValue(jsi::Object &object, const jsi::String &name, const jsi::Value &value) override;
+
+  bool isArray(const jsi::Object &object) const override;
+  bool isArrayBuffer(const jsi::Object &object) const override;
+  bool isFunction(const jsi::Object &object) const override;
+  bool isHostObject(const jsi::Object &object) const override;
+  bool isHostFunction(const jsi::Function &function) const override;
+  jsi::Array getPropertyNames(const jsi::Object &object) override;
+
+  jsi::WeakObject createWeakObject(const jsi::Object &object) override;
+  jsi::Value lockWeakObject(const jsi::WeakObject &object) override;
+
+  jsi::Array createArray(size_t length) override;
+  size_t size(const jsi::Array &array) override;
+  size_t size(const jsi::ArrayBuffer &buffer) override;
+  uint8_t *data(const jsi::ArrayBuffer &buffer) override;
+  jsi::Value getValueAtIndex(const jsi::Array &array, size_t index) override;
+  void setValueAtIndexImpl(jsi::Array &array, size_t index, const jsi::Value &value) override;
+
+  jsi::Function createFunctionFromHostFunction(const jsi::PropNameID &name, unsigned int paramCount, jsi::HostFunctionType func) override;
+  jsi::Value call(const jsi::Function &function, const jsi::Value &jsThis, const jsi::Value *args, size_t count) override;
+  jsi::Value callAsConstructor(const jsi::Function &function, const jsi::Value *args, size_t count) override;
+
+  bool strictEquals(const jsi::Symbol &a, const jsi::Symbol &b) const override;
+  bool strictEquals(const jsi::String &a, const jsi::String &b) const override;
+  bool strictEquals(const jsi::Object &a, const jsi::Object &b) const override;
+
+  bool instanceOf(const jsi::Object &object, const jsi::Function &constructor) override;
+
+private:
+  struct CellPointer;
+
+  static Cell &cell(const jsi::Pointer &pointer);
+  static const Cell &cell(const jsi::Value &value);
+  template <typename T>
+  static T wrap(std::shared_ptr<Cell> cell);
+  static std::shared_ptr<Cell> makeString(std::string string);
+
+  jsi::Value getNamedProperty(const jsi::Object &object, const std::string &name);
+  void setNamedProperty(jsi::Object &object, const std::string &name, const jsi::Value &value);
+  void installGlobals();
+
+  std::shared_ptr<Cell> global_;
+};
+
+// Runs invokeAsync() work when the test says so, like the JS thread picking it up later.
+class YeetTestJSCallInvoker : public react::JSCallInvoker {
+public:
+  void invokeAsync(std::function<void()> &&func) override;
+
+  // Runs everything queued so far, including work queued while running. Returns how many ran.
+  size_t flush();
+  size_t pending();
+
+private:
+  std::mutex mutex_;
+  std::vector<std::function<void()>> queue_;
+};
+
+#endif
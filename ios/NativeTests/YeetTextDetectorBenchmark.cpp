@@ -0,0 +1,162 @@
+//
+//  YeetTextDetectorBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "YeetSquareDetector.h"
+#include "YeetTextDetector.h"
+#include "YeetTextDetectorFixtures.h"
+
+// Runs YeetTextDetector over a synthetic meme corpus: photo-sized frames with shapes and sensor
+// noise behind top and bottom captions. Reports time per image, how many captions came back as a
+// line, and how many lines weren't captions. Then times text + square detection the way SmartCrop
+// runs them, with one shared YeetDetectorPreprocessor, against two separate detect(image) calls.
+
+struct YeetMeme {
+  cv::Mat image;
+  std::vector<cv::Rect> captions;
+};
+
+static const char *YeetMemeWords[] = {
+  "WHEN", "THE", "CODE", "FINALLY", "COMPILES", "ME", "EXPLAINING", "TO", "MY", "MOM", "WHY",
+  "NOBODY", "ASKED", "MONDAY", "AGAIN", "SEND", "HELP", "ONE", "DOES", "NOT", "SIMPLY", "DEPLOY",
+  "ON", "FRIDAY",
+};
+
+static YeetMeme makeMeme(int index, std::mt19937 &random) {
+  static const cv::Size sizes[] = {cv::Size(640, 480), cv::Size(1080, 1080), cv::Size(720, 1280), cv::Size(1280, 720)};
+  const cv::Size size = sizes[index % 4];
+  auto uniform = [&random](int low, int high) {
+    return std::uniform_int_distribution<int>(low, high)(random);
+  };
+
+  YeetMeme meme;
+  meme.image = yeetMemeBackground(size.width, size.height);
+
+  const int shapes = uniform(3, 6);
+  for (int s = 0; s < shapes; s++) {
+    const cv::Scalar color(uniform(0, 255), uniform(0, 255), uniform(0, 255), 255);
+    const cv::Point center(uniform(0, size.width), uniform(size.height / 5, size.height * 4 / 5));
+    const cv::Size axes(uniform(size.width / 20, size.width / 5), uniform(size.height / 20, size.height / 5));
+    if (s % 2) {
+      cv::ellipse(meme.image, center, axes, uniform(0, 180), 0, 360, color, cv::FILLED);
+    } else {
+      cv::rectangle(meme.image, center - cv::Point(axes.width, axes.height), center + cv::Point(axes.width, axes.height), color, cv::FILLED);
+    }
+  }
+
+  cv::Mat noise(size, CV_16SC4);
+  cv::randn(noise, cv::Scalar(0, 0, 0, 0), cv::Scalar(4, 4, 4, 0));
+  cv::Mat wide;
+  meme.image.convertTo(wide, CV_16SC4);
+  wide += noise;
+  wide.convertTo(meme.image, CV_8UC4);
+
+  for (bool top : {true, false}) {
+    std::string text;
+    const int words = uniform(2, 4);
+    for (int w = 0; w < words; w++) {
+      text += (w ? " " : "") + std::string(YeetMemeWords[uniform(0, (int)(sizeof(YeetMemeWords) / sizeof(YeetMemeWords[0])) - 1)]);
+    }
+
+    double scale = size.width / 400.0;
+    int thickness = std::max(2, size.width / 270);
+    int baseline = 0;
+    cv::Size textSize = cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX, scale, thickness, &baseline);
+    if (textSize.width > size.width * 0.9) {
+      const double shrink = size.width * 0.9 / textSize.width;
+      scale *= shrink;
+      thickness = std::max(2, (int)(thickness * shrink));
+      textSize = cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX, scale, thickness, &baseline);
+    }
+
+    const int x = (size.width - textSize.width) / 2;
+    const int y = top ? textSize.height + size.height / 20 : size.height - size.height / 20 - baseline;
+    meme.captions.push_back(yeetDrawCaption(meme.image, text, cv::Point(x, y), scale, thickness));
+  }
+
+  return meme;
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+  const int count = std::max(1, argc > 1 ? atoi(argv[1]) : 24);
+
+  cv::theRNG().state = 1;
+  std::mt19937 random(1);
+  std::vector<YeetMeme> corpus;
+  for (int i = 0; i < count; i++) {
+    corpus.push_back(makeMeme(i, random));
+  }
+
+  YeetTextDetector textDetector;
+  std::vector<YeetTextLine> lines;
+  std::vector<double> times;
+  int found = 0;
+  int captions = 0;
+  int extra = 0;
+
+  for (const auto &meme : corpus) {
+    auto start = std::chrono::steady_clock::now();
+    textDetector.detect(meme.image, lines);
+    times.push_back(millisecondsSince(start));
+
+    for (const auto &caption : meme.captions) {
+      captions++;
+      found += std::any_of(lines.begin(), lines.end(), [&caption](const YeetTextLine &line) {
+        return yeetRectIoU(line.bounds, caption) > 0.5;
+      });
+    }
+    for (const auto &line : lines) {
+      extra += std::none_of(meme.captions.begin(), meme.captions.end(), [&line](const cv::Rect &caption) {
+        return yeetRectIoU(line.bounds, caption) > 0.5;
+      });
+    }
+  }
+
+  YeetSquareDetector squareDetector;
+  std::vector<YeetSquare> squares;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &meme : corpus) {
+    textDetector.detect(meme.image, lines);
+    squareDetector.detect(meme.image, squares);
+  }
+  const double separate = millisecondsSince(start) / count;
+
+  YeetDetectorPreprocessor preprocessor;
+  start = std::chrono::steady_clock::now();
+  for (const auto &meme : corpus) {
+    preprocessor.process(meme.image, YeetTextDetectorOptions().medianBlurSize);
+    textDetector.detect(preprocessor, lines);
+    squareDetector.detect(preprocessor, squares);
+  }
+  const double shared = millisecondsSince(start) / count;
+
+  std::vector<double> sorted = times;
+  std::sort(sorted.begin(), sorted.end());
+  double total = 0;
+  for (double time : times) {
+    total += time;
+  }
+
+  printf("%d memes, %d captions\n", count, captions);
+  printf("text lines:               %7.2f ms/image mean, %7.2f ms p95\n", total / count, sorted[std::min(sorted.size() - 1, sorted.size() * 95 / 100)]);
+  printf("captions found:           %d/%d\n", found, captions);
+  printf("lines that aren't captions: %d\n", extra);
+  printf("text + squares, separate: %7.2f ms/image\n", separate);
+  printf("text + squares, shared:   %7.2f ms/image\n", shared);
+  return 0;
+}
@@ -0,0 +1,45 @@
+//
+//  YeetTextDetectorFixtures.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <algorithm>
+#include <string>
+
+// An RGBA vertical gradient, standing in for the photo behind a caption.
+inline cv::Mat yeetMemeBackground(int width, int height) {
+  cv::Mat image(height, width, CV_8UC4);
+  for (int y = 0; y < height; y++) {
+    image.row(y).setTo(cv::Scalar(60 + y * 120 / height, 90, 160 - y * 96 / height, 255));
+  }
+  return image;
+}
+
+// Draws text with its baseline starting at origin, the usual meme way (white with a black outline)
+// when outlined, otherwise in color. Returns the box cv::getTextSize says it covers.
+inline cv::Rect yeetDrawCaption(cv::Mat &image, const std::string &text, cv::Point origin, double scale, int thickness, bool outlined = true, cv::Scalar color = cv::Scalar(255, 255, 255, 255)) {
+  if (outlined) {
+    cv::putText(image, text, origin, cv::FONT_HERSHEY_SIMPLEX, scale, cv::Scalar(0, 0, 0, 255), thickness + 6, cv::LINE_AA);
+  }
+  cv::putText(image, text, origin, cv::FONT_HERSHEY_SIMPLEX, scale, color, thickness, cv::LINE_AA);
+
+  int baseline = 0;
+  const cv::Size size = cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX, scale, thickness, &baseline);
+  return cv::Rect(origin.x, origin.y - size.height, size.width, size.height + baseline);
+}
+
+inline double yeetRectIoU(const cv::Rect &a, const cv::Rect &b) {
+  const double intersection = (a & b).area();
+  return intersection / std::max(1.0, a.area() + b.area() - intersection);
+}
+
+#endif
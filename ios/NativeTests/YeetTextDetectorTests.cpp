@@ -0,0 +1,135 @@
+//
+//  YeetTextDetectorTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetTextDetector.h"
+#include "YeetTextDetectorFixtures.h"
+#include <algorithm>
+
+static int letterCount(const std::string &text) {
+  return (int)std::count_if(text.begin(), text.end(), [](char c) { return c != ' '; });
+}
+
+static void expectLine(const YeetTextLine &line, const cv::Rect &expected, const std::string &text) {
+  EXPECT_GT(yeetRectIoU(line.bounds, expected), 0.7) << text;
+  // Outlines, counters and whole words show up as candidates too, so there are usually more.
+  EXPECT_GE(line.characterCount, letterCount(text)) << text;
+}
+
+TEST(YeetTextDetector, FindsTopAndBottomCaptions) {
+  cv::Mat image = yeetMemeBackground(640, 480);
+  const cv::Rect bottom = yeetDrawCaption(image, "FINALLY COMPILES", cv::Point(40, 440), 1.6, 4);
+  const cv::Rect top = yeetDrawCaption(image, "WHEN THE CODE", cv::Point(40, 70), 1.6, 4);
+
+  YeetTextDetector detector;
+  std::vector<YeetTextLine> lines;
+  detector.detect(image, lines);
+
+  ASSERT_EQ(lines.size(), 2u);
+  expectLine(lines[0], top, "WHEN THE CODE");
+  expectLine(lines[1], bottom, "FINALLY COMPILES");
+}
+
+// Every letter sits inside its outline's region, and each word's outline is one region. Those must
+// not swallow the letters as duplicates, or a two-word caption only counts two characters.
+TEST(YeetTextDetector, KeepsStackedLinesApart) {
+  cv::Mat image = yeetMemeBackground(640, 480);
+  const cv::Rect first = yeetDrawCaption(image, "FIRST LINE", cv::Point(40, 200), 1.6, 4);
+  const cv::Rect second = yeetDrawCaption(image, "SECOND LINE", cv::Point(40, 262), 1.6, 4);
+
+  YeetTextDetector detector;
+  std::vector<YeetTextLine> lines;
+  detector.detect(image, lines);
+
+  ASSERT_EQ(lines.size(), 2u);
+  expectLine(lines[0], first, "FIRST LINE");
+  expectLine(lines[1], second, "SECOND LINE");
+}
+
+TEST(YeetTextDetector, SplitsWordsTooFarApart) {
+  cv::Mat image = yeetMemeBackground(640, 480);
+  const cv::Rect left = yeetDrawCaption(image, "LEFT", cv::Point(30, 240), 1.6, 4);
+  const cv::Rect right = yeetDrawCaption(image, "RIGHT", cv::Point(420, 240), 1.6, 4);
+
+  YeetTextDetector detector;
+  std::vector<YeetTextLine> lines;
+  detector.detect(image, lines);
+
+  ASSERT_EQ(lines.size(), 2u);
+  // Same row, so they're ordered left to right.
+  expectLine(lines[0], left, "LEFT");
+  expectLine(lines[1], right, "RIGHT");
+}
+
+TEST(YeetTextDetector, FindsDarkTextOnLight) {
+  cv::Mat image(300, 640, CV_8UC4, cv::Scalar(255, 255, 255, 255));
+  const cv::Rect expected = yeetDrawCaption(image, "hello there world", cv::Point(30, 150), 1.4, 3, false, cv::Scalar(0, 0, 0, 255));
+
+  YeetTextDetector detector;
+  std::vector<YeetTextLine> lines;
+  detector.detect(image, lines);
+
+  ASSERT_EQ(lines.size(), 1u);
+  expectLine(lines[0], expected, "hello there world");
+}
+
+TEST(YeetTextDetector, IgnoresNoiseAndSolidBlocks) {
+  YeetTextDetector detector;
+  std::vector<YeetTextLine> lines;
+
+  cv::Mat noisy = yeetMemeBackground(640, 480);
+  cv::Mat noise(noisy.size(), CV_16SC4);
+  cv::randn(noise, cv::Scalar(0, 0, 0, 0), cv::Scalar(6, 6, 6, 0));
+  cv::Mat wide;
+  noisy.convertTo(wide, CV_16SC4);
+  wide += noise;
+  wide.convertTo(noisy, CV_8UC4);
+  detector.detect(noisy, lines);
+  EXPECT_TRUE(lines.empty());
+
+  // A row of character-sized boxes, but solid ones fill their bounds, which glyphs don't.
+  cv::Mat blocks = yeetMemeBackground(640, 480);
+  for (int i = 0; i < 6; i++) {
+    cv::rectangle(blocks, cv::Point(40 + i * 60, 200), cv::Point(80 + i * 60, 240), cv::Scalar(255, 255, 255, 255), cv::FILLED);
+  }
+  detector.detect(blocks, lines);
+  EXPECT_TRUE(lines.empty());
+}
+
+TEST(YeetTextDetector, SharedPreprocessingGivesTheSameLines) {
+  cv::Mat image = yeetMemeBackground(640, 480);
+  yeetDrawCaption(image, "WHEN THE CODE", cv::Point(40, 70), 1.6, 4);
+  yeetDrawCaption(image, "FINALLY COMPILES", cv::Point(40, 440), 1.6, 4);
+
+  YeetTextDetector detector;
+  std::vector<YeetTextLine> expected;
+  detector.detect(image, expected);
+
+  YeetDetectorPreprocessor preprocessor;
+  preprocessor.process(image, YeetTextDetectorOptions().medianBlurSize);
+  std::vector<YeetTextLine> shared;
+  detector.detect(preprocessor, shared);
+
+  ASSERT_EQ(shared.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(shared[i].bounds, expected[i].bounds);
+    EXPECT_EQ(shared[i].characterCount, expected[i].characterCount);
+  }
+}
+
+TEST(YeetTextDetector, RejectsImagesWithoutColor) {
+  YeetTextDetector detector;
+  std::vector<YeetTextLine> lines(1);
+
+  detector.detect(cv::Mat(), lines);
+  EXPECT_TRUE(lines.empty());
+
+  lines.resize(1);
+  detector.detect(cv::Mat(100, 100, CV_8UC1, cv::Scalar(0)), lines);
+  EXPECT_TRUE(lines.empty());
+}
@@ -0,0 +1,82 @@
+//
+//  YeetThresholdKernelBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include "YeetThresholdKernel.h"
+
+// Times binarizing one detector plane at every level: one cv::threshold pass per level (what
+// find_squares did with `gray0 >= level`) against one yeetMultiThreshold pass. Exits non-zero if
+// they disagree.
+
+template <typename Run>
+static double millisecondsPerPlane(int iterations, Run &&run) {
+  run();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    run();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+}
+
+int main(int argc, char **argv) {
+  const int width = argc > 1 ? atoi(argv[1]) : 1080;
+  const int height = argc > 2 ? atoi(argv[2]) : 1440;
+  const int levels = argc > 3 ? atoi(argv[3]) : 10;
+  const int iterations = argc > 4 ? atoi(argv[4]) : 50;
+
+  std::mt19937 random(1);
+  cv::Mat plane(height, width, CV_8UC1);
+  for (int y = 0; y < height; y++) {
+    uchar *row = plane.ptr<uchar>(y);
+    for (int x = 0; x < width; x++) {
+      // Smooth, like a blurred camera plane, plus a little noise.
+      row[x] = cv::saturate_cast<uchar>(128 + 100 * sin(x * 0.01) * cos(y * 0.013) + (int)(random() % 9) - 4);
+    }
+  }
+
+  std::vector<uchar> thresholds(levels);
+  for (int l = 0; l < levels; l++) {
+    thresholds[l] = (uchar)((l + 1) * 255 / levels);
+  }
+
+  std::vector<cv::Mat> perLevel(levels);
+  std::vector<cv::Mat> multi;
+  yeetMultiThreshold(plane, thresholds, multi);
+  for (int l = 0; l < levels; l++) {
+    cv::threshold(plane, perLevel[l], thresholds[l] - 1.0, 255, cv::THRESH_BINARY);
+    for (int y = 0; y < height; y++) {
+      if (memcmp(perLevel[l].ptr<uchar>(y), multi[l].ptr<uchar>(y), width) != 0) {
+        fprintf(stderr, "level %d differs from cv::threshold at row %d\n", l, y);
+        return 1;
+      }
+    }
+  }
+
+  double threshold = millisecondsPerPlane(iterations, [&]() {
+    for (int l = 0; l < levels; l++) {
+      cv::threshold(plane, perLevel[l], thresholds[l] - 1.0, 255, cv::THRESH_BINARY);
+    }
+  });
+
+  double multiThreshold = millisecondsPerPlane(iterations, [&]() {
+    yeetMultiThreshold(plane, thresholds, multi);
+  });
+
+  printf("%dx%d plane, %d levels, %d iterations, %d threads\n", width, height, levels, iterations, cv::getNumThreads());
+  printf("cv::threshold per level: %7.3f ms/plane\n", threshold);
+  printf("yeetMultiThreshold:      %7.3f ms/plane\n", multiThreshold);
+  return 0;
+}
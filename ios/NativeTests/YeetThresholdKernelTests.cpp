@@ -0,0 +1,119 @@
+//
+//  YeetThresholdKernelTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include <opencv2/imgproc/imgproc.hpp>
+#include "YeetThresholdKernel.h"
+#include <random>
+
+static cv::Mat randomPlane(int width, int height, std::mt19937 &random) {
+  cv::Mat plane(height, width, CV_8UC1);
+  std::uniform_int_distribution<int> value(0, 255);
+  for (int y = 0; y < height; y++) {
+    uchar *row = plane.ptr<uchar>(y);
+    for (int x = 0; x < width; x++) {
+      row[x] = (uchar)value(random);
+    }
+  }
+  return plane;
+}
+
+// src >= t is src > t - 1, which is what THRESH_BINARY computes.
+static void expectMatchesThreshold(const cv::Mat &src, const std::vector<uchar> &thresholds, const std::vector<cv::Mat> &dst) {
+  ASSERT_EQ(dst.size(), thresholds.size());
+
+  cv::Mat expected;
+  for (size_t l = 0; l < thresholds.size(); l++) {
+    cv::threshold(src, expected, thresholds[l] - 1.0, 255, cv::THRESH_BINARY);
+    ASSERT_EQ(dst[l].rows, src.rows);
+    ASSERT_EQ(dst[l].cols, src.cols);
+
+    for (int y = 0; y < src.rows; y++) {
+      const uchar *actualRow = dst[l].ptr<uchar>(y);
+      const uchar *expectedRow = expected.ptr<uchar>(y);
+      for (int x = 0; x < src.cols; x++) {
+        ASSERT_EQ(actualRow[x], expectedRow[x]) << "level " << l << " (" << (int)thresholds[l] << ") at " << x << ", " << y;
+      }
+    }
+  }
+}
+
+static std::vector<uchar> detectorThresholds(int levels) {
+  std::vector<uchar> thresholds(levels);
+  for (int l = 0; l < levels; l++) {
+    thresholds[l] = (uchar)((l + 1) * 255 / levels);
+  }
+  return thresholds;
+}
+
+// Widths on both sides of the 16-pixel vector width, so the scalar tail runs too.
+TEST(YeetThresholdKernel, MatchesCvThreshold) {
+  std::mt19937 random(7);
+  std::vector<cv::Mat> dst;
+
+  for (int width : {1, 15, 16, 17, 100, 641}) {
+    cv::Mat src = randomPlane(width, 37, random);
+    for (int levels : {1, 10}) {
+      std::vector<uchar> thresholds = detectorThresholds(levels);
+      yeetMultiThreshold(src, thresholds, dst);
+      expectMatchesThreshold(src, thresholds, dst);
+    }
+  }
+}
+
+// More than one batch of 16 levels, and the edges of the range, where >= and > differ.
+TEST(YeetThresholdKernel, HandlesManyLevelsAndExtremeThresholds) {
+  std::mt19937 random(11);
+  cv::Mat src = randomPlane(203, 64, random);
+  src.at<uchar>(0, 0) = 0;
+  src.at<uchar>(0, 1) = 255;
+
+  std::vector<uchar> thresholds = {0, 1, 254, 255};
+  for (int t = 0; t < 40; t++) {
+    thresholds.push_back((uchar)std::uniform_int_distribution<int>(0, 255)(random));
+  }
+
+  std::vector<cv::Mat> dst;
+  yeetMultiThreshold(src, thresholds, dst);
+  expectMatchesThreshold(src, thresholds, dst);
+}
+
+// Planes from extractChannel are continuous, but ROIs aren't, so rows have to go through ptr().
+TEST(YeetThresholdKernel, ReadsRowsOfAView) {
+  std::mt19937 random(3);
+  cv::Mat image = randomPlane(300, 200, random);
+  cv::Mat view = image(cv::Rect(13, 7, 250, 150));
+  ASSERT_FALSE(view.isContinuous());
+
+  std::vector<uchar> thresholds = detectorThresholds(10);
+  std::vector<cv::Mat> dst;
+  yeetMultiThreshold(view, thresholds, dst);
+  expectMatchesThreshold(view, thresholds, dst);
+}
+
+TEST(YeetThresholdKernel, ReallocatesOnlyWhenTheSizeChanges) {
+  std::mt19937 random(5);
+  std::vector<uchar> thresholds = detectorThresholds(10);
+  std::vector<cv::Mat> dst;
+
+  cv::Mat first = randomPlane(64, 48, random);
+  yeetMultiThreshold(first, thresholds, dst);
+  const uchar *data = dst[0].data;
+
+  cv::Mat second = randomPlane(64, 48, random);
+  yeetMultiThreshold(second, thresholds, dst);
+  EXPECT_EQ(dst[0].data, data);
+  expectMatchesThreshold(second, thresholds, dst);
+
+  cv::Mat bigger = randomPlane(128, 96, random);
+  yeetMultiThreshold(bigger, thresholds, dst);
+  expectMatchesThreshold(bigger, thresholds, dst);
+
+  yeetMultiThreshold(bigger, {}, dst);
+  EXPECT_TRUE(dst.empty());
+}
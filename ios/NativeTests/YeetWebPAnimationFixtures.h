@@ -0,0 +1,159 @@
+//
+//  YeetWebPAnimationFixtures.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <WebP/encode.h>
+#include <WebPDemux/demux.h>
+#include <WebPMux/mux.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// One ANMF frame: a rectangle of straight (not premultiplied) RGBA pixels on the canvas.
+struct YeetTestWebPFrame {
+  int x = 0;
+  int y = 0;
+  int width = 0;
+  int height = 0;
+  int duration = 100;
+  bool blend = false;
+  bool disposeToBackground = false;
+  std::vector<uint8_t> rgba;
+};
+
+// A frame whose alpha cycles through opaque, half and fully transparent in 4px diagonal bands, so
+// blending and disposal both show up in the composited canvas. Offsets must be even (ANMF stores
+// them halved).
+inline YeetTestWebPFrame yeetTestWebPFrame(int seed, int x, int y, int width, int height, bool blend, bool disposeToBackground) {
+  YeetTestWebPFrame frame;
+  frame.x = x;
+  frame.y = y;
+  frame.width = width;
+  frame.height = height;
+  frame.blend = blend;
+  frame.disposeToBackground = disposeToBackground;
+  frame.rgba.resize((size_t)width * height * 4);
+
+  static const uint8_t alphas[] = {255, 128, 0};
+  for (int row = 0; row < height; row++) {
+    for (int column = 0; column < width; column++) {
+      uint8_t *pixel = &frame.rgba[((size_t)row * width + column) * 4];
+      pixel[0] = (uint8_t)(seed * 53 + column * 3);
+      pixel[1] = (uint8_t)(seed * 97 + row * 5);
+      pixel[2] = (uint8_t)(seed * 31 + (column ^ row));
+      pixel[3] = alphas[(column / 4 + row / 4 + seed) % 3];
+    }
+  }
+  return frame;
+}
+
+// Encodes each frame (lossless unless quality is given) and muxes them into an animated WebP.
+// Empty on failure.
+inline std::vector<uint8_t> yeetEncodeTestAnimation(int canvasWidth, int canvasHeight, const std::vector<YeetTestWebPFrame> &frames, float quality = -1) {
+  std::vector<uint8_t> file;
+  WebPMux *mux = WebPMuxNew();
+  if (!mux) {
+    return file;
+  }
+
+  bool ok = WebPMuxSetCanvasSize(mux, canvasWidth, canvasHeight) == WEBP_MUX_OK;
+  for (const auto &frame : frames) {
+    if (!ok) {
+      break;
+    }
+
+    uint8_t *encoded = nullptr;
+    const size_t size = quality < 0
+      ? WebPEncodeLosslessRGBA(frame.rgba.data(), frame.width, frame.height, frame.width * 4, &encoded)
+      : WebPEncodeRGBA(frame.rgba.data(), frame.width, frame.height, frame.width * 4, quality, &encoded);
+    if (size == 0) {
+      ok = false;
+      break;
+    }
+
+    WebPMuxFrameInfo info;
+    memset(&info, 0, sizeof(info));
+    info.bitstream.bytes = encoded;
+    info.bitstream.size = size;
+    info.x_offset = frame.x;
+    info.y_offset = frame.y;
+    info.duration = frame.duration;
+    info.id = WEBP_CHUNK_ANMF;
+    info.dispose_method = frame.disposeToBackground ? WEBP_MUX_DISPOSE_BACKGROUND : WEBP_MUX_DISPOSE_NONE;
+    info.blend_method = frame.blend ? WEBP_MUX_BLEND : WEBP_MUX_NO_BLEND;
+    ok = WebPMuxPushFrame(mux, &info, 1) == WEBP_MUX_OK;
+    WebPFree(encoded);
+  }
+
+  WebPMuxAnimParams params;
+  params.bgcolor = 0;
+  params.loop_count = 0;
+  WebPData assembled;
+  WebPDataInit(&assembled);
+  if (ok && WebPMuxSetAnimationParams(mux, &params) == WEBP_MUX_OK && WebPMuxAssemble(mux, &assembled) == WEBP_MUX_OK) {
+    file.assign(assembled.bytes, assembled.bytes + assembled.size);
+  }
+
+  WebPDataClear(&assembled);
+  WebPMuxDelete(mux);
+  return file;
+}
+
+// Every canvas of the animation from libwebp's own WebPAnimDecoder, premultiplied like
+// YeetAnimatedWebP's. Empty on failure.
+inline std::vector<std::vector<uint8_t>> yeetDecodeWithAnimDecoder(const std::vector<uint8_t> &file) {
+  std::vector<std::vector<uint8_t>> canvases;
+
+  WebPData data;
+  data.bytes = file.data();
+  data.size = file.size();
+  WebPAnimDecoderOptions options;
+  WebPAnimDecoderOptionsInit(&options);
+  options.color_mode = MODE_rgbA;
+
+  WebPAnimDecoder *decoder = WebPAnimDecoderNew(&data, &options);
+  if (!decoder) {
+    return canvases;
+  }
+
+  WebPAnimInfo info;
+  WebPAnimDecoderGetInfo(decoder, &info);
+  const size_t size = (size_t)info.canvas_width * info.canvas_height * 4;
+  while (WebPAnimDecoderHasMoreFrames(decoder)) {
+    uint8_t *canvas = nullptr;
+    int timestamp = 0;
+    if (!WebPAnimDecoderGetNext(decoder, &canvas, &timestamp)) {
+      canvases.clear();
+      break;
+    }
+    canvases.emplace_back(canvas, canvas + size);
+  }
+
+  WebPAnimDecoderDelete(decoder);
+  return canvases;
+}
+
+// Largest difference between two canvases in any channel, or 256 if their sizes differ.
+inline int yeetMaxChannelDifference(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b) {
+  if (a.size() != b.size()) {
+    return 256;
+  }
+
+  int difference = 0;
+  for (size_t i = 0; i < a.size(); i++) {
+    difference = std::max(difference, std::abs((int)a[i] - (int)b[i]));
+  }
+  return difference;
+}
+
+#endif
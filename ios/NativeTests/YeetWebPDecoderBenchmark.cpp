@@ -0,0 +1,117 @@
+//
+//  YeetWebPDecoderBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <WebP/encode.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "YeetResidentMemory.h"
+#include "YeetWebPDecoder.h"
+
+// Decodes a camera photo and a phone screenshot at full size and at common feed thumbnail sizes,
+// reporting time per decode and how far peak RSS rose during one decode. Full size is what
+// YeetWebImageDecoder used to decode for every request before scaling on the GPU.
+//
+// Exits non-zero if a decode fails or comes out at the wrong size.
+
+struct YeetBenchmarkSource {
+  const char *name;
+  int width;
+  int height;
+};
+
+struct YeetBenchmarkTarget {
+  const char *name;
+  int width;
+  int height;
+  YeetWebPResizeMode mode;
+};
+
+static const YeetBenchmarkSource YeetSources[] = {
+  {"photo", 4032, 3024},
+  {"screenshot", 1125, 2436},
+};
+
+// Pixel sizes: a full-width image, feed cells and avatars, all at 3x.
+static const YeetBenchmarkTarget YeetTargets[] = {
+  {"full size", 0, 0, YeetWebPResizeMode::cover},
+  {"1125x1125 fit", 1125, 1125, YeetWebPResizeMode::contain},
+  {"375x375 cover", 375, 375, YeetWebPResizeMode::cover},
+  {"180x180 cover", 180, 180, YeetWebPResizeMode::cover},
+  {"96x96 cover", 96, 96, YeetWebPResizeMode::cover},
+};
+
+// Smooth gradients with a little grain, which compresses about like a photo does.
+static std::vector<uint8_t> encodeSource(int width, int height) {
+  std::vector<uint8_t> rgb((size_t)width * height * 3);
+  uint32_t seed = 7;
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      seed = seed * 1664525 + 1013904223;
+      const int grain = (int)(seed >> 29) - 4;
+      uint8_t *pixel = &rgb[((size_t)y * width + x) * 3];
+      pixel[0] = (uint8_t)std::min(255, std::max(0, x * 255 / width + grain));
+      pixel[1] = (uint8_t)std::min(255, std::max(0, y * 255 / height + grain));
+      pixel[2] = (uint8_t)std::min(255, std::max(0, ((x + y) / 8) % 256 + grain));
+    }
+  }
+
+  uint8_t *output = nullptr;
+  const size_t size = WebPEncodeRGB(rgb.data(), width, height, width * 3, 80, &output);
+  std::vector<uint8_t> webp(output, output + size);
+  WebPFree(output);
+  return webp;
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+  const int runs = std::max(1, argc > 1 ? atoi(argv[1]) : 10);
+
+  bool failed = false;
+  for (const YeetBenchmarkSource &source : YeetSources) {
+    const std::vector<uint8_t> webp = encodeSource(source.width, source.height);
+    if (webp.empty()) {
+      fprintf(stderr, "couldn't encode the %s\n", source.name);
+      return 1;
+    }
+    printf("%s, %dx%d, %zu KB\n", source.name, source.width, source.height, webp.size() / 1024);
+
+    for (const YeetBenchmarkTarget &target : YeetTargets) {
+      const YeetWebPDecodePlan plan = yeetWebPDecodePlan(source.width, source.height, target.width, target.height, target.mode);
+
+      // The first decode, alone, for memory.
+      const long baseline = yeetResetPeakResident();
+      auto bitmap = yeetDecodeWebP(webp.data(), webp.size(), target.width, target.height, target.mode);
+      const long rssGrowth = yeetPeakResidentGrowth(baseline);
+      if (!bitmap || bitmap->width != plan.width || bitmap->height != plan.height) {
+        fprintf(stderr, "%s at %s: expected %dx%d\n", source.name, target.name, plan.width, plan.height);
+        failed = true;
+        continue;
+      }
+      bitmap.reset();
+
+      double total = 0;
+      for (int run = 0; run < runs; run++) {
+        auto start = std::chrono::steady_clock::now();
+        bitmap = yeetDecodeWebP(webp.data(), webp.size(), target.width, target.height, target.mode);
+        total += millisecondsSince(start);
+        bitmap.reset();
+      }
+
+      printf("  %-14s -> %4dx%-4d %8.2f ms   bitmap %7.2f MB   peak RSS +%7.2f MB\n", target.name, plan.width, plan.height,
+        total / runs, (double)plan.width * plan.height * 4 / (1024 * 1024), rssGrowth / 1024.0);
+    }
+  }
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+//
+//  YeetWebPDecoderTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/21/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetWebPDecoder.h"
+#include <WebP/encode.h>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+static void expectPlan(const YeetWebPDecodePlan &plan, int cropX, int cropY, int cropWidth, int cropHeight, int width, int height) {
+  EXPECT_EQ(plan.cropX, cropX);
+  EXPECT_EQ(plan.cropY, cropY);
+  EXPECT_EQ(plan.cropWidth, cropWidth);
+  EXPECT_EQ(plan.cropHeight, cropHeight);
+  EXPECT_EQ(plan.width, width);
+  EXPECT_EQ(plan.height, height);
+}
+
+TEST(YeetWebPDecodePlan, NoTargetDecodesEverything) {
+  for (auto mode : {YeetWebPResizeMode::cover, YeetWebPResizeMode::contain, YeetWebPResizeMode::stretch, YeetWebPResizeMode::none}) {
+    expectPlan(yeetWebPDecodePlan(400, 200, 0, 0, mode), 0, 0, 400, 200, 400, 200);
+    expectPlan(yeetWebPDecodePlan(400, 200, 100, 0, mode), 0, 0, 400, 200, 400, 200);
+  }
+}
+
+TEST(YeetWebPDecodePlan, CoverCropsToTheTargetAspectRatioThenShrinks) {
+  // Wider than the target: the sides are cropped.
+  expectPlan(yeetWebPDecodePlan(400, 200, 100, 100, YeetWebPResizeMode::cover), 100, 0, 200, 200, 100, 100);
+  // Taller than the target: the top and bottom are cropped.
+  expectPlan(yeetWebPDecodePlan(200, 400, 100, 50, YeetWebPResizeMode::cover), 0, 150, 200, 100, 100, 50);
+  // Smaller than the target: cropped, but never scaled up.
+  expectPlan(yeetWebPDecodePlan(100, 100, 400, 200, YeetWebPResizeMode::cover), 0, 25, 100, 50, 100, 50);
+
+  const YeetWebPDecodePlan plan = yeetWebPDecodePlan(400, 200, 100, 100, YeetWebPResizeMode::cover);
+  EXPECT_TRUE(plan.crops(400, 200));
+  EXPECT_TRUE(plan.scales());
+}
+
+TEST(YeetWebPDecodePlan, ContainShrinksTheWholeImage) {
+  expectPlan(yeetWebPDecodePlan(400, 200, 100, 100, YeetWebPResizeMode::contain), 0, 0, 400, 200, 100, 50);
+  expectPlan(yeetWebPDecodePlan(400, 200, 1000, 1000, YeetWebPResizeMode::contain), 0, 0, 400, 200, 400, 200);
+
+  const YeetWebPDecodePlan plan = yeetWebPDecodePlan(400, 200, 100, 100, YeetWebPResizeMode::contain);
+  EXPECT_FALSE(plan.crops(400, 200));
+}
+
+TEST(YeetWebPDecodePlan, StretchAndNone) {
+  expectPlan(yeetWebPDecodePlan(400, 200, 100, 300, YeetWebPResizeMode::stretch), 0, 0, 400, 200, 100, 200);
+  expectPlan(yeetWebPDecodePlan(400, 200, 100, 100, YeetWebPResizeMode::none), 0, 0, 400, 200, 400, 200);
+  EXPECT_FALSE(yeetWebPDecodePlan(400, 200, 100, 100, YeetWebPResizeMode::none).scales());
+}
+
+TEST(YeetWebPDecodePlan, StaysInsideTheSourceForAnySize) {
+  std::mt19937 random(3);
+  std::uniform_int_distribution<int> dimension(1, 5000);
+  for (int i = 0; i < 20000; i++) {
+    const int sourceWidth = dimension(random);
+    const int sourceHeight = dimension(random);
+    const int targetWidth = dimension(random);
+    const int targetHeight = dimension(random);
+    const auto mode = static_cast<YeetWebPResizeMode>(random() % 4);
+    const YeetWebPDecodePlan plan = yeetWebPDecodePlan(sourceWidth, sourceHeight, targetWidth, targetHeight, mode);
+
+    ASSERT_GE(plan.cropX, 0);
+    ASSERT_GE(plan.cropY, 0);
+    ASSERT_GE(plan.cropWidth, 1);
+    ASSERT_GE(plan.cropHeight, 1);
+    ASSERT_LE(plan.cropX + plan.cropWidth, sourceWidth);
+    ASSERT_LE(plan.cropY + plan.cropHeight, sourceHeight);
+    ASSERT_GE(plan.width, 1);
+    ASSERT_GE(plan.height, 1);
+    ASSERT_LE(plan.width, plan.cropWidth);
+    ASSERT_LE(plan.height, plan.cropHeight);
+
+    if (mode == YeetWebPResizeMode::cover) {
+      // The crop is centered and within a pixel of the target's aspect ratio.
+      EXPECT_LE(std::abs(sourceWidth - plan.cropWidth - 2 * plan.cropX), 1);
+      EXPECT_LE(std::abs(sourceHeight - plan.cropHeight - 2 * plan.cropY), 1);
+      const double error = std::fabs((double)plan.cropWidth * targetHeight - (double)plan.cropHeight * targetWidth);
+      EXPECT_LE(error, std::max(targetWidth, targetHeight) + 1e-6);
+    }
+  }
+}
+
+// An opaque, lossless test image, so decoded pixels can be compared exactly.
+struct TestImage {
+  int width;
+  int height;
+  std::vector<uint8_t> rgba;
+  std::vector<uint8_t> webp;
+
+  TestImage(int width, int height) : width(width), height(height), rgba((size_t)width * height * 4) {
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        uint8_t *pixel = &rgba[((size_t)y * width + x) * 4];
+        pixel[0] = (uint8_t)(x * 7 + y);
+        pixel[1] = (uint8_t)(y * 5);
+        pixel[2] = (uint8_t)((x ^ y) * 3);
+        pixel[3] = 255;
+      }
+    }
+
+    uint8_t *output = nullptr;
+    const size_t size = WebPEncodeLosslessRGBA(rgba.data(), width, height, width * 4, &output);
+    webp.assign(output, output + size);
+    WebPFree(output);
+  }
+
+  const uint8_t *pixel(int x, int y) const { return &rgba[((size_t)y * width + x) * 4]; }
+};
+
+TEST(YeetWebPDecoder, DecodesAtFullSize) {
+  const TestImage image(61, 37);
+  ASSERT_FALSE(image.webp.empty());
+
+  auto bitmap = yeetDecodeWebP(image.webp.data(), image.webp.size(), 0, 0, YeetWebPResizeMode::cover);
+  ASSERT_NE(bitmap, nullptr);
+  ASSERT_EQ(bitmap->width, 61);
+  ASSERT_EQ(bitmap->height, 37);
+  EXPECT_EQ(bitmap->pixels, image.rgba);
+}
+
+TEST(YeetWebPDecoder, CoverCropMatchesTheSourceRegion) {
+  const TestImage image(64, 32);
+  // 32x32 out of the middle; the target is bigger, so nothing is scaled.
+  auto bitmap = yeetDecodeWebP(image.webp.data(), image.webp.size(), 300, 300, YeetWebPResizeMode::cover);
+  ASSERT_NE(bitmap, nullptr);
+  ASSERT_EQ(bitmap->width, 32);
+  ASSERT_EQ(bitmap->height, 32);
+
+  for (int y = 0; y < 32; y++) {
+    for (int x = 0; x < 32; x++) {
+      ASSERT_EQ(memcmp(&bitmap->pixels[((size_t)y * 32 + x) * 4], image.pixel(x + 16, y), 4), 0) << x << ", " << y;
+    }
+  }
+}
+
+TEST(YeetWebPDecoder, ScalesToThePlannedSize) {
+  const TestImage image(200, 100);
+  auto bitmap = yeetDecodeWebP(image.webp.data(), image.webp.size(), 50, 50, YeetWebPResizeMode::contain);
+  ASSERT_NE(bitmap, nullptr);
+  EXPECT_EQ(bitmap->width, 50);
+  EXPECT_EQ(bitmap->height, 25);
+  EXPECT_EQ(bitmap->pixels.size(), 50u * 25 * 4);
+}
+
+TEST(YeetWebPDecoder, RejectsGarbage) {
+  const uint8_t garbage[] = {'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'E', 'B', 'P', 1, 2, 3};
+  EXPECT_EQ(yeetDecodeWebP(garbage, sizeof(garbage), 0, 0, YeetWebPResizeMode::cover), nullptr);
+
+  const TestImage image(16, 16);
+  EXPECT_EQ(yeetDecodeWebP(image.webp.data(), image.webp.size() / 2, 0, 0, YeetWebPResizeMode::cover), nullptr);
+}
@@ -0,0 +1,183 @@
+//
+//  YeetWebPDeltaEncoderBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "YeetWebPAnimationFixtures.h"
+#include "YeetWebPEncoder.h"
+#include "YeetWebPEncoderFixtures.h"
+
+// Encodes 60-frame 512x512 animations (see YeetTestAnimation) three ways at q75 and reports output
+// size, encode time and frames written:
+//
+//   full frames: every frame encoded whole and muxed, which is what an encoder without diffing does;
+//   delta:       YeetWebPDeltaEncoder, only the changed rect of each frame;
+//   anim:        YeetWebPAnimationEncoder, libwebp's WebPAnimEncoder, for reference.
+//
+// The meme is the case the delta encoder is for: a still background with a small looping region.
+//
+// Then encodes each animation losslessly with the delta encoder and exits non-zero if a decoded
+// canvas differs from the one that went in.
+
+static const int YeetCorpusSize = 512;
+static const int YeetCorpusFrames = 60;
+static const float YeetQuality = 75;
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static long fileSize(const std::string &path) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return -1;
+  }
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fclose(file);
+  return size;
+}
+
+// Every canvas as a full, unblended ANMF frame.
+static size_t encodeFullFrames(const std::vector<std::vector<uint8_t>> &canvases) {
+  std::vector<YeetTestWebPFrame> frames;
+  for (const auto &canvas : canvases) {
+    YeetTestWebPFrame frame;
+    frame.width = YeetCorpusSize;
+    frame.height = YeetCorpusSize;
+    frame.rgba = canvas;
+    // The canvases are premultiplied; WebPEncodeRGBA wants straight alpha.
+    for (size_t i = 0; i < frame.rgba.size(); i += 4) {
+      const int a = frame.rgba[i + 3];
+      for (int c = 0; c < 3 && a != 0 && a != 255; c++) {
+        frame.rgba[i + c] = (uint8_t)std::min(255, (frame.rgba[i + c] * 255 + a / 2) / a);
+      }
+    }
+    frames.push_back(std::move(frame));
+  }
+  return yeetEncodeTestAnimation(YeetCorpusSize, YeetCorpusSize, frames, YeetQuality).size();
+}
+
+template <typename Encoder>
+static bool encodeWith(const std::vector<std::vector<uint8_t>> &canvases, const YeetWebPEncodeOptions &options, const std::string &path, size_t &encodedFrames, std::string &error) {
+  Encoder encoder(YeetCorpusSize, YeetCorpusSize, canvases.size(), options);
+  for (const auto &canvas : canvases) {
+    if (!encoder.add(yeetTestEncodeFrame(canvas, YeetCorpusSize, YeetCorpusSize))) {
+      error = encoder.error();
+      return false;
+    }
+  }
+  if (!encoder.finish(path)) {
+    error = encoder.error();
+    return false;
+  }
+  encodedFrames = encoder.frameCount();
+  return true;
+}
+
+static size_t encodedFrameCount(const std::string &path) {
+  const std::vector<uint8_t> file = yeetReadTestFile(path);
+  WebPData data = {file.data(), file.size()};
+  WebPDemuxer *demux = WebPDemux(&data);
+  if (!demux) {
+    return 0;
+  }
+  const size_t count = WebPDemuxGetI(demux, WEBP_FF_FRAME_COUNT);
+  WebPDemuxDelete(demux);
+  return count;
+}
+
+static void printRow(const char *name, long size, double milliseconds, size_t frames, long fullSize) {
+  printf("  %-12s %8.1f KB %9.1f ms %6.2f ms/frame   %3zu frames   %5.1f%% of full frames\n", name, size / 1024.0,
+    milliseconds, milliseconds / YeetCorpusFrames, frames, 100.0 * size / fullSize);
+}
+
+int main() {
+  char directory[] = "/tmp/yeet-webp-delta-benchmark-XXXXXX";
+  if (!mkdtemp(directory)) {
+    perror("mkdtemp");
+    return 1;
+  }
+  const std::string path = std::string(directory) + "/output.webp";
+
+  YeetWebPEncodeOptions options;
+  options.quality = YeetQuality;
+
+  bool failed = false;
+  const std::pair<const char *, YeetTestAnimation> kinds[] = {
+    {"meme", YeetTestAnimation::meme},
+    {"sticker", YeetTestAnimation::sticker},
+    {"clip", YeetTestAnimation::clip},
+  };
+  for (const auto &kind : kinds) {
+    std::vector<std::vector<uint8_t>> canvases;
+    for (int i = 0; i < YeetCorpusFrames; i++) {
+      canvases.push_back(yeetTestCanvas(kind.second, YeetCorpusSize, YeetCorpusSize, i));
+    }
+    printf("%s: %d frames, %dx%d\n", kind.first, YeetCorpusFrames, YeetCorpusSize, YeetCorpusSize);
+
+    auto start = std::chrono::steady_clock::now();
+    const long fullSize = (long)encodeFullFrames(canvases);
+    const double fullMilliseconds = millisecondsSince(start);
+    if (fullSize == 0) {
+      fprintf(stderr, "%s: couldn't encode full frames\n", kind.first);
+      failed = true;
+      continue;
+    }
+    printRow("full frames", fullSize, fullMilliseconds, canvases.size(), fullSize);
+
+    size_t frames = 0;
+    std::string error;
+    start = std::chrono::steady_clock::now();
+    if (encodeWith<YeetWebPDeltaEncoder>(canvases, options, path, frames, error)) {
+      printRow("delta", fileSize(path), millisecondsSince(start), encodedFrameCount(path), fullSize);
+    } else {
+      fprintf(stderr, "%s, delta: %s\n", kind.first, error.c_str());
+      failed = true;
+    }
+
+    start = std::chrono::steady_clock::now();
+    if (encodeWith<YeetWebPAnimationEncoder>(canvases, options, path, frames, error)) {
+      printRow("anim", fileSize(path), millisecondsSince(start), encodedFrameCount(path), fullSize);
+    } else {
+      fprintf(stderr, "%s, anim: %s\n", kind.first, error.c_str());
+      failed = true;
+    }
+
+    // Lossless, so the delta encoder's output can be checked pixel for pixel.
+    YeetWebPEncodeOptions lossless;
+    lossless.lossless = true;
+    if (!encodeWith<YeetWebPDeltaEncoder>(canvases, lossless, path, frames, error)) {
+      fprintf(stderr, "%s, lossless delta: %s\n", kind.first, error.c_str());
+      failed = true;
+      continue;
+    }
+    const auto decoded = yeetDecodeWithAnimDecoder(yeetReadTestFile(path));
+    size_t frame = 0;
+    for (size_t i = 0; i < canvases.size(); i++) {
+      if (i > 0 && canvases[i] == canvases[i - 1]) {
+        continue;
+      }
+      if (frame >= decoded.size() || yeetMaxChannelDifference(decoded[frame], canvases[i]) > 1) {
+        fprintf(stderr, "%s: lossless delta frame %zu differs from the input\n", kind.first, i);
+        failed = true;
+        break;
+      }
+      frame++;
+    }
+  }
+
+  remove(path.c_str());
+  rmdir(directory);
+  return failed ? 1 : 0;
+}
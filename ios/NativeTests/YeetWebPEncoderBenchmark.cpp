@@ -0,0 +1,318 @@
+//
+//  YeetWebPEncoderBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "YeetWebPAnimationFixtures.h"
+#include "YeetWebPEncoder.h"
+#include "YeetWebPEncoderFixtures.h"
+
+// Encodes a corpus of animations as GIF and as WebP with YeetWebPAnimationEncoder, reporting file
+// size and encode time for each.
+//
+// The corpus is a sticker, a meme and a clip (see YeetTestAnimation), 30 frames at 512x512, plus
+// any WebPs passed on the command line, still or animated, e.g. the ones in yeetTests/Fixtures:
+//
+//   YeetWebPEncoderBenchmark ../yeetTests/Fixtures/drivethrough-cat.webp
+//
+// There's no GIF encoder on Linux to compare against, so the GIF column comes from the small one
+// below: a fixed 252-color palette, full frames, LZW. ImageIO picks a palette per frame, which
+// looks better and changes the sizes somewhat, so read the GIF column as a ballpark.
+//
+// Exits non-zero if an encode fails.
+
+static const int YeetCorpusSize = 512;
+static const int YeetCorpusFrames = 30;
+static const int YeetGIFTransparentIndex = 255;
+
+struct YeetCorpusAnimation {
+  std::string name;
+  int width = 0;
+  int height = 0;
+  std::vector<std::vector<uint8_t>> canvases;
+};
+
+// LZW-compressed image data, in the 255-byte sub-blocks GIF wants.
+class YeetGIFWriter {
+public:
+  explicit YeetGIFWriter(std::vector<uint8_t> &output) : output_(output) {}
+
+  void compress(const std::vector<uint8_t> &indices) {
+    static const int minimumCodeSize = 8;
+    static const int clearCode = 1 << minimumCodeSize;
+    static const int endCode = clearCode + 1;
+    static const int maximumCode = 4095;
+
+    output_.push_back(minimumCodeSize);
+    int codeSize = minimumCodeSize + 1;
+    int nextCode = endCode + 1;
+    std::vector<int32_t> keys(YeetHashSize, -1);
+    std::vector<uint16_t> codes(YeetHashSize);
+
+    writeCode(clearCode, codeSize);
+    int prefix = indices[0];
+    for (size_t i = 1; i < indices.size(); i++) {
+      const int32_t key = (prefix << 8) | indices[i];
+      size_t slot = ((size_t)key * 2654435761u) % YeetHashSize;
+      while (keys[slot] != -1 && keys[slot] != key) {
+        slot = (slot + 1) % YeetHashSize;
+      }
+      if (keys[slot] == key) {
+        prefix = codes[slot];
+        continue;
+      }
+
+      writeCode(prefix, codeSize);
+      // Same order as giflib: the code size grows once the next code no longer fits.
+      if (nextCode >= (1 << codeSize) && codeSize < 12) {
+        codeSize++;
+      }
+      if (nextCode >= maximumCode) {
+        writeCode(clearCode, codeSize);
+        std::fill(keys.begin(), keys.end(), -1);
+        codeSize = minimumCodeSize + 1;
+        nextCode = endCode + 1;
+      } else {
+        keys[slot] = key;
+        codes[slot] = (uint16_t)nextCode++;
+      }
+      prefix = indices[i];
+    }
+
+    writeCode(prefix, codeSize);
+    writeCode(endCode, codeSize);
+    if (bitCount_ > 0) {
+      block_.push_back((uint8_t)bits_);
+      bits_ = 0;
+      bitCount_ = 0;
+    }
+    flushBlock();
+    output_.push_back(0);
+  }
+
+private:
+  // Prime, and comfortably more than the 4096 codes, so probes stay short.
+  static const size_t YeetHashSize = 9973;
+
+  void writeCode(int code, int size) {
+    bits_ |= (uint32_t)code << bitCount_;
+    bitCount_ += size;
+    while (bitCount_ >= 8) {
+      block_.push_back((uint8_t)bits_);
+      bits_ >>= 8;
+      bitCount_ -= 8;
+      if (block_.size() == 255) {
+        flushBlock();
+      }
+    }
+  }
+
+  void flushBlock() {
+    if (!block_.empty()) {
+      output_.push_back((uint8_t)block_.size());
+      output_.insert(output_.end(), block_.begin(), block_.end());
+      block_.clear();
+    }
+  }
+
+  std::vector<uint8_t> &output_;
+  std::vector<uint8_t> block_;
+  uint32_t bits_ = 0;
+  int bitCount_ = 0;
+};
+
+static void appendShort(std::vector<uint8_t> &output, int value) {
+  output.push_back((uint8_t)(value & 0xFF));
+  output.push_back((uint8_t)(value >> 8));
+}
+
+// A looping GIF with every frame drawn in full over a cleared canvas, 6x7x6 levels of red, green
+// and blue, and anything under half opaque transparent.
+static std::vector<uint8_t> encodeGIF(const YeetCorpusAnimation &animation, int durationMs) {
+  std::vector<uint8_t> output = {'G', 'I', 'F', '8', '9', 'a'};
+  appendShort(output, animation.width);
+  appendShort(output, animation.height);
+  // A 256-entry global color table, then the background index and aspect ratio.
+  output.push_back(0xF7);
+  output.push_back(0);
+  output.push_back(0);
+  for (int i = 0; i < 256; i++) {
+    const int r = i < 252 ? i / 42 : 0;
+    const int g = i < 252 ? (i / 6) % 7 : 0;
+    const int b = i < 252 ? i % 6 : 0;
+    output.push_back((uint8_t)(r * 255 / 5));
+    output.push_back((uint8_t)(g * 255 / 6));
+    output.push_back((uint8_t)(b * 255 / 5));
+  }
+
+  // Loop forever.
+  const uint8_t netscape[] = {0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0', 0x03, 0x01, 0x00, 0x00, 0x00};
+  output.insert(output.end(), netscape, netscape + sizeof(netscape));
+
+  std::vector<uint8_t> indices((size_t)animation.width * animation.height);
+  for (const auto &canvas : animation.canvases) {
+    for (size_t i = 0; i < indices.size(); i++) {
+      const uint8_t *pixel = &canvas[i * 4];
+      const int a = pixel[3];
+      if (a < 128) {
+        indices[i] = YeetGIFTransparentIndex;
+        continue;
+      }
+      const int r = std::min(255, (pixel[0] * 255 + a / 2) / a);
+      const int g = std::min(255, (pixel[1] * 255 + a / 2) / a);
+      const int b = std::min(255, (pixel[2] * 255 + a / 2) / a);
+      indices[i] = (uint8_t)(((r * 5 + 127) / 255 * 7 + (g * 6 + 127) / 255) * 6 + (b * 5 + 127) / 255);
+    }
+
+    // Graphic control: restore to background afterwards, with a transparent index.
+    output.insert(output.end(), {0x21, 0xF9, 0x04, (2 << 2) | 1});
+    appendShort(output, durationMs / 10);
+    output.push_back(YeetGIFTransparentIndex);
+    output.push_back(0);
+
+    output.push_back(0x2C);
+    appendShort(output, 0);
+    appendShort(output, 0);
+    appendShort(output, animation.width);
+    appendShort(output, animation.height);
+    output.push_back(0);
+    YeetGIFWriter(output).compress(indices);
+  }
+
+  output.push_back(0x3B);
+  return output;
+}
+
+struct YeetWebPVariant {
+  const char *name;
+  YeetWebPEncodeOptions options;
+};
+
+static std::vector<YeetWebPVariant> webpVariants() {
+  YeetWebPEncodeOptions lossy;
+  lossy.quality = 75;
+
+  YeetWebPEncodeOptions smallest = lossy;
+  smallest.minimizeSize = true;
+
+  YeetWebPEncodeOptions mixed = lossy;
+  mixed.allowMixed = true;
+
+  YeetWebPEncodeOptions lossless;
+  lossless.lossless = true;
+  lossless.quality = 50;
+  lossless.method = 2;
+
+  return {
+    {"WebP q75", lossy},
+    {"WebP q75 min size", smallest},
+    {"WebP q75 mixed", mixed},
+    {"WebP lossless", lossless},
+  };
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static long fileSize(const std::string &path) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return -1;
+  }
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fclose(file);
+  return size;
+}
+
+int main(int argc, char **argv) {
+  std::vector<YeetCorpusAnimation> corpus;
+  const std::pair<const char *, YeetTestAnimation> kinds[] = {
+    {"sticker", YeetTestAnimation::sticker},
+    {"meme", YeetTestAnimation::meme},
+    {"clip", YeetTestAnimation::clip},
+  };
+  for (const auto &kind : kinds) {
+    YeetCorpusAnimation animation;
+    animation.name = kind.first;
+    animation.width = YeetCorpusSize;
+    animation.height = YeetCorpusSize;
+    for (int i = 0; i < YeetCorpusFrames; i++) {
+      animation.canvases.push_back(yeetTestCanvas(kind.second, YeetCorpusSize, YeetCorpusSize, i));
+    }
+    corpus.push_back(std::move(animation));
+  }
+
+  for (int i = 1; i < argc; i++) {
+    YeetCorpusAnimation animation;
+    animation.name = argv[i];
+    const std::vector<uint8_t> file = yeetReadTestFile(argv[i]);
+    WebPData data = {file.data(), file.size()};
+    WebPDemuxer *demux = file.empty() ? nullptr : WebPDemux(&data);
+    if (!demux) {
+      fprintf(stderr, "couldn't read %s\n", argv[i]);
+      return 1;
+    }
+    animation.width = (int)WebPDemuxGetI(demux, WEBP_FF_CANVAS_WIDTH);
+    animation.height = (int)WebPDemuxGetI(demux, WEBP_FF_CANVAS_HEIGHT);
+    WebPDemuxDelete(demux);
+    animation.canvases = yeetDecodeWithAnimDecoder(file);
+    if (animation.canvases.empty()) {
+      fprintf(stderr, "couldn't decode %s\n", argv[i]);
+      return 1;
+    }
+    corpus.push_back(std::move(animation));
+  }
+
+  char directory[] = "/tmp/yeet-webp-encoder-benchmark-XXXXXX";
+  if (!mkdtemp(directory)) {
+    perror("mkdtemp");
+    return 1;
+  }
+  const std::string path = std::string(directory) + "/output.webp";
+  const std::vector<YeetWebPVariant> variants = webpVariants();
+
+  bool failed = false;
+  for (const auto &animation : corpus) {
+    printf("%s: %zu frames, %dx%d\n", animation.name.c_str(), animation.canvases.size(), animation.width, animation.height);
+
+    auto start = std::chrono::steady_clock::now();
+    const size_t gifSize = encodeGIF(animation, 100).size();
+    const double gifMilliseconds = millisecondsSince(start);
+    printf("  %-18s %8.1f KB %9.1f ms\n", "GIF", gifSize / 1024.0, gifMilliseconds);
+
+    for (const auto &variant : variants) {
+      start = std::chrono::steady_clock::now();
+      YeetWebPAnimationEncoder encoder(animation.width, animation.height, animation.canvases.size(), variant.options);
+      bool ok = true;
+      for (const auto &canvas : animation.canvases) {
+        ok = ok && encoder.add(yeetTestEncodeFrame(canvas, animation.width, animation.height));
+      }
+      ok = ok && encoder.finish(path);
+      const double milliseconds = millisecondsSince(start);
+
+      if (!ok) {
+        fprintf(stderr, "%s, %s: %s\n", animation.name.c_str(), variant.name, encoder.error().c_str());
+        failed = true;
+        continue;
+      }
+      const long size = fileSize(path);
+      printf("  %-18s %8.1f KB %9.1f ms   %5.1f%% of the GIF\n", variant.name, size / 1024.0, milliseconds, 100.0 * size / gifSize);
+      remove(path.c_str());
+    }
+  }
+
+  rmdir(directory);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+//
+//  YeetWebPEncoderFixtures.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "YeetWebPEncoder.h"
+
+// The kinds of animation people export, as premultiplied RGBA canvases, width * 4 bytes per row.
+enum class YeetTestAnimation {
+  // A sticker: a subject bobbing and changing color on a transparent background.
+  sticker,
+  // A meme: an opaque photo-like background that never changes, with a small looping region in
+  // the middle. Every fourth frame repeats the one before.
+  meme,
+  // A clip: every pixel changes every frame, like a screen recording panning.
+  clip,
+};
+
+inline std::vector<uint8_t> yeetTestCanvas(YeetTestAnimation kind, int width, int height, int index) {
+  std::vector<uint8_t> canvas((size_t)width * height * 4);
+  const double phase = index * 0.3;
+
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      uint8_t *pixel = &canvas[((size_t)y * width + x) * 4];
+      int r = 0, g = 0, b = 0, a = 255;
+
+      if (kind == YeetTestAnimation::sticker) {
+        const double cx = width / 2.0 + std::sin(phase) * width / 8;
+        const double cy = height / 2.0 + std::cos(phase) * height / 10;
+        const double distance = std::hypot(x - cx, y - cy) / (width / 3.0);
+        // A soft edge, so some pixels are partly transparent.
+        a = distance < 0.9 ? 255 : distance < 1 ? (int)((1 - distance) * 10 * 255) : 0;
+        r = 200 + (int)(55 * std::sin(phase + x * 0.05));
+        g = 80 + (y * 120 / height);
+        b = 60 + (index * 9) % 120;
+      } else {
+        r = 30 + x * 180 / width + ((x * 7 + y * 3) % 11);
+        g = 60 + y * 150 / height + ((x ^ y) % 9);
+        b = 110 + ((x / 12 + y / 12) % 2) * 40;
+
+        const int frame = kind == YeetTestAnimation::meme && index % 4 == 3 ? index - 1 : index;
+        if (kind == YeetTestAnimation::clip) {
+          r = (r + index * 3) % 256;
+          g = 30 + ((x + index * 4) * 180 / width) % 200;
+        } else if (std::abs(x - width / 2) < width / 8 && std::abs(y - height / 2) < height / 8) {
+          r = (x * 5 + frame * 40) % 256;
+          g = (y * 3 + frame * 25) % 256;
+        }
+      }
+
+      pixel[0] = (uint8_t)(r * a / 255);
+      pixel[1] = (uint8_t)(g * a / 255);
+      pixel[2] = (uint8_t)(b * a / 255);
+      pixel[3] = (uint8_t)a;
+    }
+  }
+
+  return canvas;
+}
+
+inline YeetWebPEncodeFrame yeetTestEncodeFrame(const std::vector<uint8_t> &canvas, int width, int height, int durationMs = 100) {
+  YeetWebPEncodeFrame frame;
+  frame.rgba = canvas.data();
+  frame.width = width;
+  frame.height = height;
+  frame.bytesPerRow = (size_t)width * 4;
+  frame.premultiplied = true;
+  frame.durationMs = durationMs;
+  return frame;
+}
+
+// The whole file, or empty if it can't be read.
+inline std::vector<uint8_t> yeetReadTestFile(const std::string &path) {
+  std::vector<uint8_t> bytes;
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return bytes;
+  }
+
+  uint8_t buffer[64 * 1024];
+  size_t read;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    bytes.insert(bytes.end(), buffer, buffer + read);
+  }
+  fclose(file);
+  return bytes;
+}
+
+#endif
@@ -0,0 +1,367 @@
+//
+//  YeetWebPEncoderTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetWebPEncoder.h"
+#include "YeetWebPAnimationFixtures.h"
+#include "YeetWebPEncoderFixtures.h"
+#include <WebP/decode.h>
+#include <algorithm>
+#include <cstdio>
+
+static const int YeetCanvasWidth = 96;
+static const int YeetCanvasHeight = 64;
+
+static std::string temporaryPath(const char *name) {
+  const std::string path = testing::TempDir() + "yeet-webp-encoder-" + name + ".webp";
+  remove(path.c_str());
+  return path;
+}
+
+static bool fileExists(const std::string &path) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file) {
+    fclose(file);
+  }
+  return file != nullptr;
+}
+
+// A still file decoded back to premultiplied RGBA, like the canvases it was encoded from.
+static std::vector<uint8_t> decodeStill(const std::vector<uint8_t> &file, int &width, int &height) {
+  std::vector<uint8_t> pixels;
+  WebPDecoderConfig config;
+  if (!WebPInitDecoderConfig(&config) || WebPGetFeatures(file.data(), file.size(), &config.input) != VP8_STATUS_OK) {
+    return pixels;
+  }
+
+  width = config.input.width;
+  height = config.input.height;
+  pixels.resize((size_t)width * height * 4);
+  config.output.colorspace = MODE_rgbA;
+  config.output.is_external_memory = 1;
+  config.output.u.RGBA.rgba = pixels.data();
+  config.output.u.RGBA.stride = width * 4;
+  config.output.u.RGBA.size = pixels.size();
+  if (WebPDecode(file.data(), file.size(), &config) != VP8_STATUS_OK) {
+    pixels.clear();
+  }
+  WebPFreeDecBuffer(&config.output);
+  return pixels;
+}
+
+static double meanChannelDifference(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b) {
+  double total = 0;
+  for (size_t i = 0; i < a.size(); i++) {
+    total += std::abs((int)a[i] - (int)b[i]);
+  }
+  return total / a.size();
+}
+
+TEST(YeetWebPEncoder, LosslessStillRoundTrips) {
+  const std::vector<uint8_t> canvas = yeetTestCanvas(YeetTestAnimation::sticker, YeetCanvasWidth, YeetCanvasHeight, 2);
+  YeetWebPEncodeOptions options;
+  options.lossless = true;
+  const std::string path = temporaryPath("lossless");
+
+  std::string error;
+  ASSERT_TRUE(yeetEncodeWebP(yeetTestEncodeFrame(canvas, YeetCanvasWidth, YeetCanvasHeight), options, path, nullptr, error)) << error;
+
+  int width = 0, height = 0;
+  const std::vector<uint8_t> decoded = decodeStill(yeetReadTestFile(path), width, height);
+  ASSERT_EQ(width, YeetCanvasWidth);
+  ASSERT_EQ(height, YeetCanvasHeight);
+  // Unpremultiplying and premultiplying again rounds partly transparent pixels by at most one.
+  EXPECT_LE(yeetMaxChannelDifference(decoded, canvas), 1);
+  remove(path.c_str());
+}
+
+TEST(YeetWebPEncoder, ReadsPaddedStraightAlphaRows) {
+  const std::vector<uint8_t> canvas = yeetTestCanvas(YeetTestAnimation::sticker, YeetCanvasWidth, YeetCanvasHeight, 5);
+  // The same pixels unpremultiplied, with 8 bytes of junk at the end of every row.
+  const size_t bytesPerRow = YeetCanvasWidth * 4 + 8;
+  std::vector<uint8_t> padded(bytesPerRow * YeetCanvasHeight, 0xAB);
+  for (int y = 0; y < YeetCanvasHeight; y++) {
+    for (int x = 0; x < YeetCanvasWidth; x++) {
+      const uint8_t *src = &canvas[((size_t)y * YeetCanvasWidth + x) * 4];
+      uint8_t *dst = &padded[y * bytesPerRow + x * 4];
+      for (int c = 0; c < 3; c++) {
+        dst[c] = src[3] ? (uint8_t)std::min(255, (src[c] * 255 + src[3] / 2) / src[3]) : 0;
+      }
+      dst[3] = src[3];
+    }
+  }
+
+  YeetWebPEncodeFrame frame = yeetTestEncodeFrame(padded, YeetCanvasWidth, YeetCanvasHeight);
+  frame.bytesPerRow = bytesPerRow;
+  frame.premultiplied = false;
+  YeetWebPEncodeOptions options;
+  options.lossless = true;
+  const std::string path = temporaryPath("padded");
+
+  std::string error;
+  ASSERT_TRUE(yeetEncodeWebP(frame, options, path, nullptr, error)) << error;
+  int width = 0, height = 0;
+  const std::vector<uint8_t> decoded = decodeStill(yeetReadTestFile(path), width, height);
+  ASSERT_EQ(width, YeetCanvasWidth);
+  EXPECT_LE(yeetMaxChannelDifference(decoded, canvas), 1);
+  remove(path.c_str());
+}
+
+TEST(YeetWebPEncoder, LossyQualityTradesSizeForFidelity) {
+  const std::vector<uint8_t> canvas = yeetTestCanvas(YeetTestAnimation::meme, 256, 256, 1);
+  const std::string path = temporaryPath("lossy");
+  std::vector<size_t> sizes;
+  std::vector<double> errors;
+
+  for (float quality : {20.0f, 90.0f}) {
+    YeetWebPEncodeOptions options;
+    options.quality = quality;
+    options.preset = YeetWebPPreset::photo;
+    std::string error;
+    ASSERT_TRUE(yeetEncodeWebP(yeetTestEncodeFrame(canvas, 256, 256), options, path, nullptr, error)) << error;
+
+    const std::vector<uint8_t> file = yeetReadTestFile(path);
+    int width = 0, height = 0;
+    const std::vector<uint8_t> decoded = decodeStill(file, width, height);
+    ASSERT_EQ(decoded.size(), canvas.size());
+    sizes.push_back(file.size());
+    errors.push_back(meanChannelDifference(decoded, canvas));
+  }
+
+  EXPECT_LT(sizes[0], sizes[1]);
+  EXPECT_GT(errors[0], errors[1]);
+  EXPECT_LT(errors[1], 4);
+  remove(path.c_str());
+}
+
+TEST(YeetWebPEncoder, StillProgressCanCancelAndRemovesTheFile) {
+  const std::vector<uint8_t> canvas = yeetTestCanvas(YeetTestAnimation::clip, 256, 256, 0);
+  const std::string path = temporaryPath("cancelled");
+
+  std::vector<float> reported;
+  std::string error;
+  EXPECT_FALSE(yeetEncodeWebP(yeetTestEncodeFrame(canvas, 256, 256), YeetWebPEncodeOptions(), path, [&reported](float progress) {
+    reported.push_back(progress);
+    return progress < 0.5f;
+  }, error));
+  EXPECT_EQ(error, "Cancelled");
+  EXPECT_FALSE(fileExists(path));
+  ASSERT_FALSE(reported.empty());
+  EXPECT_TRUE(std::is_sorted(reported.begin(), reported.end()));
+
+  reported.clear();
+  ASSERT_TRUE(yeetEncodeWebP(yeetTestEncodeFrame(canvas, 256, 256), YeetWebPEncodeOptions(), path, [&reported](float progress) {
+    reported.push_back(progress);
+    return true;
+  }, error)) << error;
+  EXPECT_TRUE(std::is_sorted(reported.begin(), reported.end()));
+  EXPECT_FLOAT_EQ(reported.back(), 1.0f);
+  remove(path.c_str());
+}
+
+TEST(YeetWebPEncoder, UnwritablePathFails) {
+  const std::vector<uint8_t> canvas = yeetTestCanvas(YeetTestAnimation::sticker, YeetCanvasWidth, YeetCanvasHeight, 0);
+  std::string error;
+  EXPECT_FALSE(yeetEncodeWebP(yeetTestEncodeFrame(canvas, YeetCanvasWidth, YeetCanvasHeight), YeetWebPEncodeOptions(), "/nonexistent/directory/out.webp", nullptr, error));
+  EXPECT_FALSE(error.empty());
+}
+
+// Every canvas of a lossless animation comes back, whatever the keyframe and size options.
+TEST(YeetWebPAnimationEncoder, LosslessAnimationRoundTrips) {
+  const int frameCount = 12;
+  std::vector<std::vector<uint8_t>> canvases;
+  for (int i = 0; i < frameCount; i++) {
+    canvases.push_back(yeetTestCanvas(YeetTestAnimation::sticker, YeetCanvasWidth, YeetCanvasHeight, i));
+  }
+
+  struct Variant {
+    const char *name;
+    int minKeyframeInterval;
+    int maxKeyframeInterval;
+    bool minimizeSize;
+  };
+  const Variant variants[] = {
+    {"defaults", 0, 0, false},
+    {"only kmin", 3, 0, false},
+    {"only kmax", 0, 4, false},
+    {"minimize size", 0, 0, true},
+  };
+
+  for (const Variant &variant : variants) {
+    YeetWebPEncodeOptions options;
+    options.lossless = true;
+    options.minKeyframeInterval = variant.minKeyframeInterval;
+    options.maxKeyframeInterval = variant.maxKeyframeInterval;
+    options.minimizeSize = variant.minimizeSize;
+    options.loopCount = 3;
+    const std::string path = temporaryPath("animation");
+
+    YeetWebPAnimationEncoder encoder(YeetCanvasWidth, YeetCanvasHeight, frameCount, options);
+    for (const auto &canvas : canvases) {
+      ASSERT_TRUE(encoder.add(yeetTestEncodeFrame(canvas, YeetCanvasWidth, YeetCanvasHeight, 40))) << variant.name << ": " << encoder.error();
+    }
+    ASSERT_TRUE(encoder.finish(path)) << variant.name << ": " << encoder.error();
+    EXPECT_EQ(encoder.frameCount(), (size_t)frameCount);
+
+    const std::vector<uint8_t> file = yeetReadTestFile(path);
+    const auto decoded = yeetDecodeWithAnimDecoder(file);
+    ASSERT_EQ(decoded.size(), canvases.size()) << variant.name;
+    for (int i = 0; i < frameCount; i++) {
+      EXPECT_LE(yeetMaxChannelDifference(decoded[i], canvases[i]), 1) << variant.name << ", frame " << i;
+    }
+
+    WebPData data = {file.data(), file.size()};
+    WebPDemuxer *demux = WebPDemux(&data);
+    ASSERT_NE(demux, nullptr);
+    EXPECT_EQ(WebPDemuxGetI(demux, WEBP_FF_LOOP_COUNT), 3u) << variant.name;
+    WebPIterator iterator;
+    ASSERT_TRUE(WebPDemuxGetFrame(demux, 2, &iterator));
+    EXPECT_EQ(iterator.duration, 40) << variant.name;
+    WebPDemuxReleaseIterator(&iterator);
+    WebPDemuxDelete(demux);
+    remove(path.c_str());
+  }
+}
+
+TEST(YeetWebPAnimationEncoder, ReportsProgressAndRejectsBadFrames) {
+  std::vector<float> reported;
+  YeetWebPAnimationEncoder encoder(YeetCanvasWidth, YeetCanvasHeight, 4, YeetWebPEncodeOptions(), [&reported](float progress) {
+    reported.push_back(progress);
+    return true;
+  });
+  const std::string path = temporaryPath("progress");
+
+  for (int i = 0; i < 4; i++) {
+    const std::vector<uint8_t> canvas = yeetTestCanvas(YeetTestAnimation::clip, YeetCanvasWidth, YeetCanvasHeight, i);
+    ASSERT_TRUE(encoder.add(yeetTestEncodeFrame(canvas, YeetCanvasWidth, YeetCanvasHeight))) << encoder.error();
+  }
+  ASSERT_TRUE(encoder.finish(path)) << encoder.error();
+  EXPECT_TRUE(std::is_sorted(reported.begin(), reported.end()));
+  EXPECT_FLOAT_EQ(reported.back(), 1.0f);
+  remove(path.c_str());
+
+  // Wrong size: the encoder fails and stays failed.
+  YeetWebPAnimationEncoder mismatched(YeetCanvasWidth, YeetCanvasHeight, 2, YeetWebPEncodeOptions());
+  const std::vector<uint8_t> small = yeetTestCanvas(YeetTestAnimation::clip, 32, 32, 0);
+  EXPECT_FALSE(mismatched.add(yeetTestEncodeFrame(small, 32, 32)));
+  EXPECT_EQ(mismatched.error(), "Frame size doesn't match the animation");
+  const std::vector<uint8_t> canvas = yeetTestCanvas(YeetTestAnimation::clip, YeetCanvasWidth, YeetCanvasHeight, 0);
+  EXPECT_FALSE(mismatched.add(yeetTestEncodeFrame(canvas, YeetCanvasWidth, YeetCanvasHeight)));
+  EXPECT_FALSE(mismatched.finish(path));
+  EXPECT_FALSE(fileExists(path));
+
+  YeetWebPAnimationEncoder empty(YeetCanvasWidth, YeetCanvasHeight, 0, YeetWebPEncodeOptions());
+  EXPECT_FALSE(empty.finish(path));
+  EXPECT_EQ(empty.error(), "No frames to encode");
+}
+
+TEST(YeetWebPAnimationEncoder, CancellingStopsEncoding) {
+  YeetWebPAnimationEncoder encoder(YeetCanvasWidth, YeetCanvasHeight, 10, YeetWebPEncodeOptions(), [](float progress) {
+    return progress < 0.25f;
+  });
+
+  int added = 0;
+  for (int i = 0; i < 10; i++) {
+    const std::vector<uint8_t> canvas = yeetTestCanvas(YeetTestAnimation::clip, YeetCanvasWidth, YeetCanvasHeight, i);
+    if (!encoder.add(yeetTestEncodeFrame(canvas, YeetCanvasWidth, YeetCanvasHeight))) {
+      break;
+    }
+    added++;
+  }
+
+  // 0.9 of the progress bar is for frames, so the third frame reports 0.27.
+  EXPECT_EQ(added, 2);
+  EXPECT_EQ(encoder.error(), "Cancelled");
+  const std::string path = temporaryPath("cancelled-animation");
+  EXPECT_FALSE(encoder.finish(path));
+  EXPECT_FALSE(fileExists(path));
+}
+
+// Lossless, so every composited canvas has to come back exactly, whichever way each rect was
+// encoded: blended over the canvas, or replacing it where pixels got more transparent.
+TEST(YeetWebPDeltaEncoder, LosslessAnimationRoundTrips) {
+  for (YeetTestAnimation kind : {YeetTestAnimation::sticker, YeetTestAnimation::meme, YeetTestAnimation::clip}) {
+    std::vector<std::vector<uint8_t>> canvases;
+    for (int i = 0; i < 10; i++) {
+      canvases.push_back(yeetTestCanvas(kind, YeetCanvasWidth, YeetCanvasHeight, i));
+    }
+
+    YeetWebPEncodeOptions options;
+    options.lossless = true;
+    options.frameDiff = true;
+    const std::string path = temporaryPath("delta");
+    YeetWebPDeltaEncoder encoder(YeetCanvasWidth, YeetCanvasHeight, canvases.size(), options);
+    for (const auto &canvas : canvases) {
+      ASSERT_TRUE(encoder.add(yeetTestEncodeFrame(canvas, YeetCanvasWidth, YeetCanvasHeight))) << encoder.error();
+    }
+    ASSERT_TRUE(encoder.finish(path)) << encoder.error();
+
+    const auto decoded = yeetDecodeWithAnimDecoder(yeetReadTestFile(path));
+    ASSERT_EQ(decoded.size(), encoder.encodedFrameCount()) << (int)kind;
+    // Merged frames are skipped in the file, so walk the canvases that were actually encoded.
+    size_t frame = 0;
+    for (size_t i = 0; i < canvases.size(); i++) {
+      if (i > 0 && canvases[i] == canvases[i - 1]) {
+        continue;
+      }
+      ASSERT_LT(frame, decoded.size());
+      EXPECT_LE(yeetMaxChannelDifference(decoded[frame], canvases[i]), 1) << (int)kind << ", frame " << i;
+      frame++;
+    }
+    EXPECT_EQ(frame, decoded.size());
+    remove(path.c_str());
+  }
+}
+
+TEST(YeetWebPDeltaEncoder, MergesIdenticalFramesAndEncodesOnlyTheChangedRect) {
+  // The meme repeats every fourth frame; only its middle eighth changes.
+  std::vector<std::vector<uint8_t>> canvases;
+  for (int i = 0; i < 8; i++) {
+    canvases.push_back(yeetTestCanvas(YeetTestAnimation::meme, YeetCanvasWidth, YeetCanvasHeight, i));
+  }
+
+  YeetWebPEncodeOptions options;
+  options.lossless = true;
+  const std::string path = temporaryPath("merged");
+  YeetWebPDeltaEncoder encoder(YeetCanvasWidth, YeetCanvasHeight, canvases.size(), options);
+  for (const auto &canvas : canvases) {
+    ASSERT_TRUE(encoder.add(yeetTestEncodeFrame(canvas, YeetCanvasWidth, YeetCanvasHeight, 50))) << encoder.error();
+  }
+  ASSERT_TRUE(encoder.finish(path)) << encoder.error();
+  EXPECT_EQ(encoder.frameCount(), 8u);
+  EXPECT_EQ(encoder.encodedFrameCount(), 6u);
+
+  const std::vector<uint8_t> file = yeetReadTestFile(path);
+  WebPData data = {file.data(), file.size()};
+  WebPDemuxer *demux = WebPDemux(&data);
+  ASSERT_NE(demux, nullptr);
+  ASSERT_EQ(WebPDemuxGetI(demux, WEBP_FF_FRAME_COUNT), 6u);
+
+  // Frame 3 repeats frame 2 and frame 7 repeats frame 6, so those two play twice as long.
+  const int durations[] = {50, 50, 100, 50, 50, 100};
+  WebPIterator iterator;
+  ASSERT_TRUE(WebPDemuxGetFrame(demux, 1, &iterator));
+  EXPECT_EQ(iterator.width, YeetCanvasWidth);
+  EXPECT_EQ(iterator.height, YeetCanvasHeight);
+  for (int i = 0; i < 6; i++) {
+    EXPECT_EQ(iterator.duration, durations[i]) << i;
+    if (i > 0) {
+      // Inside the animated region, and opaque changes are blended over the canvas.
+      EXPECT_LE(iterator.width, YeetCanvasWidth / 4 + 2) << i;
+      EXPECT_LE(iterator.height, YeetCanvasHeight / 4 + 2) << i;
+      EXPECT_EQ(iterator.blend_method, WEBP_MUX_BLEND) << i;
+    }
+    EXPECT_EQ(iterator.dispose_method, WEBP_MUX_DISPOSE_NONE) << i;
+    if (i < 5) {
+      ASSERT_TRUE(WebPDemuxNextFrame(&iterator));
+    }
+  }
+  WebPDemuxReleaseIterator(&iterator);
+  WebPDemuxDelete(demux);
+  remove(path.c_str());
+}
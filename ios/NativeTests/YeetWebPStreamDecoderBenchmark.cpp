@@ -0,0 +1,134 @@
+//
+//  YeetWebPStreamDecoderBenchmark.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <WebP/encode.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "YeetWebPStreamDecoder.h"
+
+// Streams a feed-sized photo (lossy) and a sticker (lossless) through YeetWebPStreamDecoder in
+// network-sized chunks and reports:
+//
+//   - total decode time against one yeetDecodeWebP call on the whole file, which is the cost of
+//     decoding as the bytes arrive instead of after the download;
+//   - how much of the file had arrived when the first rows showed up, and how many rows were on
+//     screen at a quarter, half and three quarters of the download.
+//
+// Exits non-zero if a streamed bitmap differs from the one-shot decode.
+
+struct YeetBenchmarkImage {
+  const char *name;
+  int width;
+  int height;
+  bool lossless;
+};
+
+static const YeetBenchmarkImage YeetImages[] = {
+  {"photo 1080x1350 lossy", 1080, 1350, false},
+  {"sticker 512x512 lossless", 512, 512, true},
+};
+
+static const size_t YeetChunkSizes[] = {2 * 1024, 8 * 1024, 32 * 1024};
+
+// Gradients with heavy grain, so the files are about as big as real ones, and for the sticker a
+// transparent border around the subject.
+static std::vector<uint8_t> encodeImage(const YeetBenchmarkImage &image) {
+  std::vector<uint8_t> rgba((size_t)image.width * image.height * 4);
+  uint32_t seed = 11;
+  for (int y = 0; y < image.height; y++) {
+    for (int x = 0; x < image.width; x++) {
+      seed = seed * 1664525 + 1013904223;
+      const int grain = (int)(seed >> 27) - 16;
+      const int dx = x - image.width / 2;
+      const int dy = y - image.height / 2;
+      const bool inside = !image.lossless || dx * dx + dy * dy < image.width * image.width / 5;
+      uint8_t *pixel = &rgba[((size_t)y * image.width + x) * 4];
+      pixel[0] = (uint8_t)std::min(255, std::max(0, x * 255 / image.width + grain));
+      pixel[1] = (uint8_t)std::min(255, std::max(0, y * 255 / image.height + grain));
+      pixel[2] = (uint8_t)std::min(255, std::max(0, ((x ^ y) & 0xF0) + grain));
+      pixel[3] = inside ? 255 : 0;
+    }
+  }
+
+  uint8_t *output = nullptr;
+  const size_t size = image.lossless ?
+    WebPEncodeLosslessRGBA(rgba.data(), image.width, image.height, image.width * 4, &output) :
+    WebPEncodeRGBA(rgba.data(), image.width, image.height, image.width * 4, 80, &output);
+  std::vector<uint8_t> webp(output, output + size);
+  WebPFree(output);
+  return webp;
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+  const int runs = std::max(1, argc > 1 ? atoi(argv[1]) : 10);
+
+  bool mismatch = false;
+  for (const YeetBenchmarkImage &image : YeetImages) {
+    const std::vector<uint8_t> webp = encodeImage(image);
+    if (webp.empty()) {
+      fprintf(stderr, "couldn't encode the %s\n", image.name);
+      return 1;
+    }
+
+    double oneShot = 0;
+    std::shared_ptr<YeetWebPBitmap> expected;
+    for (int run = 0; run < runs; run++) {
+      auto start = std::chrono::steady_clock::now();
+      expected = yeetDecodeWebP(webp.data(), webp.size(), 0, 0, YeetWebPResizeMode::cover);
+      oneShot += millisecondsSince(start);
+    }
+    if (!expected) {
+      fprintf(stderr, "yeetDecodeWebP couldn't decode the %s\n", image.name);
+      return 1;
+    }
+    printf("%s, %zu KB: one shot %.2f ms\n", image.name, webp.size() / 1024, oneShot / runs);
+
+    for (size_t chunkSize : YeetChunkSizes) {
+      double streamed = 0;
+      // Rows on screen after each chunk, from the last run; every run decodes the same rows.
+      std::vector<int> rowsAfterChunk;
+      for (int run = 0; run < runs; run++) {
+        YeetWebPStreamDecoder decoder(0, 0, YeetWebPResizeMode::cover);
+        rowsAfterChunk.clear();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < webp.size(); offset += chunkSize) {
+          decoder.append(webp.data() + offset, std::min(chunkSize, webp.size() - offset));
+          rowsAfterChunk.push_back(decoder.decodedRows());
+        }
+        streamed += millisecondsSince(start);
+
+        auto bitmap = decoder.bitmap();
+        if (!bitmap || bitmap->pixels != expected->pixels) {
+          fprintf(stderr, "%s in %zu byte chunks differs from the one-shot decode\n", image.name, chunkSize);
+          mismatch = true;
+          break;
+        }
+      }
+
+      const size_t chunks = rowsAfterChunk.size();
+      const size_t firstChunk = std::find_if(rowsAfterChunk.begin(), rowsAfterChunk.end(), [](int rows) { return rows > 0; }) - rowsAfterChunk.begin();
+      // Rows on screen once the first chunk reaching this fraction of the file has been appended.
+      auto rowsAt = [&](double fraction) {
+        const size_t chunk = std::min(chunks - 1, (size_t)(webp.size() * fraction) / chunkSize);
+        return 100.0 * rowsAfterChunk[chunk] / expected->height;
+      };
+      printf("  %5zu KB chunks: streamed %7.2f ms   first rows at %5.1f%% of the bytes   rows at 25/50/75%%: %5.1f%% %5.1f%% %5.1f%%\n",
+        chunkSize / 1024, streamed / runs, 100.0 * std::min(webp.size(), (firstChunk + 1) * chunkSize) / webp.size(),
+        rowsAt(0.25), rowsAt(0.5), rowsAt(0.75));
+    }
+  }
+
+  return mismatch ? 1 : 0;
+}
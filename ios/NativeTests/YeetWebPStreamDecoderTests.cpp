@@ -0,0 +1,178 @@
+//
+//  YeetWebPStreamDecoderTests.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/21/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include <gtest/gtest.h>
+#include "YeetWebPStreamDecoder.h"
+#include <WebP/encode.h>
+#include <algorithm>
+#include <random>
+
+// A noisy opaque image, so lossy encoding has real texture to work with.
+static std::vector<uint8_t> encodeTestImage(int width, int height, bool lossless) {
+  std::vector<uint8_t> rgba((size_t)width * height * 4);
+  uint32_t seed = 12345;
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      seed = seed * 1664525 + 1013904223;
+      uint8_t *pixel = &rgba[((size_t)y * width + x) * 4];
+      pixel[0] = (uint8_t)(x * 255 / width);
+      pixel[1] = (uint8_t)(y * 255 / height);
+      pixel[2] = (uint8_t)(seed >> 24);
+      pixel[3] = 255;
+    }
+  }
+
+  uint8_t *output = nullptr;
+  const size_t size = lossless ?
+    WebPEncodeLosslessRGBA(rgba.data(), width, height, width * 4, &output) :
+    WebPEncodeRGBA(rgba.data(), width, height, width * 4, 75, &output);
+  std::vector<uint8_t> webp(output, output + size);
+  WebPFree(output);
+  return webp;
+}
+
+static YeetWebPStreamDecoder::Status streamInChunks(YeetWebPStreamDecoder &decoder, const std::vector<uint8_t> &data, size_t chunkSize) {
+  YeetWebPStreamDecoder::Status status = YeetWebPStreamDecoder::Status::incomplete;
+  for (size_t offset = 0; offset < data.size(); offset += chunkSize) {
+    status = decoder.append(data.data() + offset, std::min(chunkSize, data.size() - offset));
+  }
+  return status;
+}
+
+struct StreamCase {
+  int targetWidth;
+  int targetHeight;
+  YeetWebPResizeMode mode;
+};
+
+// The stream decoder promises the same bitmap as a one-shot decode of the whole file, however
+// the bytes happen to arrive.
+TEST(YeetWebPStreamDecoder, MatchesOneShotDecodeForAnyChunking) {
+  const StreamCase cases[] = {
+    {0, 0, YeetWebPResizeMode::cover},
+    {90, 90, YeetWebPResizeMode::cover},
+    {500, 100, YeetWebPResizeMode::cover},
+    {64, 64, YeetWebPResizeMode::contain},
+    {100, 30, YeetWebPResizeMode::stretch},
+  };
+
+  for (bool lossless : {false, true}) {
+    const std::vector<uint8_t> webp = encodeTestImage(181, 123, lossless);
+    ASSERT_FALSE(webp.empty());
+
+    for (const StreamCase &test : cases) {
+      auto expected = yeetDecodeWebP(webp.data(), webp.size(), test.targetWidth, test.targetHeight, test.mode);
+      ASSERT_NE(expected, nullptr);
+
+      for (size_t chunkSize : {(size_t)1, (size_t)7, (size_t)100, (size_t)4096, webp.size()}) {
+        YeetWebPStreamDecoder decoder(test.targetWidth, test.targetHeight, test.mode);
+        ASSERT_EQ(streamInChunks(decoder, webp, chunkSize), YeetWebPStreamDecoder::Status::complete)
+          << "lossless " << lossless << ", target " << test.targetWidth << "x" << test.targetHeight << ", chunk " << chunkSize;
+
+        auto bitmap = decoder.bitmap();
+        ASSERT_NE(bitmap, nullptr);
+        EXPECT_EQ(bitmap->width, expected->width);
+        EXPECT_EQ(bitmap->height, expected->height);
+        EXPECT_TRUE(bitmap->pixels == expected->pixels)
+          << "lossless " << lossless << ", target " << test.targetWidth << "x" << test.targetHeight << ", chunk " << chunkSize;
+        EXPECT_EQ(decoder.decodedRows(), expected->height);
+      }
+    }
+  }
+}
+
+// Network reads come in whatever sizes the connection delivers, not fixed ones.
+TEST(YeetWebPStreamDecoder, MatchesOneShotDecodeForRandomChunks) {
+  std::mt19937 random(21);
+  for (bool lossless : {false, true}) {
+    const std::vector<uint8_t> webp = encodeTestImage(203, 157, lossless);
+    auto expected = yeetDecodeWebP(webp.data(), webp.size(), 120, 80, YeetWebPResizeMode::cover);
+    ASSERT_NE(expected, nullptr);
+
+    for (int trial = 0; trial < 50; trial++) {
+      // Mostly small reads, with the occasional large one.
+      std::uniform_int_distribution<size_t> chunkSize(1, trial % 5 == 0 ? webp.size() : 512);
+      YeetWebPStreamDecoder decoder(120, 80, YeetWebPResizeMode::cover);
+      YeetWebPStreamDecoder::Status status = YeetWebPStreamDecoder::Status::incomplete;
+      for (size_t offset = 0; offset < webp.size();) {
+        const size_t size = std::min(chunkSize(random), webp.size() - offset);
+        status = decoder.append(webp.data() + offset, size);
+        offset += size;
+      }
+
+      ASSERT_EQ(status, YeetWebPStreamDecoder::Status::complete) << "lossless " << lossless << ", trial " << trial;
+      auto bitmap = decoder.bitmap();
+      ASSERT_NE(bitmap, nullptr);
+      EXPECT_TRUE(bitmap->pixels == expected->pixels) << "lossless " << lossless << ", trial " << trial;
+    }
+  }
+}
+
+TEST(YeetWebPStreamDecoder, ReportsRowsAndSnapshotsThePartialImage) {
+  const std::vector<uint8_t> webp = encodeTestImage(160, 200, false);
+
+  std::vector<int> reported;
+  YeetWebPStreamDecoder decoder(0, 0, YeetWebPResizeMode::cover, [&reported](int decodedRows, int height) {
+    EXPECT_EQ(height, 200);
+    reported.push_back(decodedRows);
+  });
+
+  EXPECT_EQ(decoder.snapshot(), nullptr);
+  EXPECT_EQ(decoder.height(), 0);
+
+  // Stop partway through and check the snapshot against the finished image afterwards.
+  const size_t half = webp.size() / 2;
+  ASSERT_EQ(decoder.append(webp.data(), half), YeetWebPStreamDecoder::Status::incomplete);
+  EXPECT_EQ(decoder.height(), 200);
+  EXPECT_EQ(decoder.bitmap(), nullptr);
+
+  const int partialRows = decoder.decodedRows();
+  ASSERT_GT(partialRows, 0);
+  ASSERT_LT(partialRows, 200);
+  auto partial = decoder.snapshot();
+  ASSERT_NE(partial, nullptr);
+
+  ASSERT_EQ(decoder.append(webp.data() + half, webp.size() - half), YeetWebPStreamDecoder::Status::complete);
+  auto finished = decoder.bitmap();
+  ASSERT_NE(finished, nullptr);
+
+  const size_t rowBytes = (size_t)finished->width * 4;
+  const size_t partialBytes = partialRows * rowBytes;
+  EXPECT_TRUE(std::equal(partial->pixels.begin(), partial->pixels.begin() + partialBytes, finished->pixels.begin()));
+  EXPECT_TRUE(std::all_of(partial->pixels.begin() + partialBytes, partial->pixels.end(), [](uint8_t byte) { return byte == 0; }));
+
+  ASSERT_FALSE(reported.empty());
+  EXPECT_TRUE(std::is_sorted(reported.begin(), reported.end()));
+  EXPECT_EQ(std::adjacent_find(reported.begin(), reported.end()), reported.end());
+}
+
+TEST(YeetWebPStreamDecoder, AnimatedFilesAreUnsupported) {
+  // RIFF header and a VP8X chunk with the animation flag, for a 16x16 canvas.
+  const uint8_t animated[] = {
+    'R', 'I', 'F', 'F', 22, 0, 0, 0, 'W', 'E', 'B', 'P',
+    'V', 'P', '8', 'X', 10, 0, 0, 0,
+    0x02, 0, 0, 0,
+    15, 0, 0,
+    15, 0, 0,
+  };
+
+  YeetWebPStreamDecoder decoder(0, 0, YeetWebPResizeMode::cover);
+  EXPECT_EQ(decoder.append(animated, sizeof(animated)), YeetWebPStreamDecoder::Status::unsupported);
+  EXPECT_EQ(decoder.bitmap(), nullptr);
+}
+
+TEST(YeetWebPStreamDecoder, GarbageFailsAndStaysFailed) {
+  const uint8_t garbage[64] = {'n', 'o', 't', ' ', 'a', ' ', 'w', 'e', 'b', 'p'};
+
+  YeetWebPStreamDecoder decoder(0, 0, YeetWebPResizeMode::cover);
+  EXPECT_EQ(decoder.append(garbage, sizeof(garbage)), YeetWebPStreamDecoder::Status::failed);
+
+  const std::vector<uint8_t> webp = encodeTestImage(16, 16, true);
+  EXPECT_EQ(decoder.append(webp.data(), webp.size()), YeetWebPStreamDecoder::Status::failed);
+  EXPECT_EQ(decoder.bitmap(), nullptr);
+}
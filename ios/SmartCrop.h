@@ -0,0 +1,30 @@
+//
+//  SmartCrop.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/12/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Content-aware crop framing. The saliency map is computed once per asset id and kept in an LRU
+// cache, so asking for several aspect ratios of the same asset only pays for the first one.
+// Rects are in image pixels (image.size * image.scale).
+@interface SmartCrop : NSObject
+// Computes and caches the map if it isn't cached yet. Slow the first time; call it off the main thread.
++ (void)prepareImage:(UIImage*)image assetId:(NSString*)assetId;
++ (BOOL)isPreparedForAssetId:(NSString*)assetId;
++ (void)forgetAssetId:(NSString*)assetId;
+
+// The crop with this aspect ratio (width / height) that keeps the most salient content.
+// zoom = 1 is the largest crop that fits; smaller zooms in. CGRectNull when the asset isn't prepared.
++ (CGRect)cropRectForAssetId:(NSString*)assetId aspectRatio:(CGFloat)aspectRatio zoom:(CGFloat)zoom;
+// Prepares the image first when needed.
++ (CGRect)cropRectInImage:(UIImage*)image assetId:(NSString*)assetId aspectRatio:(CGFloat)aspectRatio zoom:(CGFloat)zoom;
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,116 @@
+//
+//  SmartCrop.mm
+//  yeet
+//
+//  Created by Jarred WSumner on 3/12/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#import "SmartCrop.h"
+#import "UIImage+OpenCVConversion.h"
+#include <opencv2/imgproc/imgproc.hpp>
+#include "YeetPixelBuffer.h"
+#include "YeetQuadSuppression.h"
+#include "YeetSaliencyMap.h"
+#include "YeetSquareDetector.h"
+#include "YeetTextDetector.h"
+
+// Saliency is blurry by nature, and both detectors are happy at this size.
+static const int YeetSmartCropWorkingSize = 512;
+
+// Both detectors read the same planes. The text detector's smaller blur keeps thin caption strokes,
+// and squares at this size hold up fine with it.
+static const int YeetSmartCropMedianBlurSize = YeetTextDetectorOptions().medianBlurSize;
+
+// Text is usually the point of a meme, so it outweighs a detected panel.
+static const float YeetSmartCropSquareWeight = 1;
+static const float YeetSmartCropTextWeight = 2;
+
+@implementation SmartCrop
+
++ (void)prepareImage:(UIImage*)image assetId:(NSString*)assetId
+{
+  if ([self isPreparedForAssetId:assetId]) {
+    return;
+  }
+
+  YeetPixelBuffer pixels;
+  cv::Mat swizzled;
+  cv::Mat original = [UIImage copyPixelBuffer:pixels fromImage:image]
+    ? yeetPixelBufferRGBA(pixels, swizzled)
+    : [UIImage toCvMat:image];
+  if (original.empty()) {
+    return;
+  }
+
+  cv::Mat working = original;
+  const double scale = (double)YeetSmartCropWorkingSize / std::max(original.cols, original.rows);
+  if (scale < 1) {
+    cv::resize(original, working, cv::Size(), scale, scale, cv::INTER_AREA);
+  }
+
+  std::vector<YeetSaliencyRegion> regions;
+
+  YeetDetectorPreprocessor preprocessed;
+  preprocessed.process(working, YeetSmartCropMedianBlurSize);
+
+  std::vector<std::vector<cv::Point>> squares;
+  YeetSquareDetector squareDetector;
+  squareDetector.detect(preprocessed, squares);
+
+  // The same panel comes back from many (channel, level) passes. Unsuppressed, each copy would add
+  // its weight again and a single panel would outweigh any caption.
+  std::vector<YeetQuad> quads;
+  yeetQuadsFromSquares(squares, cv::Mat(), quads);
+  std::vector<YeetRankedQuad> ranked;
+  yeetSuppressQuads(quads, ranked);
+  for (const auto &result : ranked) {
+    YeetSaliencyRegion region;
+    region.bounds = cv::Rect(result.quad.bounds);
+    region.weight = YeetSmartCropSquareWeight;
+    regions.push_back(region);
+  }
+
+  std::vector<YeetTextLine> lines;
+  YeetTextDetector textDetector;
+  textDetector.detect(preprocessed, lines);
+  for (const auto &line : lines) {
+    YeetSaliencyRegion region;
+    region.bounds = line.bounds;
+    region.weight = YeetSmartCropTextWeight;
+    regions.push_back(region);
+  }
+
+  auto map = std::make_shared<YeetSaliencyMap>();
+  map->compute(working, regions, original.size());
+  YeetSaliencyCache::shared().set(assetId.UTF8String, map);
+}
+
++ (BOOL)isPreparedForAssetId:(NSString*)assetId
+{
+  return YeetSaliencyCache::shared().get(assetId.UTF8String) != nullptr;
+}
+
++ (void)forgetAssetId:(NSString*)assetId
+{
+  YeetSaliencyCache::shared().remove(assetId.UTF8String);
+}
+
++ (CGRect)cropRectForAssetId:(NSString*)assetId aspectRatio:(CGFloat)aspectRatio zoom:(CGFloat)zoom
+{
+  auto map = YeetSaliencyCache::shared().get(assetId.UTF8String);
+  if (!map || map->empty()) {
+    return CGRectNull;
+  }
+
+  const cv::Rect crop = map->bestCrop(aspectRatio, zoom);
+  return CGRectMake(crop.x, crop.y, crop.width, crop.height);
+}
+
++ (CGRect)cropRectInImage:(UIImage*)image assetId:(NSString*)assetId aspectRatio:(CGFloat)aspectRatio zoom:(CGFloat)zoom
+{
+  [self prepareImage:image assetId:assetId];
+  return [self cropRectForAssetId:assetId aspectRatio:aspectRatio zoom:zoom];
+}
+
+@end
@@ -5,6 +5,7 @@
 #pragma clang diagnostic ignored "-Wdocumentation"
 
 #import <opencv2/core/core.hpp>
+#include "YeetPixelBuffer.h"
 
 #pragma clang pop
 #endif
@@ -13,10 +14,21 @@
 
 #ifdef __cplusplus
 
+// RGBA, at the image's size in pixels (image.size * image.scale).
 + (cv::Mat)toCvMat:(UIImage *)image;
+// Grayscale, drawn straight into a DeviceGray context. Empty if the context can't be created.
 + (cv::Mat)toCvMatGray:(UIImage *)image;
 + (UIImage *)fromCvMat:(cv::Mat)cvMat;
 
+// Copies the CGImage's pixels out of its data provider as they are, instead of redrawing them.
+// That's still one copy of the image (CGImage has no public way to read its backing store in
+// place), but it skips toCvMat:'s bitmap context and color conversion.
+// Returns NO when toCvMat: would produce something different: a non 8-bit RGBA/BGRA layout,
+// or an image whose scale or orientation doesn't match its CGImage.
++ (BOOL)copyPixelBuffer:(YeetPixelBuffer &)buffer fromImage:(UIImage *)image;
+// Wraps the buffer's pixels in a CGImage without copying them. The image keeps buffer.owner alive.
++ (UIImage *)fromPixelBuffer:(const YeetPixelBuffer &)buffer;
+
 #endif
 
 @end
@@ -17,8 +17,9 @@
 + (cv::Mat)toCvMat:(UIImage *)image
 {
     CGColorSpaceRef colorSpace = CGImageGetColorSpace(image.CGImage);
-    CGFloat cols = image.size.width;
-    CGFloat rows = image.size.height;
+    // In pixels, like copyPixelBuffer:fromImage:, so callers never have to know which one ran.
+    CGFloat cols = round(image.size.width * image.scale);
+    CGFloat rows = round(image.size.height * image.scale);
 
     cv::Mat cvMat(rows, cols, CV_8UC4); // 8 bits per component, 4 channels (color channels + alpha)
 
@@ -39,9 +40,11 @@
 
 + (cv::Mat)toCvMatGray:(UIImage *)image
 {
-    CGColorSpaceRef colorSpace = CGImageGetColorSpace(image.CGImage);
-    CGFloat cols = image.size.width;
-    CGFloat rows = image.size.height;
+    // An 8-bit, one-channel bitmap context has to be DeviceGray with no alpha. Any other
+    // combination makes CGBitmapContextCreate return NULL.
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceGray();
+    CGFloat cols = round(image.size.width * image.scale);
+    CGFloat rows = round(image.size.height * image.scale);
 
     cv::Mat cvMat(rows, cols, CV_8UC1); // 8 bits per component, 1 channels
 
@@ -51,8 +54,12 @@
                                                     8,                          // Bits per component
                                                     cvMat.step[0],              // Bytes per row
                                                     colorSpace,                 // Colorspace
-                                                    kCGImageAlphaNoneSkipLast |
+                                                    kCGImageAlphaNone |
                                                     kCGBitmapByteOrderDefault); // Bitmap info flags
+    CGColorSpaceRelease(colorSpace);
+    if (contextRef == NULL) {
+        return cv::Mat();
+    }
 
     CGContextDrawImage(contextRef, CGRectMake(0, 0, cols, rows), image.CGImage);
     CGContextRelease(contextRef);
@@ -62,6 +69,10 @@
 
 + (UIImage *)fromCvMat:(cv::Mat)cvMat
 {
+    if (cvMat.type() == CV_8UC4) {
+        return [self fromPixelBuffer:YeetPixelBuffer::adopt(cvMat, YeetPixelFormat::RGBA)];
+    }
+
     NSData *data = [NSData dataWithBytes:cvMat.data length:cvMat.elemSize()*cvMat.total()];
     CGColorSpaceRef colorSpace;
 
@@ -97,6 +108,99 @@
     return finalImage;
 }
 
++ (BOOL)copyPixelBuffer:(YeetPixelBuffer &)buffer fromImage:(UIImage *)image
+{
+    CGImageRef imageRef = image.CGImage;
+    if (imageRef == NULL || image.scale != 1.0 || image.imageOrientation != UIImageOrientationUp) {
+        return NO;
+    }
+
+    if (CGImageGetBitsPerComponent(imageRef) != 8 ||
+        CGImageGetBitsPerPixel(imageRef) != 32 ||
+        CGColorSpaceGetModel(CGImageGetColorSpace(imageRef)) != kCGColorSpaceModelRGB) {
+        return NO;
+    }
+
+    CGImageAlphaInfo alphaInfo = CGImageGetAlphaInfo(imageRef);
+    CGBitmapInfo byteOrder = CGImageGetBitmapInfo(imageRef) & kCGBitmapByteOrderMask;
+    // Drawing into toCvMat's skip-alpha context composites over black, which is what premultiplied
+    // color already is. Straight alpha would give different RGB, so those images get redrawn.
+    BOOL alphaLast = alphaInfo == kCGImageAlphaPremultipliedLast || alphaInfo == kCGImageAlphaNoneSkipLast;
+    BOOL alphaFirst = alphaInfo == kCGImageAlphaPremultipliedFirst || alphaInfo == kCGImageAlphaNoneSkipFirst;
+
+    // 32Little reverses the component order in memory, so "alpha first" is BGRA.
+    YeetPixelFormat format;
+    if (alphaLast && (byteOrder == kCGBitmapByteOrderDefault || byteOrder == kCGBitmapByteOrder32Big)) {
+        format = YeetPixelFormat::RGBA;
+    } else if (alphaFirst && byteOrder == kCGBitmapByteOrder32Little) {
+        format = YeetPixelFormat::BGRA;
+    } else {
+        return NO;
+    }
+
+    CGDataProviderRef provider = CGImageGetDataProvider(imageRef);
+    CFDataRef data = provider ? CGDataProviderCopyData(provider) : NULL;
+    if (data == NULL) {
+        return NO;
+    }
+
+    std::shared_ptr<void> owner((void *)data, [](void *data) {
+        CFRelease((CFDataRef)data);
+    });
+
+    // CGDataProviderCopyData returns a copy, which the CFData owns. Treat the view as read-only.
+    buffer = YeetPixelBuffer::borrow(
+        (uint8_t *)CFDataGetBytePtr(data),
+        (int)CGImageGetWidth(imageRef),
+        (int)CGImageGetHeight(imageRef),
+        CGImageGetBytesPerRow(imageRef),
+        format,
+        owner
+    );
+
+    return !buffer.empty() && buffer.length() <= (size_t)CFDataGetLength(data);
+}
+
+static void releasePixelBuffer(void *info, const void *data, size_t size)
+{
+    delete (YeetPixelBuffer *)info;
+}
+
++ (UIImage *)fromPixelBuffer:(const YeetPixelBuffer &)buffer
+{
+    if (buffer.empty()) {
+        return nil;
+    }
+
+    CGBitmapInfo bitmapInfo = buffer.format == YeetPixelFormat::RGBA
+        ? kCGImageAlphaNoneSkipLast | kCGBitmapByteOrderDefault
+        : kCGImageAlphaNoneSkipFirst | kCGBitmapByteOrder32Little;
+
+    // The provider holds its own copy of the buffer (and so a reference to owner) until the CGImage is gone.
+    YeetPixelBuffer *retained = new YeetPixelBuffer(buffer);
+    CGDataProviderRef provider = CGDataProviderCreateWithData(retained, retained->data, retained->length(), releasePixelBuffer);
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+
+    CGImageRef imageRef = CGImageCreate(buffer.width,
+                                        buffer.height,
+                                        8,
+                                        32,
+                                        buffer.bytesPerRow,
+                                        colorSpace,
+                                        bitmapInfo,
+                                        provider,
+                                        NULL,
+                                        false,
+                                        kCGRenderingIntentDefault);
+
+    UIImage *finalImage = imageRef ? [UIImage imageWithCGImage:imageRef] : nil;
+    CGImageRelease(imageRef);
+    CGDataProviderRelease(provider);
+    CGColorSpaceRelease(colorSpace);
+
+    return finalImage;
+}
+
 #endif
 
 @end
@@ -7,7 +7,6 @@
 //
 
 #import <UIKit/UIKit.h>
-#import <SDWebImage/SDAnimatedImage.h>
 
 
 @protocol RCTAnimatedImage <NSObject>
@@ -19,9 +18,22 @@
 
 @end
 
+#ifdef __cplusplus
+#include <memory>
 
-@interface YeetAnimatedImage : SDAnimatedImage <RCTAnimatedImage>
+struct YeetWebPBitmap;
+
+// Wraps the bitmap's pixels in a CGImage without copying them. The CGImage keeps the bitmap alive,
+// which also keeps a decoder from reusing the buffer while it's on screen.
+CGImageRef _Nullable YeetCreateWebPBitmapImage(const std::shared_ptr<const YeetWebPBitmap> &bitmap);
+#endif
 
-@end
 
+// An animated WebP that decodes frames as they're shown instead of all at once.
+// The image itself is the first frame, so it also works anywhere a still UIImage is expected.
+@interface YeetAnimatedImage : UIImage <RCTAnimatedImage>
 
+// nil unless data is a valid WebP with more than one frame.
++ (nullable instancetype)animatedImageWithWebPData:(nonnull NSData *)data scale:(CGFloat)scale;
+
+@end
@@ -1,8 +0,0 @@
-#import <ImageIO/ImageIO.h>
-#import "YeetAnimatedImage.h"
-
-
-@implementation YeetAnimatedImage
-
-
-@end
@@ -0,0 +1,94 @@
+#import <ImageIO/ImageIO.h>
+#import "YeetAnimatedImage.h"
+#include "YeetAnimatedWebP.h"
+
+static void YeetReleaseWebPBitmap(void *info, const void *data, size_t size)
+{
+  delete (std::shared_ptr<const YeetWebPBitmap> *)info;
+}
+
+CGImageRef YeetCreateWebPBitmapImage(const std::shared_ptr<const YeetWebPBitmap> &bitmap)
+{
+  if (!bitmap || bitmap->pixels.empty()) {
+    return NULL;
+  }
+
+  const int width = bitmap->width;
+  const int height = bitmap->height;
+  auto info = new std::shared_ptr<const YeetWebPBitmap>(bitmap);
+  CGDataProviderRef provider = CGDataProviderCreateWithData(info, bitmap->pixels.data(), bitmap->pixels.size(), YeetReleaseWebPBitmap);
+  if (!provider) {
+    delete info;
+    return NULL;
+  }
+
+  CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+  CGImageRef image = CGImageCreate(width, height, 8, 32, (size_t)width * 4, colorSpace,
+                                   kCGBitmapByteOrderDefault | kCGImageAlphaPremultipliedLast,
+                                   provider, NULL, false, kCGRenderingIntentDefault);
+  CGColorSpaceRelease(colorSpace);
+  CGDataProviderRelease(provider);
+  return image;
+}
+
+@implementation YeetAnimatedImage {
+  std::unique_ptr<YeetAnimatedWebP> _webp;
+}
+
++ (instancetype)animatedImageWithWebPData:(NSData *)data scale:(CGFloat)scale
+{
+  // Immutable, so the bytes the demuxer points into can't move.
+  NSData *bytes = [data copy];
+  std::shared_ptr<void> owner((void *)CFBridgingRetain(bytes), [](void *object) {
+    CFRelease(object);
+  });
+
+  auto webp = YeetAnimatedWebP::create((const uint8_t *)bytes.bytes, bytes.length, owner);
+  if (!webp || webp->frameCount() < 2) {
+    return nil;
+  }
+
+  CGImageRef poster = YeetCreateWebPBitmapImage(webp->frame(0));
+  if (!poster) {
+    return nil;
+  }
+
+  YeetAnimatedImage *image = [[self alloc] initWithCGImage:poster scale:scale orientation:UIImageOrientationUp];
+  CGImageRelease(poster);
+
+  image->_webp = std::move(webp);
+  return image;
+}
+
+- (NSUInteger)animatedImageFrameCount
+{
+  return _webp ? _webp->frameCount() : 0;
+}
+
+- (NSUInteger)animatedImageLoopCount
+{
+  return _webp ? _webp->loopCount() : 0;
+}
+
+- (UIImage *)animatedImageFrameAtIndex:(NSUInteger)index
+{
+  if (!_webp) {
+    return nil;
+  }
+
+  CGImageRef frame = YeetCreateWebPBitmapImage(_webp->frame((int)index));
+  if (!frame) {
+    return nil;
+  }
+
+  UIImage *image = [UIImage imageWithCGImage:frame scale:self.scale orientation:UIImageOrientationUp];
+  CGImageRelease(frame);
+  return image;
+}
+
+- (NSTimeInterval)animatedImageDurationAtIndex:(NSUInteger)index
+{
+  return _webp ? _webp->duration((int)index) / 1000.0 : 0;
+}
+
+@end
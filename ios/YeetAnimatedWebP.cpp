@@ -0,0 +1,198 @@
+//
+//  YeetAnimatedWebP.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/16/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetAnimatedWebP.h"
+#include <WebP/decode.h>
+#include "WebPDemux/demux.h"
+#include <algorithm>
+#include <cstring>
+
+// Browsers play frames this short at 100ms, and stickers are authored against them.
+static const int YeetAnimatedWebPMinDuration = 10;
+static const int YeetAnimatedWebPDefaultDuration = 100;
+
+std::unique_ptr<YeetAnimatedWebP> YeetAnimatedWebP::create(const uint8_t *data, size_t size, std::shared_ptr<void> owner, size_t ringSize) {
+  WebPData webpData;
+  webpData.bytes = data;
+  webpData.size = size;
+
+  WebPDemuxer *demux = WebPDemux(&webpData);
+  if (!demux) {
+    return nullptr;
+  }
+
+  std::unique_ptr<YeetAnimatedWebP> image(new YeetAnimatedWebP(demux, std::move(owner), ringSize));
+  if (image->frames_.empty() || image->width_ <= 0 || image->height_ <= 0) {
+    return nullptr;
+  }
+
+  return image;
+}
+
+YeetAnimatedWebP::YeetAnimatedWebP(WebPDemuxer *demux, std::shared_ptr<void> owner, size_t ringSize)
+: demux_(demux), owner_(std::move(owner)), ring_(std::max<size_t>(1, ringSize)) {
+  width_ = (int)WebPDemuxGetI(demux_, WEBP_FF_CANVAS_WIDTH);
+  height_ = (int)WebPDemuxGetI(demux_, WEBP_FF_CANVAS_HEIGHT);
+  loopCount_ = (int)WebPDemuxGetI(demux_, WEBP_FF_LOOP_COUNT);
+
+  WebPIterator iterator;
+  if (!WebPDemuxGetFrame(demux_, 1, &iterator)) {
+    return;
+  }
+
+  do {
+    FrameInfo frame;
+    frame.x = iterator.x_offset;
+    frame.y = iterator.y_offset;
+    frame.width = iterator.width;
+    frame.height = iterator.height;
+    frame.duration = iterator.duration <= YeetAnimatedWebPMinDuration ? YeetAnimatedWebPDefaultDuration : iterator.duration;
+    frame.hasAlpha = iterator.has_alpha != 0;
+    frame.blend = iterator.blend_method == WEBP_MUX_BLEND;
+    frame.disposeToBackground = iterator.dispose_method == WEBP_MUX_DISPOSE_BACKGROUND;
+
+    // Same rules as libwebp's WebPAnimDecoder: a frame is a keyframe when it paints the whole
+    // canvas without reading it, or when the previous frame leaves nothing behind.
+    const bool fullCanvas = frame.x == 0 && frame.y == 0 && frame.width == width_ && frame.height == height_;
+    if (frames_.empty()) {
+      frame.keyframe = true;
+    } else if (fullCanvas && (!frame.hasAlpha || !frame.blend)) {
+      frame.keyframe = true;
+    } else {
+      const FrameInfo &previous = frames_.back();
+      const bool previousFullCanvas = previous.x == 0 && previous.y == 0 && previous.width == width_ && previous.height == height_;
+      frame.keyframe = previous.disposeToBackground && (previousFullCanvas || previous.keyframe);
+    }
+
+    frames_.push_back(frame);
+  } while (WebPDemuxNextFrame(&iterator));
+  WebPDemuxReleaseIterator(&iterator);
+}
+
+YeetAnimatedWebP::~YeetAnimatedWebP() {
+  WebPDemuxDelete(demux_);
+}
+
+int YeetAnimatedWebP::duration(int index) const {
+  if (index < 0 || index >= (int)frames_.size()) {
+    return 0;
+  }
+  return frames_[index].duration;
+}
+
+std::shared_ptr<const YeetAnimatedWebPFrame> YeetAnimatedWebP::frame(int index) {
+  if (index < 0 || index >= (int)frames_.size()) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto &slot : ring_) {
+    if (slot && slot->index == index) {
+      return slot;
+    }
+  }
+
+  if (canvas_.empty()) {
+    canvas_.assign((size_t)width_ * height_ * 4, 0);
+  }
+
+  int keyframe = index;
+  while (!frames_[keyframe].keyframe) {
+    keyframe--;
+  }
+
+  // Keep going from the canvas when it's already past the keyframe, otherwise start over from it.
+  const int start = canvasIndex_ >= keyframe && canvasIndex_ < index ? canvasIndex_ + 1 : keyframe;
+  for (int i = start; i <= index; i++) {
+    if (!composite(i)) {
+      canvasIndex_ = -1;
+      return nullptr;
+    }
+  }
+
+  // Whoever has the slot's previous frame (an on-screen image) keeps it; the ring moves on to a new buffer.
+  std::shared_ptr<YeetAnimatedWebPFrame> &slot = ring_[nextSlot_];
+  nextSlot_ = (nextSlot_ + 1) % ring_.size();
+  if (!slot || slot.use_count() > 1) {
+    slot = std::make_shared<YeetAnimatedWebPFrame>();
+  }
+
+  slot->index = index;
+  slot->width = width_;
+  slot->height = height_;
+  slot->pixels.assign(canvas_.begin(), canvas_.end());
+  return slot;
+}
+
+void YeetAnimatedWebP::clearCanvas(int x, int y, int width, int height) {
+  for (int row = y; row < y + height; row++) {
+    memset(&canvas_[((size_t)row * width_ + x) * 4], 0, (size_t)width * 4);
+  }
+}
+
+bool YeetAnimatedWebP::composite(int index) {
+  const FrameInfo &frame = frames_[index];
+
+  if (frame.keyframe) {
+    std::fill(canvas_.begin(), canvas_.end(), 0);
+  } else if (index > 0 && frames_[index - 1].disposeToBackground) {
+    const FrameInfo &previous = frames_[index - 1];
+    clearCanvas(previous.x, previous.y, previous.width, previous.height);
+  }
+  canvasIndex_ = index;
+
+  WebPIterator iterator;
+  if (!WebPDemuxGetFrame(demux_, index + 1, &iterator)) {
+    return false;
+  }
+
+  const size_t stride = (size_t)frame.width * 4;
+  scratch_.resize(stride * frame.height);
+
+  WebPDecoderConfig config;
+  WebPInitDecoderConfig(&config);
+  // Premultiplied, which is what CoreGraphics draws fastest, and what makes blending one multiply.
+  config.output.colorspace = MODE_rgbA;
+  config.output.is_external_memory = 1;
+  config.output.u.RGBA.rgba = scratch_.data();
+  config.output.u.RGBA.stride = (int)stride;
+  config.output.u.RGBA.size = scratch_.size();
+
+  const VP8StatusCode status = WebPDecode(iterator.fragment.bytes, iterator.fragment.size, &config);
+  WebPFreeDecBuffer(&config.output);
+  WebPDemuxReleaseIterator(&iterator);
+  if (status != VP8_STATUS_OK) {
+    return false;
+  }
+
+  const bool blend = frame.blend && frame.hasAlpha && !frame.keyframe;
+  for (int row = 0; row < frame.height; row++) {
+    const uint8_t *src = &scratch_[row * stride];
+    uint8_t *dst = &canvas_[((size_t)(frame.y + row) * width_ + frame.x) * 4];
+
+    if (!blend) {
+      memcpy(dst, src, stride);
+      continue;
+    }
+
+    // Premultiplied "over": dst = src + dst * (1 - srcAlpha).
+    for (int x = 0; x < frame.width; x++, src += 4, dst += 4) {
+      const uint32_t alpha = src[3];
+      if (alpha == 255) {
+        memcpy(dst, src, 4);
+      } else if (alpha != 0) {
+        const uint32_t remaining = 255 - alpha;
+        for (int c = 0; c < 4; c++) {
+          dst[c] = (uint8_t)(src[c] + (dst[c] * remaining + 127) / 255);
+        }
+      }
+    }
+  }
+
+  return true;
+}
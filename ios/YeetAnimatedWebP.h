@@ -0,0 +1,93 @@
+//
+//  YeetAnimatedWebP.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/16/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "YeetWebPDecoder.h"
+
+struct WebPDemuxer;
+
+// One composited canvas.
+struct YeetAnimatedWebPFrame : YeetWebPBitmap {
+  int index = -1;
+};
+
+// Animated WebP decoded one frame at a time.
+//
+// The file is demuxed once up front, which only reads frame headers. Frames are decoded when
+// asked for and composited onto a canvas that follows the disposal and blend rules, so playing
+// forward decodes exactly one frame per frame. Seeking backwards (or looping) replays from the
+// nearest keyframe: a frame that doesn't depend on the ones before it.
+//
+// The last few composited frames are kept in a ring. A slot is reused once nothing else holds
+// its frame, so memory stays at a few canvases no matter how many frames there are.
+//
+// Thread-safe.
+class YeetAnimatedWebP {
+public:
+  // The data isn't copied; owner keeps it alive. Returns nullptr when it isn't a valid WebP.
+  static std::unique_ptr<YeetAnimatedWebP> create(const uint8_t *data, size_t size, std::shared_ptr<void> owner, size_t ringSize = 3);
+
+  ~YeetAnimatedWebP();
+  YeetAnimatedWebP(const YeetAnimatedWebP &) = delete;
+  YeetAnimatedWebP &operator=(const YeetAnimatedWebP &) = delete;
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+  int frameCount() const { return (int)frames_.size(); }
+  // 0 means forever.
+  int loopCount() const { return loopCount_; }
+  // Milliseconds.
+  int duration(int index) const;
+
+  // nullptr if index is out of range or the frame data is corrupt.
+  std::shared_ptr<const YeetAnimatedWebPFrame> frame(int index);
+
+private:
+  struct FrameInfo {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    int duration = 0;
+    bool hasAlpha = false;
+    bool blend = false;
+    bool disposeToBackground = false;
+    bool keyframe = false;
+  };
+
+  YeetAnimatedWebP(WebPDemuxer *demux, std::shared_ptr<void> owner, size_t ringSize);
+
+  bool composite(int index);
+  void clearCanvas(int x, int y, int width, int height);
+
+  WebPDemuxer *demux_;
+  std::shared_ptr<void> owner_;
+  int width_ = 0;
+  int height_ = 0;
+  int loopCount_ = 0;
+  std::vector<FrameInfo> frames_;
+
+  std::mutex mutex_;
+  std::vector<uint8_t> canvas_;
+  // The frame currently composited on canvas_, or -1.
+  int canvasIndex_ = -1;
+  // Decoded frame before it's drawn onto the canvas.
+  std::vector<uint8_t> scratch_;
+  std::vector<std::shared_ptr<YeetAnimatedWebPFrame>> ring_;
+  size_t nextSlot_ = 0;
+};
+
+#endif
@@ -10,6 +10,7 @@
 #import "YeetClipboard.h"
 #include <ReactCommon/BridgeJSCallInvoker.h>
 #import <jsi/jsi.h>
+#import "YeetJSIModuleRegistry.h"
 
 #ifdef __cplusplus
 
@@ -17,9 +18,9 @@ using namespace facebook;
 
 @class RCTCxxBridge;
 
-class JSI_EXPORT YeetClipboardJSIModule : public jsi::HostObject {
+class JSI_EXPORT YeetClipboardJSIModule : public YeetJSIHostObject {
 public:
-    YeetClipboardJSIModule(YeetClipboard* clipboard);
+    YeetClipboardJSIModule(YeetClipboard* clipboard, std::shared_ptr<facebook::react::JSCallInvoker> jsInvoker);
 
     static void install(YeetClipboard *clipboard);
 
@@ -30,6 +31,8 @@ public:
 
     jsi::Value getOther(jsi::Runtime &runtime, const jsi::PropNameID &name);
 
+    void invalidate() override;
+
 private:
     YeetClipboard* clipboard_;
     std::shared_ptr<facebook::react::JSCallInvoker> _jsInvoker;
@@ -69,31 +69,28 @@
 @end
 
 YeetClipboardJSIModule::YeetClipboardJSIModule
- (YeetClipboard *clipboard)
-: clipboard_(clipboard) {
-  std::shared_ptr<facebook::react::JSCallInvoker> _jsInvoker = std::make_shared<react::BridgeJSCallInvoker>(clipboard.bridge.reactInstance);
+ (YeetClipboard *clipboard, std::shared_ptr<facebook::react::JSCallInvoker> jsInvoker)
+: clipboard_(clipboard), _jsInvoker(jsInvoker) {
 }
 
 
 void YeetClipboardJSIModule::install(YeetClipboard *clipboard) {
-  RCTCxxBridge* bridge = clipboard.bridge;
-
-   if (bridge.runtime == nullptr) {
-     return;
-   }
+  auto registry = YeetJSIModuleRegistry::forBridge(clipboard.bridge);
+  if (registry == nullptr) {
+    return;
+  }
 
-  jsi::Runtime &runtime = *(jsi::Runtime *)bridge.runtime;
+  registry->install("Clipboard", std::make_shared<YeetClipboardJSIModule>(clipboard, registry->jsInvoker()));
+}
 
-  auto reaModuleName = "Clipboard";
-  auto reaJsiModule = std::make_shared<YeetClipboardJSIModule>(std::move(clipboard));
-  auto object = jsi::Object::createFromHostObject(runtime, reaJsiModule);
-  runtime.global().setProperty(runtime, reaModuleName, std::move(object));
+void YeetClipboardJSIModule::invalidate() {
+  clipboard_ = nil;
+  _jsInvoker = nullptr;
 }
 
 jsi::Value YeetClipboardJSIModule::get(jsi::Runtime &runtime, const jsi::PropNameID &name) {
   if (_jsInvoker == nullptr) {
-      RCTCxxBridge* bridge = clipboard_.bridge;
-    _jsInvoker = std::make_shared<react::BridgeJSCallInvoker>(bridge.reactInstance);
+    return jsi::Value::undefined();
   }
 
 
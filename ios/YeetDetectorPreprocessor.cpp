@@ -0,0 +1,20 @@
+//
+//  YeetDetectorPreprocessor.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/10/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetDetectorPreprocessor.h"
+#include <opencv2/imgproc/imgproc.hpp>
+
+void YeetDetectorPreprocessor::process(const cv::Mat &image, int medianBlurSize) {
+  // blur will enhance edge detection
+  cv::medianBlur(image, blurred_, medianBlurSize);
+
+  planes_.resize(channelCount);
+  for (int c = 0; c < channelCount; c++) {
+    cv::extractChannel(blurred_, planes_[c], c);
+  }
+}
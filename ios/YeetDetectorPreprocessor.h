@@ -0,0 +1,38 @@
+//
+//  YeetDetectorPreprocessor.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/10/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+
+// The preprocessing every detector here starts with: a median blur, then the first three channels
+// split into their own 8-bit planes. The buffers are kept between calls so repeated detection on
+// same-sized images doesn't reallocate.
+//
+// Each detector owns one for detect(image). To run several detectors over the same image, process
+// it once and pass it to their detect(preprocessed) instead.
+class YeetDetectorPreprocessor {
+public:
+  static const int channelCount = 3;
+
+  // image must have at least channelCount channels.
+  void process(const cv::Mat &image, int medianBlurSize);
+
+  bool empty() const { return planes_.empty() || planes_[0].empty(); }
+  const cv::Mat &blurred() const { return blurred_; }
+  const cv::Mat &plane(int channel) const { return planes_[channel]; }
+
+private:
+  cv::Mat blurred_;
+  std::vector<cv::Mat> planes_;
+};
+
+#endif
@@ -0,0 +1,80 @@
+//
+//  YeetFrameDiff.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/20/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetFrameDiff.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cstring>
+
+static const int YeetFrameDiffPixelsPerVector = 4;
+
+static inline bool pixelChanged(const uint8_t *a, const uint8_t *b, int x) {
+  return memcmp(a + x * 4, b + x * 4, 4) != 0;
+}
+
+#if CV_SIMD128
+static inline bool vectorChanged(const uint8_t *a, const uint8_t *b, int x) {
+  return cv::v_check_any(cv::v_load(a + x * 4) != cv::v_load(b + x * 4));
+}
+#endif
+
+// The first changed pixel in [begin, end), or end.
+static int firstChangedPixel(const uint8_t *a, const uint8_t *b, int begin, int end) {
+  int x = begin;
+#if CV_SIMD128
+  for (; x <= end - YeetFrameDiffPixelsPerVector && !vectorChanged(a, b, x); x += YeetFrameDiffPixelsPerVector) {}
+#endif
+  for (; x < end && !pixelChanged(a, b, x); x++) {}
+  return x;
+}
+
+// One past the last changed pixel in [begin, end), or begin.
+static int lastChangedPixel(const uint8_t *a, const uint8_t *b, int begin, int end) {
+  int x = end;
+#if CV_SIMD128
+  for (; x - YeetFrameDiffPixelsPerVector >= begin && !vectorChanged(a, b, x - YeetFrameDiffPixelsPerVector); x -= YeetFrameDiffPixelsPerVector) {}
+#endif
+  for (; x > begin && !pixelChanged(a, b, x - 1); x--) {}
+  return x;
+}
+
+YeetFrameRect yeetChangedRect(const uint8_t *previous, size_t previousBytesPerRow, const uint8_t *current, size_t currentBytesPerRow, int width, int height) {
+  YeetFrameRect rect;
+
+  auto rowChanged = [&](int y) {
+    return firstChangedPixel(previous + (size_t)y * previousBytesPerRow, current + (size_t)y * currentBytesPerRow, 0, width) < width;
+  };
+
+  int top = 0;
+  while (top < height && !rowChanged(top)) {
+    top++;
+  }
+  if (top == height) {
+    return rect;
+  }
+
+  int bottom = height;
+  while (bottom - 1 > top && !rowChanged(bottom - 1)) {
+    bottom--;
+  }
+
+  int left = width;
+  int right = 0;
+  for (int y = top; y < bottom && (left > 0 || right < width); y++) {
+    const uint8_t *a = previous + (size_t)y * previousBytesPerRow;
+    const uint8_t *b = current + (size_t)y * currentBytesPerRow;
+    left = firstChangedPixel(a, b, 0, left);
+    right = lastChangedPixel(a, b, std::max(right, left), width);
+  }
+
+  rect.x = left;
+  rect.y = top;
+  rect.width = right - left;
+  rect.height = bottom - top;
+  return rect;
+}
@@ -0,0 +1,33 @@
+//
+//  YeetFrameDiff.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/20/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+
+struct YeetFrameRect {
+  int x = 0;
+  int y = 0;
+  int width = 0;
+  int height = 0;
+
+  bool empty() const { return width <= 0 || height <= 0; }
+};
+
+// The smallest rect containing every pixel that differs between two RGBA frames of the same size.
+// Empty when the frames are identical.
+//
+// Scans down to the first changed row and up to the last one. Rows between them are only scanned
+// up to the left edge found so far and back to the right edge, so the inside of the changed region
+// is never compared. Pixels are compared 16 bytes at a time.
+YeetFrameRect yeetChangedRect(const uint8_t *previous, size_t previousBytesPerRow, const uint8_t *current, size_t currentBytesPerRow, int width, int height);
+
+#endif
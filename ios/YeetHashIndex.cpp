@@ -0,0 +1,283 @@
+//
+//  YeetHashIndex.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/14/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetHashIndex.h"
+#include "YeetPerceptualHash.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+// File layout: "YHIX", u32 version, then records of u64 hash, u32 id length, id bytes. Little endian,
+// which is every device we ship on.
+static const char YeetHashIndexMagic[4] = {'Y', 'H', 'I', 'X'};
+// Version 2: pHash leaves out the DC coefficient, so version 1 hashes are a different function.
+static const uint32_t YeetHashIndexVersion = 2;
+// Anything longer is a corrupt length field, not an id.
+static const uint32_t YeetHashIndexMaxIdLength = 4096;
+
+YeetHashIndex &YeetHashIndex::shared() {
+  static YeetHashIndex *index = new YeetHashIndex();
+  return *index;
+}
+
+YeetHashIndex::~YeetHashIndex() {
+  if (file_) {
+    fclose(file_);
+  }
+}
+
+bool YeetHashIndex::open(const std::string &path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_) {
+    fclose(file_);
+    file_ = nullptr;
+  }
+
+  FILE *file = fopen(path.c_str(), "r+b");
+  if (!file) {
+    file = fopen(path.c_str(), "w+b");
+  }
+  if (!file) {
+    return false;
+  }
+
+  char magic[4];
+  uint32_t version = 0;
+  const bool hasMagic = fread(magic, 1, sizeof(magic), file) == sizeof(magic);
+  if (hasMagic && memcmp(magic, YeetHashIndexMagic, sizeof(magic)) != 0) {
+    fclose(file);
+    return false;
+  }
+
+  const bool hasVersion = hasMagic && fread(&version, sizeof(version), 1, file) == 1;
+  if (hasVersion && version > YeetHashIndexVersion) {
+    fclose(file);
+    return false;
+  }
+
+  if (!hasVersion || version < YeetHashIndexVersion) {
+    // New (or torn before the header finished) file, or one whose hashes were computed differently
+    // and can't be compared with new ones. Assets are indexed again the next time they're hashed.
+    rewind(file);
+    if (fwrite(YeetHashIndexMagic, 1, sizeof(YeetHashIndexMagic), file) != sizeof(YeetHashIndexMagic) ||
+        fwrite(&YeetHashIndexVersion, sizeof(YeetHashIndexVersion), 1, file) != 1 ||
+        fflush(file) != 0) {
+      fclose(file);
+      return false;
+    }
+    ftruncate(fileno(file), ftell(file));
+    file_ = file;
+    return true;
+  }
+
+  long valid = ftell(file);
+  std::string id;
+  while (true) {
+    uint64_t hash;
+    uint32_t length;
+    if (fread(&hash, sizeof(hash), 1, file) != 1 ||
+        fread(&length, sizeof(length), 1, file) != 1 ||
+        length > YeetHashIndexMaxIdLength) {
+      break;
+    }
+
+    id.resize(length);
+    if (length > 0 && fread(&id[0], 1, length, file) != length) {
+      break;
+    }
+
+    insertLocked(hash, id);
+    valid = ftell(file);
+  }
+
+  // Drop a torn last record so appends start on a record boundary.
+  fflush(file);
+  ftruncate(fileno(file), valid);
+  fseek(file, valid, SEEK_SET);
+
+  if (entries_.size() < hashes_.size()) {
+    file = compact(file, path);
+  }
+
+  file_ = file;
+  return true;
+}
+
+// Rewrites the log with only the live records, then swaps it in with rename() so a crash leaves
+// either the old log or the new one. Returns the file to append to, which is the old one if the
+// rewrite fails.
+FILE *YeetHashIndex::compact(FILE *file, const std::string &path) {
+  const std::string temporaryPath = path + ".compact";
+  FILE *compacted = fopen(temporaryPath.c_str(), "w+b");
+  if (!compacted) {
+    return file;
+  }
+
+  std::swap(file_, compacted);
+  bool written = fwrite(YeetHashIndexMagic, 1, sizeof(YeetHashIndexMagic), file_) == sizeof(YeetHashIndexMagic) &&
+    fwrite(&YeetHashIndexVersion, sizeof(YeetHashIndexVersion), 1, file_) == 1;
+  for (size_t entry = 0; entry < hashes_.size() && written; entry++) {
+    if (live_[entry]) {
+      written = append(hashes_[entry], ids_[entry]);
+    }
+  }
+  std::swap(file_, compacted);
+
+  written = fflush(compacted) == 0 && written;
+  if (!written || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+    fclose(compacted);
+    unlink(temporaryPath.c_str());
+    return file;
+  }
+
+  fclose(file);
+  return compacted;
+}
+
+bool YeetHashIndex::insert(uint64_t hash, const std::string &id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!insertLocked(hash, id)) {
+    return false;
+  }
+
+  append(hash, id);
+  return true;
+}
+
+bool YeetHashIndex::append(uint64_t hash, const std::string &id) {
+  if (!file_ || id.size() > YeetHashIndexMaxIdLength) {
+    return false;
+  }
+
+  const uint32_t length = (uint32_t)id.size();
+  const bool written = fwrite(&hash, sizeof(hash), 1, file_) == 1 &&
+    fwrite(&length, sizeof(length), 1, file_) == 1 &&
+    fwrite(id.data(), 1, length, file_) == length;
+
+  return fflush(file_) == 0 && written;
+}
+
+static inline uint16_t yeetHashChunk(uint64_t hash, int chunk) {
+  return (uint16_t)(hash >> (chunk * 16));
+}
+
+bool YeetHashIndex::insertLocked(uint64_t hash, const std::string &id) {
+  const int32_t entry = (int32_t)hashes_.size();
+  auto existing = entries_.find(id);
+  if (existing != entries_.end()) {
+    if (hashes_[existing->second] == hash) {
+      return false;
+    }
+
+    live_[existing->second] = 0;
+    existing->second = entry;
+  } else {
+    entries_.emplace(id, entry);
+  }
+
+  hashes_.push_back(hash);
+  ids_.push_back(id);
+  live_.push_back(1);
+
+  for (int chunk = 0; chunk < chunkCount; chunk++) {
+    if (heads_[chunk].empty()) {
+      heads_[chunk].assign(1 << chunkBits, -1);
+    }
+
+    const uint16_t key = yeetHashChunk(hash, chunk);
+    next_[chunk].push_back(heads_[chunk][key]);
+    heads_[chunk][key] = entry;
+  }
+  return true;
+}
+
+void YeetHashIndex::linearQuery(uint64_t hash, int maxDistance, std::vector<YeetHashMatch> &matches) const {
+  for (size_t entry = 0; entry < hashes_.size(); entry++) {
+    if (!live_[entry]) {
+      continue;
+    }
+
+    const int distance = yeetHammingDistance(hash, hashes_[entry]);
+    if (distance <= maxDistance) {
+      YeetHashMatch match;
+      match.id = ids_[entry];
+      match.hash = hashes_[entry];
+      match.distance = distance;
+      matches.push_back(std::move(match));
+    }
+  }
+}
+
+void YeetHashIndex::query(uint64_t hash, int maxDistance, std::vector<YeetHashMatch> &matches) const {
+  matches.clear();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (hashes_.empty() || maxDistance < 0) {
+    return;
+  }
+
+  const int chunkRadius = maxDistance / chunkCount;
+  if (chunkRadius > 3) {
+    linearQuery(hash, maxDistance, matches);
+  } else {
+    // Every 16-bit key within chunkRadius of 0, to XOR with each of the query's chunks.
+    std::vector<uint16_t> flips;
+    flips.push_back(0);
+    for (int i = 0; i < chunkBits && chunkRadius >= 1; i++) {
+      flips.push_back((uint16_t)(1 << i));
+      for (int j = i + 1; j < chunkBits && chunkRadius >= 2; j++) {
+        flips.push_back((uint16_t)((1 << i) | (1 << j)));
+        for (int k = j + 1; k < chunkBits && chunkRadius >= 3; k++) {
+          flips.push_back((uint16_t)((1 << i) | (1 << j) | (1 << k)));
+        }
+      }
+    }
+
+    for (int chunk = 0; chunk < chunkCount; chunk++) {
+      const uint16_t key = yeetHashChunk(hash, chunk);
+
+      for (uint16_t flip : flips) {
+        for (int32_t entry = heads_[chunk][key ^ flip]; entry >= 0; entry = next_[chunk][entry]) {
+          if (!live_[entry]) {
+            continue;
+          }
+
+          const uint64_t candidate = hashes_[entry];
+
+          // An entry close enough in an earlier chunk was already seen in that chunk's table.
+          bool seen = false;
+          for (int earlier = 0; earlier < chunk && !seen; earlier++) {
+            seen = __builtin_popcount(yeetHashChunk(candidate ^ hash, earlier)) <= chunkRadius;
+          }
+          if (seen) {
+            continue;
+          }
+
+          const int distance = yeetHammingDistance(hash, candidate);
+          if (distance <= maxDistance) {
+            YeetHashMatch match;
+            match.id = ids_[entry];
+            match.hash = candidate;
+            match.distance = distance;
+            matches.push_back(std::move(match));
+          }
+        }
+      }
+    }
+  }
+
+  std::sort(matches.begin(), matches.end(), [](const YeetHashMatch &a, const YeetHashMatch &b) {
+    return a.distance < b.distance || (a.distance == b.distance && a.id < b.id);
+  });
+}
+
+size_t YeetHashIndex::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
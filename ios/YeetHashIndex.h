@@ -0,0 +1,88 @@
+//
+//  YeetHashIndex.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/14/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct YeetHashMatch {
+  std::string id;
+  uint64_t hash = 0;
+  int distance = 0;
+};
+
+// Perceptual hashes searchable by Hamming distance, with multi-index hashing.
+//
+// Each hash is split into four 16-bit chunks, and each chunk has its own table. If two hashes are
+// within r bits, at least one of their chunks is within r / 4 bits (pigeonhole), so a query only
+// probes the keys within r / 4 of each of its chunks: 1 key per table at r < 4, 17 at r < 8, 137 at
+// r < 12, 697 at r < 16. Past that, a linear popcount scan is cheaper and is used instead.
+//
+// Each id has at most one hash. Inserting a new hash for an id replaces the old entry, which stays
+// in the tables as a dead entry that queries skip.
+//
+// open() makes the index persistent: the file is an append-only log of (hash, id) records, replayed
+// on open and appended to on every insert. Later records for an id replace earlier ones, and open()
+// rewrites the log without the replaced records. A record torn by a crash is dropped and truncated
+// away, and a log from an older hash version is emptied.
+//
+// Thread-safe.
+class YeetHashIndex {
+public:
+  static YeetHashIndex &shared();
+
+  YeetHashIndex() {}
+  ~YeetHashIndex();
+  YeetHashIndex(const YeetHashIndex &) = delete;
+  YeetHashIndex &operator=(const YeetHashIndex &) = delete;
+
+  // Loads the log at path (creating it if needed) into the index and appends future inserts to it.
+  // Returns false if the file can't be opened or isn't an index; the index stays in memory only.
+  bool open(const std::string &path);
+
+  // Indexes id under hash, replacing the hash id had before. Returns false if id already has this hash.
+  bool insert(uint64_t hash, const std::string &id);
+
+  // Every entry within maxDistance of hash, closest first.
+  void query(uint64_t hash, int maxDistance, std::vector<YeetHashMatch> &matches) const;
+
+  // Live entries, one per id.
+  size_t size() const;
+
+private:
+  static const int chunkCount = 4;
+  static const int chunkBits = 16;
+
+  void linearQuery(uint64_t hash, int maxDistance, std::vector<YeetHashMatch> &matches) const;
+
+  bool insertLocked(uint64_t hash, const std::string &id);
+  bool append(uint64_t hash, const std::string &id);
+  FILE *compact(FILE *file, const std::string &path);
+
+  mutable std::mutex mutex_;
+  std::vector<uint64_t> hashes_;
+  std::vector<std::string> ids_;
+  // 0 once a newer hash replaced the entry.
+  std::vector<uint8_t> live_;
+  // The live entry for each id.
+  std::unordered_map<std::string, int32_t> entries_;
+  // Per chunk: the newest entry whose chunk has each value, and each entry's next older one.
+  // Linked lists in flat arrays keep the tables at a fixed 1MB however many entries there are.
+  std::vector<int32_t> heads_[chunkCount];
+  std::vector<int32_t> next_[chunkCount];
+  FILE *file_ = nullptr;
+};
+
+#endif
@@ -440,7 +440,7 @@ class YeetImageView : PINAnimatedImageView {
   }
   func loadFileImage(async: Bool = true) throws {
     if async {
-      DispatchQueue.global(qos: .userInitiated).async {
+      YeetTaskQueue.schedule(.interactive) {
         do {
           try self._loadFileImage(async: async)
         } catch {
@@ -0,0 +1,91 @@
+//
+//  YeetJSIMethodTable.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/22/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <jsi/jsi.h>
+#include <vector>
+#include "YeetJSIStruct.h"
+
+using namespace facebook;
+
+// The property names a HostObject answers in get(), and the host functions it created for them.
+//
+// Finding a name is a PropNameID::compare per entry instead of converting it to UTF-8 and comparing
+// strings, and each method's jsi::Function is only created the first time it's read. The names and
+// functions belong to the runtime they were created in, so clear() has to run before it goes away.
+class YeetJSIMethodTable {
+public:
+  template <size_t Count>
+  explicit YeetJSIMethodTable(const char *const (&names)[Count]) : names_(names), count_(Count) {}
+
+  size_t size() const { return count_; }
+  const char *name(size_t index) const { return names_[index]; }
+
+  // The index of name, or -1 if the table doesn't have it.
+  int indexOf(jsi::Runtime &runtime, YeetJSIPropNameCache &propNames, const jsi::PropNameID &name) {
+    if (interned_.empty()) {
+      interned_.reserve(count_);
+      for (size_t index = 0; index < count_; index++) {
+        interned_.push_back(jsi::PropNameID(runtime, propNames.get(runtime, names_[index])));
+      }
+      functions_.resize(count_);
+    }
+
+    for (size_t index = 0; index < count_; index++) {
+      if (jsi::PropNameID::compare(runtime, name, interned_[index])) {
+        return (int)index;
+      }
+    }
+
+    return -1;
+  }
+
+  // Returns the cached function for index, or calls create(). Functions are cached; anything else
+  // (a getter like photosAuthorizationStatus) is created again on every read.
+  template <typename Create>
+  jsi::Value get(jsi::Runtime &runtime, size_t index, Create &&create) {
+    jsi::Value &cached = functions_[index];
+    if (!cached.isUndefined()) {
+      return jsi::Value(runtime, cached);
+    }
+
+    jsi::Value value = create();
+    if (value.isObject() && value.getObject(runtime).isFunction(runtime)) {
+      cached = jsi::Value(runtime, value);
+    }
+
+    return value;
+  }
+
+  std::vector<jsi::PropNameID> propertyNames(jsi::Runtime &runtime, YeetJSIPropNameCache &propNames) const {
+    std::vector<jsi::PropNameID> names;
+    names.reserve(count_);
+    for (size_t index = 0; index < count_; index++) {
+      names.push_back(jsi::PropNameID(runtime, propNames.get(runtime, names_[index])));
+    }
+
+    return names;
+  }
+
+  void clear() {
+    functions_.clear();
+    interned_.clear();
+  }
+
+private:
+  const char *const *names_;
+  size_t count_;
+  // Parallel to names_. Empty until the first lookup.
+  std::vector<jsi::PropNameID> interned_;
+  std::vector<jsi::Value> functions_;
+};
+
+#endif
@@ -8,14 +8,19 @@
 
 #import <jsi/jsi.h>
 #include <ReactCommon/BridgeJSCallInvoker.h>
+#include <vector>
+#import "YeetStorage.h"
+#import "YeetJSIModuleRegistry.h"
+#include "YeetJSIMethodTable.h"
 
 using namespace facebook;
 
 @class RCTCxxBridge;
+@class YeetLayoutSnapshotObserver;
 
-class JSI_EXPORT YeetJSIModule : public jsi::HostObject {
+class JSI_EXPORT YeetJSIModule : public YeetJSIHostObject {
 public:
-    YeetJSIModule(RCTCxxBridge* bridge);
+    YeetJSIModule(RCTCxxBridge* bridge, std::shared_ptr<facebook::react::JSCallInvoker> jsInvoker, std::shared_ptr<YeetJSIPropNameCache> propNames);
 
     static void install(RCTCxxBridge *bridge);
 
@@ -23,10 +28,18 @@ public:
      * `jsi::HostObject` specific overloads.
      */
     jsi::Value get(jsi::Runtime &runtime, const jsi::PropNameID &name) override;
+    std::vector<jsi::PropNameID> getPropertyNames(jsi::Runtime &runtime) override;
 
-    
+    void invalidate() override;
 
 private:
+    jsi::Value createMethod(jsi::Runtime &runtime, const jsi::PropNameID &name, const std::string &methodName);
+    YeetLayoutSnapshotObserver *layoutSnapshotObserver();
+
     RCTCxxBridge* bridge_;
     std::shared_ptr<facebook::react::JSCallInvoker> _jsInvoker;
+    std::shared_ptr<YeetStorage> storage_;
+    YeetLayoutSnapshotObserver *layoutObserver_;
+    YeetJSIMethodTable methods_;
+    std::shared_ptr<YeetJSIPropNameCache> propNames_;
 };
@@ -11,36 +11,93 @@
 #import "YeetJSIUTils.h"
 #import "RCTConvert+PHotos.h"
 #import <MMKV/MMKV.h>
+#import "YeetStorage.h"
 #import "YeetSplashScreen.h"
 #import <React/RCTShadowView.h>
+#import "YeetLayoutMeasurement.h"
+#import "YeetLayoutSnapshotObserver.h"
 #import "PanViewManager.h"
 #import "EnableWebpDecoder.h"
 #import <React/RCTUIManagerUtils.h>
 
 
-
-YeetJSIModule::YeetJSIModule(RCTCxxBridge *bridge)
-: bridge_(bridge) {
-  std::shared_ptr<facebook::react::JSCallInvoker> _jsInvoker = std::make_shared<react::BridgeJSCallInvoker>(bridge.reactInstance);
+static const char *const YeetJSIModulePropertyNames[] = {
+  "photosAuthorizationStatus",
+  "scrollViewMetrics",
+  "triggerScrollEvent",
+  "removeItem",
+  "getItem",
+  "setItem",
+  "multiGet",
+  "multiSet",
+  "hideSplashScreen",
+  "hapticFeedback",
+  "focusedTextInputTag",
+  "focus",
+  "blur",
+  "transitionPanView",
+  "measureRelativeTo",
+  "measureRelativeToSync",
+  "stopMeasuringRelativeTo",
+};
+
+YeetJSIModule::YeetJSIModule(RCTCxxBridge *bridge, std::shared_ptr<facebook::react::JSCallInvoker> jsInvoker, std::shared_ptr<YeetJSIPropNameCache> propNames)
+: bridge_(bridge), _jsInvoker(jsInvoker), storage_(std::make_shared<YeetStorage>([MMKV defaultMMKV])), methods_(YeetJSIModulePropertyNames), propNames_(propNames) {
 }
 
 
 void YeetJSIModule::install(RCTCxxBridge *bridge) {
-  if (bridge.runtime == nullptr) {
+  auto registry = YeetJSIModuleRegistry::forBridge(bridge);
+  if (registry == nullptr) {
     return;
   }
 
- jsi::Runtime &runtime = *(jsi::Runtime *)bridge.runtime;
+  registry->install("YeetJSI", std::make_shared<YeetJSIModule>(bridge, registry->jsInvoker(), registry->propNames()));
+}
+
+void YeetJSIModule::invalidate() {
+  methods_.clear();
+  propNames_ = nullptr;
+  _jsInvoker = nullptr;
 
- auto reaModuleName = "YeetJSI";
- auto reaJsiModule = std::make_shared<YeetJSIModule>(std::move(bridge));
- auto object = jsi::Object::createFromHostObject(runtime, reaJsiModule);
- runtime.global().setProperty(runtime, reaModuleName, std::move(object));
+  [layoutObserver_ invalidate];
+  layoutObserver_ = nil;
+  bridge_ = nil;
 }
 
 jsi::Value YeetJSIModule::get(jsi::Runtime &runtime, const jsi::PropNameID &name) {
-  auto methodName = name.utf8(runtime);
+  if (_jsInvoker == nullptr || propNames_ == nullptr) {
+    return jsi::Value::undefined();
+  }
+
+  int index = methods_.indexOf(runtime, *propNames_, name);
+  if (index < 0) {
+    return jsi::Value::undefined();
+  }
+
+  // The HostObject is installed once per runtime, so the functions are cached for its lifetime.
+  return methods_.get(runtime, index, [&]() {
+    return createMethod(runtime, name, methods_.name(index));
+  });
+}
+
+std::vector<jsi::PropNameID> YeetJSIModule::getPropertyNames(jsi::Runtime &runtime) {
+  if (propNames_ == nullptr) {
+    return {};
+  }
 
+  return methods_.propertyNames(runtime, *propNames_);
+}
+
+YeetLayoutSnapshotObserver *YeetJSIModule::layoutSnapshotObserver() {
+  if (layoutObserver_ == nil) {
+    layoutObserver_ = [[YeetLayoutSnapshotObserver alloc] initWithUIManager:bridge_.uiManager];
+  }
+
+  return layoutObserver_;
+}
+
+jsi::Value YeetJSIModule::createMethod(jsi::Runtime &runtime, const jsi::PropNameID &name, const std::string &methodName) {
   RCTCxxBridge* _bridge = bridge_;
   std::shared_ptr<facebook::react::JSCallInvoker> jsInvoker = _jsInvoker;
 
@@ -110,97 +167,58 @@ jsi::Value YeetJSIModule::get(jsi::Runtime &runtime, const jsi::PropNameID &name
        return jsi::Value(true);
    });
   } else if (methodName == "removeItem") {
-    MMKV *mmkv = [MMKV defaultMMKV];
-    return jsi::Function::createFromHostFunction(runtime, name, 1, [mmkv](
+    std::shared_ptr<YeetStorage> storage = storage_;
+    return jsi::Function::createFromHostFunction(runtime, name, 1, [storage](
           jsi::Runtime &runtime,
           const jsi::Value &thisValue,
           const jsi::Value *arguments,
           size_t count) -> jsi::Value {
 
-
-      NSString *key = convertJSIStringToNSString(runtime, arguments[0].asString(runtime));
-
-      if (key && key.length > 0) {
-        [mmkv removeValueForKey:key];
-        return jsi::Value(true);
-      } else {
-        return jsi::Value(false);
-      }
+      return jsi::Value(storage->removeItem(runtime, arguments[0].asString(runtime)));
     });
   } else if (methodName == "getItem") {
-    MMKV *mmkv = [MMKV defaultMMKV];
-    return jsi::Function::createFromHostFunction(runtime, name, 2, [mmkv](
+    std::shared_ptr<YeetStorage> storage = storage_;
+    return jsi::Function::createFromHostFunction(runtime, name, 2, [storage](
           jsi::Runtime &runtime,
           const jsi::Value &thisValue,
           const jsi::Value *arguments,
           size_t count) -> jsi::Value {
 
-      NSString *type =  convertJSIStringToNSString(runtime, arguments[1].asString(runtime));
-      NSString *key =   convertJSIStringToNSString(runtime, arguments[0].asString(runtime));
-
-      if (!key || ![key length]) {
-        return jsi::Value::null();
-      }
-
-      if ([type isEqualToString:@"string"]) {
-        NSString *value = [mmkv getStringForKey:key];
-
-        if (value) {
-          return convertNSStringToJSIString(runtime, value);
-        } else {
-          return jsi::Value::null();
-        }
-      } else if ([type isEqualToString:@"number"]) {
-        double value = [mmkv getDoubleForKey:key];
-
-        if (value) {
-          return jsi::Value(value);
-        } else {
-          return jsi::Value::null();
-        }
-      } else if ([type isEqualToString:@"bool"]) {
-        BOOL value = [mmkv getBoolForKey:key defaultValue:NO];
-
-        return jsi::Value(value == YES ? 1 : 0);
-      } else {
-        return jsi::Value::null();
-      }
+      YeetStorageType type = YeetStorage::typeFromValue(runtime, arguments[1]);
+      return storage->getItem(runtime, arguments[0].asString(runtime), type);
     });
   } else if (methodName == "setItem") {
-    MMKV *mmkv = [MMKV defaultMMKV];
-    return jsi::Function::createFromHostFunction(runtime, name, 3, [mmkv](
+    std::shared_ptr<YeetStorage> storage = storage_;
+    return jsi::Function::createFromHostFunction(runtime, name, 3, [storage](
              jsi::Runtime &runtime,
              const jsi::Value &thisValue,
              const jsi::Value *arguments,
              size_t count) -> jsi::Value {
-      NSString *type =  convertJSIStringToNSString(runtime, arguments[2].asString(runtime));
-      NSString *key =   convertJSIStringToNSString(runtime, arguments[0].asString(runtime));
-
-      if (!key || ![key length]) {
-        return jsi::Value::null();
-      }
-
-      if ([type isEqualToString:@"string"]) {
-        NSString *value = convertJSIStringToNSString(runtime, arguments[1].asString(runtime));
 
-        if ([value length] > 0) {
-          return jsi::Value([mmkv setString:value forKey:key]);
-        } else {
-          return jsi::Value(false);
-        }
-      } else if ([type isEqualToString:@"number"]) {
-        double value = arguments[2].asNumber();
+      YeetStorageType type = YeetStorage::typeFromValue(runtime, arguments[2]);
+      return jsi::Value(storage->setItem(runtime, arguments[0].asString(runtime), arguments[1], type));
+    });
 
-        return jsi::Value([mmkv setDouble:value forKey:key]);
-      } else if ([type isEqualToString:@"bool"]) {
-        BOOL value = arguments[2].asNumber();
+  } else if (methodName == "multiGet") {
+    std::shared_ptr<YeetStorage> storage = storage_;
+    return jsi::Function::createFromHostFunction(runtime, name, 2, [storage](
+          jsi::Runtime &runtime,
+          const jsi::Value &thisValue,
+          const jsi::Value *arguments,
+          size_t count) -> jsi::Value {
 
-        return jsi::Value([mmkv setBool:value forKey:key]);
-      } else {
-        return jsi::Value::null();
-      }
+      return storage->multiGet(runtime, arguments[0].asObject(runtime).asArray(runtime), arguments[1]);
     });
+  } else if (methodName == "multiSet") {
+    std::shared_ptr<YeetStorage> storage = storage_;
+    return jsi::Function::createFromHostFunction(runtime, name, 1, [storage](
+          jsi::Runtime &runtime,
+          const jsi::Value &thisValue,
+          const jsi::Value *arguments,
+          size_t count) -> jsi::Value {
 
+      return jsi::Value(storage->multiSet(runtime, arguments[0].asObject(runtime).asArray(runtime)));
+    });
   } else if (methodName == "hideSplashScreen") {
     return jsi::Function::createFromHostFunction(runtime, name, 0, [](
              jsi::Runtime &runtime,
@@ -306,56 +324,95 @@ jsi::Value YeetJSIModule::get(jsi::Runtime &runtime, const jsi::PropNameID &name
              size_t count) -> jsi::Value {
 
       __block NSNumber *containerTag = @(arguments[0].asNumber());
-      __block NSArray<NSNumber*> *blocks = convertJSIArrayToNSArray(runtime, arguments[1].getObject(runtime).getArray(runtime), jsInvoker);
-
-      __block RCTResponseSenderBlock callback = convertJSIFunctionToCallback(runtime, arguments[2].asObject(runtime).getFunction(runtime), jsInvoker);
 
+      jsi::Array blockTags = arguments[1].getObject(runtime).getArray(runtime);
+      size_t blockCount = blockTags.size(runtime);
+      std::vector<double> tags;
+      tags.reserve(blockCount);
+      for (size_t i = 0; i < blockCount; i++) {
+        tags.push_back(blockTags.getValueAtIndex(runtime, i).asNumber());
+      }
 
-      __block RCTBridge *bridge = rctBridge;
+      // Measurements come back as one flat [x, y, width, height, ...] array, parallel to blocks.
+      // Blocks that can't be measured are NaN so the indices still line up.
+      std::shared_ptr<react::CallbackWrapper> callback = std::make_shared<react::CallbackWrapper>(arguments[2].getObject(runtime).getFunction(runtime), runtime, jsInvoker);
 
       RCTExecuteOnUIManagerQueue(^{
-       
-
-        __block NSMutableArray *measurements = [[NSMutableArray alloc] initWithCapacity: blocks.count];
+        auto measurements = std::make_shared<std::vector<double>>(tags.size() * YeetLayoutFrameStride);
+        double *frame = measurements->data();
 
         RCTShadowView *containerView = [rctBridge.uiManager shadowViewForReactTag:containerTag];
 
-        if (!containerView) {
-          __block NSDictionary *result = @{ @"measurements": measurements};
-          [rctBridge dispatchBlock:^{
-            callback(@[NSNull.null, result]);
-            [measurements removeAllObjects];
-                            measurements = nil;
-            result = nil;
-           } queue:RCTJSThread];
-          return;
-        }
+        for (double tag : tags) {
+          RCTShadowView *block = containerView ? [rctBridge.uiManager shadowViewForReactTag:@(tag)] : nil;
 
-        RCTShadowView *block;
-        for (NSNumber *blockTag in blocks) {
-          block = [rctBridge.uiManager shadowViewForReactTag:blockTag];
-          if (block != nil) {
+          if (block == nil) {
+            clearLayoutFrame(frame);
+          } else if (!measureYogaNodeRelativeTo(block.yogaNode, containerView.yogaNode, frame)) {
+            // Virtual shadow views (e.g. inside text) aren't in the Yoga tree, so walk the shadow views instead.
             CGRect rect = [block measureLayoutRelativeToAncestor:containerView];
-            [measurements addObject:@{ @"x": @(rect.origin.x) ,@"y": @(rect.origin.y), @"width": @(rect.size.width), @"height": @(rect.size.height) }];
+
+            if (CGRectIsNull(rect)) {
+              clearLayoutFrame(frame);
+            } else {
+              frame[0] = rect.origin.x;
+              frame[1] = rect.origin.y;
+              frame[2] = rect.size.width;
+              frame[3] = rect.size.height;
+            }
           }
 
+          frame += YeetLayoutFrameStride;
         }
 
-        containerView = nil;
-        block = nil;
+        [rctBridge dispatchBlock:^{
+          jsi::Runtime &rt = callback->runtime();
+          callback->callback().call(rt, jsi::Value::null(), convertDoubleVectorToJSIArray(rt, *measurements));
+        } queue:RCTJSThread];
+      });
+      return jsi::Value::null();
+    });
+  } else if (methodName == "measureRelativeToSync") {
+    YeetLayoutSnapshotObserver *layoutObserver = layoutSnapshotObserver();
+    std::shared_ptr<YeetLayoutSnapshot> snapshot = layoutObserver.snapshot;
 
-        __block NSDictionary *result = @{ @"measurements": [[NSArray alloc] initWithArray:measurements copyItems:YES]};
-        [measurements removeAllObjects];
-         measurements = nil;
+    return jsi::Function::createFromHostFunction(runtime, name, 2, [layoutObserver, snapshot](
+             jsi::Runtime &runtime,
+             const jsi::Value &thisValue,
+             const jsi::Value *arguments,
+             size_t count) -> jsi::Value {
 
-        [bridge dispatchBlock:^{
+      int containerTag = (int)arguments[0].asNumber();
 
-          callback(@[NSNull.null, result]);
-         result = nil;
+      jsi::Array blockTags = arguments[1].getObject(runtime).getArray(runtime);
+      size_t blockCount = blockTags.size(runtime);
+      std::vector<int> tags;
+      tags.reserve(blockCount);
+      for (size_t i = 0; i < blockCount; i++) {
+        tags.push_back((int)blockTags.getValueAtIndex(runtime, i).asNumber());
+      }
 
-        } queue:RCTJSThread];
-      });
-      return jsi::Value::null();
+      // Same packed format as measureRelativeTo, read from the last layout pass.
+      // The first call for a container starts snapshotting it and returns null.
+      std::vector<double> measurements(tags.size() * YeetLayoutFrameStride);
+      if (!snapshot->read(containerTag, tags, measurements.data())) {
+        [layoutObserver watchContainer:@(containerTag)];
+        return jsi::Value::null();
+      }
+
+      return convertDoubleVectorToJSIArray(runtime, measurements);
+    });
+  } else if (methodName == "stopMeasuringRelativeTo") {
+    YeetLayoutSnapshotObserver *layoutObserver = layoutSnapshotObserver();
+
+    return jsi::Function::createFromHostFunction(runtime, name, 1, [layoutObserver](
+             jsi::Runtime &runtime,
+             const jsi::Value &thisValue,
+             const jsi::Value *arguments,
+             size_t count) -> jsi::Value {
+
+      [layoutObserver unwatchContainer:@(arguments[0].asNumber())];
+      return jsi::Value::undefined();
     });
   }
 
@@ -0,0 +1,64 @@
+//
+//  YeetJSIModuleRegistry.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/2/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <jsi/jsi.h>
+#include <ReactCommon/BridgeJSCallInvoker.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#import "YeetJSIStruct.h"
+
+#ifdef __cplusplus
+
+using namespace facebook;
+
+@class RCTBridge;
+@class RCTCxxBridge;
+
+// A HostObject the registry can tear down before its runtime goes away.
+// invalidate() runs on the JS thread and should drop every jsi::Value/jsi::Function the module holds.
+class JSI_EXPORT YeetJSIHostObject : public jsi::HostObject {
+public:
+    virtual void invalidate() {}
+};
+
+// One per RCTCxxBridge. Owns the JSCallInvoker and the interned property names shared by
+// YeetJSI, MediaPlayerViewManager and Clipboard, and tears them all down when the bridge reloads
+// or is invalidated.
+class YeetJSIModuleRegistry {
+public:
+    // Returns nullptr if the bridge doesn't have a runtime yet, or is being torn down.
+    static std::shared_ptr<YeetJSIModuleRegistry> forBridge(RCTBridge *bridge);
+
+    YeetJSIModuleRegistry(RCTCxxBridge *bridge, jsi::Runtime &runtime);
+    ~YeetJSIModuleRegistry();
+
+    // Sets global[name] to the module. Installing the same name again replaces the old module.
+    void install(const char *name, std::shared_ptr<YeetJSIHostObject> module);
+
+    // Must run on the JS thread, before the runtime is destroyed.
+    void invalidate();
+
+    std::shared_ptr<react::JSCallInvoker> jsInvoker() const { return jsInvoker_; }
+    std::shared_ptr<YeetJSIPropNameCache> propNames() const { return propNames_; }
+
+private:
+    __weak RCTCxxBridge *bridge_;
+    jsi::Runtime &runtime_;
+    std::shared_ptr<react::JSCallInvoker> jsInvoker_;
+    std::shared_ptr<YeetJSIPropNameCache> propNames_;
+    void removeObservers();
+
+    std::unordered_map<std::string, std::shared_ptr<YeetJSIHostObject>> modules_;
+    NSArray *observers_;
+    bool invalidated_ = false;
+};
+
+#endif
@@ -0,0 +1,140 @@
+//
+//  YeetJSIModuleRegistry.mm
+//  yeet
+//
+//  Created by Jarred WSumner on 3/2/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#import "YeetJSIModuleRegistry.h"
+#import <React/RCTBridge+Private.h>
+#import <objc/runtime.h>
+#include <ReactCommon/LongLivedObject.h>
+
+@interface RCTBridge (ext)
+- (std::weak_ptr<facebook::react::Instance>)reactInstance;
+@end
+
+// Hangs the registry off the RCTCxxBridge it belongs to. Every reload creates a new RCTCxxBridge
+// and runtime, so a registry can't be handed to a later bridge the way a reused address could be.
+@interface YeetJSIModuleRegistryHolder : NSObject {
+@public
+  std::shared_ptr<YeetJSIModuleRegistry> registry;
+}
+@end
+
+@implementation YeetJSIModuleRegistryHolder
+@end
+
+static char YeetJSIModuleRegistryKey;
+static std::mutex registriesMutex;
+
+std::shared_ptr<YeetJSIModuleRegistry> YeetJSIModuleRegistry::forBridge(RCTBridge *bridge) {
+  RCTCxxBridge *cxxBridge = (RCTCxxBridge *)bridge;
+  if (cxxBridge.runtime == nullptr || !cxxBridge.isValid) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(registriesMutex);
+  YeetJSIModuleRegistryHolder *holder = objc_getAssociatedObject(cxxBridge, &YeetJSIModuleRegistryKey);
+  if (holder != nil) {
+    return holder->registry->invalidated_ ? nullptr : holder->registry;
+  }
+
+  auto registry = std::make_shared<YeetJSIModuleRegistry>(cxxBridge, *(jsi::Runtime *)cxxBridge.runtime);
+  holder = [YeetJSIModuleRegistryHolder new];
+  holder->registry = registry;
+  objc_setAssociatedObject(cxxBridge, &YeetJSIModuleRegistryKey, holder, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+
+  // Modules hold jsi::Values (cached functions, callbacks, PropNameIDs) which have to be released
+  // while the runtime is still alive.
+  // - On reload, the notification is posted on the main thread and the bridge tears the runtime
+  //   down on the JS thread afterwards, so a block queued there runs first.
+  // - When the bridge is invalidated without a reload, the will-invalidate notification is posted
+  //   on the JS thread right before the runtime is reset, so the block runs immediately.
+  std::weak_ptr<YeetJSIModuleRegistry> weakRegistry = registry;
+  __weak RCTCxxBridge *weakBridge = cxxBridge;
+  void (^invalidateRegistry)(NSNotification *) = ^(NSNotification * _Nonnull note) {
+    RCTCxxBridge *strongBridge = weakBridge;
+    if (strongBridge == nil) {
+      return;
+    }
+
+    if (note.object != strongBridge && note.object != strongBridge.parentBridge && note.userInfo[@"bridge"] != strongBridge) {
+      return;
+    }
+
+    // Runs the block inline when already on the JS thread.
+    [strongBridge dispatchBlock:^{
+      auto strongRegistry = weakRegistry.lock();
+      if (strongRegistry != nullptr) {
+        strongRegistry->invalidate();
+      }
+    } queue:RCTJSThread];
+  };
+
+  NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+  registry->observers_ = @[
+    [center addObserverForName:RCTBridgeWillReloadNotification object:nil queue:nil usingBlock:invalidateRegistry],
+    [center addObserverForName:RCTBridgeWillInvalidateModulesNotification object:nil queue:nil usingBlock:invalidateRegistry],
+  ];
+
+  return registry;
+}
+
+YeetJSIModuleRegistry::YeetJSIModuleRegistry(RCTCxxBridge *bridge, jsi::Runtime &runtime)
+: bridge_(bridge),
+  runtime_(runtime),
+  jsInvoker_(std::make_shared<react::BridgeJSCallInvoker>(bridge.reactInstance)),
+  propNames_(std::make_shared<YeetJSIPropNameCache>()) {
+}
+
+YeetJSIModuleRegistry::~YeetJSIModuleRegistry() {
+  removeObservers();
+}
+
+void YeetJSIModuleRegistry::removeObservers() {
+  for (id observer in observers_) {
+    [[NSNotificationCenter defaultCenter] removeObserver:observer];
+  }
+  observers_ = nil;
+}
+
+void YeetJSIModuleRegistry::install(const char *name, std::shared_ptr<YeetJSIHostObject> module) {
+  if (invalidated_) {
+    return;
+  }
+
+  auto previous = modules_.find(name);
+  if (previous != modules_.end()) {
+    previous->second->invalidate();
+  }
+
+  modules_[name] = module;
+  runtime_.global().setProperty(runtime_, name, jsi::Object::createFromHostObject(runtime_, module));
+}
+
+void YeetJSIModuleRegistry::invalidate() {
+  {
+    std::lock_guard<std::mutex> lock(registriesMutex);
+    if (invalidated_) {
+      return;
+    }
+
+    invalidated_ = true;
+  }
+
+  for (auto &module : modules_) {
+    module.second->invalidate();
+  }
+
+  modules_.clear();
+  propNames_->clear();
+  jsInvoker_ = nullptr;
+
+  // Pending PromiseWrappers and NativePromises hold JS functions from this runtime. Nothing else
+  // clears the collection when the bridge goes away, since the app doesn't use the TurboModule manager.
+  react::LongLivedObjectCollection::get().clear();
+
+  removeObservers();
+}
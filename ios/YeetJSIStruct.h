@@ -0,0 +1,158 @@
+//
+//  YeetJSIStruct.h
+//  yeet
+//
+//  Created by Jarred WSumner on 2/28/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <jsi/jsi.h>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+using namespace facebook;
+
+// Decodes a jsi::Object straight into a plain C++ struct.
+//
+// Instead of convertJSIObjectToNSDictionary (getPropertyNames + an NSString per key) and RCTConvert,
+// a struct declares its fields once:
+//
+//   struct Bounds { double x = 0; double y = 0; };
+//   template <> struct YeetJSIStructFields<Bounds> {
+//     static auto fields() { return std::make_tuple(jsiField("x", &Bounds::x), jsiField("y", &Bounds::y)); }
+//   };
+//
+// and decodeJSIStruct does exactly one getProperty per declared field. Missing or mistyped fields keep
+// the struct's default value.
+
+template <typename Struct, typename Member>
+struct YeetJSIField {
+  const char *name;
+  Member Struct::*member;
+};
+
+template <typename Struct, typename Member>
+constexpr YeetJSIField<Struct, Member> jsiField(const char *name, Member Struct::*member) {
+  return { name, member };
+}
+
+// Specialize with `static auto fields()` returning a std::tuple of jsiField()s.
+template <typename Struct>
+struct YeetJSIStructFields {};
+
+// Specialize with `static bool fromString(const std::string &value, Enum &out)` for string-backed enums.
+template <typename Enum>
+struct YeetJSIEnum {};
+
+// For fields where null/undefined means something different from the default value.
+template <typename T>
+struct YeetJSINullable {
+  bool isNull = true;
+  T value;
+};
+
+// PropNameIDs are created once per field name and reused on every decode.
+// Field names are string literals, so the pointer is a stable key.
+// Owned by the module that decodes, so it goes away with the runtime.
+class YeetJSIPropNameCache {
+public:
+  const jsi::PropNameID &get(jsi::Runtime &runtime, const char *name) {
+    auto cached = names_.find(name);
+    if (cached == names_.end()) {
+      cached = names_.emplace(name, jsi::PropNameID::forAscii(runtime, name)).first;
+    }
+
+    return cached->second;
+  }
+
+  // PropNameIDs belong to a runtime, so this has to run before it's destroyed.
+  void clear() {
+    names_.clear();
+  }
+
+private:
+  std::unordered_map<const char *, jsi::PropNameID> names_;
+};
+
+inline void decodeJSIValue(jsi::Runtime &runtime, YeetJSIPropNameCache &names, const jsi::Value &value, double &out) {
+  if (value.isNumber()) {
+    out = value.getNumber();
+  }
+}
+
+inline void decodeJSIValue(jsi::Runtime &runtime, YeetJSIPropNameCache &names, const jsi::Value &value, long &out) {
+  if (value.isNumber()) {
+    out = (long)value.getNumber();
+  }
+}
+
+inline void decodeJSIValue(jsi::Runtime &runtime, YeetJSIPropNameCache &names, const jsi::Value &value, bool &out) {
+  if (value.isBool()) {
+    out = value.getBool();
+  } else if (value.isNumber()) {
+    out = value.getNumber() != 0;
+  }
+}
+
+inline void decodeJSIValue(jsi::Runtime &runtime, YeetJSIPropNameCache &names, const jsi::Value &value, std::string &out) {
+  if (value.isString()) {
+    out = value.getString(runtime).utf8(runtime);
+  }
+}
+
+template <typename Enum>
+auto decodeJSIValue(jsi::Runtime &runtime, YeetJSIPropNameCache &names, const jsi::Value &value, Enum &out)
+  -> decltype(YeetJSIEnum<Enum>::fromString(std::string(), out), void()) {
+  if (value.isString()) {
+    YeetJSIEnum<Enum>::fromString(value.getString(runtime).utf8(runtime), out);
+  }
+}
+
+template <typename T>
+void decodeJSIValue(jsi::Runtime &runtime, YeetJSIPropNameCache &names, const jsi::Value &value, YeetJSINullable<T> &out) {
+  out.isNull = value.isNull() || value.isUndefined();
+  if (!out.isNull) {
+    decodeJSIValue(runtime, names, value, out.value);
+  }
+}
+
+template <typename Struct>
+auto decodeJSIValue(jsi::Runtime &runtime, YeetJSIPropNameCache &names, const jsi::Value &value, Struct &out)
+  -> decltype(YeetJSIStructFields<Struct>::fields(), void());
+
+template <typename Struct, typename Member>
+void decodeJSIField(jsi::Runtime &runtime, YeetJSIPropNameCache &names, const jsi::Object &object, Struct &out, const YeetJSIField<Struct, Member> &field) {
+  decodeJSIValue(runtime, names, object.getProperty(runtime, names.get(runtime, field.name)), out.*(field.member));
+}
+
+template <typename Struct, typename Fields, size_t... Index>
+void decodeJSIFields(jsi::Runtime &runtime, YeetJSIPropNameCache &names, const jsi::Object &object, Struct &out, const Fields &fields, std::index_sequence<Index...>) {
+  using expand = int[];
+  (void)expand{ 0, (decodeJSIField(runtime, names, object, out, std::get<Index>(fields)), 0)... };
+}
+
+// Returns false if value isn't an object, leaving out untouched.
+template <typename Struct>
+bool decodeJSIStruct(jsi::Runtime &runtime, YeetJSIPropNameCache &names, const jsi::Value &value, Struct &out) {
+  if (!value.isObject()) {
+    return false;
+  }
+
+  auto fields = YeetJSIStructFields<Struct>::fields();
+  decodeJSIFields(runtime, names, value.getObject(runtime), out, fields, std::make_index_sequence<std::tuple_size<decltype(fields)>::value>());
+  return true;
+}
+
+template <typename Struct>
+auto decodeJSIValue(jsi::Runtime &runtime, YeetJSIPropNameCache &names, const jsi::Value &value, Struct &out)
+  -> decltype(YeetJSIStructFields<Struct>::fields(), void()) {
+  decodeJSIStruct(runtime, names, value, out);
+}
+
+#endif
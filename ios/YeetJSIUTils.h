@@ -25,6 +25,7 @@ jsi::Value convertNSNumberToJSINumber(jsi::Runtime &runtime, NSNumber *value);
 jsi::String convertNSStringToJSIString(jsi::Runtime &runtime, NSString *value);
 jsi::Object convertNSDictionaryToJSIObject(jsi::Runtime &runtime, NSDictionary *value);
 jsi::Array convertNSArrayToJSIArray(jsi::Runtime &runtime, NSArray *value);
+jsi::Array convertDoubleVectorToJSIArray(jsi::Runtime &runtime, const std::vector<double> &value);
 //std::vector<jsi::Value> convertNSArrayToStdVector(jsi::Runtime &runtime, NSArray *value);
 //jsi::Value convertObjCObjectToJSIValue(jsi::Runtime &runtime, id value);
 //id convertJSIValueToObjCObject(
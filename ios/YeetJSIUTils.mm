@@ -66,6 +66,15 @@ jsi::Array convertNSArrayToJSIArray(jsi::Runtime &runtime, NSArray *value)
   return result;
 }
 
+jsi::Array convertDoubleVectorToJSIArray(jsi::Runtime &runtime, const std::vector<double> &value)
+{
+  jsi::Array result = jsi::Array(runtime, value.size());
+  for (size_t i = 0; i < value.size(); i++) {
+    result.setValueAtIndex(runtime, i, jsi::Value(value[i]));
+  }
+  return result;
+}
+
 std::vector<jsi::Value> convertNSArrayToStdVector(jsi::Runtime &runtime, NSArray *value)
 {
   std::vector<jsi::Value> result;
@@ -0,0 +1,50 @@
+//
+//  YeetLayoutMeasurement.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 2/26/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetLayoutMeasurement.h"
+#include <cmath>
+#include <limits>
+
+// Yoga reports undefined layout values as NaN. RCTCoreGraphicsFloatFromYogaFloat treats those as 0.
+static double layoutValue(float value) {
+  return std::isnan(value) ? 0 : value;
+}
+
+void clearLayoutFrame(double *frame) {
+  for (size_t i = 0; i < YeetLayoutFrameStride; i++) {
+    frame[i] = std::numeric_limits<double>::quiet_NaN();
+  }
+}
+
+bool measureYogaNodeRelativeTo(YGNodeRef node, YGNodeRef ancestor, double *frame) {
+  if (node == nullptr || ancestor == nullptr) {
+    clearLayoutFrame(frame);
+    return false;
+  }
+
+  double x = 0;
+  double y = 0;
+
+  YGNodeRef current = node;
+  while (current != nullptr && current != ancestor) {
+    x += layoutValue(YGNodeLayoutGetLeft(current));
+    y += layoutValue(YGNodeLayoutGetTop(current));
+    current = YGNodeGetParent(current);
+  }
+
+  if (current != ancestor) {
+    clearLayoutFrame(frame);
+    return false;
+  }
+
+  frame[0] = x;
+  frame[1] = y;
+  frame[2] = layoutValue(YGNodeLayoutGetWidth(node));
+  frame[3] = layoutValue(YGNodeLayoutGetHeight(node));
+  return true;
+}
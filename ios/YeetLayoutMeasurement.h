@@ -0,0 +1,27 @@
+//
+//  YeetLayoutMeasurement.h
+//  yeet
+//
+//  Created by Jarred WSumner on 2/26/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <yoga/Yoga.h>
+#include <cstddef>
+
+// Frames are packed as [x, y, width, height] so a batch can be handed to JS as one flat array.
+static const size_t YeetLayoutFrameStride = 4;
+
+// Writes node's frame relative to ancestor into frame[0..3], the same way
+// -[RCTShadowView measureLayoutRelativeToAncestor:] does, but straight off the Yoga tree.
+// Returns false and writes NaN when ancestor isn't in node's owner chain.
+bool measureYogaNodeRelativeTo(YGNodeRef node, YGNodeRef ancestor, double *frame);
+
+// Marks a slot in a packed frame buffer as missing.
+void clearLayoutFrame(double *frame);
+
+#endif
@@ -0,0 +1,65 @@
+//
+//  YeetLayoutSnapshot.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 2/27/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetLayoutSnapshot.h"
+#include <algorithm>
+#include <thread>
+
+YeetLayoutSnapshot::Containers &YeetLayoutSnapshot::beginWrite() {
+  Buffer &back = buffers_[1 - front_.load()];
+
+  // A reader that pinned this buffer before the last publish() may still be copying out of it.
+  // Readers that pin it from now on see front_ has moved and back off, so this can't starve.
+  while (back.readers.load() != 0) {
+    std::this_thread::yield();
+  }
+
+  back.containers.clear();
+  return back.containers;
+}
+
+void YeetLayoutSnapshot::publish() {
+  front_.store(1 - front_.load());
+}
+
+bool YeetLayoutSnapshot::read(int containerTag, const std::vector<int> &tags, double *frames) {
+  Buffer *buffer;
+
+  // seq_cst on both sides: the writer's readers.load() and our front_.load() can't both miss each other.
+  while (true) {
+    int index = front_.load();
+    buffer = &buffers_[index];
+    buffer->readers.fetch_add(1);
+
+    if (front_.load() == index) {
+      break;
+    }
+
+    buffer->readers.fetch_sub(1);
+  }
+
+  auto container = buffer->containers.find(containerTag);
+  bool hasContainer = container != buffer->containers.end();
+
+  if (hasContainer) {
+    for (int tag : tags) {
+      auto frame = container->second.find(tag);
+
+      if (frame == container->second.end()) {
+        clearLayoutFrame(frames);
+      } else {
+        std::copy(frame->second.begin(), frame->second.end(), frames);
+      }
+
+      frames += YeetLayoutFrameStride;
+    }
+  }
+
+  buffer->readers.fetch_sub(1);
+  return hasContainer;
+}
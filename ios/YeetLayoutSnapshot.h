@@ -0,0 +1,50 @@
+//
+//  YeetLayoutSnapshot.h
+//  yeet
+//
+//  Created by Jarred WSumner on 2/27/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include "YeetLayoutMeasurement.h"
+#include <array>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+// Double-buffered layout frames, so the JS thread can measure without hopping to the UIManager queue.
+//
+// There's exactly one writer (the UIManager queue, after each layout pass) and any number of readers.
+// Readers never take a lock: they pin the front buffer with a reader count and retry if it was swapped
+// underneath them. The writer only ever waits for readers that are still on the buffer it's about to reuse.
+class YeetLayoutSnapshot {
+public:
+  using Frame = std::array<double, YeetLayoutFrameStride>;
+  // reactTag -> frame relative to the container
+  using Frames = std::unordered_map<int, Frame>;
+  // container reactTag -> frames of its subtree
+  using Containers = std::unordered_map<int, Frames>;
+
+  // Writer side. Returns the back buffer, emptied. Call publish() when done filling it.
+  Containers &beginWrite();
+  void publish();
+
+  // Reader side. Writes tags.size() packed frames into frames, NaN for tags that aren't in the subtree.
+  // Returns false if containerTag wasn't in the latest snapshot.
+  bool read(int containerTag, const std::vector<int> &tags, double *frames);
+
+private:
+  struct Buffer {
+    Containers containers;
+    std::atomic<int> readers{0};
+  };
+
+  Buffer buffers_[2];
+  std::atomic<int> front_{0};
+};
+
+#endif
@@ -0,0 +1,36 @@
+//
+//  YeetLayoutSnapshotObserver.h
+//  yeet
+//
+//  Created by Jarred WSumner on 2/27/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <React/RCTUIManager.h>
+#import <React/RCTUIManagerObserverCoordinator.h>
+
+#ifdef __cplusplus
+#include "YeetLayoutSnapshot.h"
+#include <memory>
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Publishes a YeetLayoutSnapshot of every watched container's subtree after each layout pass.
+@interface YeetLayoutSnapshotObserver : NSObject <RCTUIManagerObserver>
+
+- (instancetype)initWithUIManager:(RCTUIManager *)uiManager;
+
+// Safe to call from any thread. The container is snapshotted on the next layout pass.
+- (void)watchContainer:(NSNumber *)containerTag;
+- (void)unwatchContainer:(NSNumber *)containerTag;
+- (void)invalidate;
+
+#ifdef __cplusplus
+@property (nonatomic, readonly) std::shared_ptr<YeetLayoutSnapshot> snapshot;
+#endif
+
+@end
+
+NS_ASSUME_NONNULL_END
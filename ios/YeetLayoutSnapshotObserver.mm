@@ -0,0 +1,101 @@
+//
+//  YeetLayoutSnapshotObserver.mm
+//  yeet
+//
+//  Created by Jarred WSumner on 2/27/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#import "YeetLayoutSnapshotObserver.h"
+#import <React/RCTShadowView.h>
+#import <React/RCTUIManagerUtils.h>
+
+static void snapshotSubtree(RCTShadowView *view, CGPoint offset, YeetLayoutSnapshot::Frames &frames) {
+  for (RCTShadowView *child in view.reactSubviews) {
+    CGRect frame = child.layoutMetrics.frame;
+    CGPoint origin = CGPointMake(offset.x + frame.origin.x, offset.y + frame.origin.y);
+
+    frames[child.reactTag.intValue] = { origin.x, origin.y, frame.size.width, frame.size.height };
+    snapshotSubtree(child, origin, frames);
+  }
+}
+
+@implementation YeetLayoutSnapshotObserver {
+  __weak RCTUIManager *_uiManager;
+  // Only touched on the UIManager queue.
+  NSMutableSet<NSNumber *> *_containerTags;
+}
+
+- (instancetype)initWithUIManager:(RCTUIManager *)uiManager {
+  if (self = [super init]) {
+    _uiManager = uiManager;
+    _containerTags = [[NSMutableSet alloc] init];
+    _snapshot = std::make_shared<YeetLayoutSnapshot>();
+
+    [uiManager.observerCoordinator addObserver:self];
+  }
+
+  return self;
+}
+
+- (void)watchContainer:(NSNumber *)containerTag {
+  RCTExecuteOnUIManagerQueue(^{
+    if ([self->_containerTags containsObject:containerTag]) {
+      return;
+    }
+
+    [self->_containerTags addObject:containerTag];
+
+    // Don't wait for the next layout pass if the container has already been laid out.
+    RCTUIManager *uiManager = self->_uiManager;
+    if (uiManager) {
+      [self publishSnapshot:uiManager];
+    }
+  });
+}
+
+- (void)unwatchContainer:(NSNumber *)containerTag {
+  RCTExecuteOnUIManagerQueue(^{
+    if (![self->_containerTags containsObject:containerTag]) {
+      return;
+    }
+
+    [self->_containerTags removeObject:containerTag];
+
+    // Drop its frames now, so a later measureRelativeToSync doesn't read a stale subtree.
+    RCTUIManager *uiManager = self->_uiManager;
+    if (uiManager) {
+      [self publishSnapshot:uiManager];
+    }
+  });
+}
+
+- (void)invalidate {
+  [_uiManager.observerCoordinator removeObserver:self];
+}
+
+- (void)publishSnapshot:(RCTUIManager *)manager {
+  YeetLayoutSnapshot::Containers &containers = _snapshot->beginWrite();
+
+  for (NSNumber *containerTag in _containerTags) {
+    RCTShadowView *container = [manager shadowViewForReactTag:containerTag];
+
+    if (container) {
+      snapshotSubtree(container, CGPointZero, containers[containerTag.intValue]);
+    }
+  }
+
+  _snapshot->publish();
+}
+
+#pragma mark - RCTUIManagerObserver
+
+- (void)uiManagerDidPerformLayout:(RCTUIManager *)manager {
+  if (_containerTags.count == 0) {
+    return;
+  }
+
+  [self publishSnapshot:manager];
+}
+
+@end
@@ -0,0 +1,167 @@
+//
+//  YeetNativePromise.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/1/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <jsi/jsi.h>
+#include <ReactCommon/JSCallInvoker.h>
+#include <ReactCommon/LongLivedObject.h>
+#include <ReactCommon/TurboModuleUtils.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+using namespace facebook;
+
+// The JS resolve and reject functions of one NativePromise. Only the JS thread creates, calls or
+// releases them. They're held by react::LongLivedObjectCollection, which YeetJSIModuleRegistry
+// clears on the JS thread before the runtime goes away, so a promise that outlives its bridge never
+// touches a dead runtime.
+struct NativePromiseCallbacks : public react::LongLivedObject {
+  NativePromiseCallbacks(jsi::Function resolve, jsi::Function reject, jsi::Runtime &runtime)
+      : resolve(std::move(resolve)), reject(std::move(reject)), runtime(runtime)
+  {
+  }
+
+  jsi::Function resolve;
+  jsi::Function reject;
+  jsi::Runtime &runtime;
+};
+
+// A promise that resolves with a plain C++ value instead of an NSDictionary/NSNumber.
+//
+// PromiseWrapper boxes results into Foundation objects on the native side and walks them with
+// convertObjCObjectToJSIValue on the JS thread. NativePromise<T> moves the native value across and
+// runs a converter on the JS thread that builds exactly the JS value it needs.
+//
+// Native code only ever holds a weak reference to the JS functions, so it can keep or drop the
+// NativePromise on any thread. Dropping one that never settled rejects it.
+template <typename T>
+class NativePromise {
+public:
+  using Converter = std::function<jsi::Value(jsi::Runtime &runtime, T &value)>;
+
+  NativePromise(
+      jsi::Function resolve,
+      jsi::Function reject,
+      jsi::Runtime &runtime,
+      std::shared_ptr<react::JSCallInvoker> jsInvoker,
+      Converter converter)
+      : jsInvoker_(jsInvoker),
+        converter_(std::move(converter))
+  {
+    auto callbacks = std::make_shared<NativePromiseCallbacks>(std::move(resolve), std::move(reject), runtime);
+    react::LongLivedObjectCollection::get().add(callbacks);
+    callbacks_ = callbacks;
+  }
+
+  ~NativePromise()
+  {
+    reject("The native promise was released without being settled");
+  }
+
+  NativePromise(const NativePromise &) = delete;
+  NativePromise &operator=(const NativePromise &) = delete;
+
+  // Safe to call from any thread. Only the first resolve() or reject() has any effect.
+  void resolve(T value)
+  {
+    if (!settle()) {
+      return;
+    }
+
+    // invokeAsync needs a copyable function, so T only gets moved once, into a shared_ptr.
+    auto result = std::make_shared<T>(std::move(value));
+    std::weak_ptr<NativePromiseCallbacks> weakCallbacks = callbacks_;
+    Converter converter = converter_;
+    jsInvoker_->invokeAsync([weakCallbacks, result, converter]() {
+      auto callbacks = weakCallbacks.lock();
+      if (callbacks == nullptr) {
+        return;
+      }
+
+      // The last reference is the local one, so the functions are released here on the JS thread.
+      callbacks->allowRelease();
+      jsi::Runtime &rt = callbacks->runtime;
+      callbacks->resolve.call(rt, converter(rt, *result));
+    });
+  }
+
+  void reject(std::string message)
+  {
+    if (!settle()) {
+      return;
+    }
+
+    std::weak_ptr<NativePromiseCallbacks> weakCallbacks = callbacks_;
+    jsInvoker_->invokeAsync([weakCallbacks, message]() {
+      auto callbacks = weakCallbacks.lock();
+      if (callbacks == nullptr) {
+        return;
+      }
+
+      callbacks->allowRelease();
+      jsi::Runtime &rt = callbacks->runtime;
+      jsi::Object error = rt.global().getPropertyAsFunction(rt, "Error").callAsConstructor(rt, jsi::String::createFromUtf8(rt, message)).getObject(rt);
+      callbacks->reject.call(rt, error);
+    });
+  }
+
+private:
+  // True for whichever of resolve() or reject() gets here first.
+  bool settle()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (settled_) {
+      return false;
+    }
+
+    settled_ = true;
+    return true;
+  }
+
+  std::mutex mutex_;
+  bool settled_ = false;
+  std::weak_ptr<NativePromiseCallbacks> callbacks_;
+  std::shared_ptr<react::JSCallInvoker> jsInvoker_;
+  Converter converter_;
+};
+
+// Like createPromise, but invoke gets a NativePromise<T> to resolve from any thread.
+template <typename T>
+jsi::Value createNativePromise(
+    jsi::Runtime &runtime,
+    std::shared_ptr<react::JSCallInvoker> jsInvoker,
+    typename NativePromise<T>::Converter converter,
+    std::function<void(std::shared_ptr<NativePromise<T>> promise)> invoke)
+{
+  jsi::Function Promise = runtime.global().getPropertyAsFunction(runtime, "Promise");
+
+  jsi::Function fn = jsi::Function::createFromHostFunction(
+      runtime,
+      jsi::PropNameID::forAscii(runtime, "fn"),
+      2,
+      [jsInvoker, converter, invoke](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+        if (count != 2) {
+          throw std::invalid_argument("Promise fn arg count must be 2");
+        }
+
+        jsi::Function resolve = args[0].getObject(rt).getFunction(rt);
+        jsi::Function reject = args[1].getObject(rt).getFunction(rt);
+        invoke(std::make_shared<NativePromise<T>>(std::move(resolve), std::move(reject), rt, jsInvoker, converter));
+        return jsi::Value::undefined();
+      });
+
+  return Promise.callAsConstructor(runtime, fn);
+}
+
+#endif
@@ -0,0 +1,183 @@
+//
+//  YeetPerceptualHash.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/14/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetPerceptualHash.h"
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+
+static const int YeetHashThumbnailSize = 32;
+static const int YeetHashFrequencies = 8;
+
+namespace {
+
+// The first 8 rows of the orthonormal 32-point DCT-II matrix. Only the low frequencies end up in
+// the hash, so the full 32x32 transform would be 4x the work for coefficients we throw away.
+struct YeetDCTBasis {
+  alignas(16) float rows[YeetHashFrequencies][YeetHashThumbnailSize];
+
+  YeetDCTBasis() {
+    const int n = YeetHashThumbnailSize;
+    for (int u = 0; u < YeetHashFrequencies; u++) {
+      const double scale = std::sqrt((u == 0 ? 1.0 : 2.0) / n);
+      for (int x = 0; x < n; x++) {
+        rows[u][x] = (float)(scale * std::cos(M_PI * (2 * x + 1) * u / (2.0 * n)));
+      }
+    }
+  }
+};
+
+const YeetDCTBasis &yeetDCTBasis() {
+  static const YeetDCTBasis basis;
+  return basis;
+}
+
+void yeetGrayThumbnail(const cv::Mat &image, cv::Size size, cv::Mat &dst) {
+  cv::Mat gray;
+  if (image.channels() == 4) {
+    cv::cvtColor(image, gray, cv::COLOR_RGBA2GRAY);
+  } else if (image.channels() == 3) {
+    cv::cvtColor(image, gray, cv::COLOR_RGB2GRAY);
+  } else {
+    gray = image;
+  }
+
+  cv::resize(gray, dst, size, 0, 0, cv::INTER_AREA);
+}
+
+// coefficients = B * X * B^T, where B is the 8x32 basis and X the 32x32 thumbnail.
+void yeetLowFrequencyDCT(const cv::Mat &thumbnail, float coefficients[YeetHashFrequencies][YeetHashFrequencies]) {
+  const YeetDCTBasis &basis = yeetDCTBasis();
+  const int n = YeetHashThumbnailSize;
+
+  // B * X, one output row at a time: each row is a weighted sum of the thumbnail's rows.
+  alignas(16) float columns[YeetHashFrequencies][YeetHashThumbnailSize];
+  for (int u = 0; u < YeetHashFrequencies; u++) {
+    float *out = columns[u];
+    std::fill(out, out + n, 0.f);
+
+    for (int y = 0; y < n; y++) {
+      const float *row = thumbnail.ptr<float>(y);
+      const float weight = basis.rows[u][y];
+      int x = 0;
+#if CV_SIMD128
+      const cv::v_float32x4 weights = cv::v_setall_f32(weight);
+      for (; x <= n - cv::v_float32x4::nlanes; x += cv::v_float32x4::nlanes) {
+        cv::v_store(out + x, cv::v_muladd(weights, cv::v_load(row + x), cv::v_load(out + x)));
+      }
+#endif
+      for (; x < n; x++) {
+        out[x] += weight * row[x];
+      }
+    }
+  }
+
+  // (B * X) * B^T: dot products of those rows with the basis rows.
+  for (int u = 0; u < YeetHashFrequencies; u++) {
+    for (int v = 0; v < YeetHashFrequencies; v++) {
+      const float *a = columns[u];
+      const float *b = basis.rows[v];
+      float sum = 0;
+      int x = 0;
+#if CV_SIMD128
+      cv::v_float32x4 accumulator = cv::v_setzero_f32();
+      for (; x <= n - cv::v_float32x4::nlanes; x += cv::v_float32x4::nlanes) {
+        accumulator = cv::v_muladd(cv::v_load(a + x), cv::v_load(b + x), accumulator);
+      }
+      sum = cv::v_reduce_sum(accumulator);
+#endif
+      for (; x < n; x++) {
+        sum += a[x] * b[x];
+      }
+      coefficients[u][v] = sum;
+    }
+  }
+}
+
+}
+
+uint64_t yeetPerceptualHash(const cv::Mat &image) {
+  if (image.empty()) {
+    return 0;
+  }
+
+  cv::Mat thumbnail, pixels;
+  yeetGrayThumbnail(image, cv::Size(YeetHashThumbnailSize, YeetHashThumbnailSize), thumbnail);
+  thumbnail.convertTo(pixels, CV_32F);
+
+  float coefficients[YeetHashFrequencies][YeetHashFrequencies];
+  yeetLowFrequencyDCT(pixels, coefficients);
+
+  // The DC coefficient (index 0) is just the thumbnail's mean brightness. It dwarfs the others, so
+  // it stays out of the median and its bit is always 0: brightening an image doesn't move the hash.
+  const int count = YeetHashFrequencies * YeetHashFrequencies;
+  const float *flat = &coefficients[0][0];
+  float sorted[count - 1];
+  std::copy(flat + 1, flat + count, sorted);
+  std::nth_element(sorted, sorted + (count - 1) / 2, sorted + count - 1);
+  const float median = sorted[(count - 1) / 2];
+
+  uint64_t hash = 0;
+  for (int i = 1; i < count; i++) {
+    hash = (hash << 1) | (flat[i] > median ? 1 : 0);
+  }
+  return hash;
+}
+
+uint64_t yeetDifferenceHash(const cv::Mat &image) {
+  if (image.empty()) {
+    return 0;
+  }
+
+  cv::Mat thumbnail;
+  yeetGrayThumbnail(image, cv::Size(YeetHashFrequencies + 1, YeetHashFrequencies), thumbnail);
+
+  uint64_t hash = 0;
+  for (int y = 0; y < YeetHashFrequencies; y++) {
+    const uchar *row = thumbnail.ptr<uchar>(y);
+    for (int x = 0; x < YeetHashFrequencies; x++) {
+      hash = (hash << 1) | (row[x] > row[x + 1] ? 1 : 0);
+    }
+  }
+  return hash;
+}
+
+std::string yeetHashToHex(uint64_t hash) {
+  static const char digits[] = "0123456789abcdef";
+  std::string hex(16, '0');
+  for (int i = 15; i >= 0; i--) {
+    hex[i] = digits[hash & 0xf];
+    hash >>= 4;
+  }
+  return hex;
+}
+
+bool yeetHashFromHex(const std::string &hex, uint64_t &hash) {
+  if (hex.empty() || hex.size() > 16) {
+    return false;
+  }
+
+  uint64_t value = 0;
+  for (char c : hex) {
+    int digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    value = (value << 4) | digit;
+  }
+
+  hash = value;
+  return true;
+}
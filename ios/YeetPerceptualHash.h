@@ -0,0 +1,39 @@
+//
+//  YeetPerceptualHash.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/14/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <opencv2/core/core.hpp>
+#include <cstdint>
+#include <string>
+
+// 64-bit perceptual hashes. Re-encoded, resized or slightly recolored copies of an image land a
+// few bits apart, so near-duplicates are a small Hamming distance away.
+//
+// Both take CV_8UC4 (RGBA), CV_8UC3 or CV_8UC1 images of any size.
+
+// pHash: the sign of each of the 8x8 lowest-frequency DCT coefficients of a 32x32 grayscale
+// thumbnail except DC, relative to their median, in the low 63 bits. Robust to scaling,
+// compression, small color changes and changes in overall brightness.
+uint64_t yeetPerceptualHash(const cv::Mat &image);
+
+// dHash: whether each pixel of a 9x8 grayscale thumbnail is brighter than its right neighbor.
+// Cheaper and better at telling apart images with the same layout but different details.
+uint64_t yeetDifferenceHash(const cv::Mat &image);
+
+inline int yeetHammingDistance(uint64_t a, uint64_t b) {
+  return __builtin_popcountll(a ^ b);
+}
+
+// 16 lowercase hex digits. JS numbers can't hold 64 bits, so hashes cross JSI as strings.
+std::string yeetHashToHex(uint64_t hash);
+bool yeetHashFromHex(const std::string &hex, uint64_t &hash);
+
+#endif
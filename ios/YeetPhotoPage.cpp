@@ -0,0 +1,104 @@
+//
+//  YeetPhotoPage.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 2/28/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetPhotoPage.h"
+#include <cstdlib>
+
+static jsi::Value stringOrNull(jsi::Runtime &runtime, const std::string &value) {
+  if (value.empty()) {
+    return jsi::Value::null();
+  }
+
+  return jsi::String::createFromUtf8(runtime, value);
+}
+
+static const char *mediaTypeName(YeetPhotoMediaType mediaType) {
+  switch (mediaType) {
+    case YeetPhotoMediaType::image:
+      return "image";
+    case YeetPhotoMediaType::video:
+      return "video";
+    case YeetPhotoMediaType::audio:
+      return "audio";
+    case YeetPhotoMediaType::unknown:
+      break;
+  }
+
+  return "unknown";
+}
+
+size_t YeetPhotoPage::size() const {
+  return ids.size();
+}
+
+void YeetPhotoPage::reserve(size_t capacity) {
+  ids.reserve(capacity);
+  widths.reserve(capacity);
+  heights.reserve(capacity);
+  durations.reserve(capacity);
+  mediaTypes.reserve(capacity);
+}
+
+void YeetPhotoPage::push_back(std::string id, double width, double height, double duration, YeetPhotoMediaType mediaType) {
+  ids.push_back(std::move(id));
+  widths.push_back(width);
+  heights.push_back(height);
+  durations.push_back(duration);
+  mediaTypes.push_back(mediaType);
+}
+
+jsi::Object YeetPhotoPage::row(jsi::Runtime &runtime, size_t index) const {
+  jsi::Object result = jsi::Object(runtime);
+  YeetPhotoDetails details = loadDetails ? loadDetails(index) : YeetPhotoDetails();
+
+  result.setProperty(runtime, "uri", jsi::String::createFromUtf8(runtime, "ph://" + ids[index]));
+  result.setProperty(runtime, "width", widths[index]);
+  result.setProperty(runtime, "height", heights[index]);
+  result.setProperty(runtime, "filename", stringOrNull(runtime, details.filename));
+  result.setProperty(runtime, "mimeType", stringOrNull(runtime, details.mimeType));
+  result.setProperty(runtime, "timestamp", stringOrNull(runtime, details.timestamp));
+  result.setProperty(runtime, "duration", durations[index]);
+  result.setProperty(runtime, "mediaType", jsi::String::createFromAscii(runtime, mediaTypeName(mediaTypes[index])));
+
+  return result;
+}
+
+YeetPhotoPageHostObject::YeetPhotoPageHostObject(std::shared_ptr<YeetPhotoPage> page)
+: page_(std::move(page)) {
+}
+
+jsi::Value YeetPhotoPageHostObject::get(jsi::Runtime &runtime, const jsi::PropNameID &name) {
+  auto propertyName = name.utf8(runtime);
+
+  if (propertyName == "length") {
+    return jsi::Value((double)page_->size());
+  }
+
+  if (propertyName.empty() || propertyName.find_first_not_of("0123456789") != std::string::npos) {
+    return jsi::Value::undefined();
+  }
+
+  size_t index = std::strtoul(propertyName.c_str(), nullptr, 10);
+  if (index >= page_->size()) {
+    return jsi::Value::undefined();
+  }
+
+  return page_->row(runtime, index);
+}
+
+std::vector<jsi::PropNameID> YeetPhotoPageHostObject::getPropertyNames(jsi::Runtime &runtime) {
+  std::vector<jsi::PropNameID> names;
+  names.reserve(page_->size() + 1);
+
+  names.push_back(jsi::PropNameID::forAscii(runtime, "length"));
+  for (size_t i = 0; i < page_->size(); i++) {
+    names.push_back(jsi::PropNameID::forAscii(runtime, std::to_string(i)));
+  }
+
+  return names;
+}
@@ -0,0 +1,67 @@
+//
+//  YeetPhotoPage.h
+//  yeet
+//
+//  Created by Jarred WSumner on 2/28/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <jsi/jsi.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace facebook;
+
+enum class YeetPhotoMediaType : uint8_t {
+  unknown,
+  image,
+  video,
+  audio,
+};
+
+// The per-asset fields that are slow to look up. Empty strings mean "missing" and become null in JS.
+struct YeetPhotoDetails {
+  std::string filename;
+  std::string mimeType;
+  std::string timestamp;
+};
+
+// One page of camera roll assets, stored as parallel columns instead of a dictionary per asset.
+// Only the fields PHAsset already has in memory are stored. The rest come from loadDetails when
+// a row is built, so rows nobody reads never pay for them.
+struct YeetPhotoPage {
+  std::vector<std::string> ids;
+  std::vector<double> widths;
+  std::vector<double> heights;
+  std::vector<double> durations;
+  std::vector<YeetPhotoMediaType> mediaTypes;
+  std::function<YeetPhotoDetails(size_t index)> loadDetails;
+
+  size_t size() const;
+  void reserve(size_t capacity);
+  void push_back(std::string id, double width, double height, double duration, YeetPhotoMediaType mediaType);
+
+  // Builds the same row object CameraRoll used to return: { uri, width, height, filename, mimeType, timestamp, duration, mediaType }
+  jsi::Object row(jsi::Runtime &runtime, size_t index) const;
+};
+
+// Array-like view over a YeetPhotoPage: `length` and integer indices.
+// Rows are only turned into JS objects when they're read.
+class JSI_EXPORT YeetPhotoPageHostObject : public jsi::HostObject {
+public:
+  YeetPhotoPageHostObject(std::shared_ptr<YeetPhotoPage> page);
+
+  jsi::Value get(jsi::Runtime &runtime, const jsi::PropNameID &name) override;
+  std::vector<jsi::PropNameID> getPropertyNames(jsi::Runtime &runtime) override;
+
+private:
+  std::shared_ptr<YeetPhotoPage> page_;
+};
+
+#endif
@@ -0,0 +1,52 @@
+//
+//  YeetPixelBuffer.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/5/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetPixelBuffer.h"
+#include <opencv2/imgproc/imgproc.hpp>
+
+cv::Mat YeetPixelBuffer::view() const {
+  if (empty()) {
+    return cv::Mat();
+  }
+
+  return cv::Mat(height, width, CV_8UC4, data, bytesPerRow);
+}
+
+YeetPixelBuffer YeetPixelBuffer::borrow(uint8_t *data, int width, int height, size_t bytesPerRow, YeetPixelFormat format, std::shared_ptr<void> owner) {
+  YeetPixelBuffer buffer;
+  if (data == nullptr || bytesPerRow < (size_t)width * 4) {
+    return buffer;
+  }
+
+  buffer.data = data;
+  buffer.width = width;
+  buffer.height = height;
+  buffer.bytesPerRow = bytesPerRow;
+  buffer.format = format;
+  buffer.owner = std::move(owner);
+  return buffer;
+}
+
+YeetPixelBuffer YeetPixelBuffer::adopt(const cv::Mat &mat, YeetPixelFormat format) {
+  if (mat.empty() || mat.type() != CV_8UC4) {
+    return YeetPixelBuffer();
+  }
+
+  // Copying the header bumps the Mat's refcount, so the pixels live as long as owner does.
+  auto owner = std::make_shared<cv::Mat>(mat);
+  return borrow(owner->data, owner->cols, owner->rows, owner->step[0], format, owner);
+}
+
+cv::Mat yeetPixelBufferRGBA(const YeetPixelBuffer &buffer, cv::Mat &scratch) {
+  if (buffer.format == YeetPixelFormat::RGBA) {
+    return buffer.view();
+  }
+
+  cv::cvtColor(buffer.view(), scratch, cv::COLOR_BGRA2RGBA);
+  return scratch;
+}
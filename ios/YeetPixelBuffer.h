@@ -0,0 +1,52 @@
+//
+//  YeetPixelBuffer.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/5/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <opencv2/core/core.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Byte order of the four 8-bit channels in memory.
+enum class YeetPixelFormat {
+  RGBA,
+  BGRA,
+};
+
+// A 4-channel, 8-bit image in memory that something else owns, with an arbitrary row stride.
+//
+// owner keeps data alive. It's whatever holds the pixels: the CFData copied out of a CGImage's
+// data provider, a cv::Mat, etc. Copying a YeetPixelBuffer never copies pixels.
+struct YeetPixelBuffer {
+  uint8_t *data = nullptr;
+  int width = 0;
+  int height = 0;
+  size_t bytesPerRow = 0;
+  YeetPixelFormat format = YeetPixelFormat::RGBA;
+  std::shared_ptr<void> owner;
+
+  bool empty() const { return data == nullptr || width <= 0 || height <= 0; }
+  size_t length() const { return bytesPerRow * height; }
+
+  // A cv::Mat header over data. It doesn't own the pixels, so keep this buffer (or owner) alive
+  // for as long as the Mat is used.
+  cv::Mat view() const;
+
+  static YeetPixelBuffer borrow(uint8_t *data, int width, int height, size_t bytesPerRow, YeetPixelFormat format, std::shared_ptr<void> owner);
+
+  // Takes a reference on a CV_8UC4 Mat's pixels, so they outlive the Mat itself.
+  static YeetPixelBuffer adopt(const cv::Mat &mat, YeetPixelFormat format);
+};
+
+// The buffer as an RGBA Mat: a view when it already is RGBA, otherwise swizzled into scratch.
+cv::Mat yeetPixelBufferRGBA(const YeetPixelBuffer &buffer, cv::Mat &scratch);
+
+#endif
@@ -0,0 +1,119 @@
+//
+//  YeetQuadGeometry.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/6/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetQuadGeometry.h"
+#include <opencv2/imgproc/imgproc.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+void yeetUpdateQuadBounds(YeetQuad &quad) {
+  const float minX = std::min(std::min(quad.topLeft.x, quad.topRight.x), std::min(quad.bottomRight.x, quad.bottomLeft.x));
+  const float minY = std::min(std::min(quad.topLeft.y, quad.topRight.y), std::min(quad.bottomRight.y, quad.bottomLeft.y));
+  const float maxX = std::max(std::max(quad.topLeft.x, quad.topRight.x), std::max(quad.bottomRight.x, quad.bottomLeft.x));
+  const float maxY = std::max(std::max(quad.topLeft.y, quad.topRight.y), std::max(quad.bottomRight.y, quad.bottomLeft.y));
+  quad.bounds = cv::Rect2f(minX, minY, maxX - minX, maxY - minY);
+}
+
+bool yeetOrderQuadCorners(const YeetSquare &square, YeetQuad &quad) {
+  if (square.size() != 4) {
+    return false;
+  }
+
+  std::array<cv::Point2f, 4> corners;
+  float centerX = 0;
+  float centerY = 0;
+  for (int i = 0; i < 4; i++) {
+    corners[i] = cv::Point2f((float)square[i].x, (float)square[i].y);
+    centerX += corners[i].x / 4;
+    centerY += corners[i].y / 4;
+  }
+
+  // With y pointing down, increasing atan2 is clockwise on screen. Degenerate squares (collinear or
+  // repeated points) can put two corners at the same angle, so those fall back to y, then x.
+  std::array<float, 4> angles;
+  std::array<int, 4> order = {{0, 1, 2, 3}};
+  for (int i = 0; i < 4; i++) {
+    angles[i] = std::atan2(corners[i].y - centerY, corners[i].x - centerX);
+  }
+  std::sort(order.begin(), order.end(), [&angles, &corners](int a, int b) {
+    if (angles[a] != angles[b]) {
+      return angles[a] < angles[b];
+    }
+    if (corners[a].y != corners[b].y) {
+      return corners[a].y < corners[b].y;
+    }
+    return corners[a].x < corners[b].x;
+  });
+
+  int first = 0;
+  for (int i = 1; i < 4; i++) {
+    const cv::Point2f &candidate = corners[order[i]];
+    const cv::Point2f &best = corners[order[first]];
+    const float candidateSum = candidate.x + candidate.y;
+    const float bestSum = best.x + best.y;
+
+    if (candidateSum < bestSum ||
+        (candidateSum == bestSum && (candidate.y < best.y || (candidate.y == best.y && candidate.x < best.x)))) {
+      first = i;
+    }
+  }
+
+  quad.topLeft = corners[order[first]];
+  quad.topRight = corners[order[(first + 1) % 4]];
+  quad.bottomRight = corners[order[(first + 2) % 4]];
+  quad.bottomLeft = corners[order[(first + 3) % 4]];
+  yeetUpdateQuadBounds(quad);
+  return true;
+}
+
+void yeetRefineQuadCorners(const cv::Mat &gray, std::vector<YeetQuad> &quads, int windowRadius) {
+  if (quads.empty() || gray.empty()) {
+    return;
+  }
+
+  std::vector<cv::Point2f> corners;
+  corners.reserve(quads.size() * 4);
+  for (const auto &quad : quads) {
+    corners.push_back(quad.topLeft);
+    corners.push_back(quad.topRight);
+    corners.push_back(quad.bottomRight);
+    corners.push_back(quad.bottomLeft);
+  }
+
+  cv::cornerSubPix(
+    gray,
+    corners,
+    cv::Size(windowRadius, windowRadius),
+    cv::Size(-1, -1),
+    cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 20, 0.03)
+  );
+
+  for (size_t i = 0; i < quads.size(); i++) {
+    YeetQuad &quad = quads[i];
+    quad.topLeft = corners[i * 4];
+    quad.topRight = corners[i * 4 + 1];
+    quad.bottomRight = corners[i * 4 + 2];
+    quad.bottomLeft = corners[i * 4 + 3];
+    yeetUpdateQuadBounds(quad);
+  }
+}
+
+void yeetQuadsFromSquares(const std::vector<YeetSquare> &squares, const cv::Mat &gray, std::vector<YeetQuad> &quads) {
+  quads.clear();
+  quads.reserve(squares.size());
+
+  YeetQuad quad;
+  for (const auto &square : squares) {
+    if (yeetOrderQuadCorners(square, quad)) {
+      quads.push_back(quad);
+    }
+  }
+
+  yeetRefineQuadCorners(gray, quads);
+}
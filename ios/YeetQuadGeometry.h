@@ -0,0 +1,45 @@
+//
+//  YeetQuadGeometry.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/6/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "YeetSquareDetector.h"
+
+// A detected square with its corners in a fixed order: clockwise on screen (y grows downward),
+// starting at the corner closest to the image's top-left.
+struct YeetQuad {
+  cv::Point2f topLeft;
+  cv::Point2f topRight;
+  cv::Point2f bottomRight;
+  cv::Point2f bottomLeft;
+  // Axis-aligned bounding box of the four corners.
+  cv::Rect2f bounds;
+};
+
+// Orders a 4-point square. Returns false (and leaves quad alone) for anything without exactly 4 points.
+//
+// Corners are sorted by angle around their centroid, then rotated so the first one has the smallest
+// x + y. Ties on x + y go to the smaller y, then the smaller x, so the result never depends on the
+// order findContours happened to produce.
+bool yeetOrderQuadCorners(const YeetSquare &square, YeetQuad &quad);
+
+// Moves every quad's corners to sub-pixel accuracy with one cv::cornerSubPix call over the whole
+// batch, then recomputes bounds. gray must be CV_8UC1 in the same coordinates as the quads.
+void yeetRefineQuadCorners(const cv::Mat &gray, std::vector<YeetQuad> &quads, int windowRadius = 5);
+
+// Recomputes bounds after the corners move.
+void yeetUpdateQuadBounds(YeetQuad &quad);
+
+// Orders every square, dropping ones that aren't quads, and refines them when gray isn't empty.
+void yeetQuadsFromSquares(const std::vector<YeetSquare> &squares, const cv::Mat &gray, std::vector<YeetQuad> &quads);
+
+#endif
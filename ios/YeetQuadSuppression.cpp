@@ -0,0 +1,194 @@
+//
+//  YeetQuadSuppression.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/7/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetQuadSuppression.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+static const int YeetQuadGridMaxCells = 64;
+
+static float cornerCosine(const cv::Point2f &previous, const cv::Point2f &corner, const cv::Point2f &next) {
+  const float dx1 = previous.x - corner.x;
+  const float dy1 = previous.y - corner.y;
+  const float dx2 = next.x - corner.x;
+  const float dy2 = next.y - corner.y;
+  return (dx1*dx2 + dy1*dy2) / std::sqrt((dx1*dx1 + dy1*dy1) * (dx2*dx2 + dy2*dy2) + 1e-10f);
+}
+
+float yeetQuadRectangularity(const YeetQuad &quad) {
+  const cv::Point2f corners[4] = {quad.topLeft, quad.topRight, quad.bottomRight, quad.bottomLeft};
+
+  float maxCosine = 0;
+  for (int i = 0; i < 4; i++) {
+    maxCosine = std::max(maxCosine, std::fabs(cornerCosine(corners[(i + 3) % 4], corners[i], corners[(i + 1) % 4])));
+  }
+
+  return std::max(0.0f, 1.0f - maxCosine);
+}
+
+float yeetBoundsIoU(const cv::Rect2f &a, const cv::Rect2f &b) {
+  const float width = std::min(a.x + a.width, b.x + b.width) - std::max(a.x, b.x);
+  const float height = std::min(a.y + a.height, b.y + b.height) - std::max(a.y, b.y);
+  if (width <= 0 || height <= 0) {
+    return 0;
+  }
+
+  const float intersection = width * height;
+  return intersection / (a.area() + b.area() - intersection);
+}
+
+namespace {
+
+// Buckets kept quads by the grid cells their bounds touch.
+class QuadGrid {
+public:
+  QuadGrid(const cv::Rect2f &area, size_t count) : origin_(area.x, area.y) {
+    const int side = std::max(1, std::min(YeetQuadGridMaxCells, (int)std::ceil(std::sqrt((double)count))));
+    columns_ = side;
+    rows_ = side;
+    cellWidth_ = std::max(1.0f, area.width / columns_);
+    cellHeight_ = std::max(1.0f, area.height / rows_);
+    cells_.resize(columns_ * rows_);
+  }
+
+  void insert(int index, const cv::Rect2f &bounds) {
+    forEachCell(bounds, [this, index](int cell) {
+      cells_[cell].push_back(index);
+    });
+  }
+
+  // Calls visit once per kept quad sharing a cell with bounds. stamp must be sized to the number
+  // of candidates and is reused between queries to skip duplicates without clearing it.
+  template <typename Visit>
+  void query(const cv::Rect2f &bounds, std::vector<int> &stamp, int queryID, Visit visit) const {
+    forEachCell(bounds, [this, &stamp, queryID, &visit](int cell) {
+      for (int index : cells_[cell]) {
+        if (stamp[index] != queryID) {
+          stamp[index] = queryID;
+          visit(index);
+        }
+      }
+    });
+  }
+
+private:
+  template <typename Visit>
+  void forEachCell(const cv::Rect2f &bounds, Visit visit) const {
+    const int minColumn = clampColumn((int)std::floor((bounds.x - origin_.x) / cellWidth_));
+    const int maxColumn = clampColumn((int)std::floor((bounds.x + bounds.width - origin_.x) / cellWidth_));
+    const int minRow = clampRow((int)std::floor((bounds.y - origin_.y) / cellHeight_));
+    const int maxRow = clampRow((int)std::floor((bounds.y + bounds.height - origin_.y) / cellHeight_));
+
+    for (int row = minRow; row <= maxRow; row++) {
+      for (int column = minColumn; column <= maxColumn; column++) {
+        visit(row * columns_ + column);
+      }
+    }
+  }
+
+  int clampColumn(int column) const { return std::max(0, std::min(columns_ - 1, column)); }
+  int clampRow(int row) const { return std::max(0, std::min(rows_ - 1, row)); }
+
+  cv::Point2f origin_;
+  int columns_;
+  int rows_;
+  float cellWidth_;
+  float cellHeight_;
+  std::vector<std::vector<int>> cells_;
+};
+
+}
+
+void yeetSuppressQuads(const std::vector<YeetQuad> &candidates, std::vector<YeetRankedQuad> &ranked, YeetQuadSuppressionOptions options) {
+  ranked.clear();
+  if (candidates.empty()) {
+    return;
+  }
+
+  const int count = (int)candidates.size();
+  std::vector<float> rectangularity(count);
+  float minX = candidates[0].bounds.x;
+  float minY = candidates[0].bounds.y;
+  float maxX = minX;
+  float maxY = minY;
+  for (int i = 0; i < count; i++) {
+    const cv::Rect2f &bounds = candidates[i].bounds;
+    rectangularity[i] = yeetQuadRectangularity(candidates[i]);
+    minX = std::min(minX, bounds.x);
+    minY = std::min(minY, bounds.y);
+    maxX = std::max(maxX, bounds.x + bounds.width);
+    maxY = std::max(maxY, bounds.y + bounds.height);
+  }
+
+  std::vector<int> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&candidates, &rectangularity](int a, int b) {
+    if (rectangularity[a] != rectangularity[b]) {
+      return rectangularity[a] > rectangularity[b];
+    }
+    return candidates[a].bounds.area() > candidates[b].bounds.area();
+  });
+
+  QuadGrid grid(cv::Rect2f(minX, minY, maxX - minX, maxY - minY), candidates.size());
+  std::vector<int> stamp(count, -1);
+  std::vector<int> kept;
+  std::vector<int> support(count, 0);
+
+  for (int queryID = 0; queryID < count; queryID++) {
+    const int candidate = order[queryID];
+    const cv::Rect2f &bounds = candidates[candidate].bounds;
+
+    int bestMatch = -1;
+    float bestIoU = options.iouThreshold;
+    grid.query(bounds, stamp, queryID, [&](int keptIndex) {
+      const float iou = yeetBoundsIoU(bounds, candidates[keptIndex].bounds);
+      if (iou > bestIoU) {
+        bestIoU = iou;
+        bestMatch = keptIndex;
+      }
+    });
+
+    if (bestMatch >= 0) {
+      support[bestMatch]++;
+    } else {
+      support[candidate] = 1;
+      kept.push_back(candidate);
+      grid.insert(candidate, bounds);
+    }
+  }
+
+  ranked.reserve(kept.size());
+  for (int index : kept) {
+    YeetRankedQuad result;
+    result.quad = candidates[index];
+    result.support = support[index];
+
+    const float supportScore = std::min(1.0f, (float)support[index] / std::max(1, options.supportSaturation));
+    result.confidence = (rectangularity[index] + supportScore) / 2;
+    ranked.push_back(result);
+  }
+
+  std::stable_sort(ranked.begin(), ranked.end(), [](const YeetRankedQuad &a, const YeetRankedQuad &b) {
+    return a.confidence > b.confidence;
+  });
+}
+
+void yeetRefineRankedQuads(const cv::Mat &gray, std::vector<YeetRankedQuad> &ranked) {
+  std::vector<YeetQuad> quads;
+  quads.reserve(ranked.size());
+  for (const auto &result : ranked) {
+    quads.push_back(result.quad);
+  }
+
+  yeetRefineQuadCorners(gray, quads);
+
+  for (size_t i = 0; i < ranked.size(); i++) {
+    ranked[i].quad = quads[i];
+  }
+}
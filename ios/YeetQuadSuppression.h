@@ -0,0 +1,53 @@
+//
+//  YeetQuadSuppression.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/7/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <vector>
+#include "YeetQuadGeometry.h"
+
+struct YeetRankedQuad {
+  YeetQuad quad;
+  // 0...1. See yeetSuppressQuads.
+  float confidence = 0;
+  // How many candidates (including this one) were merged into it.
+  int support = 0;
+};
+
+struct YeetQuadSuppressionOptions {
+  // Candidates whose bounds overlap a kept quad by more than this are merged into it.
+  float iouThreshold = 0.5f;
+  // Support at which the support half of the confidence maxes out. The detector runs 30
+  // (channel, level) passes, and a real rectangle usually shows up in several of them.
+  int supportSaturation = 6;
+};
+
+// Greedy IoU non-maximum suppression.
+//
+// Candidates are visited from most to least rectangular (1 - the largest |cos| at any corner),
+// with larger area and then input order breaking ties. Each one is either kept or merged into the
+// kept quad it overlaps most. Kept quads are indexed in a uniform grid over the candidates' bounds,
+// so a candidate is only compared against kept quads that share a cell with it.
+//
+// confidence = (rectangularity + min(1, support / supportSaturation)) / 2, and the result is
+// sorted by it, highest first.
+void yeetSuppressQuads(const std::vector<YeetQuad> &candidates, std::vector<YeetRankedQuad> &ranked, YeetQuadSuppressionOptions options = YeetQuadSuppressionOptions());
+
+// yeetRefineQuadCorners over the quads suppression kept. Suppress first, so merged duplicates
+// never go through cornerSubPix.
+void yeetRefineRankedQuads(const cv::Mat &gray, std::vector<YeetRankedQuad> &ranked);
+
+// Intersection over union of two axis-aligned rects. 0 when they don't overlap.
+float yeetBoundsIoU(const cv::Rect2f &a, const cv::Rect2f &b);
+
+// 1 for a perfect rectangle, falling toward 0 as corners get further from 90°.
+float yeetQuadRectangularity(const YeetQuad &quad);
+
+#endif
@@ -0,0 +1,166 @@
+//
+//  YeetRectangleTracker.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/8/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetRectangleTracker.h"
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/video/tracking.hpp>
+#include <algorithm>
+#include <utility>
+
+static cv::Point2f blendPoint(const cv::Point2f &previous, const cv::Point2f &measured, float smoothing) {
+  return cv::Point2f(
+    previous.x * smoothing + measured.x * (1 - smoothing),
+    previous.y * smoothing + measured.y * (1 - smoothing)
+  );
+}
+
+YeetRectangleTracker::YeetRectangleTracker(YeetRectangleTrackerOptions options)
+: options_(options), detector_(options.detector) {
+}
+
+void YeetRectangleTracker::reset() {
+  tracks_.clear();
+  previousGray_.release();
+  framesSinceKeyframe_ = 0;
+}
+
+const std::vector<YeetTrackedQuad> &YeetRectangleTracker::process(const cv::Mat &frame) {
+  if (frame.empty()) {
+    return tracks_;
+  }
+
+  cv::cvtColor(frame, gray_, cv::COLOR_RGBA2GRAY);
+
+  const bool sizeChanged = !previousGray_.empty() && previousGray_.size() != gray_.size();
+  if (sizeChanged) {
+    reset();
+  }
+
+  const bool keyframe = previousGray_.empty() || tracks_.empty() || framesSinceKeyframe_ >= options_.keyframeInterval;
+  if (keyframe) {
+    detectKeyframe(frame);
+    framesSinceKeyframe_ = 1;
+  } else {
+    trackFlow();
+    framesSinceKeyframe_++;
+  }
+
+  std::swap(previousGray_, gray_);
+  return tracks_;
+}
+
+void YeetRectangleTracker::smooth(YeetQuad &previous, const YeetQuad &measured) const {
+  const float smoothing = std::max(0.0f, std::min(0.99f, options_.smoothing));
+  previous.topLeft = blendPoint(previous.topLeft, measured.topLeft, smoothing);
+  previous.topRight = blendPoint(previous.topRight, measured.topRight, smoothing);
+  previous.bottomRight = blendPoint(previous.bottomRight, measured.bottomRight, smoothing);
+  previous.bottomLeft = blendPoint(previous.bottomLeft, measured.bottomLeft, smoothing);
+  yeetUpdateQuadBounds(previous);
+}
+
+void YeetRectangleTracker::detectKeyframe(const cv::Mat &frame) {
+  detector_.detect(frame, squares_);
+  yeetQuadsFromSquares(squares_, cv::Mat(), quads_);
+  yeetSuppressQuads(quads_, ranked_, options_.suppression);
+  yeetRefineRankedQuads(gray_, ranked_);
+
+  std::vector<YeetTrackedQuad> tracks;
+  tracks.reserve(ranked_.size());
+  std::vector<bool> matched(tracks_.size(), false);
+
+  // ranked_ is most confident first, so the strongest detection claims a track first.
+  for (const auto &detection : ranked_) {
+    int bestTrack = -1;
+    float bestIoU = options_.matchIoU;
+    for (size_t i = 0; i < tracks_.size(); i++) {
+      if (matched[i]) {
+        continue;
+      }
+
+      const float iou = yeetBoundsIoU(tracks_[i].quad.bounds, detection.quad.bounds);
+      if (iou >= bestIoU) {
+        bestIoU = iou;
+        bestTrack = (int)i;
+      }
+    }
+
+    if (bestTrack >= 0) {
+      matched[bestTrack] = true;
+
+      YeetTrackedQuad track = tracks_[bestTrack];
+      smooth(track.quad, detection.quad);
+      track.measured = detection.quad;
+      track.confidence = detection.confidence;
+      track.age++;
+      track.detected = true;
+      tracks.push_back(track);
+    } else if (detection.confidence >= options_.minConfidence) {
+      YeetTrackedQuad track;
+      track.id = nextID_++;
+      track.quad = detection.quad;
+      track.measured = detection.quad;
+      track.confidence = detection.confidence;
+      track.detected = true;
+      tracks.push_back(track);
+    }
+  }
+
+  // Tracks the detector didn't confirm end here.
+  tracks_ = std::move(tracks);
+}
+
+void YeetRectangleTracker::trackFlow() {
+  previousPoints_.clear();
+  previousPoints_.reserve(tracks_.size() * 4);
+  for (const auto &track : tracks_) {
+    previousPoints_.push_back(track.measured.topLeft);
+    previousPoints_.push_back(track.measured.topRight);
+    previousPoints_.push_back(track.measured.bottomRight);
+    previousPoints_.push_back(track.measured.bottomLeft);
+  }
+
+  cv::calcOpticalFlowPyrLK(
+    previousGray_,
+    gray_,
+    previousPoints_,
+    nextPoints_,
+    status_,
+    error_,
+    cv::Size(options_.flowWindow, options_.flowWindow),
+    options_.flowLevels
+  );
+
+  // A track only survives if all four of its corners were found.
+  size_t kept = 0;
+  for (size_t i = 0; i < tracks_.size(); i++) {
+    const size_t corner = i * 4;
+    if (!status_[corner] || !status_[corner + 1] || !status_[corner + 2] || !status_[corner + 3]) {
+      continue;
+    }
+
+    YeetQuad measured;
+    measured.topLeft = nextPoints_[corner];
+    measured.topRight = nextPoints_[corner + 1];
+    measured.bottomRight = nextPoints_[corner + 2];
+    measured.bottomLeft = nextPoints_[corner + 3];
+    yeetUpdateQuadBounds(measured);
+
+    YeetTrackedQuad &track = tracks_[kept];
+    if (kept != i) {
+      track = tracks_[i];
+    }
+
+    smooth(track.quad, measured);
+    track.measured = measured;
+    track.age++;
+    track.detected = false;
+    kept++;
+  }
+
+  tracks_.resize(kept);
+}
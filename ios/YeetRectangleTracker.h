@@ -0,0 +1,90 @@
+//
+//  YeetRectangleTracker.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/8/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "YeetSquareDetector.h"
+#include "YeetQuadGeometry.h"
+#include "YeetQuadSuppression.h"
+
+struct YeetRectangleTrackerOptions {
+  YeetSquareDetectorOptions detector;
+  YeetQuadSuppressionOptions suppression;
+
+  // Full detection runs on the first frame, then every keyframeInterval frames, and on any frame
+  // after every track was lost. Frames in between only follow the corners with optical flow.
+  int keyframeInterval = 15;
+  // Detections below this confidence don't start new tracks.
+  float minConfidence = 0.5f;
+  // A keyframe detection continues a track when their bounds overlap by at least this much.
+  float matchIoU = 0.3f;
+  // Exponential smoothing of corner positions: 0 follows the measurement exactly, values closer to 1
+  // move more slowly and jitter less.
+  float smoothing = 0.5f;
+  // Optical-flow window size and pyramid levels for cv::calcOpticalFlowPyrLK.
+  int flowWindow = 21;
+  int flowLevels = 3;
+};
+
+struct YeetTrackedQuad {
+  // Stable across frames for as long as the rectangle is tracked.
+  int id = 0;
+  // Smoothed position, for display.
+  YeetQuad quad;
+  // Where detection or optical flow actually put the corners this frame. Flow starts from these,
+  // so smoothing never feeds back into what gets tracked.
+  YeetQuad measured;
+  float confidence = 0;
+  // Frames since the track started.
+  int age = 0;
+  // True when this frame's position came from full detection rather than optical flow.
+  bool detected = false;
+};
+
+// Follows rectangles across video frames on top of YeetSquareDetector.
+//
+// Frames must be RGBA (CV_8UC4) and the same size. Not thread-safe: feed it frames in order from
+// one queue.
+class YeetRectangleTracker {
+public:
+  explicit YeetRectangleTracker(YeetRectangleTrackerOptions options = YeetRectangleTrackerOptions());
+
+  // Returns the tracks for this frame. The reference is valid until the next call.
+  const std::vector<YeetTrackedQuad> &process(const cv::Mat &frame);
+
+  void reset();
+
+  const std::vector<YeetTrackedQuad> &tracks() const { return tracks_; }
+
+private:
+  void detectKeyframe(const cv::Mat &frame);
+  void trackFlow();
+  void smooth(YeetQuad &previous, const YeetQuad &measured) const;
+
+  YeetRectangleTrackerOptions options_;
+  YeetSquareDetector detector_;
+  std::vector<YeetTrackedQuad> tracks_;
+  int nextID_ = 1;
+  int framesSinceKeyframe_ = 0;
+
+  cv::Mat gray_;
+  cv::Mat previousGray_;
+  std::vector<YeetSquare> squares_;
+  std::vector<YeetQuad> quads_;
+  std::vector<YeetRankedQuad> ranked_;
+  std::vector<cv::Point2f> previousPoints_;
+  std::vector<cv::Point2f> nextPoints_;
+  std::vector<uchar> status_;
+  std::vector<float> error_;
+};
+
+#endif
@@ -0,0 +1,260 @@
+//
+//  YeetSaliencyMap.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/12/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetSaliencyMap.h"
+#include <opencv2/imgproc/imgproc.hpp>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+namespace {
+
+// Hou & Zhang's spectral residual: the log amplitude spectrum minus its local average is what's
+// "unexpected" about the image. Transforming just that back (with the original phase) lights up
+// the regions that stand out.
+void yeetSpectralResidual(const cv::Mat &gray, int spectralSize, cv::Size mapSize, cv::Mat &dst) {
+  cv::Mat small;
+  cv::resize(gray, small, cv::Size(spectralSize, spectralSize), 0, 0, cv::INTER_AREA);
+
+  cv::Mat planes[2];
+  small.convertTo(planes[0], CV_32F, 1.0 / 255);
+  planes[1] = cv::Mat::zeros(planes[0].size(), CV_32F);
+
+  cv::Mat spectrum;
+  cv::merge(planes, 2, spectrum);
+  cv::dft(spectrum, spectrum);
+  cv::split(spectrum, planes);
+
+  cv::Mat amplitude, phase, average;
+  cv::cartToPolar(planes[0], planes[1], amplitude, phase);
+  // Flat backgrounds leave whole rows of bins at rounding noise. Their log is far below their
+  // neighbours' local average, so without a floor relative to the spectrum they boost those
+  // neighbours into stripes that cover the whole map.
+  cv::add(amplitude, cv::Scalar::all(1e-3 * cv::mean(amplitude)[0]), amplitude);
+  cv::log(amplitude, amplitude);
+  cv::blur(amplitude, average, cv::Size(3, 3));
+  cv::subtract(amplitude, average, amplitude);
+  cv::exp(amplitude, amplitude);
+
+  cv::polarToCart(amplitude, phase, planes[0], planes[1]);
+  cv::merge(planes, 2, spectrum);
+  cv::dft(spectrum, spectrum, cv::DFT_INVERSE | cv::DFT_SCALE);
+  cv::split(spectrum, planes);
+
+  cv::magnitude(planes[0], planes[1], amplitude);
+  cv::multiply(amplitude, amplitude, amplitude);
+  cv::GaussianBlur(amplitude, amplitude, cv::Size(0, 0), spectralSize / 24.0);
+
+  cv::resize(amplitude, dst, mapSize, 0, 0, cv::INTER_LINEAR);
+  cv::normalize(dst, dst, 0, 1, cv::NORM_MINMAX);
+}
+
+// Fraction of edge pixels around each cell. Spectral residual misses large, busy regions (a
+// screenshot of a tweet); this catches them.
+void yeetEdgeDensity(const cv::Mat &gray, const YeetSaliencyOptions &options, cv::Mat &dst) {
+  cv::Mat edges;
+  cv::Canny(gray, edges, options.edgeLowThreshold, options.edgeHighThreshold);
+  edges.convertTo(dst, CV_32F, 1.0 / 255);
+
+  const int window = std::max(3, (std::max(gray.cols, gray.rows) / 16) | 1);
+  cv::blur(dst, dst, cv::Size(window, window));
+  cv::normalize(dst, dst, 0, 1, cv::NORM_MINMAX);
+}
+
+}
+
+void YeetSaliencyMap::compute(const cv::Mat &image, const std::vector<YeetSaliencyRegion> &regions, cv::Size sourceSize, const YeetSaliencyOptions &options) {
+  map_.release();
+  integral_.release();
+  sourceSize_ = sourceSize.empty() ? image.size() : sourceSize;
+  if (image.empty() || sourceSize_.empty()) {
+    return;
+  }
+
+  const double scale = std::min(1.0, (double)options.mapSize / std::max(image.cols, image.rows));
+  const cv::Size mapSize(std::max(1, cvRound(image.cols * scale)), std::max(1, cvRound(image.rows * scale)));
+  scaleX_ = (double)mapSize.width / sourceSize_.width;
+  scaleY_ = (double)mapSize.height / sourceSize_.height;
+
+  cv::Mat gray;
+  if (image.channels() == 4) {
+    cv::cvtColor(image, gray, cv::COLOR_RGBA2GRAY);
+  } else if (image.channels() == 3) {
+    cv::cvtColor(image, gray, cv::COLOR_RGB2GRAY);
+  } else {
+    gray = image;
+  }
+
+  cv::Mat small;
+  cv::resize(gray, small, mapSize, 0, 0, cv::INTER_AREA);
+
+  cv::Mat spectral, edges;
+  yeetSpectralResidual(gray, options.spectralSize, mapSize, spectral);
+  yeetEdgeDensity(small, options, edges);
+
+  cv::Mat detected = cv::Mat::zeros(mapSize, CV_32F);
+  const double regionScaleX = (double)mapSize.width / image.cols;
+  const double regionScaleY = (double)mapSize.height / image.rows;
+  for (const auto &region : regions) {
+    const int left = cvFloor(region.bounds.x * regionScaleX);
+    const int top = cvFloor(region.bounds.y * regionScaleY);
+    const int right = cvCeil((region.bounds.x + region.bounds.width) * regionScaleX);
+    const int bottom = cvCeil((region.bounds.y + region.bounds.height) * regionScaleY);
+
+    const cv::Rect cells = cv::Rect(left, top, right - left, bottom - top) & cv::Rect(0, 0, mapSize.width, mapSize.height);
+    if (!cells.empty()) {
+      cv::Mat roi = detected(cells);
+      cv::add(roi, cv::Scalar::all(region.weight), roi);
+    }
+  }
+  if (!regions.empty()) {
+    cv::normalize(detected, detected, 0, 1, cv::NORM_MINMAX);
+  }
+
+  spectral.convertTo(map_, CV_32F, options.spectralWeight);
+  cv::scaleAdd(edges, options.edgeWeight, map_, map_);
+  cv::scaleAdd(detected, options.regionWeight, map_, map_);
+  cv::normalize(map_, map_, 0, 1, cv::NORM_MINMAX);
+
+  cv::integral(map_, integral_, CV_64F);
+}
+
+double YeetSaliencyMap::sum(int x, int y, int width, int height) const {
+  const double *top = integral_.ptr<double>(y);
+  const double *bottom = integral_.ptr<double>(y + height);
+  return bottom[x + width] - bottom[x] - top[x + width] + top[x];
+}
+
+cv::Rect YeetSaliencyMap::toMap(const cv::Rect &rect) const {
+  const int left = cvFloor(rect.x * scaleX_);
+  const int top = cvFloor(rect.y * scaleY_);
+  const int right = cvCeil((rect.x + rect.width) * scaleX_);
+  const int bottom = cvCeil((rect.y + rect.height) * scaleY_);
+  return cv::Rect(left, top, right - left, bottom - top) & cv::Rect(0, 0, map_.cols, map_.rows);
+}
+
+double YeetSaliencyMap::coverage(const cv::Rect &rect) const {
+  if (empty()) {
+    return 0;
+  }
+
+  const double total = sum(0, 0, map_.cols, map_.rows);
+  const cv::Rect cells = toMap(rect);
+  if (total <= 0 || cells.empty()) {
+    return 0;
+  }
+
+  return sum(cells.x, cells.y, cells.width, cells.height) / total;
+}
+
+cv::Rect YeetSaliencyMap::bestCrop(double aspectRatio, double zoom) const {
+  const cv::Rect whole(0, 0, sourceSize_.width, sourceSize_.height);
+  if (empty() || aspectRatio <= 0) {
+    return whole;
+  }
+
+  zoom = std::max(0.01, std::min(1.0, zoom));
+
+  double width = sourceSize_.width;
+  double height = width / aspectRatio;
+  if (height > sourceSize_.height) {
+    height = sourceSize_.height;
+    width = height * aspectRatio;
+  }
+
+  const int cropWidth = std::max(1, std::min(sourceSize_.width, cvRound(width * zoom)));
+  const int cropHeight = std::max(1, std::min(sourceSize_.height, cvRound(height * zoom)));
+  const int windowWidth = std::max(1, std::min(map_.cols, cvRound(cropWidth * scaleX_)));
+  const int windowHeight = std::max(1, std::min(map_.rows, cvRound(cropHeight * scaleY_)));
+
+  const int lastX = map_.cols - windowWidth;
+  const int lastY = map_.rows - windowHeight;
+  const double tolerance = 1e-6 * std::max(1.0, sum(0, 0, map_.cols, map_.rows));
+
+  int bestX = 0;
+  int bestY = 0;
+  double bestSum = -1;
+  // Twice the distance to the centered window, so it stays an integer.
+  int bestDistance = INT_MAX;
+
+  for (int y = 0; y <= lastY; y++) {
+    const double *top = integral_.ptr<double>(y);
+    const double *bottom = integral_.ptr<double>(y + windowHeight);
+    const int distanceY = std::abs(2 * y - lastY);
+
+    for (int x = 0; x <= lastX; x++) {
+      const double windowSum = bottom[x + windowWidth] - bottom[x] - top[x + windowWidth] + top[x];
+      const int distance = distanceY + std::abs(2 * x - lastX);
+
+      if (windowSum > bestSum + tolerance || (windowSum >= bestSum - tolerance && distance < bestDistance)) {
+        bestSum = std::max(bestSum, windowSum);
+        bestDistance = distance;
+        bestX = x;
+        bestY = y;
+      }
+    }
+  }
+
+  // Window positions are in whole map cells, so clamp after scaling back up.
+  const int x = std::max(0, std::min(sourceSize_.width - cropWidth, cvRound(bestX / scaleX_)));
+  const int y = std::max(0, std::min(sourceSize_.height - cropHeight, cvRound(bestY / scaleY_)));
+  return cv::Rect(x, y, cropWidth, cropHeight);
+}
+
+YeetSaliencyCache &YeetSaliencyCache::shared() {
+  static YeetSaliencyCache *cache = new YeetSaliencyCache();
+  return *cache;
+}
+
+YeetSaliencyCache::YeetSaliencyCache(size_t capacity)
+: capacity_(std::max<size_t>(1, capacity)) {
+}
+
+std::shared_ptr<const YeetSaliencyMap> YeetSaliencyCache::get(const std::string &assetId) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = index_.find(assetId);
+  if (found == index_.end()) {
+    return nullptr;
+  }
+
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->second;
+}
+
+void YeetSaliencyCache::set(const std::string &assetId, std::shared_ptr<const YeetSaliencyMap> map) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = index_.find(assetId);
+  if (found != index_.end()) {
+    found->second->second = std::move(map);
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return;
+  }
+
+  entries_.emplace_front(assetId, std::move(map));
+  index_[assetId] = entries_.begin();
+
+  if (entries_.size() > capacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+}
+
+void YeetSaliencyCache::remove(const std::string &assetId) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = index_.find(assetId);
+  if (found != index_.end()) {
+    entries_.erase(found->second);
+    index_.erase(found);
+  }
+}
+
+void YeetSaliencyCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  index_.clear();
+}
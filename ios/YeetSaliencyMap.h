@@ -0,0 +1,100 @@
+//
+//  YeetSaliencyMap.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/12/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <opencv2/core/core.hpp>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct YeetSaliencyOptions {
+  // Longest side of the saliency map. Crop queries are linear in map cells, so keep this small.
+  int mapSize = 128;
+  // Spectral residual works on a fixed, small spectrum regardless of the image's aspect ratio.
+  int spectralSize = 64;
+
+  // Canny thresholds for the edge density term.
+  double edgeLowThreshold = 50;
+  double edgeHighThreshold = 150;
+
+  // Each term is normalized to 0...1 before weighting.
+  float spectralWeight = 0.5f;
+  float edgeWeight = 0.3f;
+  float regionWeight = 0.2f;
+};
+
+// Something a detector already found (squares, text lines), in image coordinates.
+struct YeetSaliencyRegion {
+  cv::Rect bounds;
+  float weight = 1;
+};
+
+// A saliency map plus its summed-area table. Computing it is the slow part (tens of ms); after
+// that, crop queries only read the table and are cheap enough to run per layout pass.
+//
+// Immutable once computed, so a shared map can be queried from any thread.
+class YeetSaliencyMap {
+public:
+  // image is CV_8UC4 (RGBA), CV_8UC3 or CV_8UC1, and regions are in its coordinates. It can be a
+  // downscaled copy of the source: crops are reported in sourceSize coordinates (image.size() when empty).
+  void compute(const cv::Mat &image, const std::vector<YeetSaliencyRegion> &regions, cv::Size sourceSize = cv::Size(), const YeetSaliencyOptions &options = YeetSaliencyOptions());
+
+  // The crop with the given aspect ratio (width / height) that holds the most saliency.
+  // zoom = 1 is the largest such crop that fits the image; smaller values zoom in. Ties go to the
+  // crop closest to the center. Returned in source coordinates.
+  cv::Rect bestCrop(double aspectRatio, double zoom = 1) const;
+
+  // Total saliency inside rect (source coordinates), as a fraction of the whole map.
+  double coverage(const cv::Rect &rect) const;
+
+  bool empty() const { return integral_.empty(); }
+  cv::Size sourceSize() const { return sourceSize_; }
+  // CV_32F, 0...1, mapSize on its longest side.
+  const cv::Mat &map() const { return map_; }
+
+private:
+  double sum(int x, int y, int width, int height) const;
+
+  cv::Rect toMap(const cv::Rect &rect) const;
+
+  cv::Size sourceSize_;
+  // Map cells per source pixel.
+  double scaleX_ = 1;
+  double scaleY_ = 1;
+  cv::Mat map_;
+  cv::Mat integral_;
+};
+
+// Saliency maps keyed by asset id, least recently used evicted first.
+class YeetSaliencyCache {
+public:
+  static YeetSaliencyCache &shared();
+
+  explicit YeetSaliencyCache(size_t capacity = 64);
+
+  std::shared_ptr<const YeetSaliencyMap> get(const std::string &assetId);
+  void set(const std::string &assetId, std::shared_ptr<const YeetSaliencyMap> map);
+  void remove(const std::string &assetId);
+  void clear();
+
+private:
+  typedef std::pair<std::string, std::shared_ptr<const YeetSaliencyMap>> Entry;
+
+  size_t capacity_;
+  std::mutex mutex_;
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+#endif
@@ -0,0 +1,192 @@
+//
+//  YeetSquareDetector.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/3/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetSquareDetector.h"
+#include "YeetThresholdKernel.h"
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+
+// Based on http://stackoverflow.com/questions/8667818/opencv-c-obj-c-detecting-a-sheet-of-paper-square-detection
+
+double yeetSquareCornerCosine(cv::Point pt1, cv::Point pt2, cv::Point pt0) {
+  double dx1 = pt1.x - pt0.x;
+  double dy1 = pt1.y - pt0.y;
+  double dx2 = pt2.x - pt0.x;
+  double dy2 = pt2.y - pt0.y;
+  return (dx1*dx2 + dy1*dy2)/sqrt((dx1*dx1 + dy1*dy1)*(dx2*dx2 + dy2*dy2) + 1e-10);
+}
+
+YeetSquareDetector::YeetSquareDetector(YeetSquareDetectorOptions options)
+: options_(options) {
+}
+
+void YeetSquareDetector::detect(const cv::Mat &image, std::vector<YeetSquare> &squares) {
+  squares.clear();
+  if (image.empty() || image.channels() < YeetDetectorPreprocessor::channelCount) {
+    return;
+  }
+
+  if (options_.pyramidScale > 0 && options_.pyramidScale < 1) {
+    detectPyramid(image, squares);
+  } else {
+    detectAtScale(image, options_.minArea, squares);
+  }
+}
+
+void YeetSquareDetector::detect(const YeetDetectorPreprocessor &preprocessed, std::vector<YeetSquare> &squares) {
+  squares.clear();
+  if (preprocessed.empty()) {
+    return;
+  }
+
+  detectPlanes(preprocessed, options_.minArea, squares);
+}
+
+void YeetSquareDetector::detectPyramid(const cv::Mat &image, std::vector<YeetSquare> &squares) {
+  const double scale = options_.pyramidScale;
+  cv::Size size(cvRound(image.cols * scale), cvRound(image.rows * scale));
+  if (size.width < options_.medianBlurSize || size.height < options_.medianBlurSize) {
+    detectAtScale(image, options_.minArea, squares);
+    return;
+  }
+
+  cv::resize(image, downscaled_, size, 0, 0, cv::INTER_AREA);
+
+  std::vector<YeetSquare> candidates;
+  detectAtScale(downscaled_, options_.minArea * scale * scale, candidates);
+  if (candidates.empty()) {
+    return;
+  }
+
+  // Map each candidate back to full resolution, pad it, and merge overlapping regions so no part of
+  // the image is searched twice.
+  const cv::Rect bounds(0, 0, image.cols, image.rows);
+  std::vector<cv::Rect> regions;
+  regions.reserve(candidates.size());
+  for (const auto &candidate : candidates) {
+    cv::Rect rect = cv::boundingRect(candidate);
+    // rect is in downscaled pixels and padding is in full-resolution ones.
+    const int padding = cvCeil(std::max(rect.width, rect.height) / scale * options_.pyramidPadding) + options_.medianBlurSize;
+
+    cv::Rect region(
+      cvFloor(rect.x / scale) - padding,
+      cvFloor(rect.y / scale) - padding,
+      cvCeil(rect.width / scale) + padding * 2,
+      cvCeil(rect.height / scale) + padding * 2
+    );
+    region &= bounds;
+
+    bool merged = true;
+    while (merged) {
+      merged = false;
+      for (auto it = regions.begin(); it != regions.end(); ++it) {
+        if ((*it & region).area() > 0) {
+          region |= *it;
+          regions.erase(it);
+          merged = true;
+          break;
+        }
+      }
+    }
+
+    regions.push_back(region);
+  }
+
+  std::vector<YeetSquare> regionSquares;
+  for (const auto &region : regions) {
+    // The region is a view into image, so nothing is copied until the blur.
+    detectAtScale(image(region), options_.minArea, regionSquares);
+
+    for (auto &square : regionSquares) {
+      for (auto &point : square) {
+        point.x += region.x;
+        point.y += region.y;
+      }
+      squares.push_back(std::move(square));
+    }
+  }
+}
+
+void YeetSquareDetector::detectAtScale(const cv::Mat &image, double minArea, std::vector<YeetSquare> &squares) {
+  squares.clear();
+
+  preprocessor_.process(image, options_.medianBlurSize);
+  detectPlanes(preprocessor_, minArea, squares);
+}
+
+void YeetSquareDetector::detectPlanes(const YeetDetectorPreprocessor &preprocessed, double minArea, std::vector<YeetSquare> &squares) {
+  squares.clear();
+
+  const int levels = options_.thresholdLevels;
+  const int jobCount = YeetDetectorPreprocessor::channelCount * levels;
+  jobSquares_.resize(jobCount);
+  for (auto &job : jobSquares_) {
+    job.clear();
+  }
+
+  thresholds_.resize(levels);
+  for (int l = 0; l < levels; l++) {
+    thresholds_[l] = (uchar)((l + 1) * 255 / levels);
+  }
+
+  // One stripe per worker, so each worker allocates its scratch once instead of once per job.
+  const double stripes = std::max(1, std::min(levels, cv::getNumThreads()));
+
+  // Channels go one at a time so only one channel's worth of binary planes is alive at once.
+  for (int c = 0; c < YeetDetectorPreprocessor::channelCount; c++) {
+    yeetMultiThreshold(preprocessed.plane(c), thresholds_, levelPlanes_);
+
+    cv::parallel_for_(cv::Range(0, levels), [this, c, levels, minArea](const cv::Range &range) {
+      Scratch scratch;
+      for (int l = range.start; l < range.end; l++) {
+        detectLevel(levelPlanes_[l], minArea, scratch, jobSquares_[c * levels + l]);
+      }
+    }, stripes);
+  }
+
+  for (auto &job : jobSquares_) {
+    squares.insert(squares.end(), job.begin(), job.end());
+  }
+}
+
+void YeetSquareDetector::detectLevel(cv::Mat &binary, double minArea, Scratch &scratch, std::vector<YeetSquare> &squares) const {
+  cv::findContours(binary, scratch.contours, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+
+  for (const auto &contour : scratch.contours) {
+    // approxPolyDP keeps a subset of the contour's points, so the quad can't be bigger than the
+    // contour's bounding box. Most contours at every level are specks, and this skips them cheaply.
+    if (contour.size() < 4 || cv::boundingRect(contour).area() <= minArea) {
+      continue;
+    }
+
+    // approximate contour with accuracy proportional
+    // to the contour perimeter
+    cv::approxPolyDP(contour, scratch.approx, cv::arcLength(contour, true) * options_.approximationAccuracy, true);
+
+    // Note: absolute value of an area is used because
+    // area may be positive or negative - in accordance with the
+    // contour orientation
+    if (scratch.approx.size() != 4 ||
+        fabs(cv::contourArea(scratch.approx)) <= minArea ||
+        !cv::isContourConvex(scratch.approx)) {
+      continue;
+    }
+
+    double maxCosine = 0;
+    for (int j = 2; j < 5; j++) {
+      double cosine = fabs(yeetSquareCornerCosine(scratch.approx[j%4], scratch.approx[j-2], scratch.approx[j-1]));
+      maxCosine = std::max(maxCosine, cosine);
+    }
+
+    if (maxCosine < options_.maxCosine) {
+      squares.push_back(scratch.approx);
+    }
+  }
+}
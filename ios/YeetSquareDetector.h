@@ -0,0 +1,77 @@
+//
+//  YeetSquareDetector.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/3/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "YeetDetectorPreprocessor.h"
+
+typedef std::vector<cv::Point> YeetSquare;
+
+struct YeetSquareDetectorOptions {
+  // Each color plane is binarized at levels (l + 1) * 255 / thresholdLevels.
+  int thresholdLevels = 10;
+  int medianBlurSize = 5;
+  // approxPolyDP epsilon, as a fraction of the contour's perimeter.
+  double approximationAccuracy = 0.02;
+  double minArea = 1000;
+  // Largest |cos| allowed between two edges meeting at a corner.
+  double maxCosine = 0.3;
+
+  // Coarse-to-fine mode. Below 1, candidates are found on the image resized by this factor, then
+  // only the (padded) regions around them are searched again at full resolution. 1 disables it.
+  double pyramidScale = 1;
+  // Padding around each candidate's bounding box, as a fraction of its longer side.
+  double pyramidPadding = 0.1;
+};
+
+// Finds convex quadrilaterals with near-right angles in an RGB(A) image.
+//
+// Every (channel, threshold level) pair is an independent findContours + approxPolyDP job. Each
+// channel is binarized at every level in one pass (yeetMultiThreshold), then its levels run with
+// cv::parallel_for_ (GCD on iOS). Each stripe keeps its own scratch buffers, and results are
+// concatenated in (channel, level) order, so the output matches running the jobs one at a time.
+//
+// Not safe to call detect() on the same instance from multiple threads.
+class YeetSquareDetector {
+public:
+  explicit YeetSquareDetector(YeetSquareDetectorOptions options = YeetSquareDetectorOptions());
+
+  void detect(const cv::Mat &image, std::vector<YeetSquare> &squares);
+  // Detects on planes someone else already blurred and split, so the caller can share them with
+  // YeetTextDetector. Always runs at the planes' size, since pyramidScale needs the original image.
+  void detect(const YeetDetectorPreprocessor &preprocessed, std::vector<YeetSquare> &squares);
+
+  const YeetSquareDetectorOptions &options() const { return options_; }
+
+private:
+  struct Scratch {
+    std::vector<std::vector<cv::Point>> contours;
+    YeetSquare approx;
+  };
+
+  void detectAtScale(const cv::Mat &image, double minArea, std::vector<YeetSquare> &squares);
+  void detectPlanes(const YeetDetectorPreprocessor &preprocessed, double minArea, std::vector<YeetSquare> &squares);
+  void detectPyramid(const cv::Mat &image, std::vector<YeetSquare> &squares);
+  void detectLevel(cv::Mat &binary, double minArea, Scratch &scratch, std::vector<YeetSquare> &squares) const;
+
+  YeetSquareDetectorOptions options_;
+  YeetDetectorPreprocessor preprocessor_;
+  cv::Mat downscaled_;
+  std::vector<uchar> thresholds_;
+  std::vector<cv::Mat> levelPlanes_;
+  std::vector<std::vector<YeetSquare>> jobSquares_;
+};
+
+// Cosine of the angle between the vectors pt0 -> pt1 and pt0 -> pt2.
+double yeetSquareCornerCosine(cv::Point pt1, cv::Point pt2, cv::Point pt0);
+
+#endif
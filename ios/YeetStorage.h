@@ -0,0 +1,47 @@
+//
+//  YeetStorage.h
+//  yeet
+//
+//  Created by Jarred WSumner on 2/26/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#ifdef __cplusplus
+
+#import <jsi/jsi.h>
+
+using namespace facebook;
+
+@class MMKV;
+
+enum class YeetStorageType {
+  unknown,
+  string,
+  number,
+  boolean,
+};
+
+// Typed MMKV binding for the YeetJSI storage functions.
+// Values go straight between jsi::Value and MMKV without the generic
+// convertJSIValueToObjCObject walker, and the type string is parsed once per call.
+class YeetStorage {
+public:
+  YeetStorage(MMKV *mmkv);
+
+  static YeetStorageType typeFromValue(jsi::Runtime &runtime, const jsi::Value &type);
+
+  jsi::Value getItem(jsi::Runtime &runtime, const jsi::String &key, YeetStorageType type);
+  bool setItem(jsi::Runtime &runtime, const jsi::String &key, const jsi::Value &value, YeetStorageType type);
+  bool removeItem(jsi::Runtime &runtime, const jsi::String &key);
+
+  // Batched variants, so a screen's worth of keys costs one JS -> native call.
+  // types is either one type string for every key or an array parallel to keys.
+  jsi::Array multiGet(jsi::Runtime &runtime, const jsi::Array &keys, const jsi::Value &types);
+  // entries is an array of [key, value, type] tuples.
+  bool multiSet(jsi::Runtime &runtime, const jsi::Array &entries);
+
+private:
+  MMKV *mmkv_;
+};
+
+#endif
@@ -0,0 +1,189 @@
+//
+//  YeetStorage.mm
+//  yeet
+//
+//  Created by Jarred WSumner on 2/26/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#import "YeetStorage.h"
+#import <MMKV/MMKV.h>
+
+// Reads don't retain the key, so we can point an NSString at the utf8 buffer instead of copying it.
+// Don't use this for writes: MMKV stores the key in a dictionary, and -copy on this string returns self.
+static NSString *borrowedKey(const std::string &utf8) {
+  return [[NSString alloc] initWithBytesNoCopy:(void *)utf8.data() length:utf8.size() encoding:NSUTF8StringEncoding freeWhenDone:NO];
+}
+
+static NSString *copiedKey(const std::string &utf8) {
+  return [[NSString alloc] initWithBytes:utf8.data() length:utf8.size() encoding:NSUTF8StringEncoding];
+}
+
+YeetStorage::YeetStorage(MMKV *mmkv)
+: mmkv_(mmkv) {
+}
+
+YeetStorageType YeetStorage::typeFromValue(jsi::Runtime &runtime, const jsi::Value &type) {
+  if (!type.isString()) {
+    return YeetStorageType::unknown;
+  }
+
+  auto name = type.getString(runtime).utf8(runtime);
+
+  if (name == "string") {
+    return YeetStorageType::string;
+  } else if (name == "number") {
+    return YeetStorageType::number;
+  } else if (name == "bool") {
+    return YeetStorageType::boolean;
+  } else {
+    return YeetStorageType::unknown;
+  }
+}
+
+jsi::Value YeetStorage::getItem(jsi::Runtime &runtime, const jsi::String &key, YeetStorageType type) {
+  auto utf8Key = key.utf8(runtime);
+
+  if (utf8Key.empty()) {
+    return jsi::Value::null();
+  }
+
+  NSString *_key = borrowedKey(utf8Key);
+
+  switch (type) {
+    case YeetStorageType::string: {
+      NSString *value = [mmkv_ getStringForKey:_key];
+      const char *utf8Value = [value UTF8String];
+
+      if (utf8Value) {
+        return jsi::String::createFromUtf8(runtime, (const uint8_t *)utf8Value, strlen(utf8Value));
+      } else {
+        return jsi::Value::null();
+      }
+    }
+
+    case YeetStorageType::number: {
+      if ([mmkv_ containsKey:_key]) {
+        return jsi::Value([mmkv_ getDoubleForKey:_key]);
+      } else {
+        return jsi::Value::null();
+      }
+    }
+
+    case YeetStorageType::boolean: {
+      return jsi::Value((bool)[mmkv_ getBoolForKey:_key defaultValue:NO]);
+    }
+
+    case YeetStorageType::unknown: {
+      return jsi::Value::null();
+    }
+  }
+}
+
+bool YeetStorage::setItem(jsi::Runtime &runtime, const jsi::String &key, const jsi::Value &value, YeetStorageType type) {
+  auto utf8Key = key.utf8(runtime);
+
+  if (utf8Key.empty()) {
+    return false;
+  }
+
+  NSString *_key = copiedKey(utf8Key);
+
+  switch (type) {
+    case YeetStorageType::string: {
+      if (!value.isString()) {
+        return false;
+      }
+
+      auto utf8Value = value.getString(runtime).utf8(runtime);
+      if (utf8Value.empty()) {
+        return false;
+      }
+
+      NSString *_value = [[NSString alloc] initWithBytes:utf8Value.data() length:utf8Value.size() encoding:NSUTF8StringEncoding];
+      return [mmkv_ setString:_value forKey:_key];
+    }
+
+    case YeetStorageType::number: {
+      if (!value.isNumber()) {
+        return false;
+      }
+
+      return [mmkv_ setDouble:value.getNumber() forKey:_key];
+    }
+
+    case YeetStorageType::boolean: {
+      // Storage.tsx stores booleans as 1/0.
+      bool _value = value.isBool() ? value.getBool() : (value.isNumber() && value.getNumber() != 0);
+      return [mmkv_ setBool:_value forKey:_key];
+    }
+
+    case YeetStorageType::unknown: {
+      return false;
+    }
+  }
+}
+
+bool YeetStorage::removeItem(jsi::Runtime &runtime, const jsi::String &key) {
+  auto utf8Key = key.utf8(runtime);
+
+  if (utf8Key.empty()) {
+    return false;
+  }
+
+  [mmkv_ removeValueForKey:copiedKey(utf8Key)];
+  return true;
+}
+
+jsi::Array YeetStorage::multiGet(jsi::Runtime &runtime, const jsi::Array &keys, const jsi::Value &types) {
+  size_t length = keys.size(runtime);
+  jsi::Array results = jsi::Array(runtime, length);
+
+  YeetStorageType sharedType = YeetStorage::typeFromValue(runtime, types);
+  bool hasTypeArray = types.isObject() && types.getObject(runtime).isArray(runtime);
+  jsi::Array typeArray = hasTypeArray ? types.getObject(runtime).getArray(runtime) : jsi::Array(runtime, 0);
+
+  for (size_t i = 0; i < length; i++) {
+    jsi::Value key = keys.getValueAtIndex(runtime, i);
+
+    if (!key.isString()) {
+      results.setValueAtIndex(runtime, i, jsi::Value::null());
+      continue;
+    }
+
+    YeetStorageType type = hasTypeArray ? YeetStorage::typeFromValue(runtime, typeArray.getValueAtIndex(runtime, i)) : sharedType;
+    results.setValueAtIndex(runtime, i, getItem(runtime, key.getString(runtime), type));
+  }
+
+  return results;
+}
+
+// MMKV 1.0.24 has no batch write. That's fine: every set appends one record to the mmap'd file
+// under MMKV's lock, and nothing is flushed to disk per call. A batch would take the same lock and
+// append the same records, so the win here is one JSI call instead of one per key.
+bool YeetStorage::multiSet(jsi::Runtime &runtime, const jsi::Array &entries) {
+  size_t length = entries.size(runtime);
+  bool didSetAll = true;
+
+  for (size_t i = 0; i < length; i++) {
+    jsi::Value entry = entries.getValueAtIndex(runtime, i);
+
+    if (!entry.isObject() || !entry.getObject(runtime).isArray(runtime)) {
+      didSetAll = false;
+      continue;
+    }
+
+    jsi::Array tuple = entry.getObject(runtime).getArray(runtime);
+    jsi::Value key = tuple.getValueAtIndex(runtime, 0);
+
+    if (!key.isString()) {
+      didSetAll = false;
+      continue;
+    }
+
+    YeetStorageType type = YeetStorage::typeFromValue(runtime, tuple.getValueAtIndex(runtime, 2));
+    didSetAll = setItem(runtime, key.getString(runtime), tuple.getValueAtIndex(runtime, 1), type) && didSetAll;
+  }
+
+  return didSetAll;
+}
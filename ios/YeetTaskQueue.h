@@ -0,0 +1,27 @@
+//
+//  YeetTaskQueue.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/9/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, YeetTaskQueuePriority) {
+  YeetTaskQueuePriorityInteractive = 0,
+  YeetTaskQueuePriorityPrefetch = 1,
+  YeetTaskQueuePriorityBackground = 2,
+};
+
+// Objective-C/Swift entry point to YeetTaskScheduler::shared().
+@interface YeetTaskQueue : NSObject
+
+// Returns a block that cancels the task if it hasn't started yet. Calling it afterwards does nothing.
++ (dispatch_block_t)schedule:(YeetTaskQueuePriority)priority block:(dispatch_block_t)block NS_SWIFT_NAME(schedule(_:block:));
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,28 @@
+//
+//  YeetTaskQueue.mm
+//  yeet
+//
+//  Created by Jarred WSumner on 3/9/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#import "YeetTaskQueue.h"
+#include "YeetTaskScheduler.h"
+
+@implementation YeetTaskQueue
+
++ (dispatch_block_t)schedule:(YeetTaskQueuePriority)priority block:(dispatch_block_t)block
+{
+  YeetCancellationToken token;
+  YeetTaskScheduler::shared().schedule(static_cast<YeetTaskPriority>(priority), [block]() {
+    @autoreleasepool {
+      block();
+    }
+  }, token);
+
+  return ^{
+    token.cancel();
+  };
+}
+
+@end
@@ -0,0 +1,160 @@
+//
+//  YeetTaskScheduler.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/9/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetTaskScheduler.h"
+#include <algorithm>
+
+// Which scheduler (if any) the current thread is a worker of, so schedule() can use its deque.
+static thread_local YeetTaskScheduler *currentScheduler = nullptr;
+static thread_local size_t currentWorker = 0;
+
+size_t YeetTaskScheduler::defaultThreadCount() {
+  // Leave a core for the main and JS threads.
+  const unsigned int cores = std::thread::hardware_concurrency();
+  return std::max(2u, cores > 1 ? cores - 1 : 1u);
+}
+
+YeetTaskScheduler &YeetTaskScheduler::shared() {
+  static YeetTaskScheduler *scheduler = new YeetTaskScheduler();
+  return *scheduler;
+}
+
+YeetTaskScheduler::YeetTaskScheduler(size_t threadCount)
+: pending_(0), pendingInteractive_(0), stopping_(false) {
+  threadCount = std::max<size_t>(1, threadCount);
+
+  local_.reserve(threadCount);
+  for (size_t i = 0; i < threadCount; i++) {
+    local_.emplace_back(new Lanes());
+  }
+
+  workers_.reserve(threadCount);
+  for (size_t i = 0; i < threadCount; i++) {
+    workers_.emplace_back([this, i]() {
+      runWorker(i);
+    });
+  }
+}
+
+YeetTaskScheduler::~YeetTaskScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  wakeReserved_.notify_all();
+
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void YeetTaskScheduler::schedule(YeetTaskPriority priority, Task task, YeetCancellationToken token) {
+  if (!task || token.isCancelled()) {
+    return;
+  }
+
+  const int lane = static_cast<int>(priority);
+
+  // Count the job before it's visible. A worker can take it as soon as the lane's mutex is
+  // released, and its fetch_sub must never run ahead of these or the counters wrap around.
+  pending_.fetch_add(1);
+  if (lane == 0) {
+    pendingInteractive_.fetch_add(1);
+  }
+
+  Lanes &lanes = currentScheduler == this ? *local_[currentWorker] : injection_;
+  {
+    std::lock_guard<std::mutex> lock(lanes.mutex);
+    lanes.lanes[lane].push_back(Job{std::move(task), std::move(token)});
+  }
+
+  // Workers check pending_ under sleepMutex_ before they wait. Taking it once the job is pushed
+  // means any worker that checked before the push is already waiting by the time we notify.
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+  }
+  wake_.notify_one();
+  if (lane == 0) {
+    wakeReserved_.notify_one();
+  }
+}
+
+bool YeetTaskScheduler::takeJob(size_t worker, Job &job, int &lane) {
+  const int lanes = isReserved(worker) ? 1 : laneCount;
+  for (lane = 0; lane < lanes; lane++) {
+    {
+      Lanes &own = *local_[worker];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.lanes[lane].empty()) {
+        job = std::move(own.lanes[lane].back());
+        own.lanes[lane].pop_back();
+        return true;
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(injection_.mutex);
+      if (!injection_.lanes[lane].empty()) {
+        job = std::move(injection_.lanes[lane].front());
+        injection_.lanes[lane].pop_front();
+        return true;
+      }
+    }
+
+    // Start stealing from the next worker over so thieves spread out instead of all hitting worker 0.
+    const size_t count = local_.size();
+    for (size_t offset = 1; offset < count; offset++) {
+      Lanes &victim = *local_[(worker + offset) % count];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.lanes[lane].empty()) {
+        job = std::move(victim.lanes[lane].front());
+        victim.lanes[lane].pop_front();
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+void YeetTaskScheduler::runWorker(size_t worker) {
+  currentScheduler = this;
+  currentWorker = worker;
+
+  const bool reserved = isReserved(worker);
+  std::atomic<size_t> &pending = reserved ? pendingInteractive_ : pending_;
+  std::condition_variable &wake = reserved ? wakeReserved_ : wake_;
+
+  Job job;
+  int lane = 0;
+  while (true) {
+    if (takeJob(worker, job, lane)) {
+      pending_.fetch_sub(1);
+      if (lane == 0) {
+        pendingInteractive_.fetch_sub(1);
+      }
+
+      if (!job.token.isCancelled()) {
+        job.task();
+      }
+
+      job = Job();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    wake.wait(lock, [this, &pending]() {
+      return stopping_ || pending.load() > 0;
+    });
+
+    if (stopping_ && pending.load() == 0) {
+      return;
+    }
+  }
+}
@@ -0,0 +1,107 @@
+//
+//  YeetTaskScheduler.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/9/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Lanes are drained strictly in this order: a worker only runs prefetch work when no interactive
+// work is queued anywhere, and only runs background work when neither is. Priorities only apply
+// when a worker picks its next task, so with more than one worker, worker 0 only ever runs
+// interactive work. Long background tasks can't occupy every thread that way.
+enum class YeetTaskPriority : int {
+  interactive = 0,
+  prefetch = 1,
+  background = 2,
+};
+
+// Shared flag between whoever scheduled a task and the task itself. Copies refer to the same flag.
+//
+// A task whose token is cancelled before a worker picks it up is dropped without running. Long
+// tasks can also capture the token and check isCancelled() themselves.
+class YeetCancellationToken {
+public:
+  YeetCancellationToken() : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+
+  void cancel() const { cancelled_->store(true, std::memory_order_relaxed); }
+  bool isCancelled() const { return cancelled_->load(std::memory_order_relaxed); }
+
+private:
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+// A fixed-size pool of worker threads for native image work (decoding, detection, caching).
+//
+// Each worker has its own deque per lane. Tasks scheduled from a worker go to the back of that
+// worker's deque and it pops from the back (newest first), so work a task fans out stays on the
+// same core. Tasks scheduled from any other thread go to a shared injection queue. Idle workers
+// take from their own deque, then the injection queue, then steal the oldest task from another
+// worker, checking every lane in priority order before moving on to the next lane.
+class YeetTaskScheduler {
+public:
+  using Task = std::function<void()>;
+
+  explicit YeetTaskScheduler(size_t threadCount = defaultThreadCount());
+
+  // Runs everything still queued, then joins the workers.
+  ~YeetTaskScheduler();
+
+  // Created on first use and never destroyed, so tasks can still be scheduled during exit.
+  static YeetTaskScheduler &shared();
+  static size_t defaultThreadCount();
+
+  void schedule(YeetTaskPriority priority, Task task, YeetCancellationToken token = YeetCancellationToken());
+
+  size_t threadCount() const { return workers_.size(); }
+
+  // Tasks scheduled but not taken by a worker yet, in every lane and in the interactive one. Only
+  // a snapshot, for tests and diagnostics.
+  size_t pendingCount() const { return pending_.load(); }
+  size_t pendingInteractiveCount() const { return pendingInteractive_.load(); }
+
+private:
+  static const int laneCount = 3;
+
+  struct Job {
+    Task task;
+    YeetCancellationToken token;
+  };
+
+  struct Lanes {
+    std::mutex mutex;
+    std::deque<Job> lanes[laneCount];
+  };
+
+  bool takeJob(size_t worker, Job &job, int &lane);
+  void runWorker(size_t worker);
+  bool isReserved(size_t worker) const { return worker == 0 && workers_.size() > 1; }
+
+  std::vector<std::unique_ptr<Lanes>> local_;
+  Lanes injection_;
+  std::vector<std::thread> workers_;
+
+  std::mutex sleepMutex_;
+  std::condition_variable wake_;
+  // The reserved worker sleeps on its own condition so a notify_one for other work can't land on
+  // it and get lost.
+  std::condition_variable wakeReserved_;
+  std::atomic<size_t> pending_;
+  std::atomic<size_t> pendingInteractive_;
+  std::atomic<bool> stopping_;
+};
+
+#endif
@@ -0,0 +1,177 @@
+//
+//  YeetTextDetector.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/10/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetTextDetector.h"
+#include <opencv2/core/utility.hpp>
+#include <opencv2/features2d.hpp>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+struct DisjointSet {
+  std::vector<int> parents;
+
+  explicit DisjointSet(size_t count) : parents(count) {
+    std::iota(parents.begin(), parents.end(), 0);
+  }
+
+  int find(int index) {
+    while (parents[index] != index) {
+      parents[index] = parents[parents[index]];
+      index = parents[index];
+    }
+    return index;
+  }
+
+  void join(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a != b) {
+      parents[std::max(a, b)] = std::min(a, b);
+    }
+  }
+};
+
+}
+
+YeetTextDetector::YeetTextDetector(YeetTextDetectorOptions options)
+: options_(options) {
+}
+
+bool YeetTextDetector::isCharacter(const std::vector<cv::Point> &region, const cv::Rect &bounds) const {
+  if (bounds.height < options_.minCharacterHeight) {
+    return false;
+  }
+
+  const double aspect = (double)std::max(bounds.width, bounds.height) / std::max(1, std::min(bounds.width, bounds.height));
+  if (aspect > options_.maxCharacterAspect) {
+    return false;
+  }
+
+  const double fill = (double)region.size() / std::max(1, bounds.area());
+  return fill >= options_.minFill && fill <= options_.maxFill;
+}
+
+void YeetTextDetector::detect(const cv::Mat &image, std::vector<YeetTextLine> &lines) {
+  lines.clear();
+  if (image.empty() || image.channels() < YeetDetectorPreprocessor::channelCount) {
+    return;
+  }
+
+  preprocessor_.process(image, options_.medianBlurSize);
+  detect(preprocessor_, lines);
+}
+
+void YeetTextDetector::detect(const YeetDetectorPreprocessor &preprocessed, std::vector<YeetTextLine> &lines) {
+  lines.clear();
+  if (preprocessed.empty()) {
+    return;
+  }
+
+  const int maxArea = std::max(options_.minCharacterArea + 1, (int)(preprocessed.plane(0).total() * options_.maxAreaFraction));
+  channelCharacters_.resize(YeetDetectorPreprocessor::channelCount);
+
+  cv::parallel_for_(cv::Range(0, YeetDetectorPreprocessor::channelCount), [this, &preprocessed, maxArea](const cv::Range &range) {
+    // cv::MSER keeps state while detecting, so every stripe gets its own.
+    cv::Ptr<cv::MSER> mser = cv::MSER::create(options_.mserDelta, options_.minCharacterArea, maxArea);
+    std::vector<std::vector<cv::Point>> regions;
+    std::vector<cv::Rect> bounds;
+
+    for (int c = range.start; c < range.end; c++) {
+      std::vector<cv::Rect> &characters = channelCharacters_[c];
+      characters.clear();
+
+      mser->detectRegions(preprocessed.plane(c), regions, bounds);
+      for (size_t i = 0; i < regions.size(); i++) {
+        if (isCharacter(regions[i], bounds[i])) {
+          characters.push_back(bounds[i]);
+        }
+      }
+    }
+  });
+
+  characters_.clear();
+  for (const auto &characters : channelCharacters_) {
+    characters_.insert(characters_.end(), characters.begin(), characters.end());
+  }
+
+  groupLines(lines);
+}
+
+void YeetTextDetector::groupLines(std::vector<YeetTextLine> &lines) {
+  std::sort(characters_.begin(), characters_.end(), [](const cv::Rect &a, const cv::Rect &b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+  });
+
+  // The same glyph shows up once per channel (and often once per polarity), so candidates that
+  // mostly cover each other count as one character. Only each other: a letter inside a bigger
+  // region (its outline, or its whole word) is still a letter.
+  const size_t count = characters_.size();
+  DisjointSet lineSets(count);
+  std::vector<bool> duplicate(count, false);
+
+  for (size_t i = 0; i < count; i++) {
+    const cv::Rect &a = characters_[i];
+    const int maxGap = (int)(a.height * options_.maxGapRatio * options_.maxHeightRatio);
+
+    // Sorted by x, so once b starts past a's reach nothing later can join it either.
+    for (size_t j = i + 1; j < count && characters_[j].x <= a.x + a.width + maxGap; j++) {
+      const cv::Rect &b = characters_[j];
+
+      const int shorter = std::min(a.height, b.height);
+      const int taller = std::max(a.height, b.height);
+      if (taller > shorter * options_.maxHeightRatio) {
+        continue;
+      }
+
+      const int overlap = std::min(a.y + a.height, b.y + b.height) - std::max(a.y, b.y);
+      if (overlap < shorter * options_.minVerticalOverlap) {
+        continue;
+      }
+
+      const int gap = b.x - (a.x + a.width);
+      if (gap > taller * options_.maxGapRatio) {
+        continue;
+      }
+
+      const int intersection = (a & b).area();
+      if (!duplicate[j] && intersection > 0.8 * std::max(a.area(), b.area())) {
+        duplicate[j] = true;
+      }
+
+      lineSets.join((int)i, (int)j);
+    }
+  }
+
+  std::vector<int> lineIndex(count, -1);
+  for (size_t i = 0; i < count; i++) {
+    const int root = lineSets.find((int)i);
+    if (lineIndex[root] < 0) {
+      lineIndex[root] = (int)lines.size();
+      YeetTextLine line;
+      line.bounds = characters_[i];
+      lines.push_back(line);
+    }
+
+    YeetTextLine &line = lines[lineIndex[root]];
+    line.bounds |= characters_[i];
+    if (!duplicate[i]) {
+      line.characterCount++;
+    }
+  }
+
+  // Captions are wider than they are tall. Lone glyphs and vertical strips aren't lines.
+  lines.erase(std::remove_if(lines.begin(), lines.end(), [this](const YeetTextLine &line) {
+    return line.characterCount < options_.minCharactersPerLine || line.bounds.width < line.bounds.height;
+  }), lines.end());
+
+  std::sort(lines.begin(), lines.end(), [](const YeetTextLine &a, const YeetTextLine &b) {
+    return a.bounds.y < b.bounds.y || (a.bounds.y == b.bounds.y && a.bounds.x < b.bounds.x);
+  });
+}
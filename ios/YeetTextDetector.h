@@ -0,0 +1,76 @@
+//
+//  YeetTextDetector.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/10/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+#include "YeetDetectorPreprocessor.h"
+
+struct YeetTextDetectorOptions {
+  // Smaller than the square detector's: a 5px median blur eats thin caption strokes.
+  int medianBlurSize = 3;
+
+  // cv::MSER parameters. maxAreaFraction caps a character at this fraction of the image.
+  int mserDelta = 5;
+  int minCharacterArea = 30;
+  double maxAreaFraction = 0.02;
+
+  // Character candidate filters.
+  int minCharacterHeight = 8;
+  double maxCharacterAspect = 8;
+  // Region pixels / bounding box pixels. Blobs and boxes fill too much, noise too little.
+  double minFill = 0.1;
+  double maxFill = 0.95;
+
+  // Two characters join the same line when they overlap vertically by at least this fraction of the
+  // shorter one, their heights are within this ratio, and the horizontal gap is at most this many
+  // times the taller height.
+  double minVerticalOverlap = 0.5;
+  double maxHeightRatio = 2;
+  double maxGapRatio = 1.2;
+
+  int minCharactersPerLine = 3;
+};
+
+struct YeetTextLine {
+  cv::Rect bounds;
+  // Distinct character candidates grouped into this line, after merging duplicates across channels.
+  int characterCount = 0;
+};
+
+// Finds lines of text (meme captions, mostly) with MSER.
+//
+// Uses the same blur + channel split as YeetSquareDetector. MSER runs on each channel plane in
+// parallel, looking for both dark-on-light and light-on-dark regions. Regions that are shaped
+// like characters are grouped into lines with union-find over a sweep sorted by x. Lines are
+// returned top to bottom.
+//
+// Not safe to call detect() on the same instance from multiple threads.
+class YeetTextDetector {
+public:
+  explicit YeetTextDetector(YeetTextDetectorOptions options = YeetTextDetectorOptions());
+
+  void detect(const cv::Mat &image, std::vector<YeetTextLine> &lines);
+  // Detects on planes someone else already blurred and split, so the caller can share them with
+  // YeetSquareDetector. medianBlurSize is ignored.
+  void detect(const YeetDetectorPreprocessor &preprocessed, std::vector<YeetTextLine> &lines);
+
+private:
+  bool isCharacter(const std::vector<cv::Point> &region, const cv::Rect &bounds) const;
+  void groupLines(std::vector<YeetTextLine> &lines);
+
+  YeetTextDetectorOptions options_;
+  YeetDetectorPreprocessor preprocessor_;
+  std::vector<std::vector<cv::Rect>> channelCharacters_;
+  std::vector<cv::Rect> characters_;
+};
+
+#endif
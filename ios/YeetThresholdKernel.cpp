@@ -0,0 +1,85 @@
+//
+//  YeetThresholdKernel.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/4/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetThresholdKernel.h"
+#include <opencv2/core/utility.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+
+// Levels are compared in batches of this many, so a batch's splatted thresholds fit in registers
+// next to the pixels. The default detector uses 10 levels, which is one batch.
+static const int YeetThresholdBatchSize = 16;
+
+struct YeetThresholdBatch {
+  int count = 0;
+  const uchar *thresholds = nullptr;
+#if CV_SIMD128
+  cv::v_uint8x16 vectors[YeetThresholdBatchSize];
+#endif
+};
+
+static void yeetMultiThresholdRow(const uchar *src, int width, const YeetThresholdBatch &batch, uchar *const *dst) {
+  const int levels = batch.count;
+  int x = 0;
+
+#if CV_SIMD128
+  const int lanes = cv::v_uint8x16::nlanes;
+  for (; x <= width - lanes; x += lanes) {
+    cv::v_uint8x16 pixels = cv::v_load(src + x);
+    for (int l = 0; l < levels; l++) {
+      // Unsigned compares give 0xFF/0x00 lanes, which is already 255/0.
+      cv::v_store(dst[l] + x, pixels >= batch.vectors[l]);
+    }
+  }
+#endif
+
+  for (; x < width; x++) {
+    const uchar pixel = src[x];
+    for (int l = 0; l < levels; l++) {
+      dst[l][x] = pixel >= batch.thresholds[l] ? 255 : 0;
+    }
+  }
+}
+
+void yeetMultiThreshold(const cv::Mat &src, const std::vector<uchar> &thresholds, std::vector<cv::Mat> &dst) {
+  CV_Assert(src.type() == CV_8UC1);
+
+  const int levels = (int)thresholds.size();
+  dst.resize(levels);
+  for (auto &plane : dst) {
+    plane.create(src.rows, src.cols, CV_8UC1);
+  }
+
+  if (levels == 0 || src.empty()) {
+    return;
+  }
+
+  cv::parallel_for_(cv::Range(0, src.rows), [&src, &thresholds, &dst, levels](const cv::Range &range) {
+    // Splatted once per stripe, not once per row.
+    YeetThresholdBatch batch;
+    uchar *rows[YeetThresholdBatchSize];
+
+    for (int first = 0; first < levels; first += YeetThresholdBatchSize) {
+      batch.count = std::min(YeetThresholdBatchSize, levels - first);
+      batch.thresholds = thresholds.data() + first;
+#if CV_SIMD128
+      for (int l = 0; l < batch.count; l++) {
+        batch.vectors[l] = cv::v_setall_u8(batch.thresholds[l]);
+      }
+#endif
+
+      for (int y = range.start; y < range.end; y++) {
+        for (int l = 0; l < batch.count; l++) {
+          rows[l] = dst[first + l].ptr<uchar>(y);
+        }
+
+        yeetMultiThresholdRow(src.ptr<uchar>(y), src.cols, batch, rows);
+      }
+    }
+  });
+}
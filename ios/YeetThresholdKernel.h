@@ -0,0 +1,26 @@
+//
+//  YeetThresholdKernel.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/4/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+
+// Binarizes an 8-bit plane at several levels in one pass:
+//
+//   dst[i] = src >= thresholds[i] ? 255 : 0
+//
+// Each row of src is loaded once per 16 levels, then compared against every level with OpenCV's
+// universal intrinsics (NEON on device, SSE on the simulator), instead of one full pass and one new
+// Mat per level. dst is resized to thresholds.size() and each plane is only reallocated when src
+// changes size.
+void yeetMultiThreshold(const cv::Mat &src, const std::vector<uchar> &thresholds, std::vector<cv::Mat> &dst);
+
+#endif
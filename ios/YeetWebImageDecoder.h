@@ -2,5 +2,13 @@
 
 @interface YeetWebImageDecoder : NSObject <RCTImageDataDecoder>
 
+// Synchronous. Animated WebPs come back as a YeetAnimatedImage; stills are decoded for size * scale.
++ (nullable UIImage *)imageWithWebPData:(nonnull NSData *)data size:(CGSize)size scale:(CGFloat)scale resizeMode:(UIViewContentMode)resizeMode;
 
 @end
+
+#ifdef __cplusplus
+#include "YeetWebPDecoder.h"
+
+YeetWebPResizeMode YeetWebPResizeModeForContentMode(UIViewContentMode contentMode);
+#endif
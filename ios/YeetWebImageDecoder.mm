@@ -0,0 +1,75 @@
+
+#import "YeetWebImageDecoder.h"
+#import <SDWebImageWebPCoder.h>
+#import <React/RCTUtils.h>
+#import "YeetAnimatedImage.h"
+#import "YeetTaskQueue.h"
+#include "YeetWebPDecoder.h"
+
+YeetWebPResizeMode YeetWebPResizeModeForContentMode(UIViewContentMode contentMode)
+{
+  switch (contentMode) {
+    case UIViewContentModeScaleAspectFill:
+      return YeetWebPResizeMode::cover;
+    case UIViewContentModeScaleAspectFit:
+      return YeetWebPResizeMode::contain;
+    case UIViewContentModeScaleToFill:
+      return YeetWebPResizeMode::stretch;
+    default:
+      return YeetWebPResizeMode::none;
+  }
+}
+
+@implementation YeetWebImageDecoder
+
+
+
+RCT_EXPORT_MODULE()
+
+- (BOOL)canDecodeImageData:(NSData *)imageData
+{
+  return [[SDImageWebPCoder sharedCoder] canDecodeFromData:imageData];
+}
+
+- (RCTImageLoaderCancellationBlock)decodeImageData:(NSData *)imageData
+                                              size:(CGSize)size
+                                             scale:(CGFloat)scale
+                                        resizeMode:(UIViewContentMode)resizeMode
+                                 completionHandler:(RCTImageLoaderCompletionBlock)completionHandler
+{
+
+
+  return [YeetTaskQueue schedule:YeetTaskQueuePriorityInteractive block:^{
+    UIImage *image = [YeetWebImageDecoder imageWithWebPData:imageData size:size scale:scale resizeMode:resizeMode];
+    if (!image) {
+      completionHandler(RCTErrorWithMessage(@"Could not decode WebP image"), nil);
+      return;
+    }
+
+    completionHandler(nil, image);
+  }];
+}
+
++ (UIImage *)imageWithWebPData:(NSData *)data size:(CGSize)size scale:(CGFloat)scale resizeMode:(UIViewContentMode)resizeMode
+{
+  // Animated WebPs decode each frame as it's shown, so only stills are decoded here.
+  YeetAnimatedImage *animatedImage = [YeetAnimatedImage animatedImageWithWebPData:data scale:scale];
+  if (animatedImage) {
+    return animatedImage;
+  }
+
+  // Stills decode straight to the size they'll be shown at, so feed thumbnails never allocate a full-size bitmap.
+  auto bitmap = yeetDecodeWebP((const uint8_t *)data.bytes, data.length,
+                               (int)round(size.width * scale), (int)round(size.height * scale),
+                               YeetWebPResizeModeForContentMode(resizeMode));
+  CGImageRef imageRef = YeetCreateWebPBitmapImage(bitmap);
+  if (!imageRef) {
+    return nil;
+  }
+
+  UIImage *image = [UIImage imageWithCGImage:imageRef scale:scale orientation:UIImageOrientationUp];
+  CGImageRelease(imageRef);
+  return image;
+}
+
+@end
@@ -0,0 +1,124 @@
+//
+//  YeetWebPDecoder.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/17/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetWebPDecoder.h"
+#include <WebP/decode.h>
+#include "WebPDemux/demux.h"
+#include <algorithm>
+#include <cmath>
+
+static int yeetRoundDimension(double value) {
+  return std::max(1, (int)std::lround(value));
+}
+
+YeetWebPDecodePlan yeetWebPDecodePlan(int sourceWidth, int sourceHeight, int targetWidth, int targetHeight, YeetWebPResizeMode mode) {
+  YeetWebPDecodePlan plan;
+  plan.cropWidth = plan.width = sourceWidth;
+  plan.cropHeight = plan.height = sourceHeight;
+
+  if (sourceWidth <= 0 || sourceHeight <= 0 || targetWidth <= 0 || targetHeight <= 0) {
+    return plan;
+  }
+
+  switch (mode) {
+    case YeetWebPResizeMode::cover: {
+      // Center crop to the target's aspect ratio, then shrink.
+      const double targetAspect = (double)targetWidth / targetHeight;
+      if ((double)sourceWidth / sourceHeight > targetAspect) {
+        plan.cropWidth = std::min(sourceWidth, yeetRoundDimension(sourceHeight * targetAspect));
+        plan.cropX = (sourceWidth - plan.cropWidth) / 2;
+      } else {
+        plan.cropHeight = std::min(sourceHeight, yeetRoundDimension(sourceWidth / targetAspect));
+        plan.cropY = (sourceHeight - plan.cropHeight) / 2;
+      }
+
+      const double scale = std::min(1.0, (double)targetWidth / plan.cropWidth);
+      plan.width = yeetRoundDimension(plan.cropWidth * scale);
+      plan.height = yeetRoundDimension(plan.cropHeight * scale);
+      break;
+    }
+
+    case YeetWebPResizeMode::contain: {
+      const double scale = std::min(1.0, std::min((double)targetWidth / sourceWidth, (double)targetHeight / sourceHeight));
+      plan.width = yeetRoundDimension(sourceWidth * scale);
+      plan.height = yeetRoundDimension(sourceHeight * scale);
+      break;
+    }
+
+    case YeetWebPResizeMode::stretch:
+      plan.width = std::min(sourceWidth, targetWidth);
+      plan.height = std::min(sourceHeight, targetHeight);
+      break;
+
+    case YeetWebPResizeMode::none:
+      break;
+  }
+
+  return plan;
+}
+
+std::shared_ptr<YeetWebPBitmap> yeetDecodeWebP(const uint8_t *data, size_t size, int targetWidth, int targetHeight, YeetWebPResizeMode mode) {
+  WebPDecoderConfig config;
+  if (!WebPInitDecoderConfig(&config)) {
+    return nullptr;
+  }
+
+  // Animated files wrap their frames in ANMF chunks that WebPDecode can't read directly.
+  WebPData webpData;
+  webpData.bytes = data;
+  webpData.size = size;
+  WebPDemuxer *demux = WebPDemux(&webpData);
+  if (!demux) {
+    return nullptr;
+  }
+
+  WebPIterator iterator;
+  if (!WebPDemuxGetFrame(demux, 1, &iterator)) {
+    WebPDemuxDelete(demux);
+    return nullptr;
+  }
+
+  const uint8_t *frameData = iterator.fragment.bytes;
+  const size_t frameSize = iterator.fragment.size;
+  const int sourceWidth = iterator.width;
+  const int sourceHeight = iterator.height;
+
+  const YeetWebPDecodePlan plan = yeetWebPDecodePlan(sourceWidth, sourceHeight, targetWidth, targetHeight, mode);
+
+  auto bitmap = std::make_shared<YeetWebPBitmap>();
+  bitmap->width = plan.width;
+  bitmap->height = plan.height;
+  bitmap->pixels.resize((size_t)plan.width * plan.height * 4);
+
+  if (plan.crops(sourceWidth, sourceHeight)) {
+    config.options.use_cropping = 1;
+    config.options.crop_left = plan.cropX;
+    config.options.crop_top = plan.cropY;
+    config.options.crop_width = plan.cropWidth;
+    config.options.crop_height = plan.cropHeight;
+  }
+  if (plan.scales()) {
+    config.options.use_scaling = 1;
+    config.options.scaled_width = plan.width;
+    config.options.scaled_height = plan.height;
+  }
+  config.options.use_threads = 1;
+
+  config.output.colorspace = MODE_rgbA;
+  config.output.is_external_memory = 1;
+  config.output.u.RGBA.rgba = bitmap->pixels.data();
+  config.output.u.RGBA.stride = plan.width * 4;
+  config.output.u.RGBA.size = bitmap->pixels.size();
+
+  const VP8StatusCode status = WebPDecode(frameData, frameSize, &config);
+  WebPFreeDecBuffer(&config.output);
+  WebPDemuxReleaseIterator(&iterator);
+  WebPDemuxDelete(demux);
+
+  return status == VP8_STATUS_OK ? bitmap : nullptr;
+}
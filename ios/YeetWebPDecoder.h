@@ -0,0 +1,59 @@
+//
+//  YeetWebPDecoder.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/17/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Premultiplied RGBA, width * 4 bytes per row.
+struct YeetWebPBitmap {
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> pixels;
+};
+
+// How the decoded image will be shown in its target size. Same meanings as UIViewContentMode.
+enum class YeetWebPResizeMode {
+  // Aspect fill: the parts outside the target's aspect ratio are never shown, so they're cropped.
+  cover,
+  // Aspect fit.
+  contain,
+  // Scale to fill.
+  stretch,
+  // Shown at its own size (center, repeat). Never scaled.
+  none,
+};
+
+// What to decode: a region of the source, scaled to a size. Never larger than the source.
+struct YeetWebPDecodePlan {
+  int cropX = 0;
+  int cropY = 0;
+  int cropWidth = 0;
+  int cropHeight = 0;
+  int width = 0;
+  int height = 0;
+
+  bool crops(int sourceWidth, int sourceHeight) const {
+    return cropX != 0 || cropY != 0 || cropWidth != sourceWidth || cropHeight != sourceHeight;
+  }
+  bool scales() const { return width != cropWidth || height != cropHeight; }
+};
+
+// targetWidth/targetHeight are in pixels. Zero means full size.
+YeetWebPDecodePlan yeetWebPDecodePlan(int sourceWidth, int sourceHeight, int targetWidth, int targetHeight, YeetWebPResizeMode mode);
+
+// Decodes a still WebP (or the first frame of an animated one) for the target size. libwebp crops
+// and scales while decoding, so only the output size is ever allocated. nullptr on failure.
+std::shared_ptr<YeetWebPBitmap> yeetDecodeWebP(const uint8_t *data, size_t size, int targetWidth, int targetHeight, YeetWebPResizeMode mode);
+
+#endif
@@ -0,0 +1,538 @@
+//
+//  YeetWebPEncoder.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/19/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetWebPEncoder.h"
+#include <WebP/encode.h>
+#include <WebPMux/mux.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static const size_t YeetWebPWriteChunkSize = 64 * 1024;
+// Share of the progress bar for encoding frames. The rest is assembling and writing the file.
+static const float YeetWebPAnimationEncodeShare = 0.9f;
+
+static WebPPreset webpPreset(YeetWebPPreset preset) {
+  switch (preset) {
+    case YeetWebPPreset::automatic:
+      return WEBP_PRESET_DEFAULT;
+    case YeetWebPPreset::picture:
+      return WEBP_PRESET_PICTURE;
+    case YeetWebPPreset::photo:
+      return WEBP_PRESET_PHOTO;
+    case YeetWebPPreset::drawing:
+      return WEBP_PRESET_DRAWING;
+    case YeetWebPPreset::icon:
+      return WEBP_PRESET_ICON;
+    case YeetWebPPreset::text:
+      return WEBP_PRESET_TEXT;
+  }
+  return WEBP_PRESET_DEFAULT;
+}
+
+static std::string webpEncodingErrorMessage(WebPEncodingError error) {
+  switch (error) {
+    case VP8_ENC_OK:
+      return "OK";
+    case VP8_ENC_ERROR_OUT_OF_MEMORY:
+    case VP8_ENC_ERROR_BITSTREAM_OUT_OF_MEMORY:
+      return "Out of memory";
+    case VP8_ENC_ERROR_NULL_PARAMETER:
+    case VP8_ENC_ERROR_INVALID_CONFIGURATION:
+      return "Invalid encoder configuration";
+    case VP8_ENC_ERROR_BAD_DIMENSION:
+      return "Image is too large to encode as WebP";
+    case VP8_ENC_ERROR_PARTITION0_OVERFLOW:
+    case VP8_ENC_ERROR_PARTITION_OVERFLOW:
+      return "Image is too complex to encode at this quality";
+    case VP8_ENC_ERROR_BAD_WRITE:
+      return "Could not write the file";
+    case VP8_ENC_ERROR_FILE_TOO_BIG:
+      return "Encoded file is too large";
+    case VP8_ENC_ERROR_USER_ABORT:
+      return "Cancelled";
+    case VP8_ENC_ERROR_LAST:
+      break;
+  }
+  return "Unknown encoding error";
+}
+
+static bool configure(WebPConfig &config, const YeetWebPEncodeOptions &options) {
+  const float quality = std::min(std::max(options.quality, 0.0f), 100.0f);
+  if (!WebPConfigPreset(&config, webpPreset(options.preset), quality)) {
+    return false;
+  }
+
+  config.lossless = options.lossless ? 1 : 0;
+  config.method = std::min(std::max(options.method, 0), 6);
+  config.thread_level = options.multithreaded ? 1 : 0;
+  return WebPValidateConfig(&config) != 0;
+}
+
+// Copies the frame into picture->argb, undoing premultiplication on the way. Writing ARGB directly
+// saves the extra full-size copy WebPPictureImportRGBA would need for premultiplied input.
+//
+// With previous, pixels that are the same as in previous become transparent.
+static bool importFrame(WebPPicture &picture, const YeetWebPEncodeFrame &frame, const uint8_t *previous = nullptr, size_t previousBytesPerRow = 0) {
+  picture.use_argb = 1;
+  picture.width = frame.width;
+  picture.height = frame.height;
+  if (!WebPPictureAlloc(&picture)) {
+    return false;
+  }
+
+  for (int y = 0; y < frame.height; y++) {
+    const uint8_t *src = frame.rgba + (size_t)y * frame.bytesPerRow;
+    const uint8_t *before = previous ? previous + (size_t)y * previousBytesPerRow : nullptr;
+    uint32_t *dst = picture.argb + (size_t)y * picture.argb_stride;
+
+    for (int x = 0; x < frame.width; x++, src += 4) {
+      if (before && memcmp(src, before + x * 4, 4) == 0) {
+        dst[x] = 0;
+        continue;
+      }
+
+      uint32_t r = src[0], g = src[1], b = src[2];
+      const uint32_t a = src[3];
+
+      if (frame.premultiplied && a != 255) {
+        if (a == 0) {
+          r = g = b = 0;
+        } else {
+          r = std::min<uint32_t>(255, (r * 255 + a / 2) / a);
+          g = std::min<uint32_t>(255, (g * 255 + a / 2) / a);
+          b = std::min<uint32_t>(255, (b * 255 + a / 2) / a);
+        }
+      }
+
+      dst[x] = (a << 24) | (r << 16) | (g << 8) | b;
+    }
+  }
+
+  return true;
+}
+
+// Writes an assembled file in chunks, reporting the fraction written. Removes it on failure.
+static bool writeWebPFile(const WebPData &data, const std::string &path, const YeetWebPEncodeProgress &progress, std::string &error) {
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file) {
+    error = "Could not open " + path;
+    return false;
+  }
+
+  bool success = true;
+  for (size_t offset = 0; offset < data.size && success; offset += YeetWebPWriteChunkSize) {
+    const size_t length = std::min(YeetWebPWriteChunkSize, data.size - offset);
+    if (fwrite(data.bytes + offset, 1, length, file) != length) {
+      success = false;
+      error = webpEncodingErrorMessage(VP8_ENC_ERROR_BAD_WRITE);
+    } else if (progress && !progress((float)(offset + length) / data.size)) {
+      success = false;
+      error = webpEncodingErrorMessage(VP8_ENC_ERROR_USER_ABORT);
+    }
+  }
+
+  if (fclose(file) != 0 && success) {
+    success = false;
+    error = webpEncodingErrorMessage(VP8_ENC_ERROR_BAD_WRITE);
+  }
+  if (!success) {
+    remove(path.c_str());
+  }
+
+  return success;
+}
+
+struct YeetWebPStillOutput {
+  FILE *file;
+  YeetWebPEncodeProgress progress;
+};
+
+static int writeToFile(const uint8_t *data, size_t size, const WebPPicture *picture) {
+  const YeetWebPStillOutput *output = static_cast<const YeetWebPStillOutput *>(picture->custom_ptr);
+  return size == 0 || fwrite(data, 1, size, output->file) == size;
+}
+
+static int reportStillProgress(int percent, const WebPPicture *picture) {
+  const YeetWebPStillOutput *output = static_cast<const YeetWebPStillOutput *>(picture->custom_ptr);
+  return !output->progress || output->progress(percent / 100.0f);
+}
+
+bool yeetEncodeWebP(const YeetWebPEncodeFrame &frame, const YeetWebPEncodeOptions &options, const std::string &path, YeetWebPEncodeProgress progress, std::string &error) {
+  WebPConfig config;
+  if (!WebPConfigInit(&config) || !configure(config, options)) {
+    error = "Invalid encoder configuration";
+    return false;
+  }
+
+  WebPPicture picture;
+  if (!WebPPictureInit(&picture)) {
+    error = "Invalid encoder configuration";
+    return false;
+  }
+
+  if (!importFrame(picture, frame)) {
+    error = webpEncodingErrorMessage(picture.error_code);
+    WebPPictureFree(&picture);
+    return false;
+  }
+
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file) {
+    error = "Could not open " + path;
+    WebPPictureFree(&picture);
+    return false;
+  }
+
+  YeetWebPStillOutput output{file, progress};
+  picture.writer = writeToFile;
+  picture.custom_ptr = &output;
+  picture.progress_hook = reportStillProgress;
+
+  bool success = WebPEncode(&config, &picture) != 0;
+  if (!success) {
+    error = webpEncodingErrorMessage(picture.error_code);
+  }
+  WebPPictureFree(&picture);
+
+  if (fclose(file) != 0 && success) {
+    success = false;
+    error = webpEncodingErrorMessage(VP8_ENC_ERROR_BAD_WRITE);
+  }
+  if (!success) {
+    remove(path.c_str());
+  } else if (progress) {
+    // libwebp's last report is usually short of 100%.
+    progress(1.0f);
+  }
+
+  return success;
+}
+
+// libwebp treats kmax <= 0 as "no keyframes", so when only one interval is given the other has to
+// be filled in. It wants kmin >= kmax / 2 + 1 and kmax > kmin, and at most 30 frames between them;
+// kmax = 2 * kmin - 1 is the widest spacing that satisfies both (gif2webp's 9/17 and 3/5 defaults).
+static void keyframeIntervals(int minInterval, int maxInterval, int &kmin, int &kmax) {
+  static const int maxCachedFrames = 30;
+  if (maxInterval <= 0) {
+    kmin = minInterval;
+    kmax = std::min(std::max(minInterval + 1, 2 * minInterval - 1), minInterval + maxCachedFrames);
+  } else if (minInterval <= 0) {
+    kmax = maxInterval;
+    kmin = std::min(maxInterval - 1, maxInterval / 2 + 1);
+  } else {
+    // Both given: libwebp clamps kmin into range itself.
+    kmin = minInterval;
+    kmax = maxInterval;
+  }
+}
+
+YeetWebPAnimationEncoder::YeetWebPAnimationEncoder(int width, int height, size_t frameCount, const YeetWebPEncodeOptions &options, YeetWebPEncodeProgress progress)
+: width_(width), height_(height), expectedFrames_(std::max<size_t>(frameCount, 1)), options_(options), progress_(std::move(progress)) {
+  WebPAnimEncoderOptions encoderOptions;
+  if (!WebPAnimEncoderOptionsInit(&encoderOptions)) {
+    fail("Invalid encoder configuration");
+    return;
+  }
+
+  encoderOptions.anim_params.loop_count = std::max(options.loopCount, 0);
+  encoderOptions.anim_params.bgcolor = 0;
+  encoderOptions.minimize_size = options.minimizeSize ? 1 : 0;
+  encoderOptions.allow_mixed = options.allowMixed ? 1 : 0;
+  if (options.minKeyframeInterval > 0 || options.maxKeyframeInterval > 0) {
+    keyframeIntervals(options.minKeyframeInterval, options.maxKeyframeInterval, encoderOptions.kmin, encoderOptions.kmax);
+  }
+
+  encoder_ = WebPAnimEncoderNew(width, height, &encoderOptions);
+  if (!encoder_) {
+    fail("Could not create the animation encoder");
+  }
+}
+
+YeetWebPAnimationEncoder::~YeetWebPAnimationEncoder() {
+  if (encoder_) {
+    WebPAnimEncoderDelete(encoder_);
+  }
+}
+
+bool YeetWebPAnimationEncoder::fail(const std::string &message) {
+  if (error_.empty()) {
+    error_ = message;
+  }
+  return false;
+}
+
+bool YeetWebPAnimationEncoder::reportProgress(float progress) {
+  if (progress_ && !progress_(progress)) {
+    return fail(webpEncodingErrorMessage(VP8_ENC_ERROR_USER_ABORT));
+  }
+  return true;
+}
+
+bool YeetWebPAnimationEncoder::add(const YeetWebPEncodeFrame &frame) {
+  if (!encoder_ || !error_.empty()) {
+    return false;
+  } else if (frame.width != width_ || frame.height != height_) {
+    return fail("Frame size doesn't match the animation");
+  }
+
+  WebPConfig config;
+  WebPPicture picture;
+  if (!WebPConfigInit(&config) || !configure(config, options_) || !WebPPictureInit(&picture)) {
+    return fail("Invalid encoder configuration");
+  }
+
+  if (!importFrame(picture, frame)) {
+    const std::string message = webpEncodingErrorMessage(picture.error_code);
+    WebPPictureFree(&picture);
+    return fail(message);
+  }
+
+  const bool added = WebPAnimEncoderAdd(encoder_, &picture, timestampMs_, &config) != 0;
+  WebPPictureFree(&picture);
+  if (!added) {
+    return fail(WebPAnimEncoderGetError(encoder_));
+  }
+
+  timestampMs_ += std::max(frame.durationMs, 1);
+  framesAdded_++;
+
+  return reportProgress(YeetWebPAnimationEncodeShare * std::min<float>(1.0f, (float)framesAdded_ / expectedFrames_));
+}
+
+bool YeetWebPAnimationEncoder::finish(const std::string &path) {
+  if (!encoder_ || !error_.empty()) {
+    return false;
+  } else if (framesAdded_ == 0) {
+    return fail("No frames to encode");
+  }
+
+  WebPData data;
+  WebPDataInit(&data);
+  if (!WebPAnimEncoderAdd(encoder_, nullptr, timestampMs_, nullptr) || !WebPAnimEncoderAssemble(encoder_, &data)) {
+    WebPDataClear(&data);
+    return fail(WebPAnimEncoderGetError(encoder_));
+  }
+
+  std::string error;
+  const bool success = writeWebPFile(data, path, [this](float written) {
+    return reportProgress(YeetWebPAnimationEncodeShare + (1 - YeetWebPAnimationEncodeShare) * written);
+  }, error);
+  WebPDataClear(&data);
+
+  return success || fail(error);
+}
+
+static int appendToVector(const uint8_t *data, size_t size, const WebPPicture *picture) {
+  std::vector<uint8_t> *output = static_cast<std::vector<uint8_t> *>(picture->custom_ptr);
+  output->insert(output->end(), data, data + size);
+  return 1;
+}
+
+static std::string webpMuxErrorMessage(WebPMuxError error) {
+  switch (error) {
+    case WEBP_MUX_MEMORY_ERROR:
+      return "Out of memory";
+    case WEBP_MUX_INVALID_ARGUMENT:
+    case WEBP_MUX_BAD_DATA:
+    case WEBP_MUX_NOT_ENOUGH_DATA:
+      return "Could not add the frame to the animation";
+    default:
+      return "Could not assemble the animation";
+  }
+}
+
+// Blending can only leave pixels alone, never make them more transparent, so a rect where some
+// changed pixel isn't opaque has to replace the canvas instead.
+static bool changedPixelsAreOpaque(const YeetWebPEncodeFrame &frame, const uint8_t *previous, size_t previousBytesPerRow) {
+  for (int y = 0; y < frame.height; y++) {
+    const uint8_t *src = frame.rgba + (size_t)y * frame.bytesPerRow;
+    const uint8_t *before = previous + (size_t)y * previousBytesPerRow;
+
+    for (int x = 0; x < frame.width; x++, src += 4) {
+      if (src[3] != 255 && memcmp(src, before + x * 4, 4) != 0) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+YeetWebPDeltaEncoder::YeetWebPDeltaEncoder(int width, int height, size_t frameCount, const YeetWebPEncodeOptions &options, YeetWebPEncodeProgress progress)
+: width_(width), height_(height), expectedFrames_(std::max<size_t>(frameCount, 1)), options_(options), progress_(std::move(progress)) {
+  mux_ = WebPMuxNew();
+  if (!mux_) {
+    fail("Could not create the animation encoder");
+  }
+}
+
+YeetWebPDeltaEncoder::~YeetWebPDeltaEncoder() {
+  if (mux_) {
+    WebPMuxDelete(mux_);
+  }
+}
+
+bool YeetWebPDeltaEncoder::fail(const std::string &message) {
+  if (error_.empty()) {
+    error_ = message;
+  }
+  return false;
+}
+
+bool YeetWebPDeltaEncoder::reportProgress(float progress) {
+  if (progress_ && !progress_(progress)) {
+    return fail(webpEncodingErrorMessage(VP8_ENC_ERROR_USER_ABORT));
+  }
+  return true;
+}
+
+bool YeetWebPDeltaEncoder::pushPending() {
+  if (!hasPending_) {
+    return true;
+  }
+
+  WebPMuxFrameInfo info;
+  memset(&info, 0, sizeof(info));
+  info.bitstream.bytes = pending_.bitstream.data();
+  info.bitstream.size = pending_.bitstream.size();
+  info.x_offset = pending_.rect.x;
+  info.y_offset = pending_.rect.y;
+  info.duration = pending_.durationMs;
+  info.id = WEBP_CHUNK_ANMF;
+  info.dispose_method = WEBP_MUX_DISPOSE_NONE;
+  info.blend_method = pending_.blend ? WEBP_MUX_BLEND : WEBP_MUX_NO_BLEND;
+
+  const WebPMuxError error = WebPMuxPushFrame(mux_, &info, 1);
+  hasPending_ = false;
+  if (error != WEBP_MUX_OK) {
+    return fail(webpMuxErrorMessage(error));
+  }
+
+  encodedFrames_++;
+  return true;
+}
+
+bool YeetWebPDeltaEncoder::add(const YeetWebPEncodeFrame &frame) {
+  if (!mux_ || !error_.empty()) {
+    return false;
+  } else if (frame.width != width_ || frame.height != height_) {
+    return fail("Frame size doesn't match the animation");
+  }
+
+  const size_t previousBytesPerRow = (size_t)width_ * 4;
+  const bool first = previous_.empty();
+  YeetFrameRect rect;
+  if (first) {
+    rect.width = width_;
+    rect.height = height_;
+  } else {
+    rect = yeetChangedRect(previous_.data(), previousBytesPerRow, frame.rgba, frame.bytesPerRow, width_, height_);
+  }
+
+  framesAdded_++;
+  const int durationMs = std::max(frame.durationMs, 1);
+  const float progress = YeetWebPAnimationEncodeShare * std::min<float>(1.0f, (float)framesAdded_ / expectedFrames_);
+
+  if (rect.empty()) {
+    pending_.durationMs += durationMs;
+    return reportProgress(progress);
+  }
+
+  // ANMF offsets are stored halved, so frames have to start on even pixels.
+  rect.width += rect.x & 1;
+  rect.height += rect.y & 1;
+  rect.x &= ~1;
+  rect.y &= ~1;
+
+  YeetWebPEncodeFrame region = frame;
+  region.rgba = frame.rgba + (size_t)rect.y * frame.bytesPerRow + (size_t)rect.x * 4;
+  region.width = rect.width;
+  region.height = rect.height;
+  const uint8_t *previousRegion = first ? nullptr : previous_.data() + (size_t)rect.y * previousBytesPerRow + (size_t)rect.x * 4;
+  const bool blend = previousRegion && changedPixelsAreOpaque(region, previousRegion, previousBytesPerRow);
+
+  if (!pushPending()) {
+    return false;
+  }
+
+  WebPConfig config;
+  WebPPicture picture;
+  if (!WebPConfigInit(&config) || !configure(config, options_) || !WebPPictureInit(&picture)) {
+    return fail("Invalid encoder configuration");
+  }
+
+  if (!importFrame(picture, region, blend ? previousRegion : nullptr, previousBytesPerRow)) {
+    const std::string message = webpEncodingErrorMessage(picture.error_code);
+    WebPPictureFree(&picture);
+    return fail(message);
+  }
+
+  pending_.bitstream.clear();
+  picture.writer = appendToVector;
+  picture.custom_ptr = &pending_.bitstream;
+
+  const bool encoded = WebPEncode(&config, &picture) != 0;
+  const WebPEncodingError encodingError = picture.error_code;
+  WebPPictureFree(&picture);
+  if (!encoded) {
+    return fail(webpEncodingErrorMessage(encodingError));
+  }
+
+  pending_.rect = rect;
+  pending_.blend = blend;
+  pending_.durationMs = durationMs;
+  hasPending_ = true;
+
+  // Only the rect changed, so that's all that needs copying.
+  if (first) {
+    previous_.resize(previousBytesPerRow * height_);
+  }
+  for (int y = rect.y; y < rect.y + rect.height; y++) {
+    memcpy(previous_.data() + (size_t)y * previousBytesPerRow + (size_t)rect.x * 4, frame.rgba + (size_t)y * frame.bytesPerRow + (size_t)rect.x * 4, (size_t)rect.width * 4);
+  }
+
+  return reportProgress(progress);
+}
+
+bool YeetWebPDeltaEncoder::finish(const std::string &path) {
+  if (!mux_ || !error_.empty()) {
+    return false;
+  } else if (framesAdded_ == 0) {
+    return fail("No frames to encode");
+  } else if (!pushPending()) {
+    return false;
+  }
+
+  WebPMuxAnimParams params;
+  params.bgcolor = 0;
+  params.loop_count = std::max(options_.loopCount, 0);
+
+  WebPMuxError muxError = WebPMuxSetCanvasSize(mux_, width_, height_);
+  if (muxError == WEBP_MUX_OK) {
+    muxError = WebPMuxSetAnimationParams(mux_, &params);
+  }
+
+  WebPData data;
+  WebPDataInit(&data);
+  if (muxError == WEBP_MUX_OK) {
+    muxError = WebPMuxAssemble(mux_, &data);
+  }
+  if (muxError != WEBP_MUX_OK) {
+    WebPDataClear(&data);
+    return fail(webpMuxErrorMessage(muxError));
+  }
+
+  std::string error;
+  const bool success = writeWebPFile(data, path, [this](float written) {
+    return reportProgress(YeetWebPAnimationEncodeShare + (1 - YeetWebPAnimationEncodeShare) * written);
+  }, error);
+  WebPDataClear(&data);
+
+  return success || fail(error);
+}
@@ -0,0 +1,172 @@
+//
+//  YeetWebPEncoder.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/19/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "YeetFrameDiff.h"
+
+struct WebPAnimEncoder;
+struct WebPMux;
+
+// Mirrors libwebp's WebPPreset, so callers don't need encode.h.
+enum class YeetWebPPreset {
+  automatic,
+  picture,
+  photo,
+  drawing,
+  icon,
+  text,
+};
+
+struct YeetWebPEncodeOptions {
+  // 0-100. For lossless, how hard to try instead of how much to throw away.
+  float quality = 80;
+  bool lossless = false;
+  // 0 (fast) - 6 (small).
+  int method = 4;
+  YeetWebPPreset preset = YeetWebPPreset::automatic;
+  // Lets libwebp use a second thread for alpha and the analysis passes.
+  bool multithreaded = true;
+
+  // Animations only. 0 loops forever.
+  int loopCount = 0;
+  // Tries every frame as both a keyframe and a sub-frame and keeps the smaller one. Much slower.
+  bool minimizeSize = false;
+  // Keyframe spacing. Both 0 keeps libwebp's defaults; if only one is set, the other is derived
+  // from it (kmax = 2 * kmin - 1) so keyframes stay on.
+  int minKeyframeInterval = 0;
+  int maxKeyframeInterval = 0;
+  // Picks lossy or lossless per frame, whichever is smaller.
+  bool allowMixed = false;
+  // Encodes with YeetWebPDeltaEncoder instead of WebPAnimEncoder.
+  bool frameDiff = false;
+};
+
+// One frame of 8-bit RGBA. CoreGraphics bitmaps are premultiplied; libwebp wants straight alpha,
+// so premultiplied frames are converted while they're copied in.
+struct YeetWebPEncodeFrame {
+  const uint8_t *rgba = nullptr;
+  int width = 0;
+  int height = 0;
+  size_t bytesPerRow = 0;
+  bool premultiplied = true;
+  // Animations only.
+  int durationMs = 100;
+};
+
+// Called with 0-1 as encoding moves along. Return false to cancel.
+typedef std::function<bool(float progress)> YeetWebPEncodeProgress;
+
+// Encodes a still image, writing to path as libwebp produces output instead of holding the whole
+// file in memory. On failure the partial file is removed and error says why.
+bool yeetEncodeWebP(const YeetWebPEncodeFrame &frame, const YeetWebPEncodeOptions &options, const std::string &path, YeetWebPEncodeProgress progress, std::string &error);
+
+// Encodes an animation one frame at a time, so the caller never holds more than one decoded frame.
+//
+// WebPAnimEncoder can't emit frames as it goes: it picks each frame's sub-rectangle and blend mode
+// by looking at the next one, and only produces a file from finish(). The assembled file is then
+// written out in chunks.
+//
+// Not thread-safe. Add frames from one thread.
+class YeetWebPAnimationEncoder {
+public:
+  // frameCount is only used to scale progress; adding more or fewer frames is fine.
+  YeetWebPAnimationEncoder(int width, int height, size_t frameCount, const YeetWebPEncodeOptions &options, YeetWebPEncodeProgress progress = nullptr);
+  ~YeetWebPAnimationEncoder();
+  YeetWebPAnimationEncoder(const YeetWebPAnimationEncoder &) = delete;
+  YeetWebPAnimationEncoder &operator=(const YeetWebPAnimationEncoder &) = delete;
+
+  // The frame has to match the canvas size. Returns false on failure or cancellation.
+  bool add(const YeetWebPEncodeFrame &frame);
+  // Assembles the animation and writes it to path.
+  bool finish(const std::string &path);
+
+  size_t frameCount() const { return framesAdded_; }
+  const std::string &error() const { return error_; }
+
+private:
+  bool reportProgress(float progress);
+  bool fail(const std::string &message);
+
+  int width_;
+  int height_;
+  size_t expectedFrames_;
+  YeetWebPEncodeOptions options_;
+  YeetWebPEncodeProgress progress_;
+
+  WebPAnimEncoder *encoder_ = nullptr;
+  size_t framesAdded_ = 0;
+  int timestampMs_ = 0;
+  std::string error_;
+};
+
+// Encodes an animation as a full first frame followed by only the rectangles that changed.
+//
+// Meant for exports that are mostly a still background with a small moving region. Each frame is
+// diffed against the previous one with yeetChangedRect. Nothing else is tried, so this is much
+// faster than WebPAnimEncoder, which encodes several candidates per frame and keeps the smallest.
+// - Identical frames aren't encoded. Their duration goes to the frame before.
+// - Every frame keeps the canvas (dispose none), so each diff is against what is on screen.
+// - When every changed pixel is opaque, unchanged pixels inside the rect become transparent and
+//   the frame is alpha-blended, which compresses far better. Otherwise the rect replaces the canvas.
+//
+// Same interface as YeetWebPAnimationEncoder. Only quality, lossless, method, preset,
+// multithreaded and loopCount apply.
+class YeetWebPDeltaEncoder {
+public:
+  YeetWebPDeltaEncoder(int width, int height, size_t frameCount, const YeetWebPEncodeOptions &options, YeetWebPEncodeProgress progress = nullptr);
+  ~YeetWebPDeltaEncoder();
+  YeetWebPDeltaEncoder(const YeetWebPDeltaEncoder &) = delete;
+  YeetWebPDeltaEncoder &operator=(const YeetWebPDeltaEncoder &) = delete;
+
+  bool add(const YeetWebPEncodeFrame &frame);
+  bool finish(const std::string &path);
+
+  // Frames added, including the ones merged into the frame before.
+  size_t frameCount() const { return framesAdded_; }
+  // Frames actually written to the file.
+  size_t encodedFrameCount() const { return encodedFrames_; }
+  const std::string &error() const { return error_; }
+
+private:
+  // The last encoded frame waits here until the next frame shows whether its duration grows.
+  struct PendingFrame {
+    std::vector<uint8_t> bitstream;
+    YeetFrameRect rect;
+    bool blend = false;
+    int durationMs = 0;
+  };
+
+  bool pushPending();
+  bool reportProgress(float progress);
+  bool fail(const std::string &message);
+
+  int width_;
+  int height_;
+  size_t expectedFrames_;
+  YeetWebPEncodeOptions options_;
+  YeetWebPEncodeProgress progress_;
+
+  WebPMux *mux_ = nullptr;
+  // The previous frame's pixels, tightly packed.
+  std::vector<uint8_t> previous_;
+  PendingFrame pending_;
+  bool hasPending_ = false;
+  size_t framesAdded_ = 0;
+  size_t encodedFrames_ = 0;
+  std::string error_;
+};
+
+#endif
@@ -0,0 +1,44 @@
+//
+//  YeetWebPExporter.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/19/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+
+#ifdef __cplusplus
+#include <string>
+#include "YeetWebPEncoder.h"
+
+struct YeetWebPExportResult {
+  int width = 0;
+  int height = 0;
+  size_t frameCount = 0;
+  unsigned long long byteCount = 0;
+};
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Re-encodes an image, GIF/APNG or video file as WebP. One frame is decoded at a time and handed
+// straight to the encoder. Slow; call it off the main thread.
+@interface YeetWebPExporter : NSObject
+
+// maxPixelSize scales the longest side down to fit (0 keeps the original size).
+// framesPerSecond is how often videos are sampled.
++ (BOOL)exportURL:(NSURL *)source
+            toURL:(NSURL *)destination
+          options:(const YeetWebPEncodeOptions &)options
+     maxPixelSize:(CGFloat)maxPixelSize
+  framesPerSecond:(double)framesPerSecond
+         progress:(YeetWebPEncodeProgress)progress
+           result:(YeetWebPExportResult &)result
+            error:(std::string &)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif
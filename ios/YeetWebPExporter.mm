@@ -0,0 +1,212 @@
+//
+//  YeetWebPExporter.mm
+//  yeet
+//
+//  Created by Jarred WSumner on 3/19/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#import "YeetWebPExporter.h"
+#import <AVFoundation/AVFoundation.h>
+#import <ImageIO/ImageIO.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Returns a +1 CGImage for the frame and its duration, or NULL when the frame can't be decoded.
+typedef CGImageRef _Nullable (^YeetWebPFrameSource)(size_t index, int *durationMs);
+
+// Draws each frame into one reused premultiplied RGBA buffer the size of the canvas.
+class YeetWebPExportCanvas {
+public:
+  YeetWebPExportCanvas(int width, int height) : width_(width), height_(height), pixels_((size_t)width * height * 4) {
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    context_ = CGBitmapContextCreate(pixels_.data(), width, height, 8, (size_t)width * 4, colorSpace,
+                                     kCGBitmapByteOrderDefault | kCGImageAlphaPremultipliedLast);
+    CGColorSpaceRelease(colorSpace);
+    if (context_) {
+      CGContextSetInterpolationQuality(context_, kCGInterpolationHigh);
+    }
+  }
+
+  ~YeetWebPExportCanvas() {
+    CGContextRelease(context_);
+  }
+
+  bool isValid() const { return context_ != NULL; }
+
+  YeetWebPEncodeFrame draw(CGImageRef image, int durationMs) {
+    const CGRect bounds = CGRectMake(0, 0, width_, height_);
+    CGContextClearRect(context_, bounds);
+    CGContextDrawImage(context_, bounds, image);
+
+    YeetWebPEncodeFrame frame;
+    frame.rgba = pixels_.data();
+    frame.width = width_;
+    frame.height = height_;
+    frame.bytesPerRow = (size_t)width_ * 4;
+    frame.premultiplied = true;
+    frame.durationMs = durationMs;
+    return frame;
+  }
+
+private:
+  int width_;
+  int height_;
+  std::vector<uint8_t> pixels_;
+  CGContextRef context_ = NULL;
+};
+
+static int imageSourceFrameDurationMs(CGImageSourceRef source, size_t index) {
+  NSDictionary *properties = CFBridgingRelease(CGImageSourceCopyPropertiesAtIndex(source, index, NULL));
+  NSDictionary *gif = properties[(id)kCGImagePropertyGIFDictionary];
+  NSDictionary *png = properties[(id)kCGImagePropertyPNGDictionary];
+
+  NSNumber *delay = gif[(id)kCGImagePropertyGIFUnclampedDelayTime] ?: gif[(id)kCGImagePropertyGIFDelayTime];
+  if (delay == nil) {
+    delay = png[(id)kCGImagePropertyAPNGUnclampedDelayTime] ?: png[(id)kCGImagePropertyAPNGDelayTime];
+  }
+
+  // Browsers play anything this short at 100ms, and so does YeetAnimatedWebP. Match them so the
+  // export plays back at the speed the source did.
+  const int durationMs = (int)lround(delay.doubleValue * 1000);
+  return durationMs <= 10 ? 100 : durationMs;
+}
+
+// Encoder is YeetWebPAnimationEncoder or YeetWebPDeltaEncoder. Releases firstImage.
+template <typename Encoder>
+static bool encodeAnimation(Encoder &encoder, YeetWebPExportCanvas &canvas, CGImageRef firstImage, int firstDurationMs, size_t frameCount, const std::string &path, YeetWebPFrameSource frameSource, std::string &error) {
+  bool success = encoder.add(canvas.draw(firstImage, firstDurationMs));
+  CGImageRelease(firstImage);
+
+  for (size_t index = 1; index < frameCount && success; index++) {
+    @autoreleasepool {
+      int durationMs = 0;
+      CGImageRef image = frameSource(index, &durationMs);
+      // A frame that won't decode is dropped rather than failing the whole export.
+      if (image) {
+        success = encoder.add(canvas.draw(image, durationMs));
+        CGImageRelease(image);
+      }
+    }
+  }
+
+  success = success && encoder.finish(path);
+  if (!success) {
+    error = encoder.error();
+  }
+  return success;
+}
+
+@implementation YeetWebPExporter
+
++ (BOOL)exportURL:(NSURL *)source
+            toURL:(NSURL *)destination
+          options:(const YeetWebPEncodeOptions &)options
+     maxPixelSize:(CGFloat)maxPixelSize
+  framesPerSecond:(double)framesPerSecond
+         progress:(YeetWebPEncodeProgress)progress
+           result:(YeetWebPExportResult &)result
+            error:(std::string &)error
+{
+  CGImageSourceRef imageSource = CGImageSourceCreateWithURL((__bridge CFURLRef)source, NULL);
+  if (imageSource && CGImageSourceGetCount(imageSource) > 0) {
+    const size_t frameCount = CGImageSourceGetCount(imageSource);
+    NSMutableDictionary *thumbnailOptions = [@{
+      (id)kCGImageSourceCreateThumbnailFromImageAlways: @YES,
+      (id)kCGImageSourceCreateThumbnailWithTransform: @YES,
+      (id)kCGImageSourceShouldCacheImmediately: @NO,
+    } mutableCopy];
+    if (maxPixelSize > 0) {
+      thumbnailOptions[(id)kCGImageSourceThumbnailMaxPixelSize] = @(maxPixelSize);
+    }
+
+    BOOL success = [self encodeFrameCount:frameCount destination:destination options:options progress:progress result:result error:error frameSource:^CGImageRef(size_t index, int *durationMs) {
+      *durationMs = imageSourceFrameDurationMs(imageSource, index);
+      // With no max size, the thumbnail is the full-size image, with the EXIF orientation applied.
+      return CGImageSourceCreateThumbnailAtIndex(imageSource, index, (__bridge CFDictionaryRef)thumbnailOptions);
+    }];
+    CFRelease(imageSource);
+    return success;
+  } else if (imageSource) {
+    CFRelease(imageSource);
+  }
+
+  AVURLAsset *asset = [AVURLAsset URLAssetWithURL:source options:@{AVURLAssetPreferPreciseDurationAndTimingKey: @YES}];
+  const double duration = CMTimeGetSeconds(asset.duration);
+  if ([asset tracksWithMediaType:AVMediaTypeVideo].count == 0 || !(duration > 0)) {
+    error = "Unsupported file type";
+    return NO;
+  }
+
+  const double fps = framesPerSecond > 0 ? framesPerSecond : 15;
+  const size_t frameCount = std::max<size_t>(1, (size_t)std::floor(duration * fps));
+  const int frameDurationMs = (int)lround(1000 / fps);
+
+  AVAssetImageGenerator *generator = [AVAssetImageGenerator assetImageGeneratorWithAsset:asset];
+  generator.appliesPreferredTrackTransform = YES;
+  generator.requestedTimeToleranceBefore = kCMTimeZero;
+  generator.requestedTimeToleranceAfter = kCMTimeZero;
+  if (maxPixelSize > 0) {
+    generator.maximumSize = CGSizeMake(maxPixelSize, maxPixelSize);
+  }
+
+  return [self encodeFrameCount:frameCount destination:destination options:options progress:progress result:result error:error frameSource:^CGImageRef(size_t index, int *durationMs) {
+    *durationMs = frameDurationMs;
+    return [generator copyCGImageAtTime:CMTimeMakeWithSeconds(index / fps, 600) actualTime:NULL error:nil];
+  }];
+}
+
++ (BOOL)encodeFrameCount:(size_t)frameCount
+             destination:(NSURL *)destination
+                 options:(const YeetWebPEncodeOptions &)options
+                progress:(YeetWebPEncodeProgress)progress
+                  result:(YeetWebPExportResult &)result
+                   error:(std::string &)error
+             frameSource:(YeetWebPFrameSource)frameSource
+{
+  const std::string path = destination.path.UTF8String ?: "";
+
+  int durationMs = 0;
+  CGImageRef firstImage = frameSource(0, &durationMs);
+  if (!firstImage) {
+    error = "Could not decode the first frame";
+    return NO;
+  }
+
+  // Every frame is drawn into the first frame's size.
+  const int width = (int)CGImageGetWidth(firstImage);
+  const int height = (int)CGImageGetHeight(firstImage);
+  YeetWebPExportCanvas canvas(width, height);
+  if (!canvas.isValid()) {
+    CGImageRelease(firstImage);
+    error = "Could not allocate a frame buffer";
+    return NO;
+  }
+
+  result.width = width;
+  result.height = height;
+
+  bool success;
+  if (frameCount == 1) {
+    success = yeetEncodeWebP(canvas.draw(firstImage, durationMs), options, path, progress, error);
+    CGImageRelease(firstImage);
+    result.frameCount = success ? 1 : 0;
+  } else if (options.frameDiff) {
+    YeetWebPDeltaEncoder encoder(width, height, frameCount, options, progress);
+    success = encodeAnimation(encoder, canvas, firstImage, durationMs, frameCount, path, frameSource, error);
+    result.frameCount = encoder.frameCount();
+  } else {
+    YeetWebPAnimationEncoder encoder(width, height, frameCount, options, progress);
+    success = encodeAnimation(encoder, canvas, firstImage, durationMs, frameCount, path, frameSource, error);
+    result.frameCount = encoder.frameCount();
+  }
+
+  if (success) {
+    result.byteCount = [[NSFileManager defaultManager] attributesOfItemAtPath:destination.path error:nil].fileSize;
+  }
+
+  return success;
+}
+
+@end
@@ -0,0 +1,23 @@
+//
+//  YeetWebPImageURLLoader.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/18/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#import <React/RCTBridge.h>
+#import <React/RCTImageURLLoader.h>
+
+// Downloads remote .webp images and decodes them while the bytes arrive, so <Image> can show
+// the top of a large still before the download finishes (via partialLoadHandler).
+// Animated WebPs are decoded by YeetWebImageDecoder once the download completes.
+//
+// Downloads go through the bridge's RCTNetworking, so they use the same request handlers and
+// cache as every other request. Not a bridge module: RCTImageLoader's loadersProvider owns it.
+@interface YeetWebPImageURLLoader : NSObject <RCTImageURLLoader>
+
+- (instancetype)initWithBridge:(RCTBridge *)bridge NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
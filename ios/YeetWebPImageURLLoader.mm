@@ -0,0 +1,170 @@
+//
+//  YeetWebPImageURLLoader.mm
+//  yeet
+//
+//  Created by Jarred WSumner on 3/18/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#import "YeetWebPImageURLLoader.h"
+#import <React/RCTNetworking.h>
+#import <React/RCTUtils.h>
+#import "YeetAnimatedImage.h"
+#import "YeetWebImageDecoder.h"
+#include "YeetWebPStreamDecoder.h"
+
+// Partial images copy the bitmap, so only publish one every eighth of the image.
+static const int YeetWebPPartialImageSteps = 8;
+
+@interface YeetWebPImageDownload : NSObject
+@property (nonatomic, assign) CGSize size;
+@property (nonatomic, assign) CGFloat scale;
+@property (nonatomic, assign) UIViewContentMode resizeMode;
+@property (nonatomic, copy) RCTImageLoaderProgressBlock progressHandler;
+@property (nonatomic, copy) RCTImageLoaderPartialLoadBlock partialLoadHandler;
+// Everything received, in case the stream decoder can't handle the file (animated).
+@property (nonatomic, strong) NSMutableData *data;
+@end
+
+@implementation YeetWebPImageDownload {
+  std::unique_ptr<YeetWebPStreamDecoder> _decoder;
+  int _publishedRows;
+}
+
+- (void)didReceiveData:(NSData *)data expectedLength:(int64_t)expectedLength
+{
+  if (!_decoder) {
+    _decoder.reset(new YeetWebPStreamDecoder((int)round(_size.width * _scale), (int)round(_size.height * _scale), YeetWebPResizeModeForContentMode(_resizeMode)));
+    _data = [NSMutableData dataWithCapacity:expectedLength > 0 ? (NSUInteger)expectedLength : 0];
+  }
+
+  [_data appendData:data];
+  if (_progressHandler) {
+    _progressHandler(_data.length, expectedLength);
+  }
+
+  // NSData may be discontiguous; enumerate so nothing gets flattened into a copy.
+  [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+    _decoder->append((const uint8_t *)bytes, byteRange.length);
+  }];
+
+  if (!_partialLoadHandler || _decoder->status() != YeetWebPStreamDecoder::Status::incomplete) {
+    return;
+  }
+
+  const int rows = _decoder->decodedRows();
+  if (rows == 0 || rows - _publishedRows < _decoder->height() / YeetWebPPartialImageSteps) {
+    return;
+  }
+
+  _publishedRows = rows;
+  CGImageRef imageRef = YeetCreateWebPBitmapImage(_decoder->snapshot());
+  if (imageRef) {
+    _partialLoadHandler([UIImage imageWithCGImage:imageRef scale:_scale orientation:UIImageOrientationUp]);
+    CGImageRelease(imageRef);
+  }
+}
+
+- (UIImage *)finishedImage
+{
+  if (_decoder && _decoder->status() == YeetWebPStreamDecoder::Status::complete) {
+    CGImageRef imageRef = YeetCreateWebPBitmapImage(_decoder->bitmap());
+    if (imageRef) {
+      UIImage *image = [UIImage imageWithCGImage:imageRef scale:_scale orientation:UIImageOrientationUp];
+      CGImageRelease(imageRef);
+      return image;
+    }
+  }
+
+  return _data.length > 0 ? [YeetWebImageDecoder imageWithWebPData:_data size:_size scale:_scale resizeMode:_resizeMode] : nil;
+}
+
+@end
+
+@implementation YeetWebPImageURLLoader {
+  __weak RCTBridge *_bridge;
+  // RCTNetworking calls back on its own queue. Decoding moves here so it doesn't hold up other
+  // requests' callbacks.
+  dispatch_queue_t _decodeQueue;
+}
+
+- (instancetype)initWithBridge:(RCTBridge *)bridge
+{
+  if (self = [super init]) {
+    _bridge = bridge;
+    _decodeQueue = dispatch_queue_create("com.yeet.webp.decode", dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0));
+  }
+  return self;
+}
+
+- (BOOL)canLoadImageURL:(NSURL *)requestURL
+{
+  NSString *scheme = requestURL.scheme.lowercaseString;
+  return ([scheme isEqualToString:@"http"] || [scheme isEqualToString:@"https"]) &&
+    [requestURL.pathExtension.lowercaseString isEqualToString:@"webp"];
+}
+
+- (RCTImageLoaderCancellationBlock)loadImageForURL:(NSURL *)imageURL
+                                              size:(CGSize)size
+                                             scale:(CGFloat)scale
+                                        resizeMode:(RCTResizeMode)resizeMode
+                                   progressHandler:(RCTImageLoaderProgressBlock)progressHandler
+                                partialLoadHandler:(RCTImageLoaderPartialLoadBlock)partialLoadHandler
+                                 completionHandler:(RCTImageLoaderCompletionBlock)completionHandler
+{
+  RCTNetworking *networking = _bridge.networking;
+  if (!networking) {
+    completionHandler(RCTErrorWithMessage(@"No networking module to load WebP images with"), nil);
+    return nil;
+  }
+
+  YeetWebPImageDownload *download = [YeetWebPImageDownload new];
+  download.size = size;
+  download.scale = scale;
+  download.resizeMode = (UIViewContentMode)resizeMode;
+  download.progressHandler = progressHandler;
+  download.partialLoadHandler = partialLoadHandler;
+
+  dispatch_queue_t decodeQueue = _decodeQueue;
+  RCTNetworkTask *task = [networking networkTaskWithRequest:[NSURLRequest requestWithURL:imageURL] completionBlock:^(NSURLResponse *response, __unused NSData *data, NSError *error) {
+    dispatch_async(decodeQueue, ^{
+      // RCTImageLoader has already moved on from cancelled requests.
+      if (error.code == NSURLErrorCancelled) {
+        return;
+      }
+
+      if (error) {
+        completionHandler(error, nil);
+        return;
+      }
+
+      NSHTTPURLResponse *httpResponse = (NSHTTPURLResponse *)response;
+      if ([httpResponse isKindOfClass:[NSHTTPURLResponse class]] && httpResponse.statusCode >= 400) {
+        completionHandler(RCTErrorWithMessage([NSString stringWithFormat:@"Failed to load %@ (status %ld)", imageURL, (long)httpResponse.statusCode]), nil);
+        return;
+      }
+
+      UIImage *image = [download finishedImage];
+      if (!image) {
+        completionHandler(RCTErrorWithMessage([NSString stringWithFormat:@"Could not decode WebP image at %@", imageURL]), nil);
+        return;
+      }
+
+      completionHandler(nil, image);
+    });
+  }];
+
+  // Chunks are decoded in order on the serial decode queue, ahead of the completion above.
+  task.incrementalDataBlock = ^(NSData *data, __unused int64_t progress, int64_t total) {
+    dispatch_async(decodeQueue, ^{
+      [download didReceiveData:data expectedLength:total];
+    });
+  };
+  [task start];
+
+  return ^{
+    [task cancel];
+  };
+}
+
+@end
@@ -0,0 +1,133 @@
+//
+//  YeetWebPStreamDecoder.cpp
+//  yeet
+//
+//  Created by Jarred WSumner on 3/18/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#include "YeetWebPStreamDecoder.h"
+#include <WebP/decode.h>
+#include <algorithm>
+#include <cstring>
+
+YeetWebPStreamDecoder::YeetWebPStreamDecoder(int targetWidth, int targetHeight, YeetWebPResizeMode mode, RowCallback onRows)
+: targetWidth_(targetWidth), targetHeight_(targetHeight), mode_(mode), onRows_(std::move(onRows)) {
+}
+
+YeetWebPStreamDecoder::~YeetWebPStreamDecoder() {
+  if (decoder_) {
+    WebPIDelete(decoder_);
+  }
+  if (config_) {
+    WebPFreeDecBuffer(&config_->output);
+  }
+}
+
+YeetWebPStreamDecoder::Status YeetWebPStreamDecoder::start() {
+  config_.reset(new WebPDecoderConfig());
+  if (!WebPInitDecoderConfig(config_.get())) {
+    return Status::failed;
+  }
+
+  const VP8StatusCode features = WebPGetFeatures(header_.data(), header_.size(), &config_->input);
+  if (features == VP8_STATUS_NOT_ENOUGH_DATA) {
+    config_.reset();
+    return Status::incomplete;
+  } else if (features != VP8_STATUS_OK) {
+    return Status::failed;
+  } else if (config_->input.has_animation) {
+    return Status::unsupported;
+  }
+
+  const int sourceWidth = config_->input.width;
+  const int sourceHeight = config_->input.height;
+  const YeetWebPDecodePlan plan = yeetWebPDecodePlan(sourceWidth, sourceHeight, targetWidth_, targetHeight_, mode_);
+
+  bitmap_ = std::make_shared<YeetWebPBitmap>();
+  bitmap_->width = plan.width;
+  bitmap_->height = plan.height;
+  bitmap_->pixels.assign((size_t)plan.width * plan.height * 4, 0);
+
+  WebPDecoderOptions &options = config_->options;
+  if (plan.crops(sourceWidth, sourceHeight)) {
+    options.use_cropping = 1;
+    options.crop_left = plan.cropX;
+    options.crop_top = plan.cropY;
+    options.crop_width = plan.cropWidth;
+    options.crop_height = plan.cropHeight;
+  }
+  if (plan.scales()) {
+    options.use_scaling = 1;
+    options.scaled_width = plan.width;
+    options.scaled_height = plan.height;
+  }
+
+  WebPDecBuffer &output = config_->output;
+  output.colorspace = MODE_rgbA;
+  output.is_external_memory = 1;
+  output.u.RGBA.rgba = bitmap_->pixels.data();
+  output.u.RGBA.stride = plan.width * 4;
+  output.u.RGBA.size = bitmap_->pixels.size();
+
+  decoder_ = WebPIDecode(nullptr, 0, config_.get());
+  if (!decoder_) {
+    return Status::failed;
+  }
+
+  std::vector<uint8_t> header;
+  header.swap(header_);
+  return append(header.data(), header.size());
+}
+
+YeetWebPStreamDecoder::Status YeetWebPStreamDecoder::append(const uint8_t *data, size_t size) {
+  if (status_ != Status::incomplete) {
+    return status_;
+  }
+
+  if (!decoder_) {
+    header_.insert(header_.end(), data, data + size);
+    status_ = start();
+    return status_;
+  }
+
+  const VP8StatusCode status = WebPIAppend(decoder_, data, size);
+  if (status != VP8_STATUS_OK && status != VP8_STATUS_SUSPENDED) {
+    status_ = Status::failed;
+    return status_;
+  }
+
+  int lastRow = 0;
+  if (WebPIDecGetRGB(decoder_, &lastRow, nullptr, nullptr, nullptr) && lastRow > decodedRows_) {
+    decodedRows_ = std::min(lastRow, bitmap_->height);
+    if (onRows_) {
+      onRows_(decodedRows_, bitmap_->height);
+    }
+  }
+
+  if (status == VP8_STATUS_OK) {
+    decodedRows_ = bitmap_->height;
+    status_ = Status::complete;
+  }
+
+  return status_;
+}
+
+std::shared_ptr<YeetWebPBitmap> YeetWebPStreamDecoder::snapshot() const {
+  if (!bitmap_ || decodedRows_ == 0) {
+    return nullptr;
+  }
+
+  auto copy = std::make_shared<YeetWebPBitmap>();
+  copy->width = bitmap_->width;
+  copy->height = bitmap_->height;
+  copy->pixels.assign(bitmap_->pixels.size(), 0);
+
+  const size_t decodedBytes = (size_t)decodedRows_ * bitmap_->width * 4;
+  memcpy(copy->pixels.data(), bitmap_->pixels.data(), decodedBytes);
+  return copy;
+}
+
+std::shared_ptr<YeetWebPBitmap> YeetWebPStreamDecoder::bitmap() const {
+  return status_ == Status::complete ? bitmap_ : nullptr;
+}
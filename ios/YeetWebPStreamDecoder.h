@@ -0,0 +1,80 @@
+//
+//  YeetWebPStreamDecoder.h
+//  yeet
+//
+//  Created by Jarred WSumner on 3/18/20.
+//  Copyright © 2020 Yeet. All rights reserved.
+//
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "YeetWebPDecoder.h"
+
+struct WebPIDecoder;
+
+// Decodes a still WebP while it downloads, with libwebp's incremental decoder.
+//
+// Bytes are buffered until the header can be read. From then on every append() decodes as many
+// rows as the new bytes allow, straight into the output bitmap, cropped and scaled the same way
+// yeetDecodeWebP would. The finished bitmap is identical to what yeetDecodeWebP returns for the
+// whole file.
+//
+// Animated files report unsupported: their frames need compositing, so the caller should
+// download the rest and go through YeetAnimatedWebP instead.
+//
+// Not thread-safe. Feed it from one serial queue.
+class YeetWebPStreamDecoder {
+public:
+  enum class Status {
+    incomplete,
+    complete,
+    unsupported,
+    failed,
+  };
+
+  // Called whenever more rows are decoded. decodedRows counts from the top of the output bitmap.
+  typedef std::function<void(int decodedRows, int height)> RowCallback;
+
+  YeetWebPStreamDecoder(int targetWidth, int targetHeight, YeetWebPResizeMode mode, RowCallback onRows = nullptr);
+  ~YeetWebPStreamDecoder();
+  YeetWebPStreamDecoder(const YeetWebPStreamDecoder &) = delete;
+  YeetWebPStreamDecoder &operator=(const YeetWebPStreamDecoder &) = delete;
+
+  Status append(const uint8_t *data, size_t size);
+
+  Status status() const { return status_; }
+  int decodedRows() const { return decodedRows_; }
+  // Output height, once the header has been read. 0 before that.
+  int height() const { return bitmap_ ? bitmap_->height : 0; }
+
+  // A copy of the rows decoded so far, with the rest transparent. nullptr before any rows.
+  std::shared_ptr<YeetWebPBitmap> snapshot() const;
+  // The finished bitmap, once status() is complete.
+  std::shared_ptr<YeetWebPBitmap> bitmap() const;
+
+private:
+  Status start();
+
+  int targetWidth_;
+  int targetHeight_;
+  YeetWebPResizeMode mode_;
+  RowCallback onRows_;
+
+  Status status_ = Status::incomplete;
+  // Bytes received before the header was complete.
+  std::vector<uint8_t> header_;
+  // Heap allocated: libwebp holds on to it for the decoder's lifetime.
+  std::unique_ptr<struct WebPDecoderConfig> config_;
+  WebPIDecoder *decoder_ = nullptr;
+  std::shared_ptr<YeetWebPBitmap> bitmap_;
+  int decodedRows_ = 0;
+};
+
+#endif
@@ -60,6 +60,8 @@
 #import <PINRemoteImage/PINDisplayLink.h>
 
 #import "FindContours.h"
+#import "SmartCrop.h"
+#import "YeetTaskQueue.h"
 
 #import <XExtensionItem/XExtensionItem.h>
 #import "YeetTextEnums.h"
@@ -413,6 +415,7 @@ RCT_EXTERN_METHOD(pause:);
 RCT_EXTERN_METHOD(play:);
 RCT_EXTERN_METHOD(editVideo:(nonnull NSNumber*)tag cb:(RCTResponseSenderBlock)callback);
 RCT_EXTERN_METHOD(detectRectangles:(nonnull NSNumber*)tag cb:(RCTResponseSenderBlock)callback);
+RCT_EXTERN_METHOD(suggestCrop:(nonnull NSNumber*)tag aspectRatio:(CGFloat)aspectRatio cb:(RCTResponseSenderBlock)callback);
 RCT_EXTERN_METHOD(reset:);
 RCT_EXTERN_METHOD(save:(nonnull NSNumber*)tag cb:(RCTResponseSenderBlock)callback);
 RCT_EXTERN_METHOD(goNext:::);
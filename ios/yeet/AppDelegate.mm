@@ -20,6 +20,7 @@
 #import <SDWebImage/SDImageLoadersManager.h>
 #import <SDWebImagePhotosPlugin.h>
 #import "YeetWebImageDecoder.h"
+#import "YeetWebPImageURLLoader.h"
 #import <RNFastImage/FFFastImageViewManager.h>
 #import "SDImageCacheConfig.h"
 #import <RCTCronetHTTPRequestHandler.h>
@@ -210,7 +211,7 @@
 
     __typeof(self) strongSelf = weakSelf;
     if (strongSelf) {
-      YeetJSIModule::install(bridge);
+      [MediaPlayerJSIModuleInstaller installYeetJSI:bridge];
       strongSelf->_turboModuleManager = [[RCTTurboModuleManager alloc] initWithBridge:bridge delegate:strongSelf];
       [strongSelf->_turboModuleManager installJSBindingWithRuntime:&runtime];
     }
@@ -244,11 +245,15 @@
 - (id<RCTTurboModule>)getModuleInstanceFromClass:(Class)moduleClass
 {
   if (moduleClass == RCTImageLoader.class) {
-    return [[moduleClass alloc] initWithRedirectDelegate:nil loadersProvider:^NSArray<id<RCTImageURLLoader>> *{
-      return @[[RCTLocalAssetImageLoader new]];
+    // Loaders are created lazily, after the bridge has set itself on the image loader.
+    __block __weak RCTImageLoader *weakImageLoader;
+    RCTImageLoader *imageLoader = [[moduleClass alloc] initWithRedirectDelegate:nil loadersProvider:^NSArray<id<RCTImageURLLoader>> *{
+      return @[[RCTLocalAssetImageLoader new], [[YeetWebPImageURLLoader alloc] initWithBridge:weakImageLoader.bridge]];
     } decodersProvider:^NSArray<id<RCTImageDataDecoder>> *{
-      return @[[RCTGIFImageDecoder new]];
+      return @[[RCTGIFImageDecoder new], [YeetWebImageDecoder new]];
     }];
+    weakImageLoader = imageLoader;
+    return imageLoader;
   } else if (moduleClass == RCTNetworking.class) {
     return [[moduleClass alloc] initWithHandlersProvider:^NSArray<id<RCTURLRequestHandler>> *{
       return @[
@@ -1,12 +1,16 @@
 import { NetworkStatus } from "apollo-client";
-import { uniqBy } from "lodash";
+import { uniq } from "lodash";
 import * as React from "react";
 import { useQuery, useLazyQuery } from "react-apollo";
 import { RESULTS } from "react-native-permissions";
 import CAMERA_ROLL_QUERY from "../../../lib/CameraRollQuery.local.graphql";
 import { ScrollDirection } from "../../FastList";
 import {
-  buildValue,
+  cameraRollRows,
+  releaseCameraRollPages
+} from "../../../lib/CameraRollGraphQL";
+import {
+  buildLazyValue,
   GalleryFilterListComponent,
   getPaginatedLimit
 } from "../GalleryFilterList";
@@ -113,20 +117,17 @@ export const CameraRollFilterList = ({
 
     if (sessionId) {
       return () => {
-        global.MediaPlayerViewManager?.stopAlbumSession(
-          photosQuery?.data?.cameraRoll?.sessionId
-        );
+        global.MediaPlayerViewManager?.stopAlbumSession(sessionId);
+        releaseCameraRollPages(sessionId);
       };
     }
   }, [photosQuery?.data?.cameraRoll?.sessionId]);
 
   const data: Array<GalleryValue> = React.useMemo(() => {
-    const data = photosQuery?.data?.cameraRoll?.data ?? [];
-
-    return buildValue(data);
+    return buildLazyValue(cameraRollRows(photosQuery?.data?.cameraRoll?.pages));
   }, [
     photosQuery?.data?.cameraRoll?.id,
-    photosQuery?.data?.cameraRoll?.data,
+    photosQuery?.data?.cameraRoll?.pages,
     assetType,
     photosQuery?.data?.cameraRoll?.sessionId
   ]);
@@ -181,11 +182,10 @@ export const CameraRollFilterList = ({
             ...fetchMoreResult,
             cameraRoll: {
               ...fetchMoreResult.cameraRoll,
-              data: uniqBy(
-                previousResult.cameraRoll.data.concat(
-                  fetchMoreResult.cameraRoll.data
-                ),
-                "id"
+              pages: uniq(
+                previousResult.cameraRoll.pages.concat(
+                  fetchMoreResult.cameraRoll.pages
+                )
               )
             }
           };
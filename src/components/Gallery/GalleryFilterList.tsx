@@ -1,5 +1,5 @@
 import { NetworkStatus } from "apollo-client";
-import { chunk, flatMap } from "lodash";
+import { chunk, flatMap, range } from "lodash";
 import memoizee from "memoizee";
 import * as React from "react";
 import { useQuery } from "react-apollo";
@@ -9,6 +9,7 @@ import { BOTTOM_Y, SCREEN_DIMENSIONS, TOP_Y } from "../../../config";
 import { PostFragment } from "../../lib/graphql/PostFragment";
 import { PostSearchQuery_searchPosts_data } from "../../lib/graphql/PostSearchQuery";
 import { YeetImageContainer } from "../../lib/imageSearch";
+import { lazyArray } from "../../lib/lazyArray";
 import IMAGE_SEARCH_QUERY from "../../lib/ImageSearchQuery.local.graphql";
 import FastList from "../FastList";
 import { registrations } from "../MediaPlayer/MediaPlayerComponent";
@@ -306,10 +307,8 @@ export class GalleryFilterListComponent extends React.PureComponent<Props> {
     : [styles.container, { height: this.props.height }];
 
   static getSections = memoize((data, numColumns) => {
-    return chunk(
-      data.map((row, index) => index),
-      numColumns
-    );
+    // Only the indices: data can be a lazyArray, where reading a row builds it.
+    return chunk(range(data.length), numColumns);
   });
 
   get sections() {
@@ -535,6 +534,11 @@ export const buildValue = (data: Array<YeetImageContainer> = []) => {
   return (data || []).map(_buildValue);
 };
 
+// Same as buildValue, but each cell is built when the list reads it.
+export const buildLazyValue = (data: Array<YeetImageContainer>) => {
+  return lazyArray(data.length, index => _buildValue(data[index]));
+};
+
 export const postToCell = memoize(
   post => {
     const {
@@ -5,7 +5,7 @@ import {
   imageContainerFromMediaSource
 } from "../../lib/imageSearch";
 import { NetworkStatus } from "apollo-client";
-import { fromPairs, chunk } from "lodash";
+import { fromPairs, chunk, range } from "lodash";
 import { FlatList } from "../FlatList";
 import {
   GallerySectionItem,
@@ -25,7 +25,7 @@ import CAMERA_ROLL_QUERY from "../../lib/CameraRollQuery.local.graphql";
 import GIFS_QUERY from "../../lib/GIFSearchQuery.local.graphql";
 import GALLERY_QUERY from "../../lib/GalleryListQuery.local.graphql";
 import { useApolloClient, useQuery, useLazyQuery } from "react-apollo";
-import CameraRollGraphQL from "../../lib/CameraRollGraphQL";
+import CameraRollGraphQL, { cameraRollRows } from "../../lib/CameraRollGraphQL";
 import Pager from "react-native-tab-view/src/Pager";
 import chroma from "chroma-js";
 import {
@@ -54,6 +54,7 @@ import {
   getInitialLimit,
   buildPostValue,
   buildValue,
+  buildLazyValue,
   buildMediaValue,
   postToCell,
   _buildValue
@@ -136,7 +137,7 @@ class GallerySectionListComponent extends React.Component<Props> {
   };
 
   static getSections = memoize((data, numColumns) =>
-    chunk(data?.map((row, index) => index) ?? [], numColumns)
+    chunk(range(data?.length ?? 0), numColumns)
   );
 
   get sections() {
@@ -497,7 +498,9 @@ export const GallerySectionList = ({
   ]);
 
   const cameraRollSection = React.useMemo<GallerySection>(() => {
-    const data = buildValue(photosQuery?.data?.cameraRoll?.data || []);
+    const data = buildLazyValue(
+      cameraRollRows(photosQuery?.data?.cameraRoll?.pages)
+    );
     if (
       data.length > 0 &&
       !sectionOrder.current.includes(GallerySectionItem.cameraRoll)
@@ -511,8 +514,8 @@ export const GallerySectionList = ({
     };
   }, [
     photosQuery?.data?.cameraRoll?.id,
-    photosQuery?.data?.cameraRoll?.data,
-    buildValue,
+    photosQuery?.data?.cameraRoll?.pages,
+    buildLazyValue,
     sectionOrder
   ]);
 
@@ -283,6 +283,23 @@ export class MediaPlayerComponent extends React.Component<MediaPlayerProps> {
     });
   };
 
+  suggestCrop = (aspectRatio: number) => {
+    return new Promise((resolve, reject) => {
+      MediaPlayerComponent.NativeModule?.suggestCrop(
+        findNodeHandle(this),
+        aspectRatio,
+        (err, success) => {
+          if (err) {
+            reject(err);
+            return;
+          } else {
+            resolve(success);
+          }
+        }
+      );
+    });
+  };
+
   editVideo = (): Promise<VideoEditResponse> =>
     new Promise<VideoEditResponse>((resolve, reject) => {
       MediaPlayerComponent.NativeModule?.editVideo(
@@ -109,6 +109,7 @@ class RawUserContextProvider extends React.Component<Props, State> {
   }
 
   componentDidMount() {
+    Storage.hydrate();
     this.loadJWT();
   }
 
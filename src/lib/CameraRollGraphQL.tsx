@@ -15,6 +15,7 @@ import Storage, { fetchRecentlyUsedContent } from "./Storage";
 import { Platform } from "react-native";
 import { check, PERMISSIONS, request, RESULTS } from "react-native-permissions";
 import memoizee from "memoizee";
+import { lazyArray } from "./lazyArray";
 
 let _lastStatus = null;
 const ensureExternalStoragePermission = async () => {
@@ -49,6 +50,39 @@ const graphqlImageContainer = (
   };
 };
 
+// Native camera roll pages by CameraRollResult id. Apollo only stores the page ids, so rows stay
+// in the native page until the list reads them.
+const cameraRollPages = new Map<string, { sessionId: string; data: any }>();
+
+export const cameraRollRows = (
+  pageIds: Array<string> = []
+): Array<YeetImageContainer> => {
+  const pages = pageIds
+    .map(pageId => cameraRollPages.get(pageId)?.data)
+    .filter(Boolean);
+  const length = pages.reduce((total, page) => total + page.length, 0);
+
+  return lazyArray(length, index => {
+    let pageIndex = 0;
+    while (index >= pages[pageIndex].length) {
+      index -= pages[pageIndex].length;
+      pageIndex++;
+    }
+
+    return graphqlImageContainer(
+      imageContainerFromCameraRoll(pages[pageIndex][index])
+    );
+  });
+};
+
+export const releaseCameraRollPages = (sessionId: string) => {
+  cameraRollPages.forEach((page, pageId) => {
+    if (page.sessionId === sessionId) {
+      cameraRollPages.delete(pageId);
+    }
+  });
+};
+
 export default {
   Query: {
     cameraRoll: async (_, args = {}, { cache, getCacheKey }) => {
@@ -88,7 +122,7 @@ export default {
                 id: `cameraroll-pageinfo`
               },
               id: "cameraroll__empty",
-              data: []
+              pages: []
             };
           }
         }
@@ -130,11 +164,15 @@ export default {
           id,
           album: result.album,
           sessionId: result.sessionId,
-          data: result.data.map(edge =>
-            graphqlImageContainer(imageContainerFromCameraRoll(edge))
-          )
+          // Read the rows with cameraRollRows(pages).
+          pages: [id]
         };
 
+        cameraRollPages.set(id, {
+          sessionId: result.sessionId,
+          data: result.data
+        });
+
         return response;
       } catch (exception) {
         console.error(exception);
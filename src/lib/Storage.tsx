@@ -10,7 +10,12 @@ import {
 } from "./db/models/RecentlyUsedContent";
 import { PostFragment } from "./graphql/PostFragment";
 import { YeetImage, YeetImageContainer } from "./imageSearch";
-import { getItem, setItem, removeItem } from "./Yeet";
+import {
+  getItem,
+  setItem,
+  removeItem,
+  multiGetItems
+} from "./Yeet";
 
 const PRODUCTION_SUPER_STORE = "@yeetapp-production";
 const DEVELOPMENT_SUPER_STORE = "@yeetapp-dev-11";
@@ -40,6 +45,15 @@ export const WATCH_KEYS = {
 
 var _cachedJWT;
 
+// Everything read while the app launches, fetched with one multiGet instead of a JSI call per key.
+const LAUNCH_KEYS = [
+  KEYS.CURRENT_USER_ID,
+  KEYS.DISMISSED_WELCOME_MODAL,
+  KEYS.DISMISSED_PUSH_NOTIFICATION_MODAL
+];
+
+var _launchValues: { [key: string]: any } | null = null;
+
 type RecentImage = YeetImage & {
   id: string;
 };
@@ -80,6 +94,10 @@ export class Storage {
   }
 
   static removeItem(key) {
+    if (_launchValues && key in _launchValues) {
+      _launchValues[key] = KEY_TYPES[key] === "bool" ? false : null;
+    }
+
     return removeItem(Storage.formatKey(key));
   }
 
@@ -131,10 +149,41 @@ export class Storage {
     return !!this.getCachedJWT();
   }
 
+  // Safe to call more than once. The first getItem for a launch key hydrates too.
+  static hydrate() {
+    if (_launchValues) {
+      return _launchValues;
+    }
+
+    const values = Storage.getItems(LAUNCH_KEYS);
+    if (!values) {
+      return null;
+    }
+
+    _launchValues = {};
+    LAUNCH_KEYS.forEach((key, index) => {
+      _launchValues[key] = values[index];
+    });
+
+    return _launchValues;
+  }
+
   static getItem(key: string) {
-    console.log(`[Storage] GET ${key}`);
+    if (LAUNCH_KEYS.includes(key)) {
+      const launchValues = Storage.hydrate();
+      if (launchValues) {
+        return launchValues[key];
+      }
+    }
+
     return getItem(Storage.formatKey(key), KEY_TYPES[key] || "string");
-    // return AsyncStorage.getItem(Storage.formatKey(key));
+  }
+
+  static getItems(keys: Array<string>) {
+    return multiGetItems(
+      keys.map(Storage.formatKey),
+      keys.map(key => KEY_TYPES[key] || "string")
+    );
   }
 
   static async insertRecentlyUsed(imageContainer: YeetImageContainer, post) {
@@ -147,9 +196,16 @@ export class Storage {
 
   static setItem(key, value) {
     if (value) {
-      return setItem(Storage.formatKey(key), value, KEY_TYPES[key]);
+      if (_launchValues && key in _launchValues) {
+        _launchValues[key] = KEY_TYPES[key] === "bool" ? !!value : value;
+      }
+
+      return setItem(
+        Storage.formatKey(key),
+        value,
+        KEY_TYPES[key] || "string"
+      );
     } else {
-      console.log(`[Storage] REMOVE ${key}`);
       return Storage.removeItem(key);
     }
   }
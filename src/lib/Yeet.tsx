@@ -22,6 +22,15 @@ export const getFocusedYeetInputTag = (): any =>
 export const setItem = (key: string, value: any, type: string): any =>
   global.YeetJSI?.setItem(key, value, type);
 
+export const multiGetItems = (
+  keys: Array<string>,
+  types: string | Array<string>
+): Array<any> => global.YeetJSI?.multiGet(keys, types);
+
+export const multiSetItems = (
+  entries: Array<[string, any, string]>
+): boolean => global.YeetJSI?.multiSet(entries);
+
 export const hideSplashScreen = () => global.YeetJSI?.hideSplashScreen();
 
 const _focusYeetTextInput = inputTag => global.YeetJSI?.focus(inputTag);
@@ -51,11 +60,44 @@ export const transitionPanSheetView = (
   size: PanSheetViewSize | "dismiss"
 ) => global.YeetJSI?.transitionPanView(tag, size);
 
+// Measurements are packed as [x, y, width, height] per block, in the same order as blocks.
+// Blocks that couldn't be measured are NaN.
+export type PackedMeasurements = Array<number>;
+
+export const MEASUREMENT_STRIDE = 4;
+
+export const measurementAt = (
+  measurements: PackedMeasurements,
+  index: number
+): BoundsRect | null => {
+  const offset = index * MEASUREMENT_STRIDE;
+  const x = measurements[offset];
+
+  if (typeof x !== "number" || isNaN(x)) {
+    return null;
+  }
+
+  return {
+    x,
+    y: measurements[offset + 1],
+    width: measurements[offset + 2],
+    height: measurements[offset + 3]
+  };
+};
+
 export const measureRelativeTo = (
   containerTag: number,
   blocks: Array<number>,
-  callback: (
-    err: Error | null,
-    measurements: { measurements: Array<BoundsRect> }
-  ) => void
+  callback: (err: Error | null, measurements: PackedMeasurements) => void
 ) => global.YeetJSI?.measureRelativeTo(containerTag, blocks, callback);
+
+// Reads from a snapshot published after each layout pass, so it returns in the same tick.
+// Returns null the first time it's called for a container, while the snapshot warms up.
+export const measureRelativeToSync = (
+  containerTag: number,
+  blocks: Array<number>
+): PackedMeasurements | null =>
+  global.YeetJSI?.measureRelativeToSync(containerTag, blocks) ?? null;
+
+export const stopMeasuringRelativeTo = (containerTag: number) =>
+  global.YeetJSI?.stopMeasuringRelativeTo(containerTag);
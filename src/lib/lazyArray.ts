@@ -0,0 +1,32 @@
+// An array-like whose items are built the first time their index is read.
+// Array methods like map() read every index, so consumers should index into it instead.
+export const lazyArray = <T>(
+  length: number,
+  read: (index: number) => T
+): Array<T> => {
+  const items = new Array<T>(length);
+
+  return new Proxy(items, {
+    get: (target, key) => {
+      if (typeof key === "string") {
+        const index = Number(key);
+        if (Number.isInteger(index) && index >= 0 && index < length) {
+          if (!(index in target)) {
+            target[index] = read(index);
+          }
+
+          return target[index];
+        }
+      }
+
+      return Reflect.get(target, key);
+    },
+    has: (target, key) => {
+      const index = typeof key === "string" ? Number(key) : NaN;
+      return (
+        (Number.isInteger(index) && index >= 0 && index < length) ||
+        Reflect.has(target, key)
+      );
+    }
+  });
+};